@@ -192,6 +192,7 @@ end translateModel;
     #include "<%fileNamePrefix%>_literals.h"
 
     <%if Flags.isSet(Flags.PARMODAUTO) then "#include \"ParModelica/auto/om_pm_interface.hpp\""%>
+    <%if Flags.isSet(Flags.PARALLEL_EQUATIONS) then "#include \"simulation/solver/equationTaskGraph.h\""%>
 
     <%if stringEq(getConfigString(HPCOM_CODE),"pthreads_spin") then "#include \"util/omc_spinlock.h\""%>
 
@@ -4025,6 +4026,41 @@ match eqlstlst
   error(sourceInfo(), 'TODO more than ODE list in <%name%> systems')
 end functionXXX_systems_arrayFormat;
 
+template equationTaskGraphTables(list<list<SimEqSystem>> eqs, String name, String modelNamePrefixStr)
+ "Generates the tables of the equations for the parallel evaluation in the
+  runtime (-d=parallelEquations). The dependencies are read from the model info."
+::=
+  let eqIndices = (List.flatten(eqs) |> eq => equationCallIndex(eq) ; separator=", ")
+  let eqFuncs = (List.flatten(eqs) |> eq => equationTaskFunction(eq, modelNamePrefixStr) ; separator=",\n")
+  if eqIndices then
+  <<
+  static const int function<%name%>_taskEqIndex[] = {<%eqIndices%>};
+  static void (*function<%name%>_tasks[])(DATA *, threadData_t *) = {
+    <%eqFuncs%>
+  };
+  >>
+end equationTaskGraphTables;
+
+template equationTaskFunction(SimEqSystem eq, String modelNamePrefixStr)
+ "Name of the generated function of an equation, empty for equations without code."
+::=
+  let ix = equationCallIndex(eq)
+  if ix then '<%symbolName(modelNamePrefixStr,"eqFunction")%>_<%ix%>'
+end equationTaskFunction;
+
+template equationTaskGraphCall(Text tables, Text fncalls, String name, String kind)
+ "Evaluates the equations with the task graph of the runtime if the tables
+  were generated, the sequential calls are the fallback."
+::=
+  if tables then
+  <<
+  if (!evaluateEquationTaskGraph(data, threadData, <%kind%>, sizeof(function<%name%>_taskEqIndex)/sizeof(int), function<%name%>_tasks, function<%name%>_taskEqIndex)) {
+    <%fncalls%>
+  }
+  >>
+  else fncalls
+end equationTaskGraphCall;
+
 template functionODE(list<list<SimEqSystem>> derivativEquations, Text method, Option<tuple<Schedule,Schedule,Schedule>> hpcOmSchedules, String modelNamePrefix)
  "Generates function in simulation file."
 ::=
@@ -4040,10 +4076,13 @@ template functionODE(list<list<SimEqSystem>> derivativEquations, Text method, Op
                 else
                     (functionXXX_systems(derivativEquations, "ODE", &fncalls, &varDecls, modelNamePrefix))
   /* let systems = functionXXX_systems(derivativEquations, "ODE", &fncalls, &varDecls) */
+  let taskGraph = if boolOr(Flags.isSet(Flags.HPCOM), Flags.isSet(Flags.PARMODAUTO)) then "" else
+                  if Flags.isSet(Flags.PARALLEL_EQUATIONS) then equationTaskGraphTables(derivativEquations, "ODE", modelNamePrefix)
   let &tmp = buffer ""
   <<
   <%tmp%>
   <%systems%>
+  <%taskGraph%>
 
   int <%symbolName(modelNamePrefix,"functionODE")%>(DATA *data, threadData_t *threadData)
   {
@@ -4058,7 +4097,7 @@ template functionODE(list<list<SimEqSystem>> derivativEquations, Text method, Op
 
     <%symbolName(modelNamePrefix,"functionLocalKnownVars")%>(data, threadData);
     <%if Flags.isSet(Flags.PARMODAUTO) then 'PM_functionODE(<%nrfuncs%>, data, threadData, functionODE_systems);'
-    else fncalls %>
+    else equationTaskGraphCall(taskGraph, fncalls, "ODE", "EQUATION_TASKGRAPH_ODE") %>
 
   #if !defined(OMC_MINIMAL_RUNTIME)
     <% if profileFunctions() then "" else "if (measure_time_flag) " %>rt_accumulate(SIM_TIMER_FUNCTION_ODE);
@@ -4080,10 +4119,13 @@ template functionAlgebraic(list<list<SimEqSystem>> algebraicEquations, String mo
                     (functionXXX_systems_arrayFormat(algebraicEquations, "Alg", &fncalls, &nrfuncs, &varDecls, modelNamePrefix))
                 else
                     (functionXXX_systems(algebraicEquations, "Alg", &fncalls, &varDecls, modelNamePrefix))
+  let taskGraph = if boolOr(Flags.isSet(Flags.HPCOM), Flags.isSet(Flags.PARMODAUTO)) then "" else
+                  if Flags.isSet(Flags.PARALLEL_EQUATIONS) then equationTaskGraphTables(algebraicEquations, "Alg", modelNamePrefix)
 
 
   <<
   <%systems%>
+  <%taskGraph%>
   /* for continuous time variables */
   int <%symbolName(modelNamePrefix,"functionAlgebraics")%>(DATA *data, threadData_t *threadData)
   {
@@ -4096,7 +4138,7 @@ template functionAlgebraic(list<list<SimEqSystem>> algebraicEquations, String mo
     data->simulationInfo->callStatistics.functionAlgebraics++;
 
     <%if Flags.isSet(Flags.PARMODAUTO) then 'PM_functionAlg(<%nrfuncs%>, data, threadData, functionAlg_systems);'
-    else fncalls %>
+    else equationTaskGraphCall(taskGraph, fncalls, "Alg", "EQUATION_TASKGRAPH_ALG") %>
 
     <%symbolName(modelNamePrefix,"function_savePreSynchronous")%>(data, threadData);
 
@@ -5157,6 +5199,19 @@ template equation_impl2(Integer clockIndex, SimEqSystem eq, Context context, Str
   )
 end equation_impl2;
 
+template equationCallIndex(SimEqSystem eq)
+ "Index of the generated function of an equation, empty for equations without code."
+::=
+  match eq
+  case e as SES_ALGORITHM(statements={})
+  then ""
+  case e as SES_LINEAR(alternativeTearing = SOME(LINEARSYSTEM))
+  case e as SES_NONLINEAR(alternativeTearing = SOME(NONLINEARSYSTEM)) then
+    equationIndexAlternativeTearing(eq)
+  else
+    equationIndex(eq)
+end equationCallIndex;
+
 template equation_call(SimEqSystem eq, String modelNamePrefix)
  "Generates an equation.
   This template should not be used for a SES_RESIDUAL.
@@ -5167,13 +5222,7 @@ template equation_call(SimEqSystem eq, String modelNamePrefix)
   then ""
   else
   (
-  let ix = match eq
-  case e as SES_LINEAR(alternativeTearing = SOME(LINEARSYSTEM))
-  case e as SES_NONLINEAR(alternativeTearing = SOME(NONLINEARSYSTEM)) then
-    equationIndexAlternativeTearing(eq)
-  else
-    equationIndex(eq)
-  end match
+  let ix = equationCallIndex(eq)
   <<
   <% if profileAll() then 'SIM_PROF_TICK_EQ(<%ix%>);' %>
   <%symbolName(modelNamePrefix,"eqFunction")%>_<%ix%>(data, threadData);
@@ -5190,13 +5239,7 @@ template equation_callJacobian(SimEqSystem eq, String modelNamePrefix)
   then ""
   else
   (
-  let ix = match eq
-  case e as SES_LINEAR(alternativeTearing = SOME(LINEARSYSTEM))
-  case e as SES_NONLINEAR(alternativeTearing = SOME(NONLINEARSYSTEM)) then
-    equationIndexAlternativeTearing(eq)
-  else
-    equationIndex(eq)
-  end match
+  let ix = equationCallIndex(eq)
   <<
   <% if profileAll() then 'SIM_PROF_TICK_EQ(<%ix%>);' %>
   <%symbolName(modelNamePrefix,"eqFunction")%>_<%ix%>(data, threadData, jacobian, parentJacobian);
@@ -309,6 +309,7 @@ case SIMCODE(modelInfo=MODELINFO(__)) then
   {
   public:
     <%lastIdentOfPath(modelInfo.name)%>StateSelection(IGlobalSettings* globalSettings, shared_ptr<ISimObjects> simObjects);
+    <%lastIdentOfPath(modelInfo.name)%>StateSelection(<%lastIdentOfPath(modelInfo.name)%>StateSelection& instance);
     virtual ~<%lastIdentOfPath(modelInfo.name)%>StateSelection();
     int getDimStateSets() const;
     int getDimStates(unsigned int index) const;
@@ -690,6 +691,11 @@ case SIMCODE(modelInfo = MODELINFO(__)) then
    {
    }
 
+   <%lastIdentOfPath(modelInfo.name)%>StateSelection::<%lastIdentOfPath(modelInfo.name)%>StateSelection(<%lastIdentOfPath(modelInfo.name)%>StateSelection& instance)
+       : <%lastIdentOfPath(modelInfo.name)%>Mixed(instance)
+   {
+   }
+
    <%lastIdentOfPath(modelInfo.name)%>StateSelection::~<%lastIdentOfPath(modelInfo.name)%>StateSelection()
    {
    }
@@ -717,7 +723,7 @@ case SIMCODE(modelInfo = MODELINFO(__)) then
    }
 
    <%lastIdentOfPath(modelInfo.name)%>WriteOutput::<%lastIdentOfPath(modelInfo.name)%>WriteOutput(<%lastIdentOfPath(modelInfo.name)%>WriteOutput& instance)
-       : <%lastIdentOfPath(modelInfo.name)%>StateSelection(instance.getGlobalSettings(), instance.getSimObjects())
+       : <%lastIdentOfPath(modelInfo.name)%>StateSelection(instance)
    {
 
    }
@@ -5800,6 +5806,10 @@ case SIMCODE(modelInfo = MODELINFO(__),makefileParams = MAKEFILE_PARAMS(__))  th
 
       <%if (Flags.isSet(Flags.HARDCODED_START_VALUES)) then
       <<
+      //the hardcoded start values below would overwrite start values given at runtime, e.g. by simulation jobs
+      if (!_global_settings->getStartValues().empty())
+        throw ModelicaSimulationError(MODEL_EQ_SYSTEM, "Start values given at runtime are not supported by models compiled with -d=hardcodedStartValues");
+
       /*initialize parameter*/
       initializeParameterVars();
       initializeIntParameterVars();
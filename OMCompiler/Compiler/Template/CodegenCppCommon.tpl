@@ -965,7 +965,7 @@ template daeExp(Exp exp, Context context, Text &preExp /*BUFP*/, Text &varDecls
   case e as UNARY(__)           then     daeExpUnary(e, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)
   case e as LBINARY(__)         then     daeExpLbinary(e, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)
   case e as LUNARY(__)          then     daeExpLunary(e, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)
-  case e as BINARY(__)          then     daeExpBinary(operator, exp1, exp2, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)
+  case e as BINARY(__)          then     daeExpBinaryFused(e, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)
   case e as IFEXP(__)           then     daeExpIf(expCond, expThen, expElse, context, &preExp, &varDecls, simCode , &extraFuncs , &extraFuncsDecl,  extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)
   case e as RELATION(__)        then     daeExpRelation(e, context, &preExp, &varDecls,simCode , &extraFuncs , &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)
   case e as CALL(__)            then     daeExpCall(e, context, &preExp /*BUFC*/, &varDecls /*BUFD*/,simCode , &extraFuncs , &extraFuncsDecl,  extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)
@@ -2351,7 +2351,10 @@ template daeExpBinary(Operator it, Exp exp1, Exp exp2, Context context, Text &pr
   case ADD_ARRAY_SCALAR(ty=T_ARRAY(dims=dims)) then
     let type = expTypeShort(ty.ty)
     let tvar = tempDecl(expTypeArrayDims(ty.ty, dims), &varDecls /*BUFD*/)
-    let &preExp += 'add_array_scalar<<%type%>>(<%e2%>, <%e1%>, <%tvar%>);<%\n%>'
+    let &preExp += if isArrayType(typeof(exp1)) then
+                     'add_array_scalar<<%type%>>(<%e1%>, <%e2%>, <%tvar%>);<%\n%>'
+                   else
+                     'add_array_scalar<<%type%>>(<%e2%>, <%e1%>, <%tvar%>);<%\n%>'
     '<%tvar%>'
   case SUB_SCALAR_ARRAY(ty=T_ARRAY(dims=dims)) then
     let type = expTypeShort(ty.ty)
@@ -2380,6 +2383,77 @@ template daeExpBinary(Operator it, Exp exp1, Exp exp2, Context context, Text &pr
   case _   then 'daeExpBinary:ERR <%ExpressionDumpTpl.dumpExp(exp1,"\"")%> <%binopSymbol(it)%> <%ExpressionDumpTpl.dumpExp(exp2,"\"")%>'
 end daeExpBinary;
 
+template daeExpBinaryFused(Exp exp, Context context, Text &preExp, Text &varDecls, SimCode simCode, Text& extraFuncs, Text& extraFuncsDecl,
+                           Text extraFuncsNamespace, Text stateDerVectorName /*=__zDot*/, Boolean useFlatArrayNotation)
+ "Generates code for a binary expression. Nested element-wise array operations
+  are fused into one expression template (see ArrayExpression.h), which is
+  evaluated in a single loop without temporary arrays."
+::=
+  match exp
+  case BINARY(__) then
+    let fuse = if elementWiseArrayExp(exp) then '<%elementWiseArrayExp(exp1)%><%elementWiseArrayExp(exp2)%>'
+    if fuse then
+      let tvar = elementWiseArrayTemp(Expression.typeof(exp), &varDecls)
+      let expr = arrayExpression(exp, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)
+      let &preExp += 'assign_array_expr(<%tvar%>, <%expr%>);<%\n%>'
+      '<%tvar%>'
+    else
+      daeExpBinary(operator, exp1, exp2, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)
+end daeExpBinaryFused;
+
+template elementWiseArrayExp(Exp exp)
+ "Returns non-empty text if exp is an element-wise array operation that is
+  supported by the expression templates."
+::=
+  match exp
+  case BINARY(operator=ADD_ARR(ty=T_ARRAY(__)))
+  case BINARY(operator=SUB_ARR(ty=T_ARRAY(__)))
+  case BINARY(operator=MUL_ARR(ty=T_ARRAY(__)))
+  case BINARY(operator=DIV_ARR(ty=T_ARRAY(__)))
+  case BINARY(operator=MUL_ARRAY_SCALAR(ty=T_ARRAY(__)))
+  case BINARY(operator=DIV_ARRAY_SCALAR(ty=T_ARRAY(__)))
+  case BINARY(operator=ADD_ARRAY_SCALAR(ty=T_ARRAY(__)))
+  case UNARY(operator=UMINUS_ARR(ty=T_ARRAY(ty=T_REAL(__)))) then "1"
+  else ""
+end elementWiseArrayExp;
+
+template elementWiseArrayTemp(DAE.Type arrayType, Text &varDecls)
+ "Declares the array holding the result of fused element-wise operations."
+::=
+  match arrayType
+  case T_ARRAY(__) then tempDecl(expTypeArrayDims(ty, dims), &varDecls /*BUFD*/)
+  else "elementWiseArrayTemp:ERR no array type"
+end elementWiseArrayTemp;
+
+template arrayExpression(Exp exp, Context context, Text &preExp, Text &varDecls, SimCode simCode, Text& extraFuncs, Text& extraFuncsDecl,
+                         Text extraFuncsNamespace, Text stateDerVectorName /*=__zDot*/, Boolean useFlatArrayNotation)
+ "Generates an expression template for nested element-wise array operations.
+  All other expressions are evaluated as usual and become its leaves."
+::=
+  match exp
+  case BINARY(operator=ADD_ARR(__)) then
+    '(<%arrayExpression(exp1, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%> + <%arrayExpression(exp2, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%>)'
+  case BINARY(operator=SUB_ARR(__)) then
+    '(<%arrayExpression(exp1, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%> - <%arrayExpression(exp2, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%>)'
+  case BINARY(operator=MUL_ARR(__)) then
+    '(<%arrayExpression(exp1, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%> * <%arrayExpression(exp2, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%>)'
+  case BINARY(operator=DIV_ARR(__)) then
+    '(<%arrayExpression(exp1, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%> / <%arrayExpression(exp2, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%>)'
+  case BINARY(operator=MUL_ARRAY_SCALAR(__)) then
+    '(<%arrayExpression(exp1, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%> * <%daeExp(exp2, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%>)'
+  case BINARY(operator=DIV_ARRAY_SCALAR(__)) then
+    '(<%arrayExpression(exp1, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%> / <%daeExp(exp2, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%>)'
+  case BINARY(operator=ADD_ARRAY_SCALAR(__)) then
+    if isArrayType(typeof(exp1)) then
+      '(<%arrayExpression(exp1, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%> + <%daeExp(exp2, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%>)'
+    else
+      '(<%daeExp(exp1, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%> + <%arrayExpression(exp2, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%>)'
+  case UNARY(operator=UMINUS_ARR(ty=T_ARRAY(ty=T_REAL(__)))) then
+    '(-<%arrayExpression(exp, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%>)'
+  else
+    'array_expr(<%daeExp(exp, context, &preExp, &varDecls, simCode, &extraFuncs, &extraFuncsDecl, extraFuncsNamespace, stateDerVectorName, useFlatArrayNotation)%>)'
+end arrayExpression;
+
 
 template daeExpSconst(String string, Context context, Text &preExp, Text &varDecls, SimCode simCode, Text& extraFuncs, Text& extraFuncsDecl,
                       Text extraFuncsNamespace, Text stateDerVectorName /*=__zDot*/, Boolean useFlatArrayNotation)
@@ -17,7 +17,7 @@ template modelInitXMLFile(SimCode simCode, String numRealVars, String numIntVars
       //let algLoops = (listAppend(allEquations,initialEquations) |> eq => algLoopXML(eq, simCode, varToArrayIndexMapping, '<%numRealVars%> - 1') ;separator="\n")
       //let jacobianMatrixes = jacobianMatrixesXML(simCode.jacobianMatrixes)
       let descriptionTag = if generateFMUModelDescription then "fmiModelDescription" else "ModelDescription"
-      let fmiDescriptionAttributes = if generateFMUModelDescription then fmiDescriptionAttributes(simCode, FMUVersion, FMUType, FMUGuid) else 'modelName="<%dotPath(modelInfo.name)%>"'
+      let fmiDescriptionAttributes = if generateFMUModelDescription then fmiDescriptionAttributes(simCode, FMUVersion, FMUType, FMUGuid) else modelDescriptionAttributes(modelInfo, numRealVars, numIntVars, numBoolVars, numStringVars)
       let fmiTypeDefinitions = if generateFMUModelDescription then CodegenFMUCommon.fmiTypeDefinitions(simCode, FMUVersion)
       let fmiDefaultExperiment = if generateFMUModelDescription then CodegenFMUCommon.DefaultExperiment(simulationSettingsOpt)
       <<
@@ -46,6 +46,24 @@ template modelInitXMLFile(SimCode simCode, String numRealVars, String numIntVars
       */
 end modelInitXMLFile;
 
+template modelDescriptionAttributes(ModelInfo modelInfo, String numRealVars, String numIntVars, String numBoolVars, String numStringVars)
+ "Generates the attributes of the init xml file: the model name and the dimensions of the simulation variables as in LoadSimVars."
+::=
+  match modelInfo
+    case MODELINFO(varInfo = vi as VARINFO(__)) then
+      let numPreVars = intAdd(stringInt(numRealVars), intAdd(stringInt(numIntVars), stringInt(numBoolVars)))
+      <<
+      modelName="<%dotPath(modelInfo.name)%>"
+      numberOfRealVariables="<%numRealVars%>"
+      numberOfIntegerVariables="<%numIntVars%>"
+      numberOfBooleanVariables="<%numBoolVars%>"
+      numberOfStringVariables="<%numStringVars%>"
+      numberOfPreVariables="<%numPreVars%>"
+      numberOfContinuousStates="<%vi.numStateVars%>"
+      stateIndex="0"
+      >>
+end modelDescriptionAttributes;
+
 template fmiDescriptionAttributes(SimCode simCode, String FMUVersion, String FMUType, String FMUGuid)
 ::=
   if isFMIVersion20(FMUVersion) then CodegenFMU2.fmiModelDescriptionAttributes(simCode,FMUGuid)
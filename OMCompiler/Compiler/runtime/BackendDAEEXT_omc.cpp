@@ -140,6 +140,11 @@ extern void BackendDAEEXT_matching(modelica_integer nv, modelica_integer ne, mod
   BackendDAEExtImpl__matching(nv, ne, matchingID, cheapID, relabel_period, clear_match);
 }
 
+extern void BackendDAEEXT_setMatchingThreads(modelica_integer numThreads)
+{
+  matching_set_num_threads(numThreads);
+}
+
 extern void BackendDAEEXT_getAssignment(modelica_metatype ass1, modelica_metatype ass2)
 {
   int i=0;
@@ -1,34 +1,25 @@
-//#include <iostream>
-//#include <omp.h>
-//
-//#ifdef WIN32
-//#include <windows.h>
-//#endif
-//
-//#define THREAD_NUM 2
-//#define REPLICATIONS 10000
-//#define WARMUP 10000
-//
-//#define PACKAGE_SIZE_BIG 128
-//#define PACKAGE_SIZE_SMALL 1
-//
-//int itemCount = 0;
-//double items[PACKAGE_SIZE_BIG];
-//unsigned long long comTimes[REPLICATIONS];
-//
-//inline volatile long long RDTSC() {
-//   register long long TSC asm("eax");
-//   asm volatile (".byte 15, 49" : : : "eax", "edx");
-//   return TSC;
-//}
 #include "expat.h"
 #include <list>
 #include <string>
 #include <sstream>
+#include <vector>
+#include <algorithm>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
 #include <fstream>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include "cJSON.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HPCOM_HAVE_TSC 1
+#endif
+
 struct Equation {
   int id;
   unsigned long calcTimeCount;
@@ -39,183 +30,673 @@ struct Equation {
   }
 };
 
+/* The cost model used by the hpcom schedulers: y=m*x+n cycles for x operations
+ * resp. x transferred variables. The defaults are used as long as the host has
+ * not been calibrated with calibrateHpcOm().
+ */
+#define HPCOM_DEFAULT_OP_M 1
+#define HPCOM_DEFAULT_OP_N 24
+#define HPCOM_DEFAULT_COMM_M 4
+#define HPCOM_DEFAULT_COMM_N 70
+
+/* The operation types of the execution cost estimation (see
+ * HpcOmTaskGraph.calculateCosts), the defaults are the costs benchmarked with
+ * the Cpp runtime. */
+enum HpcOmOpType {HPCOM_OP_ADD, HPCOM_OP_MUL, HPCOM_OP_DIV, HPCOM_OP_TRIG, HPCOM_OP_RELATION, HPCOM_OP_LOGIC, HPCOM_OP_OTHER, HPCOM_OP_CALL, HPCOM_OP_COUNT};
+static const char *hpcomOpNames[HPCOM_OP_COUNT] = {"add", "mul", "div", "trig", "relation", "logic", "other", "call"};
+static const int hpcomDefaultOpCosts[HPCOM_OP_COUNT] = {12, 32, 37, 236, 2, 4, 110, 375};
+
+#define HPCOM_CALIBRATION_VERSION 2
+#define HPCOM_BENCH_OPS 200000
+#define HPCOM_BENCH_REPLICATIONS 5
+#define HPCOM_PINGPONG_ROUNDS 20000
+#define HPCOM_PACKAGE_SIZE_SMALL 1
+#define HPCOM_PACKAGE_SIZE_BIG 128
+/* The core pair matrix grows quadratically, larger machines are sampled. */
+#define HPCOM_MAX_CALIBRATED_CPUS 16
+
+struct HpcOmCalibration {
+  bool loaded;
+  std::string file; /* the database the values were read from */
+  int opM, opN, commM, commN;
+  int opCosts[HPCOM_OP_COUNT];
+  int nCpus;
+  std::vector<int> cpus; /* the calibrated cpus */
+  std::vector<std::vector<double> > cacheLine; /* cycles from cpus[i] to cpus[j], negative if not measured */
+  std::vector<int> cpuNodes; /* the NUMA node of each cpu */
+  std::vector<std::vector<int> > numaDistances;
+  std::vector<std::vector<double> > nodeCosts; /* mean cacheLine between two nodes, negative without samples */
+  double meanCost; /* mean of all measured pairs, 0 without */
+};
+
+static HpcOmCalibration hpcomCalibration;
+static pthread_mutex_t hpcomCalibrationMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * The calibration database holds one entry per host, so a shared home
+ * directory can be used from different machines.
+ */
+static std::string hpcomCalibrationFile()
+{
+  const char *env = getenv("OPENMODELICA_HPCOM_CALIBRATION");
+  if (env && *env)
+    return env;
+  const char *home = getenv("HOME");
+#if defined(__MINGW32__)
+  if (!home)
+    home = getenv("APPDATA");
+#endif
+  if (!home)
+    return "";
+  return std::string(home) + "/.openmodelica/hpcom-calibration.json";
+}
+
+static std::string hpcomHostName()
+{
+  char name[256] = "";
+  if (gethostname(name, sizeof(name)-1) != 0 || !*name)
+    return "localhost";
+  name[sizeof(name)-1] = '\0';
+  return name;
+}
+
+static cJSON* hpcomReadCalibrationFile(const std::string &fileName)
+{
+  std::ifstream ifile(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!ifile)
+    return NULL;
+  std::stringstream content;
+  content << ifile.rdbuf();
+  return cJSON_Parse(content.str().c_str());
+}
+
+static int hpcomGetInt(cJSON *object, const char *name, int def)
+{
+  cJSON *item = object ? cJSON_GetObjectItem(object, name) : NULL;
+  return (item && item->type == cJSON_Number) ? item->valueint : def;
+}
+
+/* Reads an array of numbers, fails for anything else. */
+static bool hpcomGetNumbers(cJSON *array, std::vector<double> &values)
+{
+  if (!array || array->type != cJSON_Array)
+    return false;
+  values.clear();
+  for (cJSON *item = array->child; item; item = item->next) {
+    if (item->type != cJSON_Number)
+      return false;
+    values.push_back(item->valuedouble);
+  }
+  return true;
+}
+
+static void hpcomResetCalibration(HpcOmCalibration &c)
+{
+  c.opM = HPCOM_DEFAULT_OP_M;
+  c.opN = HPCOM_DEFAULT_OP_N;
+  c.commM = HPCOM_DEFAULT_COMM_M;
+  c.commN = HPCOM_DEFAULT_COMM_N;
+  for (int i = 0; i < HPCOM_OP_COUNT; i++)
+    c.opCosts[i] = hpcomDefaultOpCosts[i];
+  c.nCpus = 1;
+  c.cpus.clear();
+  c.cacheLine.clear();
+  c.cpuNodes.clear();
+  c.numaDistances.clear();
+  c.nodeCosts.clear();
+  c.meanCost = 0;
+}
+
+/**
+ * Reads the core pair matrix and the NUMA distances of a host entry. An
+ * inconsistent entry leaves them empty, every pair of cores then costs the same.
+ */
+static void hpcomLoadTopology(cJSON *host, HpcOmCalibration &c)
+{
+  cJSON *comm = cJSON_GetObjectItem(host, "comm");
+  cJSON *numa = cJSON_GetObjectItem(host, "numa");
+  std::vector<double> values;
+  c.nCpus = std::max(1, hpcomGetInt(host, "cpus", 1));
+
+  if (comm && hpcomGetNumbers(cJSON_GetObjectItem(comm, "cpus"), values)) {
+    cJSON *rows = cJSON_GetObjectItem(comm, "cacheLine");
+    size_t n = values.size();
+    bool ok = true;
+    for (size_t i = 0; i < n; i++) {
+      c.cpus.push_back((int) values[i]);
+      ok = ok && c.cpus[i] >= 0 && c.cpus[i] < c.nCpus;
+    }
+    for (cJSON *row = rows ? rows->child : NULL; ok && row; row = row->next) {
+      if (!hpcomGetNumbers(row, values) || values.size() != n)
+        break;
+      c.cacheLine.push_back(values);
+    }
+    if (!ok || c.cacheLine.size() != n) {
+      c.cpus.clear();
+      c.cacheLine.clear();
+    }
+  }
+
+  if (numa && hpcomGetNumbers(cJSON_GetObjectItem(numa, "cpuNodes"), values)) {
+    cJSON *rows = cJSON_GetObjectItem(numa, "distances");
+    for (size_t i = 0; i < values.size(); i++)
+      c.cpuNodes.push_back((int) values[i]);
+    for (cJSON *row = rows ? rows->child : NULL; row; row = row->next) {
+      if (!hpcomGetNumbers(row, values))
+        break;
+      c.numaDistances.push_back(std::vector<int>(values.begin(), values.end()));
+    }
+    size_t nNodes = c.numaDistances.size();
+    bool ok = nNodes > 0;
+    for (size_t i = 0; ok && i < nNodes; i++)
+      ok = c.numaDistances[i].size() == nNodes && c.numaDistances[i][i] > 0;
+    for (size_t i = 0; ok && i < c.cpuNodes.size(); i++)
+      ok = c.cpuNodes[i] >= 0 && c.cpuNodes[i] < (int) nNodes;
+    if (!ok) {
+      c.cpuNodes.clear();
+      c.numaDistances.clear();
+    }
+  }
+
+  /* the mean costs between the nodes, for the cores that were not measured */
+  size_t nNodes = std::max((size_t) 1, c.numaDistances.size());
+  std::vector<std::vector<double> > sums(nNodes, std::vector<double>(nNodes, 0.0));
+  std::vector<std::vector<int> > counts(nNodes, std::vector<int>(nNodes, 0));
+  double sum = 0;
+  int count = 0;
+  for (size_t i = 0; i < c.cpus.size(); i++) {
+    for (size_t j = 0; j < c.cpus.size(); j++) {
+      double cost = c.cacheLine[i][j];
+      if (i == j || cost < 0)
+        continue;
+      int na = c.cpus[i] < (int) c.cpuNodes.size() ? c.cpuNodes[c.cpus[i]] : 0;
+      int nb = c.cpus[j] < (int) c.cpuNodes.size() ? c.cpuNodes[c.cpus[j]] : 0;
+      sums[na][nb] += cost;
+      counts[na][nb]++;
+      sum += cost;
+      count++;
+    }
+  }
+  c.nodeCosts.assign(nNodes, std::vector<double>(nNodes, -1.0));
+  for (size_t i = 0; i < nNodes; i++)
+    for (size_t j = 0; j < nNodes; j++)
+      if (counts[i][j] > 0)
+        c.nodeCosts[i][j] = sums[i][j] / counts[i][j];
+  c.meanCost = count > 0 ? sum / count : 0;
+}
+
+/**
+ * Reads the calibration of the current host once per database. Translation
+ * never measures, so the resulting schedules only change if the host is
+ * calibrated again. hpcomCalibrationMutex has to be held.
+ */
+static HpcOmCalibration& hpcomLoadCalibration()
+{
+  std::string file = hpcomCalibrationFile();
+  if (!hpcomCalibration.loaded || hpcomCalibration.file != file) {
+    hpcomResetCalibration(hpcomCalibration);
+    cJSON *root = hpcomReadCalibrationFile(file);
+    cJSON *hosts = root ? cJSON_GetObjectItem(root, "hosts") : NULL;
+    cJSON *host = hosts ? cJSON_GetObjectItem(hosts, hpcomHostName().c_str()) : NULL;
+    if (host && hpcomGetInt(host, "version", 0) == HPCOM_CALIBRATION_VERSION) {
+      cJSON *op = cJSON_GetObjectItem(host, "op");
+      cJSON *comm = cJSON_GetObjectItem(host, "comm");
+      cJSON *opCosts = op ? cJSON_GetObjectItem(op, "costs") : NULL;
+      hpcomCalibration.opM = hpcomGetInt(op, "m", HPCOM_DEFAULT_OP_M);
+      hpcomCalibration.opN = hpcomGetInt(op, "n", HPCOM_DEFAULT_OP_N);
+      hpcomCalibration.commM = hpcomGetInt(comm, "m", HPCOM_DEFAULT_COMM_M);
+      hpcomCalibration.commN = hpcomGetInt(comm, "n", HPCOM_DEFAULT_COMM_N);
+      for (int i = 0; i < HPCOM_OP_COUNT; i++)
+        hpcomCalibration.opCosts[i] = hpcomGetInt(opCosts, hpcomOpNames[i], hpcomDefaultOpCosts[i]);
+      hpcomLoadTopology(host, hpcomCalibration);
+    }
+    if (root)
+      cJSON_Delete(root);
+    hpcomCalibration.file = file;
+    hpcomCalibration.loaded = true;
+  }
+  return hpcomCalibration;
+}
+
+static double hpcomNow()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec*1e9 + ts.tv_nsec;
+}
+
+/**
+ * The task graph costs are given in cycles. Convert the measured nanoseconds
+ * with the rate of the time stamp counter; without one cycles and nanoseconds
+ * are treated alike.
+ */
+static double hpcomCyclesPerNs()
+{
+#if defined(HPCOM_HAVE_TSC)
+  double t0 = hpcomNow(), t1;
+  unsigned long long c0 = __rdtsc();
+  do {
+    t1 = hpcomNow();
+  } while (t1 - t0 < 2e7);
+  return (__rdtsc() - c0) / (t1 - t0);
+#else
+  return 1.0;
+#endif
+}
+
+static void hpcomPinThread(int cpu)
+{
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+/* The microbenchmarks; "other" is the mean of sqrt, exp and pow. */
+enum HpcOmBench {HPCOM_BENCH_ADD, HPCOM_BENCH_MUL, HPCOM_BENCH_DIV, HPCOM_BENCH_SIN, HPCOM_BENCH_RELATION,
+                 HPCOM_BENCH_LOGIC, HPCOM_BENCH_SQRT, HPCOM_BENCH_EXP, HPCOM_BENCH_POW, HPCOM_BENCH_CALL};
+
+/* volatile operands keep the compiler from folding the dependency chains */
+static volatile double hpcomSeed = 1.000001;
+static volatile int hpcomSeedInt = 1;
+static volatile double hpcomSink;
+
+static void __attribute__((noinline)) hpcomEmptyCall(double *x)
+{
+  __asm__ __volatile__("" : : "r"(x) : "memory");
+}
+
+/**
+ * Time per operation in ns for a chain of dependent operations. The fastest
+ * of a few replications is used, which filters out interrupts.
+ */
+static double hpcomBenchOp(int type)
+{
+  double best = -1;
+  for (int r = 0; r < HPCOM_BENCH_REPLICATIONS; r++) {
+    double x = hpcomSeed, c = hpcomSeed;
+    int k = hpcomSeedInt, kc = hpcomSeedInt;
+    double t0 = hpcomNow();
+    for (int i = 0; i < HPCOM_BENCH_OPS; i++) {
+      switch (type) {
+      case HPCOM_BENCH_ADD: x = x + c; break;
+      case HPCOM_BENCH_MUL: x = x * c; break;
+      case HPCOM_BENCH_DIV: x = x / c; break;
+      case HPCOM_BENCH_SIN: x = sin(x + c); break;
+      /* includes an addition, which is subtracted by the caller */
+      case HPCOM_BENCH_RELATION: x = (x < c) ? x + c : x - c; break;
+      case HPCOM_BENCH_LOGIC:
+        k = !k != !kc;
+        __asm__ __volatile__("" : "+r"(k));
+        break;
+      case HPCOM_BENCH_SQRT: x = sqrt(x + c); break;
+      case HPCOM_BENCH_EXP: x = exp(x * 1e-9); break;
+      case HPCOM_BENCH_POW: x = pow(x, c); break;
+      default: hpcomEmptyCall(&x);
+      }
+    }
+    double t = (hpcomNow() - t0) / HPCOM_BENCH_OPS;
+    hpcomSink = x + k;
+    if (best < 0 || t < best)
+      best = t;
+  }
+  return best;
+}
+
+/* Shared state of one ping-pong run: the sender fills the package and bumps
+ * the sequence number, the receiver reads the package and answers. */
+struct HpcOmPingPong {
+  double package[HPCOM_PACKAGE_SIZE_BIG] __attribute__((aligned(64)));
+  volatile long sequence __attribute__((aligned(64)));
+  volatile long answer __attribute__((aligned(64)));
+  int packageSize;
+  int cpu;
+};
+
+static void* hpcomPingPongReceiver(void *arg)
+{
+  HpcOmPingPong *pp = (HpcOmPingPong*) arg;
+  double sum = 0;
+  hpcomPinThread(pp->cpu);
+  for (long i = 1; i <= HPCOM_PINGPONG_ROUNDS; i++) {
+    while (__atomic_load_n(&pp->sequence, __ATOMIC_ACQUIRE) != i);
+    for (int j = 0; j < pp->packageSize; j++)
+      sum += pp->package[j];
+    __atomic_store_n(&pp->answer, i, __ATOMIC_RELEASE);
+  }
+  hpcomSink = sum;
+  return NULL;
+}
+
+/**
+ * One-way time in ns to pass packageSize doubles from cpu a to cpu b.
+ * Returns a negative value if the receiver thread can not be started.
+ */
+static double hpcomBenchComm(int a, int b, int packageSize)
+{
+  HpcOmPingPong pp;
+  pthread_t receiver;
+  memset((void*)&pp, 0, sizeof(pp));
+  pp.packageSize = packageSize;
+  pp.cpu = b;
+  hpcomPinThread(a);
+  if (pthread_create(&receiver, NULL, hpcomPingPongReceiver, &pp) != 0)
+    return -1;
+  double t0 = 0;
+  /* the first quarter of the rounds is warm-up */
+  for (long i = 1; i <= HPCOM_PINGPONG_ROUNDS; i++) {
+    if (i == HPCOM_PINGPONG_ROUNDS/4 + 1)
+      t0 = hpcomNow();
+    for (int j = 0; j < packageSize; j++)
+      pp.package[j] = i + j;
+    __atomic_store_n(&pp.sequence, i, __ATOMIC_RELEASE);
+    while (__atomic_load_n(&pp.answer, __ATOMIC_ACQUIRE) != i);
+  }
+  double t = hpcomNow() - t0;
+  pthread_join(receiver, NULL);
+  return t / (HPCOM_PINGPONG_ROUNDS - HPCOM_PINGPONG_ROUNDS/4) / 2;
+}
+
+/* Parses a sysfs cpu list like "0-3,8-11". */
+static std::vector<int> hpcomParseCpuList(const std::string &list)
+{
+  std::vector<int> cpus;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    int first, last;
+    int n = sscanf(range.c_str(), "%d-%d", &first, &last);
+    if (n == 1)
+      last = first;
+    if (n >= 1)
+      for (int i = first; i <= last; i++)
+        cpus.push_back(i);
+  }
+  return cpus;
+}
+
+/**
+ * The NUMA distance matrix as reported by the kernel and the node of each cpu.
+ * Machines without NUMA information are treated as a single node.
+ */
+static void hpcomReadNuma(int nCpus, cJSON *numa)
+{
+  cJSON *distances = cJSON_CreateArray();
+  std::vector<int> cpuNodes(nCpus, 0);
+  int node;
+  for (node = 0; ; node++) {
+    std::stringstream path;
+    path << "/sys/devices/system/node/node" << node << "/";
+    std::ifstream fdist((path.str() + "distance").c_str());
+    std::ifstream fcpus((path.str() + "cpulist").c_str());
+    if (!fdist || !fcpus)
+      break;
+    std::vector<int> row;
+    int d;
+    while (fdist >> d)
+      row.push_back(d);
+    cJSON_AddItemToArray(distances, cJSON_CreateIntArray(row.empty() ? NULL : &row[0], row.size()));
+    std::string list;
+    std::getline(fcpus, list);
+    std::vector<int> cpus = hpcomParseCpuList(list);
+    for (size_t i = 0; i < cpus.size(); i++)
+      if (cpus[i] < nCpus)
+        cpuNodes[cpus[i]] = node;
+  }
+  if (node == 0) {
+    int local = 10;
+    cJSON_AddItemToArray(distances, cJSON_CreateIntArray(&local, 1));
+  }
+  cJSON_AddItemToObject(numa, "distances", distances);
+  cJSON_AddItemToObject(numa, "cpuNodes", cJSON_CreateIntArray(&cpuNodes[0], nCpus));
+}
+
+static int hpcomRound(double d)
+{
+  return (int) std::max(1.0, floor(d + 0.5));
+}
+
+/**
+ * Measures the cost model of this host and stores it in the calibration
+ * database: the cost of each operation type, the cache line transfer costs
+ * between all pairs of up to HPCOM_MAX_CALIBRATED_CPUS cores spread over the
+ * whole machine, the NUMA distances and the linear op/comm models derived
+ * from them. The result is the database file or an empty string on failure.
+ */
+static std::string HpcOmBenchmarkExtImpl__calibrate(const char *fileName)
+{
+  std::string file = (fileName && *fileName) ? fileName : hpcomCalibrationFile();
+  if (file.empty())
+    return "";
+
+  int nCpus = (int) sysconf(_SC_NPROCESSORS_ONLN);
+  if (nCpus < 1)
+    nCpus = 1;
+  int nCalibrated = std::min(nCpus, HPCOM_MAX_CALIBRATED_CPUS);
+  std::vector<int> cpus(nCalibrated);
+  for (int i = 0; i < nCalibrated; i++)
+    cpus[i] = (int) ((long) i * nCpus / nCalibrated);
+  double cyclesPerNs = hpcomCyclesPerNs();
+#if defined(__linux__)
+  cpu_set_t affinity;
+  pthread_getaffinity_np(pthread_self(), sizeof(affinity), &affinity);
+#endif
+
+  cJSON *host = cJSON_CreateObject();
+  cJSON_AddNumberToObject(host, "version", HPCOM_CALIBRATION_VERSION);
+  cJSON_AddNumberToObject(host, "cpus", nCpus);
+  cJSON_AddNumberToObject(host, "cyclesPerNs", cyclesPerNs);
+
+  /* operations */
+  cJSON *op = cJSON_CreateObject();
+  cJSON *opCosts = cJSON_CreateObject();
+  hpcomPinThread(cpus[0]);
+  double addCost = hpcomBenchOp(HPCOM_BENCH_ADD) * cyclesPerNs;
+  double cost[HPCOM_OP_COUNT];
+  cost[HPCOM_OP_ADD] = addCost;
+  cost[HPCOM_OP_MUL] = hpcomBenchOp(HPCOM_BENCH_MUL) * cyclesPerNs;
+  cost[HPCOM_OP_DIV] = hpcomBenchOp(HPCOM_BENCH_DIV) * cyclesPerNs;
+  cost[HPCOM_OP_TRIG] = hpcomBenchOp(HPCOM_BENCH_SIN) * cyclesPerNs;
+  cost[HPCOM_OP_RELATION] = hpcomBenchOp(HPCOM_BENCH_RELATION) * cyclesPerNs - addCost;
+  cost[HPCOM_OP_LOGIC] = hpcomBenchOp(HPCOM_BENCH_LOGIC) * cyclesPerNs;
+  cost[HPCOM_OP_OTHER] = (hpcomBenchOp(HPCOM_BENCH_SQRT) + hpcomBenchOp(HPCOM_BENCH_EXP) + hpcomBenchOp(HPCOM_BENCH_POW)) / 3 * cyclesPerNs;
+  cost[HPCOM_OP_CALL] = hpcomBenchOp(HPCOM_BENCH_CALL) * cyclesPerNs;
+  int opCost[HPCOM_OP_COUNT];
+  for (int i = 0; i < HPCOM_OP_COUNT; i++) {
+    opCost[i] = hpcomRound(cost[i]);
+    cJSON_AddNumberToObject(opCosts, hpcomOpNames[i], opCost[i]);
+  }
+  int opM = hpcomRound((cost[HPCOM_OP_ADD] + cost[HPCOM_OP_MUL]) / 2);
+  int opN = opCost[HPCOM_OP_CALL];
+  cJSON_AddNumberToObject(op, "m", opM);
+  cJSON_AddNumberToObject(op, "n", opN);
+  cJSON_AddItemToObject(op, "costs", opCosts);
+  cJSON_AddItemToObject(host, "op", op);
+
+  /* communication, samples whose receiver thread could not be started are
+   * stored as -1 and skipped */
+  int commM = HPCOM_DEFAULT_COMM_M, commN = HPCOM_DEFAULT_COMM_N;
+  cJSON *comm = cJSON_CreateObject();
+  if (nCalibrated > 1) {
+    cJSON *cacheLine = cJSON_CreateArray();
+    double sum = 0, sumSlope = 0;
+    int pairs = 0, slopes = 0;
+    for (int a = 0; a < nCalibrated; a++) {
+      std::vector<double> row(nCalibrated, 0.0);
+      for (int b = 0; b < nCalibrated; b++) {
+        if (a == b)
+          continue;
+        double small = hpcomBenchComm(cpus[a], cpus[b], HPCOM_PACKAGE_SIZE_SMALL);
+        if (small < 0) {
+          row[b] = -1;
+          continue;
+        }
+        row[b] = small * cyclesPerNs;
+        sum += small;
+        pairs++;
+        /* m from the cores seen by the first cpu */
+        if (a == 0) {
+          double big = hpcomBenchComm(cpus[a], cpus[b], HPCOM_PACKAGE_SIZE_BIG);
+          if (big >= 0) {
+            sumSlope += (big - small) / (HPCOM_PACKAGE_SIZE_BIG - HPCOM_PACKAGE_SIZE_SMALL);
+            slopes++;
+          }
+        }
+      }
+      cJSON_AddItemToArray(cacheLine, cJSON_CreateDoubleArray(&row[0], nCalibrated));
+    }
+    if (slopes > 0)
+      commM = hpcomRound(sumSlope / slopes * cyclesPerNs);
+    if (pairs > 0)
+      commN = hpcomRound(sum / pairs * cyclesPerNs);
+    cJSON_AddNumberToObject(comm, "pairs", pairs);
+    cJSON_AddItemToObject(comm, "cpus", cJSON_CreateIntArray(&cpus[0], nCalibrated));
+    cJSON_AddItemToObject(comm, "cacheLine", cacheLine);
+  }
+  cJSON_AddNumberToObject(comm, "m", commM);
+  cJSON_AddNumberToObject(comm, "n", commN);
+  cJSON_AddItemToObject(host, "comm", comm);
+#if defined(__linux__)
+  pthread_setaffinity_np(pthread_self(), sizeof(affinity), &affinity);
+#endif
+
+  cJSON *numa = cJSON_CreateObject();
+  hpcomReadNuma(nCpus, numa);
+  cJSON_AddItemToObject(host, "numa", numa);
+
+  /* merge into the database, keeping the entries of other hosts */
+  cJSON *root = hpcomReadCalibrationFile(file);
+  if (!root || root->type != cJSON_Object) {
+    if (root)
+      cJSON_Delete(root);
+    root = cJSON_CreateObject();
+  }
+  cJSON *hosts = cJSON_GetObjectItem(root, "hosts");
+  if (!hosts) {
+    hosts = cJSON_CreateObject();
+    cJSON_AddItemToObject(root, "hosts", hosts);
+  }
+  std::string hostName = hpcomHostName();
+  cJSON_DeleteItemFromObject(hosts, hostName.c_str());
+  cJSON_AddItemToObject(hosts, hostName.c_str(), host);
+
+  if (!fileName || !*fileName) {
+    std::string dir = file.substr(0, file.find_last_of('/'));
+#if defined(__MINGW32__)
+    mkdir(dir.c_str());
+#else
+    mkdir(dir.c_str(), 0755);
+#endif
+  }
+  char *content = cJSON_Print(root);
+  FILE *fout = fopen(file.c_str(), "w");
+  bool ok = fout && fputs(content, fout) >= 0;
+  if (fout)
+    ok = (fclose(fout) == 0) && ok;
+  free(content);
+
+  /* the new values are used from now on, if they come from the database in use */
+  if (ok) {
+    pthread_mutex_lock(&hpcomCalibrationMutex);
+    if (hpcomCalibration.loaded && hpcomCalibration.file == file) {
+      hpcomResetCalibration(hpcomCalibration);
+      hpcomCalibration.opM = opM;
+      hpcomCalibration.opN = opN;
+      hpcomCalibration.commM = commM;
+      hpcomCalibration.commN = commN;
+      for (int i = 0; i < HPCOM_OP_COUNT; i++)
+        hpcomCalibration.opCosts[i] = opCost[i];
+      hpcomLoadTopology(host, hpcomCalibration);
+    }
+    pthread_mutex_unlock(&hpcomCalibrationMutex);
+  }
+  cJSON_Delete(root);
+  return ok ? file : "";
+}
+
 /**
  * Approximate the required time for operations (mult,add).
  * result: 2-parameters (m,n) y=mx+n
  */
 void* HpcOmBenchmarkExtImpl__requiredTimeForOp() {
-//  unsigned long long calcTimesMul[REPLICATIONS];
-//  unsigned long long calcTimesAdd[REPLICATIONS];
-//  unsigned int sumCalc = 0;
-//  void *res = mmc_mk_nil();
-//
-//  //warmup
-//  for (int i = 0; i < REPLICATIONS; i++)
-//  {
-//    double last = 1234.123 + i;
-//    last = last * 3.6424;
-//  }
-//
-//  //bench mul
-//  for (int i = 0; i < REPLICATIONS; i++)
-//  {
-//    double last = 1234.123 + i;
-//    unsigned long long t1 = RDTSC();
-//    double res = last * 3.6424;
-//    unsigned long long t2 = RDTSC();
-//    calcTimesMul[i] = (t2-t1);
-//  }
-//
-//  //bench add
-//  for (int i = 0; i < REPLICATIONS; i++)
-//  {
-//    double last = 1234.123 + i;
-//    unsigned long long t1 = RDTSC();
-//    double res = last + 3.6424;
-//    unsigned long long t2 = RDTSC();
-//    calcTimesAdd[i] = (t2-t1);
-//  }
-//
-//  for (int i = 0; i < REPLICATIONS; i++)
-//  {
-//    sumCalc += calcTimesAdd[i];
-//    sumCalc += calcTimesMul[i];
-//  }
-//
-//  int m = 1;
-//  res = mmc_mk_cons(mmc_mk_icon((sumCalc/(REPLICATIONS*2))),res); //push n
-//  res = mmc_mk_cons(mmc_mk_icon(m),res); //push m
+  pthread_mutex_lock(&hpcomCalibrationMutex);
+  HpcOmCalibration &calibration = hpcomLoadCalibration();
   void *res = mmc_mk_nil();
-  res = mmc_mk_cons(mmc_mk_icon(24), res); //push n
-  res = mmc_mk_cons(mmc_mk_icon(1), res); //push m
+  res = mmc_mk_cons(mmc_mk_icon(calibration.opN), res); //push n
+  res = mmc_mk_cons(mmc_mk_icon(calibration.opM), res); //push m
+  pthread_mutex_unlock(&hpcomCalibrationMutex);
   return res;
 }
 
-//void sendMessage (int warmUp, int replications, int packageSize)
-//{
-//  for (int i = 0; i < warmUp; i++)
-//  {
-//    for(int j=0; j < packageSize; j++)
-//    {
-//      items[j] = 672364.8897+i+j;
-//    }
-//    itemCount++;
-//    while(itemCount > 0);
-//  }
-//
-//  for (int i = 0; i < replications; i++)
-//  {
-//    for(int j=0; j < packageSize; j++)
-//    {
-//      items[j] = 672364.8897+i+j;
-//    }
-//    itemCount++;
-//    unsigned long long t1 = RDTSC();
-//    while(itemCount > 0);
-//    unsigned long long t2 = RDTSC();
-//    comTimes[i] = (t2-t1);
-//  }
-//}
-//
-//void waitForMessage(int warmUp, int replications, int packageSize)pt..str()
-//{
-//  double last[packageSize];
-//
-//  for (int i = 0; i < warmUp; i++)
-//  {
-//    while(itemCount == 0);
-//    for(int j=0; j < packageSize; j++)
-//    {
-//      last[j] = items[j];
-//    }
-//    itemCount--;
-//  }
-//
-//  for (int i = 0; i < replications; i++)
-//  {
-//    while(itemCount == 0);
-//    for(int j=0; j < packageSize; j++)
-//    {
-//      last[j] = items[j];
-//    }
-//    itemCount--;
-//  }
-//}
+/**
+ * The required time of each operation type used to estimate the execution
+ * costs, in the order of HpcOmOpType.
+ */
+void* HpcOmBenchmarkExtImpl__requiredTimeForOpTypes() {
+  pthread_mutex_lock(&hpcomCalibrationMutex);
+  HpcOmCalibration &calibration = hpcomLoadCalibration();
+  void *res = mmc_mk_nil();
+  for (int i = HPCOM_OP_COUNT - 1; i >= 0; i--)
+    res = mmc_mk_cons(mmc_mk_icon(calibration.opCosts[i]), res);
+  pthread_mutex_unlock(&hpcomCalibrationMutex);
+  return res;
+}
 
 /**
  * Approximate the required time to send doubles to another cpu.
  * result: 2-parameters (m,n) y=mx+n
  */
 void* HpcOmBenchmarkExtImpl__requiredTimeForComm() {
-//  void *res = mmc_mk_nil();
-//  unsigned int sumComSmall = 0;
-//  unsigned int sumComBig = 0;
-//
-//  omp_set_num_threads(THREAD_NUM);
-//  omp_set_dynamic(0);
-//
-//  //Benchmark for small package
-//  #pragma omp parallel for shared(items) shared(itemCount)
-//  for (int i=0; i < THREAD_NUM; i++)
-//  {
-//    if((i % 2) == 0)
-//    {
-//#ifdef WIN32
-//      DWORD_PTR mask = (1 << omp_get_thread_num());
-//      SetThreadAffinityMask( GetCurrentThread(), mask );
-//      SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
-//#endif
-//      sendMessage(WARMUP,REPLICATIONS, PACKAGE_SIZE_SMALL);
-//    }
-//    else
-//    {
-//#ifdef WIN32
-//      DWORD_PTR mask = (1 << omp_get_thread_num());
-//      SetThreadAffinityMask( GetCurrentThread(), mask );
-//      SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
-//#endif
-//      waitForMessage(WARMUP,REPLICATIONS, PACKAGE_SIZE_SMALL);
-//    }
-//  }
-//
-//  for (int i = 0; i < REPLICATIONS; i++)
-//    sumComSmall += comTimes[i];
-//
-//  //Benchmark for big package
-//  #pragma omp parallel for shared(items) shared(itemCount)
-//  for (int i=0; i < THREAD_NUM; i++)
-//  {
-//    if((i % 2) == 0)
-//    {
-//#ifdef WIN32
-//      DWORD_PTR mask = (1 << omp_get_thread_num());
-//      SetThreadAffinityMask( GetCurrentThread(), mask );
-//      SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
-//#endif
-//      sendMessage(WARMUP,REPLICATIONS, PACKAGE_SIZE_BIG);
-//    }
-//    else
-//    {
-//#ifdef WIN32
-//      DWORD_PTR mask = (1 << omp_get_thread_num());
-//      SetThreadAffinityMask( GetCurrentThread(), mask );
-//      SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
-//#endif
-//      waitForMessage(WARMUP,REPLICATIONS, PACKAGE_SIZE_BIG);
-//    }
-//  }
-//
-//  for (int i = 0; i < REPLICATIONS; i++)
-//    sumComBig += comTimes[i];
-//
-//  res = mmc_mk_cons(mmc_mk_icon(sumComSmall/(REPLICATIONS*2)),res); //push n
-//  res = mmc_mk_cons(mmc_mk_icon((sumComBig-sumComSmall)/((PACKAGE_SIZE_BIG-PACKAGE_SIZE_SMALL)*(REPLICATIONS*2))),res); //push m
+  pthread_mutex_lock(&hpcomCalibrationMutex);
+  HpcOmCalibration &calibration = hpcomLoadCalibration();
   void *res = mmc_mk_nil();
-  res = mmc_mk_cons(mmc_mk_icon(70), res); //push n
-  res = mmc_mk_cons(mmc_mk_icon(4), res); //push m
+  res = mmc_mk_cons(mmc_mk_icon(calibration.commN), res); //push n
+  res = mmc_mk_cons(mmc_mk_icon(calibration.commM), res); //push m
+  pthread_mutex_unlock(&hpcomCalibrationMutex);
   return res;
 }
 
+/**
+ * Cycles to pass a cache line from cpu a to cpu b. Pairs that were not
+ * measured get the mean of their NUMA nodes, or the local mean scaled by the
+ * NUMA distance.
+ */
+static double hpcomPairCost(const HpcOmCalibration &c, int a, int b)
+{
+  int ia = std::find(c.cpus.begin(), c.cpus.end(), a) - c.cpus.begin();
+  int ib = std::find(c.cpus.begin(), c.cpus.end(), b) - c.cpus.begin();
+  if (a != b && ia < (int) c.cpus.size() && ib < (int) c.cpus.size() && c.cacheLine[ia][ib] >= 0)
+    return c.cacheLine[ia][ib];
+  int na = a < (int) c.cpuNodes.size() ? c.cpuNodes[a] : 0;
+  int nb = b < (int) c.cpuNodes.size() ? c.cpuNodes[b] : 0;
+  if (c.nodeCosts[na][nb] >= 0)
+    return c.nodeCosts[na][nb];
+  if (c.nodeCosts[na][na] >= 0 && na < (int) c.numaDistances.size())
+    return c.nodeCosts[na][na] * c.numaDistances[na][nb] / c.numaDistances[na][na];
+  return c.meanCost;
+}
+
+/**
+ * The communication costs from thread a to thread b relative to the mean
+ * costs of the calibrated cores. The hpcom threads are not pinned, they are
+ * assumed to run on the cpus in order. Without a calibration all pairs of
+ * threads cost the same (1.0).
+ */
+double HpcOmBenchmarkExtImpl__commCostFactor(int threadA, int threadB) {
+  double factor = 1.0;
+  pthread_mutex_lock(&hpcomCalibrationMutex);
+  HpcOmCalibration &calibration = hpcomLoadCalibration();
+  if (calibration.meanCost > 0 && threadA > 0 && threadB > 0) {
+    int a = (threadA - 1) % calibration.nCpus;
+    int b = (threadB - 1) % calibration.nCpus;
+    factor = hpcomPairCost(calibration, a, b) / calibration.meanCost;
+  }
+  pthread_mutex_unlock(&hpcomCalibrationMutex);
+  return factor;
+}
+
 class XmlBenchReader {
 private:
   struct ParserUserData {
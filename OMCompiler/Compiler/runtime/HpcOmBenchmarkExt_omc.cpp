@@ -20,6 +20,15 @@ extern void* HpcOmBenchmarkExt_requiredTimeForOp()
 #endif
 }
 
+extern void* HpcOmBenchmarkExt_requiredTimeForOpTypes()
+{
+#if defined(_MSC_VER)
+  HPC_OM_VS();
+#else
+  return HpcOmBenchmarkExtImpl__requiredTimeForOpTypes();
+#endif
+}
+
 extern void* HpcOmBenchmarkExt_requiredTimeForComm()
 {
 #if defined(_MSC_VER)
@@ -29,6 +38,25 @@ extern void* HpcOmBenchmarkExt_requiredTimeForComm()
 #endif
 }
 
+extern double HpcOmBenchmarkExt_commCostFactor(int threadA, int threadB)
+{
+#if defined(_MSC_VER)
+  HPC_OM_VS();
+#else
+  return HpcOmBenchmarkExtImpl__commCostFactor(threadA, threadB);
+#endif
+}
+
+extern const char* HpcOmBenchmarkExt_calibrate(const char *filename)
+{
+#if defined(_MSC_VER)
+  HPC_OM_VS();
+#else
+  std::string res = HpcOmBenchmarkExtImpl__calibrate(filename);
+  return strcpy(ModelicaAllocateString(res.size()), res.c_str());
+#endif
+}
+
 extern void* HpcOmBenchmarkExt_readCalcTimesFromXml(const char *filename)
 {
 #if defined(_MSC_VER)
@@ -23,6 +23,7 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <math.h>
+#include <pthread.h>
 
 #include "matchmaker.h"
 
@@ -1230,10 +1231,309 @@ void match_pr_fifo_fair(int* col_ptrs, int* col_ids, int* row_ptrs, int* row_ids
   free(r_label);
 }
 
+/*
+ * Multithreaded Pothen-Fan, see
+ *
+ *   "A. Azad, M. Halappanavar, S. Rajamanickam, E. G. Boman, A. Khan and A. Pothen.
+ *   'Multithreaded Algorithms for Maximum Matching in Bipartite Graphs'
+ *   IPDPS 2012."
+ *
+ * In each phase all unmatched columns start a DFS with lookahead at the same
+ * time. A row belongs to the first thread that claims it in the phase, so the
+ * augmenting paths found by different threads are vertex disjoint and can be
+ * flipped without further locking. The matching is maximum once a phase does
+ * not find any augmenting path.
+ */
+
+#define PF_PAR_CHUNK 64
+
+static int matching_num_threads = 1;
+
+void matching_set_num_threads(int num_threads) {
+  matching_num_threads = num_threads > 1 ? num_threads : 1;
+}
+
+int matching_get_num_threads(void) {
+  return matching_num_threads;
+}
+
+struct matching_pool {
+  pthread_mutex_t lock;
+  pthread_cond_t start_cond;
+  pthread_cond_t done_cond;
+  pthread_t* threads;
+  int nthreads;   /* including the calling thread */
+  int generation; /* incremented for every task */
+  int running;    /* workers still busy with the task */
+  int stop;
+  void (*task)(void*, int);
+  void* arg;
+};
+
+typedef struct {
+  matching_pool* pool;
+  int thread;
+} matching_pool_worker_arg;
+
+static void* matching_pool_worker(void* arg) {
+  matching_pool_worker_arg* worker = (matching_pool_worker_arg*) arg;
+  matching_pool* pool = worker->pool;
+  int thread = worker->thread;
+  int generation = 0;
+
+  free(worker);
+  pthread_mutex_lock(&pool->lock);
+  for(;;) {
+    while(pool->generation == generation && !pool->stop) {
+      pthread_cond_wait(&pool->start_cond, &pool->lock);
+    }
+    if(pool->stop) {
+      break;
+    }
+    generation = pool->generation;
+    pthread_mutex_unlock(&pool->lock);
+    pool->task(pool->arg, thread);
+    pthread_mutex_lock(&pool->lock);
+    if(--pool->running == 0) {
+      pthread_cond_signal(&pool->done_cond);
+    }
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+matching_pool* matching_pool_create(int num_threads) {
+  matching_pool* pool = (matching_pool*) malloc(sizeof(matching_pool));
+  matching_pool_worker_arg* worker;
+  int i;
+
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->start_cond, NULL);
+  pthread_cond_init(&pool->done_cond, NULL);
+  pool->threads = (pthread_t*) malloc(sizeof(pthread_t) * (num_threads > 1 ? num_threads : 1));
+  pool->nthreads = 1;
+  pool->generation = 0;
+  pool->running = 0;
+  pool->stop = 0;
+  pool->task = NULL;
+  pool->arg = NULL;
+  for(i = 1; i < num_threads; i++) {
+    worker = (matching_pool_worker_arg*) malloc(sizeof(matching_pool_worker_arg));
+    worker->pool = pool;
+    worker->thread = i;
+    /* fewer threads if the system refuses more */
+    if(pthread_create(&pool->threads[i], NULL, matching_pool_worker, worker)) {
+      free(worker);
+      break;
+    }
+    pool->nthreads++;
+  }
+  return pool;
+}
+
+int matching_pool_size(matching_pool* pool) {
+  return pool->nthreads;
+}
+
+void matching_pool_run(matching_pool* pool, void (*task)(void*, int), void* arg) {
+  pthread_mutex_lock(&pool->lock);
+  pool->task = task;
+  pool->arg = arg;
+  pool->running = pool->nthreads - 1;
+  pool->generation++;
+  pthread_cond_broadcast(&pool->start_cond);
+  pthread_mutex_unlock(&pool->lock);
+
+  task(arg, 0);
+
+  pthread_mutex_lock(&pool->lock);
+  while(pool->running > 0) {
+    pthread_cond_wait(&pool->done_cond, &pool->lock);
+  }
+  pthread_mutex_unlock(&pool->lock);
+}
+
+void matching_pool_free(matching_pool* pool) {
+  int i;
+
+  pthread_mutex_lock(&pool->lock);
+  pool->stop = 1;
+  pthread_cond_broadcast(&pool->start_cond);
+  pthread_mutex_unlock(&pool->lock);
+  for(i = 1; i < pool->nthreads; i++) {
+    pthread_join(pool->threads[i], NULL);
+  }
+  pthread_cond_destroy(&pool->done_cond);
+  pthread_cond_destroy(&pool->start_cond);
+  pthread_mutex_destroy(&pool->lock);
+  free(pool->threads);
+  free(pool);
+}
+
+typedef struct {
+  int* col_ptrs;
+  int* col_ids;
+  int* match;
+  int* row_match;
+  int* visited;
+  int* colptrs;
+  int* lookahead;
+  int* unmatched;
+  int** stacks;
+  int nunmatched;
+  int next;
+  int phase;
+  volatile int augmented;
+} pf_par_data;
+
+static inline int pf_par_claim(int* visited, int row, int phase) {
+  int old = visited[row];
+  return old != phase && MATCHING_ATOMIC_CAS(&visited[row], old, phase);
+}
+
+static void pf_par_phase(void* arg, int thread) {
+  pf_par_data* d = (pf_par_data*) arg;
+  int* col_ptrs = d->col_ptrs;
+  int* col_ids = d->col_ids;
+  int* match = d->match;
+  int* row_match = d->row_match;
+  int* visited = d->visited;
+  int* colptrs = d->colptrs;
+  int* lookahead = d->lookahead;
+  int* stack = d->stacks[thread];
+  int phase = d->phase;
+  int start, end, i, row, col, stack_col, stack_last, temp, ptr, eptr, current_col;
+
+  while((start = MATCHING_ATOMIC_ADD(&d->next, PF_PAR_CHUNK)) < d->nunmatched) {
+    end = start + PF_PAR_CHUNK < d->nunmatched ? start + PF_PAR_CHUNK : d->nunmatched;
+    for(i = start; i < end; i++) {
+      current_col = d->unmatched[i];
+      stack[0] = current_col; stack_last = 0; colptrs[current_col] = col_ptrs[current_col];
+
+      while(stack_last > -1) {
+        stack_col = stack[stack_last];
+        eptr = col_ptrs[stack_col + 1];
+
+        /* lookahead; a free row stays free until its owner matches it */
+        for(ptr = lookahead[stack_col]; ptr < eptr; ptr++) {
+          row = col_ids[ptr];
+          if(row_match[row] == -1 && pf_par_claim(visited, row, phase)) {
+            break;
+          }
+        }
+        lookahead[stack_col] = ptr + 1;
+
+        if(ptr >= eptr) {
+          for(ptr = colptrs[stack_col]; ptr < eptr; ptr++) {
+            if(pf_par_claim(visited, col_ids[ptr], phase)) {
+              break;
+            }
+          }
+          colptrs[stack_col] = ptr + 1;
+
+          if(ptr == eptr) {
+            --stack_last;
+            continue;
+          }
+
+          row = col_ids[ptr];
+          col = row_match[row];
+          if(col != -1) {
+            stack[++stack_last] = col; colptrs[col] = col_ptrs[col];
+            continue;
+          }
+        } else {
+          row = col_ids[ptr];
+        }
+
+        while(row != -1) {
+          col = stack[stack_last--];
+          temp = match[col];
+          match[col] = row; row_match[row] = col;
+          row = temp;
+        }
+        d->augmented = 1;
+        break;
+      }
+    }
+  }
+}
+
+void match_pf_par(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, int m, int num_threads) {
+  pf_par_data data;
+  matching_pool* pool;
+  int i, j, nthreads;
+
+  if(num_threads <= 1) {
+    match_pf_fair(col_ptrs, col_ids, match, row_match, n, m);
+    return;
+  }
+
+  pool = matching_pool_create(num_threads);
+  nthreads = matching_pool_size(pool);
+  data.col_ptrs = col_ptrs;
+  data.col_ids = col_ids;
+  data.match = match;
+  data.row_match = row_match;
+  data.visited = (int*) malloc(sizeof(int) * m);
+  data.colptrs = (int*) malloc(sizeof(int) * n);
+  data.lookahead = (int*) malloc(sizeof(int) * n);
+  data.unmatched = (int*) malloc(sizeof(int) * n);
+  data.stacks = (int**) malloc(sizeof(int*) * nthreads);
+  data.nunmatched = 0;
+  data.phase = 0;
+
+  memset(data.visited, 0, sizeof(int) * m);
+  memcpy(data.lookahead, col_ptrs, sizeof(int) * n);
+  for(i = 0; i < nthreads; i++) {
+    data.stacks[i] = (int*) malloc(sizeof(int) * n);
+  }
+
+  for(i = 0; i < n; i++) {
+    if(match[i] == -1 && col_ptrs[i] != col_ptrs[i+1]) {
+      data.unmatched[data.nunmatched++] = i;
+    }
+  }
+
+  while(data.nunmatched > 0) {
+    data.next = 0;
+    data.phase++;
+    data.augmented = 0;
+
+    /* small phases are not worth waking up the workers */
+    if(data.nunmatched <= PF_PAR_CHUNK) {
+      pf_par_phase(&data, 0);
+    } else {
+      matching_pool_run(pool, pf_par_phase, &data);
+    }
+
+    if(!data.augmented) {
+      break;
+    }
+    for(i = 0, j = 0; i < data.nunmatched; i++) {
+      if(match[data.unmatched[i]] == -1) {
+        data.unmatched[j++] = data.unmatched[i];
+      }
+    }
+    data.nunmatched = j;
+  }
+
+  matching_pool_free(pool);
+  for(i = 0; i < nthreads; i++) {
+    free(data.stacks[i]);
+  }
+  free(data.stacks);
+  free(data.unmatched);
+  free(data.lookahead);
+  free(data.colptrs);
+  free(data.visited);
+}
+
 void matching(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, int m, int matching_id, int cheap_id, double relabel_period, int clear_match) {
   int* row_ptrs;
   int* row_ids;
   int i;
+  int need_rows = (matching_id >= do_hk && matching_id != do_pf_par) || (cheap_id > do_old_cheap && cheap_id != do_par_cheap);
 
   if (clear_match==1)
   {
@@ -1245,7 +1545,7 @@ void matching(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, in
     }
   }
 
-  if(matching_id >= do_hk || cheap_id > do_old_cheap) {
+  if(need_rows) {
 
     row_ptrs = (int*) malloc((m+1) * sizeof(int));
     memset(row_ptrs, 0, (m+1) * sizeof(int));
@@ -1294,8 +1594,10 @@ void matching(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, in
     match_abmp_bfs(col_ptrs, col_ids, row_ptrs, row_ids, match, row_match, n, m);
   } else if(matching_id == do_pr_fifo_fair) {
     match_pr_fifo_fair(col_ptrs, col_ids, row_ptrs, row_ids, match, row_match, n, m, relabel_period);
+  } else if(matching_id == do_pf_par) {
+    match_pf_par(col_ptrs, col_ids, match, row_match, n, m, matching_num_threads);
   }
-  if(matching_id >= do_hk || cheap_id > do_old_cheap) {
+  if(need_rows) {
     free(row_ids);
     free(row_ptrs);
   }
@@ -0,0 +1,143 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+/*
+ * Benchmark for the matching algorithms on generated sparse graphs.
+ *
+ *   make matching_benchmark
+ *   ./matching_benchmark [n] [nonzeros per column] [threads]
+ *
+ * The generated graphs look like the incidence matrix of a large flattened
+ * model: every equation references the variable on the diagonal plus a few
+ * neighbours and some randomly chosen variables. Each algorithm starts from
+ * the empty matching; the cardinality of the result is checked against the
+ * sequential PF+ algorithm.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "matchmaker.h"
+
+static double now(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+static unsigned int rnd(unsigned int *state)
+{
+  *state = *state * 1103515245u + 12345u;
+  return (*state >> 8);
+}
+
+static void generate(int n, int nnz_per_col, int **col_ptrs, int **col_ids)
+{
+  unsigned int state = 42;
+  int i, k, nz = 0;
+
+  *col_ptrs = (int*) malloc((n+1) * sizeof(int));
+  *col_ids = (int*) malloc((size_t)n * nnz_per_col * sizeof(int));
+  for (i = 0; i < n; i++) {
+    (*col_ptrs)[i] = nz;
+    /* leave some equations without their diagonal variable, so the
+       cheap matching does not solve the problem on its own */
+    if (rnd(&state) % 8) {
+      (*col_ids)[nz++] = i;
+    }
+    if (i > 0) {
+      (*col_ids)[nz++] = i-1;
+    }
+    for (k = nz - (*col_ptrs)[i]; k < nnz_per_col; k++) {
+      (*col_ids)[nz++] = rnd(&state) % n;
+    }
+  }
+  (*col_ptrs)[n] = nz;
+}
+
+static int cardinality(int *match, int n)
+{
+  int i, card = 0;
+  for (i = 0; i < n; i++) {
+    card += match[i] != -1;
+  }
+  return card;
+}
+
+static int run(const char *name, int *col_ptrs, int *col_ids, int n, int matching_id, int cheap_id, int num_threads, int expected)
+{
+  int *match = (int*) malloc(n * sizeof(int));
+  int *row_match = (int*) malloc(n * sizeof(int));
+  double t;
+  int card;
+
+  matching_set_num_threads(num_threads);
+  t = now();
+  matching(col_ptrs, col_ids, match, row_match, n, n, matching_id, cheap_id, 1.0, 1);
+  t = now() - t;
+  card = cardinality(match, n);
+  printf("%-28s threads=%-3d time=%8.3fs matched=%d%s\n", name, num_threads, t, card,
+    expected >= 0 && card != expected ? " (WRONG)" : "");
+  free(row_match);
+  free(match);
+  return card;
+}
+
+int main(int argc, char **argv)
+{
+  int n = argc > 1 ? atoi(argv[1]) : 1000000;
+  int nnz_per_col = argc > 2 ? atoi(argv[2]) : 4;
+  int num_threads = argc > 3 ? atoi(argv[3]) : 4;
+  int *col_ptrs, *col_ids;
+  int expected, fail = 0;
+
+  if (n < 1 || nnz_per_col < 2 || num_threads < 1) {
+    fprintf(stderr, "Usage: %s [n>0] [nonzeros per column>1] [threads>0]\n", argv[0]);
+    return 1;
+  }
+
+  generate(n, nnz_per_col, &col_ptrs, &col_ids);
+  printf("n=%d nz=%d\n", n, col_ptrs[n]);
+
+  expected = run("PF+ (cheap=1)", col_ptrs, col_ids, n, do_pf_fair, do_old_cheap, 1, -1);
+  fail |= expected != run("PF+ (cheap=3)", col_ptrs, col_ids, n, do_pf_fair, do_sk_cheap_rand, 1, expected);
+  fail |= expected != run("HK (cheap=3)", col_ptrs, col_ids, n, do_hk, do_sk_cheap_rand, 1, expected);
+  fail |= expected != run("PR (cheap=3)", col_ptrs, col_ids, n, do_pr_fifo_fair, do_sk_cheap_rand, 1, expected);
+  fail |= expected != run("PF parallel (cheap=1)", col_ptrs, col_ids, n, do_pf_par, do_old_cheap, num_threads, expected);
+  fail |= expected != run("PF parallel (cheap=5)", col_ptrs, col_ids, n, do_pf_par, do_par_cheap, num_threads, expected);
+
+  free(col_ids);
+  free(col_ptrs);
+  return fail;
+}
@@ -554,6 +554,72 @@ void mind_cheap(int *col_ptrs, int *col_ids, int *row_ptrs, int *row_ids, int *m
   free(rnodes);
 }
 
+/*
+ * Multithreaded one-sided Karp-Sipser: the columns with a single entry are
+ * matched first, then every other column takes the first free row. Rows are
+ * claimed with an atomic compare-and-swap on row_match, so the threads never
+ * match the same row twice.
+ */
+
+#define PAR_CHEAP_CHUNK 256
+
+typedef struct {
+  int* col_ptrs;
+  int* col_ids;
+  int* match;
+  int* row_match;
+  int n;
+  int next;
+  int degree_one;
+} par_cheap_data;
+
+static void par_cheap_worker(void* arg, int thread) {
+  par_cheap_data* d = (par_cheap_data*) arg;
+  int start, end, i, ptr, s_ptr, e_ptr, r_id;
+
+  while((start = MATCHING_ATOMIC_ADD(&d->next, PAR_CHEAP_CHUNK)) < d->n) {
+    end = start + PAR_CHEAP_CHUNK < d->n ? start + PAR_CHEAP_CHUNK : d->n;
+    for(i = start; i < end; i++) {
+      s_ptr = d->col_ptrs[i];
+      e_ptr = d->col_ptrs[i + 1];
+      if(d->match[i] != -1 || (d->degree_one && e_ptr - s_ptr != 1)) {
+        continue;
+      }
+      for(ptr = s_ptr; ptr < e_ptr; ptr++) {
+        r_id = d->col_ids[ptr];
+        if(d->row_match[r_id] == -1 && MATCHING_ATOMIC_CAS(&d->row_match[r_id], -1, i)) {
+          d->match[i] = r_id;
+          break;
+        }
+      }
+    }
+  }
+}
+
+void par_cheap(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, int m, int num_threads) {
+  par_cheap_data data;
+  matching_pool* pool;
+
+  if(num_threads <= 1) {
+    old_cheap(col_ptrs, col_ids, match, row_match, n, m);
+    return;
+  }
+
+  pool = matching_pool_create(num_threads);
+  data.col_ptrs = col_ptrs;
+  data.col_ids = col_ids;
+  data.match = match;
+  data.row_match = row_match;
+  data.n = n;
+
+  for(data.degree_one = 1; data.degree_one >= 0; data.degree_one--) {
+    data.next = 0;
+    matching_pool_run(pool, par_cheap_worker, &data);
+  }
+
+  matching_pool_free(pool);
+}
+
 void cheap_matching(int *col_ptrs, int *col_ids, int *row_ptrs, int *row_ids, int *match, int *row_match, int n, int m, int cheap_id)
 {
   if(do_old_cheap == cheap_id)
@@ -572,6 +638,10 @@ void cheap_matching(int *col_ptrs, int *col_ids, int *row_ptrs, int *row_ids, in
   {
     mind_cheap(col_ptrs, col_ids, row_ptrs, row_ids, match, row_match, n, m);
   }
+  else if(do_par_cheap == cheap_id)
+  {
+    par_cheap(col_ptrs, col_ids, match, row_match, n, m, matching_get_num_threads());
+  }
 }
 
 void cheapmatching(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, int m, int cheap_id, int clear_match) {
@@ -589,7 +659,7 @@ void cheapmatching(int* col_ptrs, int* col_ids, int* match, int* row_match, int
     }
   }
 
-  if(cheap_id > do_old_cheap) {
+  if(cheap_id > do_old_cheap && cheap_id != do_par_cheap) {
     row_ptrs = (int*) malloc((m+1) * sizeof(int));
     memset(row_ptrs, 0, (m+1) * sizeof(int));
 
@@ -617,7 +687,7 @@ void cheapmatching(int* col_ptrs, int* col_ids, int* match, int* row_match, int
 
   cheap_matching(col_ptrs, col_ids, row_ptrs, row_ids, match, row_match, n, m, cheap_id);
 
-  if(cheap_id > do_old_cheap) {
+  if(cheap_id > do_old_cheap && cheap_id != do_par_cheap) {
     free(row_ids);
     free(row_ptrs);
   }
@@ -24,6 +24,7 @@
 #define do_sk_cheap 2
 #define do_sk_cheap_rand 3
 #define do_mind_cheap 4
+#define do_par_cheap 5
 
 #define do_dfs 1
 #define do_bfs 2
@@ -35,11 +36,22 @@
 #define do_abmp 8
 #define do_abmp_bfs 9
 #define do_pr_fifo_fair 10
+#define do_pf_par 11
+
+#if defined(_MSC_VER)
+#include <windows.h>
+#define MATCHING_ATOMIC_ADD(X,V) InterlockedExchangeAdd((volatile LONG*) (X), (V))
+#define MATCHING_ATOMIC_CAS(X,OLD,NEW) (InterlockedCompareExchange((volatile LONG*) (X), (NEW), (OLD)) == (OLD))
+#else
+#define MATCHING_ATOMIC_ADD(X,V) __sync_fetch_and_add((X), (V))
+#define MATCHING_ATOMIC_CAS(X,OLD,NEW) __sync_bool_compare_and_swap((X), (OLD), (NEW))
+#endif
 
 void old_cheap(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, int m);
 void sk_cheap(int* col_ptrs, int* col_ids, int* row_ptrs, int* row_ids, int* match, int* row_match, int n, int m);
 void sk_cheap_rand(int* col_ptrs, int* col_ids, int* row_ptrs, int* row_ids, int* match, int* row_match, int n, int m);
 void mind_cheap(int* col_ptrs, int* col_ids, int* row_ptrs, int* row_ids, int* match, int* row_match, int n, int m);
+void par_cheap(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, int m, int num_threads);
 
 void match_dfs(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, int m);
 void match_bfs(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, int m);
@@ -51,6 +63,20 @@ void match_hk_dw(int* col_ptrs, int* col_ids, int* row_ptrs, int* row_ids, int*
 void match_abmp(int* col_ptrs, int* col_ids, int* row_ptrs, int* row_ids, int* match, int* row_match, int n, int m);
 void match_abmp_bfs(int* col_ptrs, int* col_ids, int* row_ptrs, int* row_ids, int* match, int* row_match, int n, int m);
 void match_pr_fifo_fair(int* col_ptrs, int* col_ids, int* row_ptrs, int* row_ids, int* match, int* row_match, int n, int m, double relabel_period);
+void match_pf_par(int* col_ptrs, int* col_ids, int* match, int* row_match, int n, int m, int num_threads);
+
+/* Number of threads used by do_pf_par and do_par_cheap (default 1) */
+void matching_set_num_threads(int num_threads);
+int matching_get_num_threads(void);
+
+/* Worker threads of the parallel algorithms, created once per call and
+ * reused for all phases. matching_pool_run runs task(arg) on every worker
+ * and on the calling thread (thread 0) and returns when all of them are done. */
+typedef struct matching_pool matching_pool;
+matching_pool* matching_pool_create(int num_threads);
+void matching_pool_run(matching_pool* pool, void (*task)(void* arg, int thread), void* arg);
+int matching_pool_size(matching_pool* pool);
+void matching_pool_free(matching_pool* pool);
 
 void pr_global_relabel(int* l_label, int* r_label, int* row_ptrs, int* row_ids, int* match, int* row_match, int n, int m);
 
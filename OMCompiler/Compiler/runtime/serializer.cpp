@@ -6,8 +6,19 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <sstream>
 #include "meta_modelica.h"
+#include "util/omc_mmap.h"
+#include "errorext.h"
 #include <stdint.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#if defined(_MSC_VER)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 
 extern "C"
 {
@@ -16,6 +27,8 @@ extern "C"
 /* This is used to keep track of generated record_description,
    that way we don't generate new every time something is de-serialized */
 std::map<std::string,record_description*> record_cache;
+/* The parser cache deserializes from several threads at once */
+static pthread_mutex_t record_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 
 static const uint8_t TAG_INT_TINY     = 0x00;
@@ -33,32 +46,32 @@ static const uint8_t TAG_SHARED_BIG   = 0xA0;
 
 /*  SERIALIZATION */
 
+/* All values are written big-endian. The multi-byte writers assemble the
+   bytes locally and append them in one go; appending byte by byte to the
+   std::string was the dominant cost of serialize. */
+
 /* Writes 8 bits to the buffer */
-void write8(uint8_t v0,std::string& buffer){
+static inline void write8(uint8_t v0,std::string& buffer){
     buffer.push_back(v0);
-    //printf("%02X ",v0);
 }
 
 /* Writes 16 bits to the buffer */
-void write16(uint16_t v0,std::string& buffer){
-    uint8_t h = (v0 & 0xFF00)>>8;
-    uint8_t l = v0 & 0xFF;
-    buffer.push_back(h);
-    buffer.push_back(l);
-    //printf("%02X ",h);
-    //printf("%02X ",l);
+static inline void write16(uint16_t v0,std::string& buffer){
+    char bytes[2] = {(char)(v0>>8), (char)v0};
+    buffer.append(bytes,2);
 }
 
 /* Writes 32 bits to the buffer */
-void write32(uint32_t v0,std::string& buffer){
-    write16((v0>>16) & 0xFFFF,buffer);
-    write16(v0       & 0xFFFF,buffer);
+static inline void write32(uint32_t v0,std::string& buffer){
+    char bytes[4] = {(char)(v0>>24), (char)(v0>>16), (char)(v0>>8), (char)v0};
+    buffer.append(bytes,4);
 }
 
 /* Writes 64 bits to the buffer */
-void write64(uint64_t v0,std::string& buffer){
-    write32((v0>>32) & 0xFFFFFFFF,buffer);
-    write32(v0       & 0xFFFFFFFF,buffer);
+static inline void write64(uint64_t v0,std::string& buffer){
+    char bytes[8] = {(char)(v0>>56), (char)(v0>>48), (char)(v0>>40), (char)(v0>>32),
+                     (char)(v0>>24), (char)(v0>>16), (char)(v0>>8), (char)v0};
+    buffer.append(bytes,8);
 }
 
 /* Writes a tag value */
@@ -105,11 +118,7 @@ void writeString(mmc_uint_t size,const char* data,std::string& buffer){
         writeTag(TAG_STRING_BIG,buffer);
         write64(size,buffer);
     }
-    mmc_uint_t i = 0;
-    while(i<size){
-        write8(data[i],buffer);
-        i++;
-    }
+    buffer.append(data,size);
 }
 
 void writeStruct(mmc_uint_t size,mmc_uint_t ctor,std::string& buffer){
@@ -142,21 +151,79 @@ void writeShared(mmc_uint_t index,std::string& buffer){
     //printf("\n");
 }
 
+/* Open-addressing hash table (linear probing) from object addresses to
+   their index in the stream. */
+class PointerTable {
+public:
+    PointerTable() : count(0), keys(1024, (void*)0), values(1024) {}
+
+    size_t size() const { return count; }
+
+    /* Returns true and sets index if ptr is already in the table.
+       Otherwise inserts it with the next index and returns false. */
+    bool findOrInsert(void* ptr, uint64_t &index){
+        size_t mask = keys.size()-1;
+        size_t i = hash(ptr) & mask;
+        while(keys[i]){
+            if(keys[i]==ptr){
+                index = values[i];
+                return true;
+            }
+            i = (i+1) & mask;
+        }
+        keys[i]   = ptr;
+        values[i] = count++;
+        if(2*count > keys.size()){
+            grow();
+        }
+        return false;
+    }
+
+private:
+    size_t count;
+    std::vector<void*> keys;
+    std::vector<uint64_t> values;
+
+    static inline size_t hash(void* ptr){
+        uint64_t h = (uint64_t)(uintptr_t)ptr;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return (size_t) h;
+    }
+
+    void grow(){
+        std::vector<void*> oldKeys(2*keys.size(), (void*)0);
+        std::vector<uint64_t> oldValues(2*values.size());
+        oldKeys.swap(keys);
+        oldValues.swap(values);
+        size_t mask = keys.size()-1;
+        for(size_t j=0; j<oldKeys.size(); j++){
+            if(oldKeys[j]){
+                size_t i = hash(oldKeys[j]) & mask;
+                while(keys[i]){
+                    i = (i+1) & mask;
+                }
+                keys[i]   = oldKeys[j];
+                values[i] = oldValues[j];
+            }
+        }
+    }
+};
+
 /* Tries to insert the object to the seen-object list. If it has been found before it writes a shared object instead.
    Returns true if the object is new, false if it's shared */
-bool isNewObject(void* ptr,std::string& buffer, std::map<void*,uint64_t> &objcache){
-    std::pair<std::map<void*,uint64_t>::iterator,bool> ret;
-    ret = objcache.insert(std::pair<void*,uint64_t>(ptr,objcache.size()));
-    if(ret.second==false){
-        writeShared(ret.first->second,buffer);
+bool isNewObject(void* ptr,std::string& buffer, PointerTable &objcache){
+    uint64_t index;
+    if(objcache.findOrInsert(ptr,index)){
+        writeShared(index,buffer);
         return false;
     }
-    //printf("%i:",objcache.size()-1);
     return true;
 }
 
 /* Record descriptions are serialized as [path,name,[field1,...,fieldn]] */
-void writeRecordDescription(struct record_description* desc,mmc_uint_t slots,std::string& buffer,std::map<void*,uint64_t> &objcache){
+void writeRecordDescription(struct record_description* desc,mmc_uint_t slots,std::string& buffer,PointerTable &objcache){
     mmc_uint_t size = 0;
     //printf("ctor(%i,%i) -> ", 3,255);
     writeStruct(3,255,buffer); // Serializes the objec as an array.
@@ -195,16 +262,16 @@ void writeRecordDescription(struct record_description* desc,mmc_uint_t slots,std
 
 void serialize(modelica_metatype input_object,std::string& buffer){
 
-    std::stack<modelica_metatype> objstack;
-    std::map<void*,uint64_t> objcache;
-    buffer.reserve(1024*1024);
+    std::vector<modelica_metatype> objstack;
+    PointerTable objcache;
+    buffer.reserve(buffer.size() + 1024*1024);
     //Inserts the object to the stack
-    objstack.push(input_object);
+    objstack.push_back(input_object);
 
     while(!objstack.empty()){
         // Takes the next object in the stack
-        modelica_metatype object = objstack.top();
-        objstack.pop();
+        modelica_metatype object = objstack.back();
+        objstack.pop_back();
 
         /* Integer */
         if(MMC_IS_IMMEDIATE(object)){
@@ -251,7 +318,7 @@ void serialize(modelica_metatype input_object,std::string& buffer){
                 }
                 // Push the sub-objects to the stack
                 while(count>left){
-                    objstack.push(MMC_FETCH(MMC_OFFSET(ptr, count)));
+                    objstack.push_back(MMC_FETCH(MMC_OFFSET(ptr, count)));
                     count--;
                 }
             }
@@ -268,6 +335,10 @@ void serialize(modelica_metatype input_object,std::string& buffer){
 void readFile(char* filename,std::string& buffer){
     std::ifstream input_file(filename,std::ifstream::in | std::ifstream::binary);
 
+    if(!input_file){
+        buffer.clear();
+        return;
+    }
     input_file.seekg(0, std::ios::end);
     buffer.reserve(input_file.tellg());
     input_file.seekg(0, std::ios::beg);
@@ -290,14 +361,46 @@ uint32_t read32(mmc_uint_t &index,unsigned char* data){
     return value;
 }
 
-/* Reads 32 bits from the buffer and moves the index forward */
+/* Reads 64 bits from the buffer and moves the index forward */
 uint64_t read64(mmc_uint_t &index,unsigned char* data){
     uint64_t value =
-            (uint64_t)data[index]<<56 | (uint64_t)data[index+1]<<48 | (uint64_t)data[index+2]<<32 | (uint64_t)data[index+3] | (uint64_t)data[index+4]<<24 | (uint64_t)data[index+5]<<16 | (uint64_t)data[index+6]<<8 | (uint64_t)data[index+7];
+            (uint64_t)data[index]<<56 | (uint64_t)data[index+1]<<48 | (uint64_t)data[index+2]<<40 | (uint64_t)data[index+3]<<32 | (uint64_t)data[index+4]<<24 | (uint64_t)data[index+5]<<16 | (uint64_t)data[index+6]<<8 | (uint64_t)data[index+7];
     index+=8;
     return value;
 }
 
+/* Returns true if n more bytes can be read before end */
+static inline bool canRead(mmc_uint_t index,mmc_uint_t end,uint64_t n){
+    return index <= end && n <= end - index;
+}
+
+/* Returns the tag at index, or an invalid tag at the end of the data */
+static inline uint8_t nextTag(mmc_uint_t index,unsigned char* data,mmc_uint_t end){
+    return index < end ? data[index] & 0xF0 : 0xF0;
+}
+
+/* Reads the length of a string and checks that the string fits before end */
+static bool readStringSize(uint8_t tag,mmc_uint_t &index,unsigned char* data,mmc_uint_t end,uint64_t &size){
+    switch(tag){
+        case TAG_STRING_SMALL:
+            index++;
+            if(!canRead(index,end,1))
+                return false;
+            size = data[index];
+            index++;
+            break;
+        case TAG_STRING_BIG:
+            index++;
+            if(!canRead(index,end,8))
+                return false;
+            size = read64(index,data);
+            break;
+        default:
+            return false;
+    }
+    return canRead(index,end,size);
+}
+
 modelica_metatype readInteger(uint8_t tag,mmc_uint_t &index,unsigned char* data){
     uint8_t uvalue8;
     int8_t  value8;
@@ -337,22 +440,14 @@ modelica_metatype readReal(uint8_t tag,mmc_uint_t &index,unsigned char* data){
 }
 
 
-modelica_metatype readString(uint8_t tag,mmc_uint_t &index,unsigned char* data){
+/* Returns NULL if the string does not fit before end */
+modelica_metatype readString(uint8_t tag,mmc_uint_t &index,unsigned char* data,mmc_uint_t end){
     uint64_t size = 0;
-    switch(tag){
-        case TAG_STRING_SMALL:
-            index++;
-            size = data[index];
-            index++;
-            break;
-        case TAG_STRING_BIG:
-            index++;
-            size = read64(index,data);
-            break;
-        default: break;
+    if(!readStringSize(tag,index,data,end,size)){
+        return NULL;
     }
 
-    modelica_metatype res = mmc_mk_scon_len(size+1);
+    modelica_metatype res = mmc_mk_scon_len(size);
     const char* str = (const char*)&(data[index]);
     index += size;
 
@@ -366,19 +461,11 @@ modelica_metatype readString(uint8_t tag,mmc_uint_t &index,unsigned char* data){
     return res;
 }
 
-char* readString_raw(uint8_t tag,mmc_uint_t &index,unsigned char* data){
+/* Returns NULL if the string does not fit before end */
+char* readString_raw(uint8_t tag,mmc_uint_t &index,unsigned char* data,mmc_uint_t end){
     uint64_t size = 0;
-    switch(tag){
-        case TAG_STRING_SMALL:
-            index++;
-            size = data[index];
-            index++;
-            break;
-        case TAG_STRING_BIG:
-            index++;
-            size = read64(index,data);
-            break;
-        default: break;
+    if(!readStringSize(tag,index,data,end,size)){
+        return NULL;
     }
 
     char* res = new char[size+1];
@@ -394,46 +481,51 @@ char* readString_raw(uint8_t tag,mmc_uint_t &index,unsigned char* data){
     return res;
 }
 
-modelica_metatype readShared(uint8_t tag,mmc_uint_t &index,unsigned char* data,std::vector<modelica_metatype> &shared){
-    uint64_t i64;
-    uint16_t i16;
-    uint32_t i32;
+/* Returns NULL if the reference does not point to an object read before */
+modelica_metatype readShared(uint8_t tag,mmc_uint_t &index,unsigned char* data,mmc_uint_t end,std::vector<modelica_metatype> &shared){
+    uint64_t i = shared.size();
     index++;
     switch(tag){
         case TAG_SHARED_TINY:
-            i16 = read16(index,data);
-            //printf("shared(%i)\n",i16);
-            return shared[i16];
+            if(canRead(index,end,2))
+                i = read16(index,data);
             break;
         case TAG_SHARED_SMALL:
-            i32 = read32(index,data);
-            //printf("shared(%i)\n",i32);
-            return shared[i32];
+            if(canRead(index,end,4))
+                i = read32(index,data);
             break;
         case TAG_SHARED_BIG:
-            i64 = read64(index,data);
-            //printf("shared(%i)\n",i64);
-            return shared[i64];
+            if(canRead(index,end,8))
+                i = read64(index,data);
             break;
         default: break;
     }
-    return 0;
+    //printf("shared(%i)\n",i);
+    return i < shared.size() ? shared[i] : NULL;
 }
 
-void readStruct(uint8_t tag, mmc_uint_t &index, uint8_t* data, mmc_uint_t &size, mmc_uint_t &ctor){
+/* Returns false if the header does not fit before end, or if there are
+   fewer bytes left than fields (each field takes at least one byte) */
+bool readStruct(uint8_t tag, mmc_uint_t &index, uint8_t* data, mmc_uint_t end, mmc_uint_t &size, mmc_uint_t &ctor){
     switch(tag){
         case TAG_STRUCT_SMALL:
+            if(!canRead(index,end,2))
+                return false;
             size = data[index] & 0x0F;
             index++;
             break;
         case TAG_STRUCT_BIG:
             index++;
+            if(!canRead(index,end,9))
+                return false;
             size = read64(index,data);
             break;
-        default: break;
+        default:
+            return false;
     }
     ctor = data[index];
     index++;
+    return canRead(index,end,size);
 }
 
 modelica_metatype allocValue(mmc_uint_t size,mmc_uint_t ctor){
@@ -442,51 +534,73 @@ modelica_metatype allocValue(mmc_uint_t size,mmc_uint_t ctor){
   return MMC_TAGPTR(p);
 }
 
-void setToNextField(modelica_metatype sub,std::stack<std::pair<modelica_metatype,int> > &stack){
-    std::pair<modelica_metatype,int> next = stack.top();
-    stack.pop();
+void setToNextField(modelica_metatype sub,std::vector<std::pair<modelica_metatype,int> > &stack){
+    std::pair<modelica_metatype,int> next = stack.back();
+    stack.pop_back();
     MMC_STRUCTDATA(next.first)[next.second-1]=sub;
 }
 
-/* This is a special case of the de-serialization to restore the record_descriptions */
-record_description* readRecordDescription(mmc_uint_t &index,unsigned char* data,std::vector<modelica_metatype> &shared){
+/* Frees the strings read for a record description */
+static void freeRecordStrings(char* path,char* name,char** fields,mmc_uint_t count){
+    for(mmc_uint_t i=0;i<count;i++){
+        delete[] fields[i];
+    }
+    delete[] fields;
+    delete[] path;
+    delete[] name;
+}
+
+/* This is a special case of the de-serialization to restore the record_descriptions.
+   Returns NULL if the description is corrupt. */
+record_description* readRecordDescription(mmc_uint_t &index,unsigned char* data,mmc_uint_t end,std::vector<modelica_metatype> &shared){
     mmc_uint_t size,ctor;
     struct record_description* pdesc;
-    uint8_t tag = data[index]&0xF0;
+    uint8_t tag = nextTag(index,data,end);
     switch(tag){
         case TAG_SHARED_TINY:
         case TAG_SHARED_SMALL:
         case TAG_SHARED_BIG:
-            pdesc = (struct record_description*)readShared(tag,index,data,shared);
+            pdesc = (struct record_description*)readShared(tag,index,data,end,shared);
             break;
 
         case TAG_STRUCT_SMALL:
         case TAG_STRUCT_BIG:
           {
-            readStruct(tag,index,data,size,ctor); // skipping since we already know what it is
-            // Read the path
-            char* path = readString_raw(data[index]&0xF0,index,data);
+            if(!readStruct(tag,index,data,end,size,ctor)){ // skipping since we already know what it is
+                return NULL;
+            }
+            // Read the path and the name
+            char* path = readString_raw(nextTag(index,data,end),index,data,end);
+            char* name = path ? readString_raw(nextTag(index,data,end),index,data,end) : NULL;
+            if(!name){
+                delete[] path;
+                return NULL;
+            }
+            // Read the array
+            if(!readStruct(nextTag(index,data,end),index,data,end,size,ctor)){ // this should be an array
+                freeRecordStrings(path,name,NULL,0);
+                return NULL;
+            }
+            char** fields = new char*[size];
+            // Now read the fields (they are not shared objects on the writing side)
+            for(mmc_uint_t i=0;i<size;i++){
+                fields[i] = readString_raw(nextTag(index,data,end),index,data,end);
+                if(!fields[i]){
+                    freeRecordStrings(path,name,fields,i);
+                    return NULL;
+                }
+            }
+
             // check if we already have a description for this path
+            pthread_mutex_lock(&record_cache_mutex);
             std::map<std::string,record_description*>::iterator it = record_cache.find(std::string(path));
 
             if(it==record_cache.end()){
                 pdesc = new struct record_description;
                 shared.push_back(pdesc);
-
                 shared.push_back(path);
-                // Read the name
-                char* name = readString_raw(data[index]&0xF0,index,data);
                 shared.push_back(name);
-                // Read the array
-                readStruct(data[index]&0xF0,index,data,size,ctor); // this should be an array
                 shared.push_back(0); // pushes anything since this objects are not reused
-                char** fields = new char*[size];
-                // Now read the fields
-                for(int i=0;i<size;i++){
-                    char* field = readString_raw(data[index]&0xF0,index,data);
-                    shared.push_back(field);
-                    fields[i] = field;
-                }
                 pdesc->path = path;
                 pdesc->name = name;
                 pdesc->fieldNames = (const char**) fields;
@@ -495,25 +609,14 @@ record_description* readRecordDescription(mmc_uint_t &index,unsigned char* data,
             }
             else {
                 pdesc = it->second;
-                // Now we read the data but we release the memory since we are not gonna use it
-                // (This part can be optimized)
+                // We release the memory of the strings since we are not gonna use them
                 shared.push_back(pdesc);
                 shared.push_back(0);
-                // Read the name
-                char* name = readString_raw(data[index]&0xF0,index,data);
                 shared.push_back(0);
-                // Read the array
-                readStruct(data[index]&0xF0,index,data,size,ctor); // this should be an array
                 shared.push_back(0); // pushes anything since this objects are not reused
-                // Now read the fields
-                for(int i=0;i<size;i++){
-                    char* field = readString_raw(data[index]&0xF0,index,data);
-                    delete[] field;
-                    shared.push_back(0);
-                }
-                delete[] path;
-                delete[] name;
+                freeRecordStrings(path,name,fields,size);
             }
+            pthread_mutex_unlock(&record_cache_mutex);
             break;
           }
         default:
@@ -522,58 +625,90 @@ record_description* readRecordDescription(mmc_uint_t &index,unsigned char* data,
     return pdesc;
 }
 
-modelica_metatype deserialize(std::string& buffer){
+/* Deserializes directly from the given memory, typically a memory-mapped
+   file. Returns NULL if the data ends before the value is complete. */
+modelica_metatype deserializeData(const unsigned char* cdata,size_t length){
     modelica_metatype  result,current;
     result = allocValue(1,0);
-    unsigned char* data = (unsigned char*) buffer.c_str();
+    unsigned char* data = (unsigned char*) cdata;
     mmc_uint_t index = 0;
     mmc_uint_t size=0;
     mmc_uint_t ctor=0;
+    mmc_uint_t end;
     std::vector<modelica_metatype> shared;
-    std::stack<std::pair<modelica_metatype,int> > stack;
+    std::vector<std::pair<modelica_metatype,int> > stack;
+
+    if(length < 8){
+        return NULL;
+    }
+    // The stream ends with the number of shared objects
+    end = length - 8;
+    index = end;
+    uint64_t numShared = read64(index,data);
+    index = 0;
+    if(numShared < length){
+        shared.reserve(numShared);
+    }
 
-    stack.push(std::make_pair(result,1));
+    stack.push_back(std::make_pair(result,1));
 
-    while(!stack.empty()){
+    while(!stack.empty() && index < end){
        unsigned char tag = data[index] & 0xF0;
        switch(tag){ // integer
           case TAG_INT_TINY:
           case TAG_INT_SMALL:
           case TAG_INT_BIG:
+            if(!canRead(index,end,tag == TAG_INT_BIG ? 9 : tag == TAG_INT_SMALL ? 5 : 1)){
+                return NULL; // corrupt data
+            }
             current = readInteger(tag,index,data);
             setToNextField(current,stack);
             break;
           case TAG_DOUBLE:
+            if(!canRead(index,end,9)){
+                return NULL; // corrupt data
+            }
             current = readReal(tag,index,data);
             setToNextField(current,stack);
             break;
           case TAG_STRING_SMALL:
           case TAG_STRING_BIG:
-            current = readString(tag,index,data);
+            current = readString(tag,index,data,end);
+            if(!current){
+                return NULL; // corrupt data
+            }
             setToNextField(current,stack);
             shared.push_back(current);
             break;
           case TAG_SHARED_TINY:
           case TAG_SHARED_SMALL:
           case TAG_SHARED_BIG:
-            current = readShared(tag,index,data,shared);
+            current = readShared(tag,index,data,end,shared);
+            if(!current){
+                return NULL; // corrupt data
+            }
             setToNextField(current,stack);
             break;
           case TAG_STRUCT_SMALL:
           case TAG_STRUCT_BIG:
             size = 0;
             ctor = 0;
-            readStruct(tag,index,data,size,ctor);
+            if(!readStruct(tag,index,data,end,size,ctor)){
+                return NULL; // corrupt data
+            }
             //printf("%i:ctor(%i,%i)\n",shared.size(),size,ctor);
             if(ctor>=3 && ctor!=255){ // not an array
                 current = allocValue(size,ctor);
                 shared.push_back(current);
                 setToNextField(current,stack);
                 while(size>0){
-                    stack.push(std::make_pair(current,size));
+                    stack.push_back(std::make_pair(current,size));
                     size--;
                 }
-                modelica_metatype record_desc = readRecordDescription(index,data,shared);
+                modelica_metatype record_desc = readRecordDescription(index,data,end,shared);
+                if(!record_desc){
+                    return NULL; // corrupt data
+                }
                 setToNextField(record_desc,stack);
             }
             else {
@@ -581,21 +716,25 @@ modelica_metatype deserialize(std::string& buffer){
                 shared.push_back(current);
                 setToNextField(current,stack);
                 while(size>0){
-                    stack.push(std::make_pair(current,size));
+                    stack.push_back(std::make_pair(current,size));
                     size--;
                 }
             }
             break;
-          default: break;
+          default:
+            return NULL; // corrupt data
        }
     }
-#if 0
-    uint64_t total = read64(index,data);
-    printf("Sent %i :  Received %i\n",total,shared.size());
-#endif
+    if(!stack.empty()){
+        return NULL;
+    }
     return MMC_FETCH(MMC_OFFSET(MMC_UNTAGPTR(result), 1));
 }
 
+modelica_metatype deserialize(std::string& buffer){
+    return deserializeData((const unsigned char*) buffer.data(),buffer.size());
+}
+
 
 static int indent_level = 0;
 
@@ -672,6 +811,23 @@ void Serializer_outputFile(modelica_metatype input_object,char* filename){
     fs.close();
 }
 
+/* Reads back a file written by Serializer_outputFile */
+modelica_metatype Serializer_inputFile(const char* filename){
+    modelica_metatype res = NULL;
+    struct stat st;
+    if(stat(filename,&st) == 0 && st.st_size > 0){
+        omc_mmap_read map = omc_mmap_open_read(filename);
+        res = deserializeData((const unsigned char*) map.data,map.size);
+        omc_mmap_close_read(map);
+    }
+    if(res == NULL){
+        const char *tokens[1] = {filename};
+        c_add_message(NULL,-1,ErrorType_scripting,ErrorLevel_error,"Failed to read serialized data from %s.",tokens,1);
+        MMC_THROW();
+    }
+    return res;
+}
+
 modelica_metatype Serializer_bypass(modelica_metatype input_object){
     std::string buffer;
     serialize(input_object,buffer);
@@ -684,5 +840,117 @@ modelica_metatype Serializer_bypass(modelica_metatype input_object){
 }
 
 
+/*  PARSER CACHE
+ *
+ * A cache file holds the serialized value of one parsed source file. It is
+ * only used if the source file still has the same size, modification time
+ * and content hash, and if it was produced with the same options (compiler
+ * version, grammar, language standard, encoding, ...).
+ *
+ *   magic[8] size[8] mtime[8] hash[8] keylen[8] key[keylen] serialized data
+ *
+ * The key is the source file name followed by the options string. */
+
+static const char cache_magic[8] = {'O','M','C','A','S','T','1','\0'};
+
+static uint64_t fnv1a64(const char* data, size_t len, uint64_t hash = 14695981039346656037ULL){
+    for(size_t i=0; i<len; i++){
+        hash ^= (unsigned char) data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/* Reads the source file and returns its size, modification time and content hash */
+static bool cacheSourceKey(const char* filename, uint64_t &size, uint64_t &mtime, uint64_t &hash){
+    struct stat st;
+    if(stat(filename,&st)){
+        return false;
+    }
+    std::ifstream input_file(filename,std::ifstream::in | std::ifstream::binary);
+    if(!input_file){
+        return false;
+    }
+    std::string contents((std::istreambuf_iterator<char>(input_file)),std::istreambuf_iterator<char>());
+    size  = st.st_size;
+    mtime = st.st_mtime;
+    hash  = fnv1a64(contents.data(),contents.size());
+    return contents.size() == size;
+}
+
+static std::string cacheFileName(const char* cacheDir,const std::string& key){
+    char name[32];
+    snprintf(name,sizeof(name),"%016llx.omast",(unsigned long long)fnv1a64(key.data(),key.size()));
+    return std::string(cacheDir) + "/" + name;
+}
+
+/* Returns SOME(value) if there is a valid cache entry for the file, otherwise NONE() */
+modelica_metatype Serializer_readCache(const char* cacheDir,const char* filename,const char* options){
+    std::string key = std::string(filename) + '\n' + options;
+    std::string cacheFile = cacheFileName(cacheDir,key);
+    uint64_t size, mtime, hash, keylen;
+    mmc_uint_t index = 8;
+    modelica_metatype res = NULL;
+    struct stat st;
+
+    /* omc_mmap throws on failure, so only map files that exist and are large enough */
+    if(stat(cacheFile.c_str(),&st) || st.st_size < 48){
+        return mmc_mk_none();
+    }
+    omc_mmap_read map = omc_mmap_open_read(cacheFile.c_str());
+    unsigned char* data = (unsigned char*) map.data;
+    if(!memcmp(data,cache_magic,8) && cacheSourceKey(filename,size,mtime,hash) &&
+       read64(index,data) == size && read64(index,data) == mtime && read64(index,data) == hash){
+        keylen = read64(index,data);
+        /* Check the full key in case of hash collisions */
+        if(keylen < map.size - index && !memcmp(data+index,key.data(),keylen)){
+            index += keylen;
+            res = deserializeData(data+index,map.size-index);
+        }
+    }
+    omc_mmap_close_read(map);
+    return res ? mmc_mk_some(res) : mmc_mk_none();
+}
+
+/* Writes the cache entry for the file. The file is written under a temporary
+ * name and renamed, so concurrent readers never see a partial entry. */
+void Serializer_writeCache(modelica_metatype input_object,const char* cacheDir,const char* filename,const char* options){
+    std::string key = std::string(filename) + '\n' + options;
+    std::string buffer, cacheFile = cacheFileName(cacheDir,key), tmpFile;
+    std::ostringstream tmpName;
+    uint64_t size, mtime, hash;
+    std::fstream fs;
+
+    if(!cacheSourceKey(filename,size,mtime,hash)){
+        return;
+    }
+    buffer.append(cache_magic,8);
+    write64(size,buffer);
+    write64(mtime,buffer);
+    write64(hash,buffer);
+    write64(key.size(),buffer);
+    buffer.append(key);
+    serialize(input_object,buffer);
+
+    /* The address of a local is unique among the threads running right now */
+    tmpName << cacheFile << "." << getpid() << "." << (void*) &buffer << ".tmp";
+    tmpFile = tmpName.str();
+    fs.open(tmpFile.c_str(),std::fstream::out | std::fstream::binary);
+    if(!fs){
+        return;
+    }
+    fs.write(buffer.c_str(),buffer.size());
+    fs.close();
+    if(fs.fail()){
+        remove(tmpFile.c_str());
+        return;
+    }
+#if defined(_WIN32)
+    remove(cacheFile.c_str());
+#endif
+    if(rename(tmpFile.c_str(),cacheFile.c_str())){
+        remove(tmpFile.c_str());
+    }
+}
 
 }
@@ -36,6 +36,11 @@
 extern "C" {
 #endif
 
+/* The AST built by the grammar actions is allocated from per-thread GC
+ * regions so that parallel parsing does not serialize on the GC lock */
+#if !defined(OMC_GC_THREAD_REGIONS)
+#define OMC_GC_THREAD_REGIONS
+#endif
 #include "systemimpl.h"
 #include <pthread.h>
 
@@ -312,13 +312,16 @@ static void* parseStream(pANTLR3_INPUT_STREAM input, int langStd, int runningTes
   // Finally, now that we have our lexer constructed, create the parser
   psr      = ModelicaParserNew(tstream);  // ModelicaParserNew is generated by ANTLR3
 
-  if (tstream == NULL) { fprintf(stderr, "Out of memory trying to allocate parser\n"); fflush(stderr); exit(ANTLR3_ERR_NOMEM); }
+  if (psr == NULL) { fprintf(stderr, "Out of memory trying to allocate parser\n"); fflush(stderr); exit(ANTLR3_ERR_NOMEM); }
 
   psr->pParser->rec->displayRecognitionError = handleParseError;
   psr->pParser->rec->recover = noRecover;
   psr->pParser->rec->recoverFromMismatchedToken = noRecoverFromMismatchedToken;
   // psr->pParser->rec->recoverFromMismatchedSet = noRecoverFromMismatchedSet;
 
+  /* The AST is bump-allocated from this thread's GC region; it is an ordinary
+   * part of the GC heap once we leave the region below */
+  mmc_GC_region_enter();
   /* if (ModelicaParser_flags & PARSE_FLAT)
     res = psr->flat_class(psr);
   else */
@@ -331,6 +334,7 @@ static void* parseStream(pANTLR3_INPUT_STREAM input, int langStd, int runningTes
   } else {
     res = psr->stored_definition(psr);
   }
+  mmc_GC_region_leave();
 
   if (ModelicaParser_lexerError || pLexer->rec->state->failed || psr->pParser->rec->state->failed) { // Some parts of the AST are NULL if errors are used...
     res = NULL;
@@ -361,10 +365,11 @@ static void* parseString(const char* data, const char* interactiveFilename, int
 
   pANTLR3_UINT8               fName;
   pANTLR3_INPUT_STREAM        input;
-  parser_members members;
+  parser_members members = {0};
   pthread_once(&parser_once_create_key,make_key);
   pthread_setspecific(modelicaParserKey,&members);
 
+  members.threadData = ModelicaParser_threadData;
   members.encoding = "UTF-8";
   members.filename_C = interactiveFilename;
   members.filename_C_testsuiteFriendly = interactiveFilename;
@@ -401,10 +406,11 @@ static void* parseFile(const char* fileName, const char* infoName, int flags, co
   pANTLR3_UINT8               fName;
   pANTLR3_INPUT_STREAM        input;
   int len = 0;
-  parser_members members;
+  parser_members members = {0};
   pthread_once(&parser_once_create_key,make_key);
   pthread_setspecific(modelicaParserKey,&members);
 
+  members.threadData = ModelicaParser_threadData;
   members.encoding = encoding;
   members.filename_C = fileName;
   members.filename_C_testsuiteFriendly = infoName;
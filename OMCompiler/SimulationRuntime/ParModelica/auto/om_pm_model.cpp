@@ -102,6 +102,9 @@ void OMModel::initialize(const char* model_name_, DATA* data_, threadData_t* thr
     ode_system_funcs = ode_system_;
 
     load_from_xml(ODE_system, "ode-equations", ode_system_funcs);
+    /*! Reuse the costs measured in a previous run of the same model on the same machine.*/
+    ODE_scheduler.use_profile(model_name + "_tasks.prof.xml", "ode-equations",
+        utility::file_hash(model_name + "_tasks.xml") + "/" + utility::hardware_signature());
     // ODE_system.construct_graph();
     // ODE_scheduler.set_up_executor(ode_system_funcs, data);
     // ODE_scheduler.schedule(4);
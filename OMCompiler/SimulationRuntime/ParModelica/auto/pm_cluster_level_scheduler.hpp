@@ -106,6 +106,14 @@ private:
     bool profiled;
     bool schedule_valid;
 
+    /*! Number of steps the tasks are timed for before clustering. The
+      measured costs are averaged to smooth out the noise of single steps.*/
+    int profile_runs;
+    int profile_count;
+    std::string profile_file;
+    std::string profile_section;
+    std::string profile_signature;
+
     tbb::task_scheduler_init tbb_system;
     TBBConcurrentStepExecutor<TaskType> step_executor;
 
@@ -122,6 +130,26 @@ public:
     {
         profiled = false;
         schedule_valid = false;
+        profile_runs = 5;
+        profile_count = 0;
+    }
+
+    /*! Uses the costs and clusters stored in file_name if they were measured
+      with the given signature. Otherwise the tasks are profiled as usual and
+      the result is written to file_name for the next run.*/
+    void use_profile(const std::string& file_name, const std::string& eq_to_read, const std::string& signature) {
+
+        profile_file = file_name;
+        profile_section = eq_to_read;
+        profile_signature = signature;
+
+        if(!task_system.load_profile(profile_file, profile_section, profile_signature))
+            return;
+
+        this->profiled = true;
+        this->schedule_valid = true;
+        task_system.levels_valid = false;
+        estimate_speedup();
     }
 
     void estimate_speedup() {
@@ -249,7 +277,7 @@ public:
         /*! skip the root node. */
         ++vert_iter;
         for ( ; vert_iter != vert_end; ++vert_iter) {
-            sys_graph[*vert_iter].profile_execute();
+            sys_graph[*vert_iter].profile_execute(profile_count);
         }
 
         execution_timer.stop_timer();
@@ -257,10 +285,17 @@ public:
         // std::cout << "P: " << step_cost << std::endl;
         // execution_timer.reset_timer();
 
+        ++profile_count;
+        if(profile_count < profile_runs)
+            return;
+
         this->profiled = true;
         this->schedule_valid = false;
         schedule();
 
+        if(!profile_file.empty())
+            task_system.save_profile(profile_file, profile_section, profile_signature, profile_count);
+
     }
 
 };
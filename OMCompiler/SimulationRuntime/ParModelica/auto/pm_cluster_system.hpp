@@ -134,7 +134,9 @@ public:
         }
     }
 
-    void profile_execute()
+    /*! Measures the cost of each task. With sample > 0 the measurement is
+      averaged with the ones of the previous samples.*/
+    void profile_execute(int sample = 0)
     {
         this->cost = 0;
         double elapsed = 0;
@@ -149,7 +151,7 @@ public:
             // if(elapsed == 0)
                 // t_iter->cost = 0.0005;
             // else
-                t_iter->cost = elapsed;
+                t_iter->cost = (t_iter->cost*sample + elapsed)/(sample + 1);
 
             this->cost += t_iter->cost;
 
@@ -501,9 +503,51 @@ public:
     }
 
 
+    /*! Moves all tasks and edges of src to dest and removes src. Unlike
+      concat_same_level_clusters the two clusters may depend on each other.*/
+    void merge_clusters(const ClusterIdType& dest_id, const ClusterIdType& src_id) {
+
+        ClusterType& dest = sys_graph[dest_id];
+        ClusterType& src = sys_graph[src_id];
+
+        typename ClusterType::iterator task_iter;
+        for(task_iter = src.begin(); task_iter != src.end(); ++task_iter) {
+            dest.add_task(*task_iter);
+        }
+
+        adjacency_iterator child_iter, child_end, curr_child_iter;
+        boost::tie(child_iter, child_end) = adjacent_vertices(src_id, sys_graph);
+        while(child_iter != child_end) {
+            curr_child_iter = child_iter;
+            ++child_iter;
+            if(*curr_child_iter != dest_id)
+                boost::add_edge(dest_id, *curr_child_iter, sys_graph);
+        }
+
+        inv_adjacency_iterator parent_iter, parent_end, curr_parent_iter;
+        boost::tie(parent_iter, parent_end) = inv_adjacent_vertices(src_id, sys_graph);
+        while(parent_iter != parent_end) {
+            curr_parent_iter = parent_iter;
+            ++parent_iter;
+            if(*curr_parent_iter != dest_id)
+                boost::add_edge(*curr_parent_iter, dest_id, sys_graph);
+        }
+
+        boost::clear_vertex(src_id, sys_graph);
+        boost::remove_vertex(src_id, sys_graph);
+        active_nodes.erase(src_id);
+        levels_valid = false;
+    }
+
     void load_from_xml(const std::string& file_name, const std::string& eq_to_read);
     void dump_graphml(const std::string& filename);
 
+    /*! Measured task costs and the clusters formed from them are stored in a
+      profile file next to the task graph. The signature identifies the model
+      and the machine they were measured for.*/
+    bool load_profile(const std::string& file_name, const std::string& eq_to_read, const std::string& signature);
+    void save_profile(const std::string& file_name, const std::string& eq_to_read, const std::string& signature, int samples);
+
 };
 
 
@@ -37,6 +37,9 @@
 
 
 #include <cstring>
+#include <map>
+#include <set>
+#include <sstream>
 
 #include <pugixml.hpp>
 
@@ -278,6 +281,156 @@ void TaskSystem_v2<TaskTypeT>::load_from_xml(const std::string& file_name, const
 
 
 
+/*! Reads the measured cost of each task from the profile. Returns false, and
+  leaves the costs untouched, if the profile is missing, was measured for
+  another model or machine or does not cover all tasks.*/
+inline bool load_profile_costs(const std::string& file_name, const std::string& eq_to_read,
+                               const std::string& signature, pugi::xml_node& xml_profile,
+                               pugi::xml_document& doc, std::map<long, double>& costs) {
+
+    if(!doc.load_file(file_name.c_str()))
+        return false;
+
+    pugi::xml_node xml_root = doc.child("taskprofile");
+    if(signature != xml_root.attribute("signature").value()) {
+        utility::log("") << "Task profile " << file_name << " is outdated, profiling again." << newl;
+        return false;
+    }
+
+    xml_profile = xml_root.child(eq_to_read.c_str());
+    if(!xml_profile)
+        return false;
+
+    for(pugi::xml_node xml_task = xml_profile.child("task"); xml_task; xml_task = xml_task.next_sibling("task")) {
+        costs[xml_task.attribute("index").as_int()] = xml_task.attribute("cost").as_double();
+    }
+
+    return true;
+}
+
+/*! Opens the profile for writing, keeping the entries of other task systems
+  if they belong to the same signature.*/
+inline pugi::xml_node save_profile_section(const std::string& file_name, const std::string& eq_to_read,
+                                           const std::string& signature, int samples, pugi::xml_document& doc) {
+
+    if(!doc.load_file(file_name.c_str())
+       || signature != doc.child("taskprofile").attribute("signature").value()) {
+        doc.reset();
+        pugi::xml_node xml_root = doc.append_child("taskprofile");
+        xml_root.append_attribute("signature") = signature.c_str();
+    }
+
+    pugi::xml_node xml_root = doc.child("taskprofile");
+    xml_root.remove_child(eq_to_read.c_str());
+    pugi::xml_node xml_profile = xml_root.append_child(eq_to_read.c_str());
+    xml_profile.append_attribute("samples") = samples;
+    return xml_profile;
+}
+
+
+template<typename TaskTypeT>
+bool TaskSystem_v2<TaskTypeT>::load_profile(const std::string& file_name, const std::string& eq_to_read, const std::string& signature) {
+
+    pugi::xml_document doc;
+    pugi::xml_node xml_profile;
+    std::map<long, double> costs;
+    if(!load_profile_costs(file_name, eq_to_read, signature, xml_profile, doc, costs))
+        return false;
+
+    /*! Right after loading every cluster holds exactly one task.*/
+    std::map<long, ClusterIdType> cluster_of_task;
+    vertex_iterator vert_iter, vert_end;
+    boost::tie(vert_iter, vert_end) = vertices(sys_graph);
+    /*! skip the root node. */
+    ++vert_iter;
+    for( ; vert_iter != vert_end; ++vert_iter) {
+        ClusterType& curr_clust = sys_graph[*vert_iter];
+        if(curr_clust.size() != 1 || costs.find(curr_clust.front().index) == costs.end())
+            return false;
+        cluster_of_task[curr_clust.front().index] = *vert_iter;
+    }
+    if(cluster_of_task.size() != costs.size())
+        return false;
+
+    /*! Check the stored clusters before changing anything.*/
+    std::vector<std::vector<long> > clusters;
+    std::set<long> clustered;
+    for(pugi::xml_node xml_clust = xml_profile.child("cluster"); xml_clust; xml_clust = xml_clust.next_sibling("cluster")) {
+        std::istringstream is(xml_clust.attribute("tasks").value());
+        std::vector<long> task_indices;
+        long task_index;
+        while(is >> task_index) {
+            if(cluster_of_task.find(task_index) == cluster_of_task.end() || !clustered.insert(task_index).second)
+                return false;
+            task_indices.push_back(task_index);
+        }
+        if(!task_indices.empty())
+            clusters.push_back(task_indices);
+    }
+
+    total_cost = 0;
+    typename std::map<long, ClusterIdType>::iterator clust_iter;
+    for(clust_iter = cluster_of_task.begin(); clust_iter != cluster_of_task.end(); ++clust_iter) {
+        ClusterType& curr_clust = sys_graph[clust_iter->second];
+        curr_clust.front().cost = costs[clust_iter->first];
+        curr_clust.cost = curr_clust.front().cost;
+        total_cost += curr_clust.cost;
+    }
+
+    /*! Merge the tasks in the stored order, which is the execution order within the cluster.*/
+    typename std::vector<std::vector<long> >::iterator task_list_iter;
+    for(task_list_iter = clusters.begin(); task_list_iter != clusters.end(); ++task_list_iter) {
+        ClusterIdType dest_id = cluster_of_task[task_list_iter->front()];
+        for(size_t i = 1; i < task_list_iter->size(); ++i) {
+            merge_clusters(dest_id, cluster_of_task[(*task_list_iter)[i]]);
+        }
+    }
+
+    levels_valid = false;
+    utility::log("") << "Loaded task costs and " << clusters.size() << " clusters from " << file_name << newl;
+    return true;
+}
+
+
+template<typename TaskTypeT>
+void TaskSystem_v2<TaskTypeT>::save_profile(const std::string& file_name, const std::string& eq_to_read, const std::string& signature, int samples) {
+
+    pugi::xml_document doc;
+    pugi::xml_node xml_profile = save_profile_section(file_name, eq_to_read, signature, samples, doc);
+
+    vertex_iterator vert_iter, vert_end;
+    boost::tie(vert_iter, vert_end) = vertices(sys_graph);
+    /*! skip the root node. */
+    ++vert_iter;
+    for(vertex_iterator iter = vert_iter; iter != vert_end; ++iter) {
+        ClusterType& curr_clust = sys_graph[*iter];
+        typename ClusterType::iterator task_iter;
+        for(task_iter = curr_clust.begin(); task_iter != curr_clust.end(); ++task_iter) {
+            pugi::xml_node xml_task = xml_profile.append_child("task");
+            xml_task.append_attribute("index") = (int)task_iter->index;
+            xml_task.append_attribute("cost") = task_iter->cost;
+        }
+    }
+
+    /*! The chosen schedule, i.e. the tasks of each cluster in execution order.*/
+    for( ; vert_iter != vert_end; ++vert_iter) {
+        ClusterType& curr_clust = sys_graph[*vert_iter];
+        if(curr_clust.size() < 2)
+            continue;
+        std::ostringstream os;
+        typename ClusterType::iterator task_iter;
+        for(task_iter = curr_clust.begin(); task_iter != curr_clust.end(); ++task_iter) {
+            os << (task_iter == curr_clust.begin() ? "" : " ") << task_iter->index;
+        }
+        xml_profile.append_child("cluster").append_attribute("tasks") = os.str().c_str();
+    }
+
+    if(!doc.save_file(file_name.c_str()))
+        utility::warning("") << "Could not write task profile " << file_name << newl;
+}
+
+
+
 
 } // openmodelica
 } // parmodelica
@@ -36,6 +36,11 @@
 
 #include "pm_utility.hpp"
 
+#include <fstream>
+#include <iomanip>
+
+#include <tbb/task_scheduler_init.h>
+
 
 namespace openmodelica {
 namespace parmodelica {
@@ -75,6 +80,48 @@ std::ostream& error() {
     return std::cerr;
 }
 
+std::string file_hash(const std::string& file_name) {
+
+    std::ifstream file(file_name.c_str(), std::ios::binary);
+    if(!file)
+        return "";
+
+    /*! FNV-1a, 64 bit */
+    unsigned long long hash = 14695981039346656037ULL;
+    char buffer[4096];
+    while(file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+        std::streamsize count = file.gcount();
+        for(std::streamsize i = 0; i < count; ++i) {
+            hash ^= (unsigned char)buffer[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    std::ostringstream os;
+    os << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return os.str();
+}
+
+std::string hardware_signature() {
+
+    std::ostringstream os;
+    os << tbb::task_scheduler_init::default_num_threads() << " threads";
+
+    /*! The processor name is only known on Linux for now.*/
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while(std::getline(cpuinfo, line)) {
+        if(line.compare(0, 10, "model name") == 0) {
+            std::string::size_type pos = line.find(':');
+            if(pos != std::string::npos)
+                os << ", " << line.substr(pos + 2);
+            break;
+        }
+    }
+
+    return os.str();
+}
+
 
 } // utility
 } // parmodelica
@@ -72,6 +72,13 @@ extern std::ostringstream error_stream;
 std::ostream& error(const char* pref);
 std::ostream& error();
 
+/*! Hash of the content of a file. Empty if the file can not be read.*/
+std::string file_hash(const std::string& file_name);
+
+/*! Describes the processor and the number of threads. Task costs measured
+  on one machine are not reused on another.*/
+std::string hardware_signature();
+
 
 
 template<typename InputIterator1, typename InputIterator2>
@@ -34,6 +34,8 @@ extern "C" {
 
 #include "FMI2Common.h"
 
+#include <string.h>
+
 /*
  * Used for logging FMU messages.
  * Logger function used by the FMU 2.0 internally.
@@ -47,19 +49,123 @@ void fmi2logger(fmi2_component_t c, fmi2_string_t instanceName, fmi2_status_t st
   fflush(NULL);
 }
 
+void initializeFMI2Buffers(FMI2ModelExchange* FMI2ME)
+{
+  FMI2ME->FMIValueReferenceTables = NULL;
+  FMI2ME->FMINumberOfValueReferenceTables = 0;
+  FMI2ME->FMIValueReferenceBuffer = NULL;
+  FMI2ME->FMIValueReferenceBufferSize = 0;
+  FMI2ME->FMIBooleanBuffer = NULL;
+  FMI2ME->FMIBooleanBufferSize = 0;
+}
+
+void freeFMI2Buffers(FMI2ModelExchange* FMI2ME)
+{
+  int i;
+  if (FMI2ME->FMIValueReferenceTables) {
+    for (i = 0 ; i < FMI2_MAX_VALUE_REFERENCE_TABLES ; i++) {
+      free(FMI2ME->FMIValueReferenceTables[i].key);
+      free(FMI2ME->FMIValueReferenceTables[i].valueReferences);
+    }
+  }
+  free(FMI2ME->FMIValueReferenceTables);
+  free(FMI2ME->FMIValueReferenceBuffer);
+  free(FMI2ME->FMIBooleanBuffer);
+  initializeFMI2Buffers(FMI2ME);
+}
+
 /*
  * OpenModelica uses signed integers and according to FMI specifications the value references should be unsigned integers.
  * So to overcome this we use value references as Real in the Modelica code.
  * This function converts back the value references from double to int and use them in FMI specific functions.
+ * The generated code calls every get/set function with the same value references, so the converted table of each
+ * call site is created on the first call and looked up by a hash of the value references afterwards.
+ * Once all FMI2_MAX_VALUE_REFERENCE_TABLES slots are used, or if a table can not be allocated, further value
+ * references are converted on every call into a reused buffer.
  */
-fmi2_value_reference_t* real_to_fmi2_value_reference(int numberOfValueReferences, double* valuesReferences)
+static fmi2_value_reference_t* convert_fmi2_value_references(FMI2ModelExchange* FMI2ME, int numberOfValueReferences, double* valuesReferences)
 {
-  fmi2_value_reference_t* valuesReferences_int = malloc(sizeof(fmi2_value_reference_t)*numberOfValueReferences);
   int i;
+  if (FMI2ME->FMIValueReferenceBufferSize < numberOfValueReferences) {
+    fmi2_value_reference_t* buffer = realloc(FMI2ME->FMIValueReferenceBuffer, sizeof(fmi2_value_reference_t)*numberOfValueReferences);
+    if (!buffer) {
+      ModelicaFormatError("Failed to allocate memory for %d FMI value references\n", numberOfValueReferences);
+    }
+    FMI2ME->FMIValueReferenceBuffer = buffer;
+    FMI2ME->FMIValueReferenceBufferSize = numberOfValueReferences;
+  }
   for (i = 0 ; i < numberOfValueReferences ; i++) {
-    valuesReferences_int[i] = (int)valuesReferences[i];
+    FMI2ME->FMIValueReferenceBuffer[i] = (int)valuesReferences[i];
+  }
+  return FMI2ME->FMIValueReferenceBuffer;
+}
+
+static fmi2_value_reference_t* get_fmi2_value_references(FMI2ModelExchange* FMI2ME, int numberOfValueReferences, double* valuesReferences)
+{
+  FMI2ValueReferenceTable* table;
+  const unsigned char* bytes = (const unsigned char*)valuesReferences;
+  unsigned int hash = 2166136261u;
+  size_t n;
+  int i, slot;
+  if (numberOfValueReferences <= 0) {
+    return NULL;
+  }
+  /* FNV-1a of the value references */
+  for (n = 0 ; n < sizeof(double)*numberOfValueReferences ; n++) {
+    hash = (hash ^ bytes[n]) * 16777619u;
+  }
+  if (!FMI2ME->FMIValueReferenceTables) {
+    FMI2ME->FMIValueReferenceTables = calloc(FMI2_MAX_VALUE_REFERENCE_TABLES, sizeof(FMI2ValueReferenceTable));
+    if (!FMI2ME->FMIValueReferenceTables) {
+      return convert_fmi2_value_references(FMI2ME, numberOfValueReferences, valuesReferences);
+    }
+  }
+  /* linear probing; the table never gets full, so an unused slot ends the search */
+  for (slot = hash % FMI2_MAX_VALUE_REFERENCE_TABLES ; ; slot = (slot + 1) % FMI2_MAX_VALUE_REFERENCE_TABLES) {
+    table = &FMI2ME->FMIValueReferenceTables[slot];
+    if (table->size == 0) {
+      break;
+    }
+    if (table->hash == hash && table->size == numberOfValueReferences && 0 == memcmp(table->key, valuesReferences, sizeof(double)*numberOfValueReferences)) {
+      return table->valueReferences;
+    }
+  }
+  if (FMI2ME->FMINumberOfValueReferenceTables >= FMI2_MAX_VALUE_REFERENCE_TABLES - 1) {
+    return convert_fmi2_value_references(FMI2ME, numberOfValueReferences, valuesReferences);
+  }
+  table->key = malloc(sizeof(double)*numberOfValueReferences + 1);
+  table->valueReferences = malloc(sizeof(fmi2_value_reference_t)*numberOfValueReferences + 1);
+  if (!table->key || !table->valueReferences) {
+    free(table->key);
+    free(table->valueReferences);
+    table->key = NULL;
+    table->valueReferences = NULL;
+    return convert_fmi2_value_references(FMI2ME, numberOfValueReferences, valuesReferences);
+  }
+  FMI2ME->FMINumberOfValueReferenceTables++;
+  table->size = numberOfValueReferences;
+  table->hash = hash;
+  memcpy(table->key, valuesReferences, sizeof(double)*numberOfValueReferences);
+  for (i = 0 ; i < numberOfValueReferences ; i++) {
+    table->valueReferences[i] = (int)valuesReferences[i];
+  }
+  return table->valueReferences;
+}
+
+/*
+ * Returns a buffer for numberOfValues FMI booleans, reused between calls.
+ */
+static int* get_fmi2_boolean_buffer(FMI2ModelExchange* FMI2ME, int numberOfValues)
+{
+  if (FMI2ME->FMIBooleanBufferSize < numberOfValues) {
+    int* buffer = realloc(FMI2ME->FMIBooleanBuffer, sizeof(int)*numberOfValues);
+    if (!buffer) {
+      ModelicaFormatError("Failed to allocate memory for %d FMI booleans\n", numberOfValues);
+    }
+    FMI2ME->FMIBooleanBuffer = buffer;
+    FMI2ME->FMIBooleanBufferSize = numberOfValues;
   }
-  return valuesReferences_int;
+  return FMI2ME->FMIBooleanBuffer;
 }
 
 /*
@@ -96,9 +202,8 @@ void fmi2GetReal_OMC(void* in_fmi2, int numberOfValueReferences, double* realVal
 {
   if (fmiType == 1) {
     FMI2ModelExchange* FMI2ME = (FMI2ModelExchange*)in_fmi2;
-    fmi2_value_reference_t* valuesReferences_int = real_to_fmi2_value_reference(numberOfValueReferences, realValuesReferences);
+    fmi2_value_reference_t* valuesReferences_int = get_fmi2_value_references(FMI2ME, numberOfValueReferences, realValuesReferences);
     fmi2_status_t status = fmi2_import_get_real(FMI2ME->FMIImportInstance, valuesReferences_int, numberOfValueReferences, (fmi2_real_t*)realValues);
-    free(valuesReferences_int);
     if (status != fmi2_status_ok && status != fmi2_status_warning) {
       ModelicaFormatError("fmi2GetReal failed with status : %s\n", fmi2_status_to_string(status));
     }
@@ -116,9 +221,8 @@ void fmi2SetReal_OMC(void* in_fmi2, int numberOfValueReferences, double* realVal
   if (fmiType == 1) {
     FMI2ModelExchange* FMI2ME = (FMI2ModelExchange*)in_fmi2;
     if (FMI2ME->FMISolvingMode == fmi2_instantiated_mode || FMI2ME->FMISolvingMode == fmi2_initialization_mode || FMI2ME->FMISolvingMode == fmi2_event_mode || FMI2ME->FMISolvingMode == fmi2_continuousTime_mode) {
-      fmi2_value_reference_t* valuesReferences_int = real_to_fmi2_value_reference(numberOfValueReferences, realValuesReferences);
+      fmi2_value_reference_t* valuesReferences_int = get_fmi2_value_references(FMI2ME, numberOfValueReferences, realValuesReferences);
       fmi2_status_t status = fmi2_import_set_real(FMI2ME->FMIImportInstance, valuesReferences_int, numberOfValueReferences, (fmi2_real_t*)realValues);
-      free(valuesReferences_int);
       if (status != fmi2_status_ok && status != fmi2_status_warning) {
         ModelicaFormatError("fmi2SetReal failed with status : %s\n", fmi2_status_to_string(status));
       }
@@ -137,9 +241,8 @@ void fmi2GetInteger_OMC(void* in_fmi2, int numberOfValueReferences, double* inte
 {
   if (fmiType == 1) {
     FMI2ModelExchange* FMI2ME = (FMI2ModelExchange*)in_fmi2;
-    fmi2_value_reference_t* valuesReferences_int = real_to_fmi2_value_reference(numberOfValueReferences, integerValuesReferences);
+    fmi2_value_reference_t* valuesReferences_int = get_fmi2_value_references(FMI2ME, numberOfValueReferences, integerValuesReferences);
     fmi2_status_t status = fmi2_import_get_integer(FMI2ME->FMIImportInstance, valuesReferences_int, numberOfValueReferences, (fmi2_integer_t*)integerValues);
-    free(valuesReferences_int);
     if (status != fmi2_status_ok && status != fmi2_status_warning) {
       ModelicaFormatError("fmi2GetInteger failed with status : %s\n", fmi2_status_to_string(status));
     }
@@ -157,9 +260,8 @@ void fmi2SetInteger_OMC(void* in_fmi2, int numberOfValueReferences, double* inte
   if (fmiType == 1) {
     FMI2ModelExchange* FMI2ME = (FMI2ModelExchange*)in_fmi2;
     if (FMI2ME->FMISolvingMode == fmi2_instantiated_mode || FMI2ME->FMISolvingMode == fmi2_initialization_mode || FMI2ME->FMISolvingMode == fmi2_event_mode) {
-      fmi2_value_reference_t* valuesReferences_int = real_to_fmi2_value_reference(numberOfValueReferences, integerValuesReferences);
+      fmi2_value_reference_t* valuesReferences_int = get_fmi2_value_references(FMI2ME, numberOfValueReferences, integerValuesReferences);
       fmi2_status_t status = fmi2_import_set_integer(FMI2ME->FMIImportInstance, valuesReferences_int, numberOfValueReferences, (fmi2_integer_t*)integerValues);
-      free(valuesReferences_int);
       if (status != fmi2_status_ok && status != fmi2_status_warning) {
         ModelicaFormatError("fmi2SetInteger failed with status : %s\n", fmi2_status_to_string(status));
       }
@@ -178,12 +280,10 @@ void fmi2GetBoolean_OMC(void* in_fmi2, int numberOfValueReferences, double* bool
 {
   if (fmiType == 1) {
     FMI2ModelExchange* FMI2ME = (FMI2ModelExchange*)in_fmi2;
-    fmi2_value_reference_t* valuesReferences_int = real_to_fmi2_value_reference(numberOfValueReferences, booleanValuesReferences);
-    int* fmiBoolean = malloc(sizeof(int)*numberOfValueReferences);
+    fmi2_value_reference_t* valuesReferences_int = get_fmi2_value_references(FMI2ME, numberOfValueReferences, booleanValuesReferences);
+    int* fmiBoolean = get_fmi2_boolean_buffer(FMI2ME, numberOfValueReferences);
     fmi2_status_t status = fmi2_import_get_boolean(FMI2ME->FMIImportInstance, valuesReferences_int, numberOfValueReferences, fmiBoolean);
     int_to_signedchar(fmiBoolean, booleanValues, numberOfValueReferences);
-    free(fmiBoolean);
-    free(valuesReferences_int);
 
 
     if (status != fmi2_status_ok && status != fmi2_status_warning) {
@@ -203,13 +303,11 @@ void fmi2SetBoolean_OMC(void* in_fmi2, int numberOfValueReferences, double* bool
   if (fmiType == 1) {
     FMI2ModelExchange* FMI2ME = (FMI2ModelExchange*)in_fmi2;
     if (FMI2ME->FMISolvingMode == fmi2_instantiated_mode || FMI2ME->FMISolvingMode == fmi2_initialization_mode || FMI2ME->FMISolvingMode == fmi2_event_mode) {
-      fmi2_value_reference_t* valuesReferences_int = real_to_fmi2_value_reference(numberOfValueReferences, booleanValuesReferences);
-      int* fmiBoolean = malloc(sizeof(int)*numberOfValueReferences);
+      fmi2_value_reference_t* valuesReferences_int = get_fmi2_value_references(FMI2ME, numberOfValueReferences, booleanValuesReferences);
+      int* fmiBoolean = get_fmi2_boolean_buffer(FMI2ME, numberOfValueReferences);
       fmi2_status_t status;
       signedchar_to_int(booleanValues, fmiBoolean, numberOfValueReferences);
       status = fmi2_import_set_boolean(FMI2ME->FMIImportInstance, valuesReferences_int, numberOfValueReferences, fmiBoolean);
-      free(fmiBoolean);
-      free(valuesReferences_int);
       if (status != fmi2_status_ok && status != fmi2_status_warning) {
         ModelicaFormatError("fmi2SetBoolean failed with status : %s\n", fmi2_status_to_string(status));
       }
@@ -228,9 +326,8 @@ void fmi2GetString_OMC(void* in_fmi2, int numberOfValueReferences, double* strin
 {
   if (fmiType == 1) {
     FMI2ModelExchange* FMI2ME = (FMI2ModelExchange*)in_fmi2;
-    fmi2_value_reference_t* valuesReferences_int = real_to_fmi2_value_reference(numberOfValueReferences, stringValuesReferences);
+    fmi2_value_reference_t* valuesReferences_int = get_fmi2_value_references(FMI2ME, numberOfValueReferences, stringValuesReferences);
     fmi2_status_t status = fmi2_import_get_string(FMI2ME->FMIImportInstance, valuesReferences_int, numberOfValueReferences, (fmi2_string_t*)stringValues);
-    free(valuesReferences_int);
     if (status != fmi2_status_ok && status != fmi2_status_warning) {
       ModelicaFormatError("fmi2GetString failed with status : %s\n", fmi2_status_to_string(status));
     }
@@ -248,9 +345,8 @@ void fmi2SetString_OMC(void* in_fmi2, int numberOfValueReferences, double* strin
   if (fmiType == 1) {
     FMI2ModelExchange* FMI2ME = (FMI2ModelExchange*)in_fmi2;
     if (FMI2ME->FMISolvingMode == fmi2_instantiated_mode || FMI2ME->FMISolvingMode == fmi2_initialization_mode || FMI2ME->FMISolvingMode == fmi2_event_mode) {
-      fmi2_value_reference_t* valuesReferences_int = real_to_fmi2_value_reference(numberOfValueReferences, stringValuesReferences);
+      fmi2_value_reference_t* valuesReferences_int = get_fmi2_value_references(FMI2ME, numberOfValueReferences, stringValuesReferences);
       fmi2_status_t status = fmi2_import_set_string(FMI2ME->FMIImportInstance, valuesReferences_int, numberOfValueReferences, (fmi2_string_t*)stringValues);
-      free(valuesReferences_int);
       if (status != fmi2_status_ok && status != fmi2_status_warning) {
         ModelicaFormatError("fmi2SetString failed with status : %s\n", fmi2_status_to_string(status));
       }
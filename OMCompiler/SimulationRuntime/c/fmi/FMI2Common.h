@@ -44,6 +44,20 @@ typedef enum {
   fmi2_none_mode
 } fmi2_solving_mode_t;
 
+/*
+ * Value references of one get/set call site, converted once to fmi2_value_reference_t.
+ * The key is a copy of the value references as passed by the Modelica code, hash is computed from its contents.
+ * The tables are kept in a hash table with FMI2_MAX_VALUE_REFERENCE_TABLES slots; a table with size 0 is unused.
+ */
+#define FMI2_MAX_VALUE_REFERENCE_TABLES 64
+
+typedef struct {
+  int size;
+  unsigned int hash;
+  double* key;
+  fmi2_value_reference_t* valueReferences;
+} FMI2ValueReferenceTable;
+
 /*
  * Structure used as an External Object in the generated Modelica code of the imported FMU.
  * Used for FMI 2.0 Model Exchange.
@@ -61,8 +75,16 @@ typedef struct {
   double FMIRelativeTolerance;
   fmi2_event_info_t* FMIEventInfo;
   fmi2_solving_mode_t FMISolvingMode;
+  FMI2ValueReferenceTable* FMIValueReferenceTables;
+  int FMINumberOfValueReferenceTables;
+  fmi2_value_reference_t* FMIValueReferenceBuffer;
+  int FMIValueReferenceBufferSize;
+  int* FMIBooleanBuffer;
+  int FMIBooleanBufferSize;
 } FMI2ModelExchange;
 
+void initializeFMI2Buffers(FMI2ModelExchange* FMI2ME);
+void freeFMI2Buffers(FMI2ModelExchange* FMI2ME);
 void fmi2logger(fmi2_component_t c, fmi2_string_t instanceName, fmi2_status_t status, fmi2_string_t category, fmi2_string_t message, ...);
 
 #endif
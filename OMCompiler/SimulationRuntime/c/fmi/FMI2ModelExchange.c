@@ -44,6 +44,7 @@ void* FMI2ModelExchangeConstructor_OMC(int fmi_log_level, char* working_director
   FMI2ModelExchange* FMI2ME = malloc(sizeof(FMI2ModelExchange));
   jm_status_enu_t status, instantiateModelStatus;
   FMI2ME->FMILogLevel = fmi_log_level;
+  initializeFMI2Buffers(FMI2ME);
   /* JM callbacks */
   FMI2ME->JMCallbacks.malloc = malloc;
   FMI2ME->JMCallbacks.calloc = calloc;
@@ -118,6 +119,7 @@ void FMI2ModelExchangeDestructor_OMC(void* in_fmi2me)
   free(FMI2ME->FMIWorkingDirectory);
   free(FMI2ME->FMIInstanceName);
   free(FMI2ME->FMIEventInfo);
+  freeFMI2Buffers(FMI2ME);
 }
 
 /*
@@ -54,18 +54,153 @@ typedef struct list_s {
   struct list_s *next;
 } list;
 
+/* A thread allocates from its active arena, so pool_malloc needs no lock.
+ * Arenas are owned by their user (e.g. an FMU instance) and activated by it
+ * on the calling thread; threads without an active arena get a default one,
+ * which lives until free_memory_pool() is called on that thread.
+ * The newest chunk is the head of the list; released chunks are kept as
+ * a spare so that a mark/release cycle does not hit malloc every time. */
+struct omc_memory_pool {
+  list *chunks;
+  list *spare;
+  size_t base;      /* bytes in use in the chunks below the head */
+  size_t reserved;  /* total size of all chunks, including the spare */
+  size_t peakUsed;
+  size_t peakReserved;
+};
+typedef struct omc_memory_pool memory_arena;
+
+#if !defined(OMC_NO_THREADS)
+static pthread_key_t memory_arena_key;  /* the active arena of the thread */
+static pthread_key_t default_arena_key;
+static pthread_once_t memory_arena_once = PTHREAD_ONCE_INIT;
+#else
+static memory_arena *memory_arena_single = NULL;
+static memory_arena *default_arena_single = NULL;
+#endif
+
+static list* new_chunk(size_t size)
+{
+  list *chunk = (list*) omc_alloc_interface.malloc_uncollectable(sizeof(list));
+  chunk->used = 0;
+  chunk->size = size;
+  chunk->memory = omc_alloc_interface.malloc_uncollectable(size);
+  chunk->next = NULL;
+  return chunk;
+}
+
+static void free_chunk(memory_arena *arena, list *chunk)
+{
+  arena->reserved -= chunk->size;
+  omc_alloc_interface.free_uncollectable(chunk->memory);
+  omc_alloc_interface.free_uncollectable(chunk);
+}
+
+static void free_arena(void *ptr)
+{
+  memory_arena *arena = (memory_arena*) ptr;
+  list *chunk;
+  if (NULL == arena) {
+    return;
+  }
+  while (arena->chunks) {
+    chunk = arena->chunks->next;
+    free_chunk(arena, arena->chunks);
+    arena->chunks = chunk;
+  }
+  if (arena->spare) {
+    free_chunk(arena, arena->spare);
+  }
+  omc_alloc_interface.free_uncollectable(arena);
+}
+
+/* No destructors: the arenas must not be freed when a thread exits */
+#if !defined(OMC_NO_THREADS)
+static void make_memory_arena_key(void)
+{
+  pthread_key_create(&memory_arena_key, NULL);
+  pthread_key_create(&default_arena_key, NULL);
+}
+#endif
+
+static memory_arena* new_arena(void)
+{
+  memory_arena *arena = (memory_arena*) omc_alloc_interface.malloc_uncollectable(sizeof(memory_arena));
+  memset(arena, 0, sizeof(memory_arena));
+  arena->chunks = new_chunk(2*1024*1024); /* 2MB pool by default */
+  arena->reserved = arena->peakReserved = arena->chunks->size;
+  return arena;
+}
+
+static inline memory_arena* default_arena(void)
+{
 #if !defined(OMC_NO_THREADS)
-static pthread_mutex_t memory_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+  pthread_once(&memory_arena_once, make_memory_arena_key);
+  return (memory_arena*) pthread_getspecific(default_arena_key);
+#else
+  return default_arena_single;
 #endif
-static list *memory_pools = NULL;
+}
+
+static inline memory_arena* current_arena(void)
+{
+#if !defined(OMC_NO_THREADS)
+  memory_arena *arena;
+  pthread_once(&memory_arena_once, make_memory_arena_key);
+  arena = (memory_arena*) pthread_getspecific(memory_arena_key);
+  return arena ? arena : (memory_arena*) pthread_getspecific(default_arena_key);
+#else
+  return memory_arena_single ? memory_arena_single : default_arena_single;
+#endif
+}
+
+static memory_arena* get_arena(void)
+{
+  memory_arena *arena = current_arena();
+  if (NULL != arena) {
+    return arena;
+  }
+  arena = new_arena();
+#if !defined(OMC_NO_THREADS)
+  pthread_setspecific(default_arena_key, arena);
+#else
+  default_arena_single = arena;
+#endif
+  return arena;
+}
 
 static void pool_init(void)
 {
-  memory_pools = (list*) omc_alloc_interface.malloc_uncollectable(sizeof(list));
-  memory_pools->used = 0;
-  memory_pools->size = 2*1024*1024; /* 2MB pool by default */
-  memory_pools->memory = omc_alloc_interface.malloc_uncollectable(memory_pools->size);
-  memory_pools->next = NULL;
+#if !defined(OMC_NO_THREADS)
+  pthread_once(&memory_arena_once, make_memory_arena_key);
+#endif
+}
+
+omc_memory_pool* memory_pool_new(void)
+{
+  return new_arena();
+}
+
+void memory_pool_free(omc_memory_pool *pool)
+{
+  if (current_arena() == pool) {
+    memory_pool_activate(NULL);
+  }
+  free_arena(pool);
+}
+
+omc_memory_pool* memory_pool_activate(omc_memory_pool *pool)
+{
+  memory_arena *previous;
+#if !defined(OMC_NO_THREADS)
+  pthread_once(&memory_arena_once, make_memory_arena_key);
+  previous = (memory_arena*) pthread_getspecific(memory_arena_key);
+  pthread_setspecific(memory_arena_key, pool);
+#else
+  previous = memory_arena_single;
+  memory_arena_single = pool;
+#endif
+  return previous;
 }
 
 static unsigned long upper_power_of_two(unsigned long v)
@@ -85,67 +220,152 @@ static inline size_t round_up(size_t num, size_t factor)
   return num + factor - 1 - (num - 1) % factor;
 }
 
-static inline void pool_expand(size_t len)
+static inline void pool_expand(memory_arena *arena, size_t len)
 {
-  list *newlist = NULL;
-  if (0==memory_pools) {
-    pool_init();
-  }
+  list *chunk;
   /* Check if we have enough memory already */
-  if (memory_pools->size - memory_pools->used >= len) {
+  if (arena->chunks->size - arena->chunks->used >= len) {
     return;
   }
-  newlist = (list*) omc_alloc_interface.malloc_uncollectable(sizeof(list));
-  newlist->next = memory_pools;
-  memory_pools = newlist;
-  memory_pools->used = 0;
-  memory_pools->size = upper_power_of_two(3*memory_pools->next->size/2 + len); /* expand by 1.5x the old memory pool. More if we request a very large array. */
-  memory_pools->memory = omc_alloc_interface.malloc_uncollectable(memory_pools->size);
+  if (arena->spare && arena->spare->size >= len) {
+    chunk = arena->spare;
+    arena->spare = NULL;
+    chunk->used = 0;
+  } else {
+    /* expand by 1.5x the old memory pool. More if we request a very large array. */
+    chunk = new_chunk(upper_power_of_two(3*arena->chunks->size/2 + len));
+    arena->reserved += chunk->size;
+    if (arena->reserved > arena->peakReserved) {
+      arena->peakReserved = arena->reserved;
+    }
+  }
+  arena->base += arena->chunks->used;
+  chunk->next = arena->chunks;
+  arena->chunks = chunk;
 }
 
-static void* pool_malloc(size_t sz)
+static inline void* pool_alloc(size_t sz)
 {
+  memory_arena *arena = get_arena();
   void *res;
   sz = round_up(sz,8);
-#if !defined(OMC_NO_THREADS)
-  pthread_mutex_lock(&memory_pool_mutex);
-#endif
-  pool_expand(sz);
-  res = (void*)((char*)memory_pools->memory + memory_pools->used);
-  memory_pools->used += sz;
-#if !defined(OMC_NO_THREADS)
-  pthread_mutex_unlock(&memory_pool_mutex);
-#endif
-  memset(res,0,sz);
+  pool_expand(arena, sz);
+  res = (void*)((char*)arena->chunks->memory + arena->chunks->used);
+  arena->chunks->used += sz;
+  if (arena->base + arena->chunks->used > arena->peakUsed) {
+    arena->peakUsed = arena->base + arena->chunks->used;
+  }
+  return res;
+}
+
+static void* pool_malloc(size_t sz)
+{
+  void *res = pool_alloc(sz);
+  memset(res,0,round_up(sz,8));
   return res;
 }
 
+/* Like GC_malloc_atomic: the memory is not cleared. Used for real, integer
+ * and boolean arrays and strings, which are always written before read. */
+static void* pool_malloc_atomic(size_t sz)
+{
+  return pool_alloc(sz);
+}
+
+/* Keep the larger of the two chunks as the spare and free the other */
+static inline void keep_spare(memory_arena *arena, list *chunk)
+{
+  if (NULL == arena->spare) {
+    arena->spare = chunk;
+  } else if (chunk->size > arena->spare->size) {
+    free_chunk(arena, arena->spare);
+    arena->spare = chunk;
+  } else {
+    free_chunk(arena, chunk);
+  }
+}
+
 static int pool_free_extra_list(void)
 {
-  list *freelist;
-  if (NULL == memory_pools) {
+  memory_arena *arena = current_arena();
+  list *chunk;
+  if (NULL == arena) {
     return 0;
   }
-  freelist = memory_pools->next;
-  while (freelist) {
-    list *next = freelist->next;
-    omc_alloc_interface.free_uncollectable(freelist->memory);
-    omc_alloc_interface.free_uncollectable(freelist);
-    freelist = next;
+  while (arena->chunks->next) {
+    chunk = arena->chunks;
+    arena->chunks = chunk->next;
+    keep_spare(arena, chunk);
+  }
+  /* Only a single chunk is kept between steps; use the largest one */
+  if (arena->spare) {
+    if (arena->spare->size > arena->chunks->size) {
+      chunk = arena->chunks;
+      arena->chunks = arena->spare;
+      arena->chunks->next = NULL;
+      arena->spare = chunk;
+    }
+    free_chunk(arena, arena->spare);
+    arena->spare = NULL;
   }
-  memory_pools->used = 0;
-  memory_pools->next = 0;
+  arena->chunks->used = 0;
+  arena->base = 0;
   return 0;
 }
 
+omc_pool_state get_memory_state(void)
+{
+  memory_arena *arena = get_arena();
+  omc_pool_state state;
+  state.pool = arena;
+  state.chunk = arena->chunks;
+  state.used = arena->chunks->used;
+  return state;
+}
+
+void restore_memory_state(omc_pool_state state)
+{
+  memory_arena *arena = (memory_arena*) state.pool;
+  list *chunk;
+  if (NULL == arena) {
+    return;
+  }
+  while (arena->chunks != state.chunk && arena->chunks->next) {
+    chunk = arena->chunks;
+    arena->chunks = chunk->next;
+    arena->base -= arena->chunks->used;
+    keep_spare(arena, chunk);
+  }
+  if (arena->chunks == state.chunk) {
+    arena->chunks->used = state.used;
+  }
+}
+
+void memory_pool_statistics(omc_memory_pool *pool, omc_pool_statistics *stats)
+{
+  memory_arena *arena = pool ? pool : current_arena();
+  if (NULL == arena) {
+    memset(stats, 0, sizeof(omc_pool_statistics));
+    return;
+  }
+  stats->used = arena->base + arena->chunks->used;
+  stats->reserved = arena->reserved;
+  stats->peakUsed = arena->peakUsed;
+  stats->peakReserved = arena->peakReserved;
+}
+
 void free_memory_pool()
 {
-  pool_free_extra_list();
-  if (memory_pools) {
-    omc_alloc_interface.free_uncollectable(memory_pools->memory);
-    omc_alloc_interface.free_uncollectable(memory_pools);
-    memory_pools = NULL;
+  memory_arena *arena = default_arena();
+  if (NULL == arena) {
+    return;
   }
+#if !defined(OMC_NO_THREADS)
+  pthread_setspecific(default_arena_key, NULL);
+#else
+  default_arena_single = NULL;
+#endif
+  free_arena(arena);
 }
 
 static void nofree(void* ptr)
@@ -159,7 +379,7 @@ static void* malloc_zero(size_t sz) {
 omc_alloc_interface_t omc_alloc_interface_pooled = {
   pool_init,
   pool_malloc,
-  pool_malloc,
+  pool_malloc_atomic,
   (char*(*)(size_t)) malloc,
   strdup,
   pool_free_extra_list,
@@ -226,7 +446,7 @@ omc_alloc_interface_t omc_alloc_interface = {
 #else
   pool_init,
   pool_malloc,
-  pool_malloc,
+  pool_malloc_atomic,
   (char*(*)(size_t)) malloc,
   strdup,
   pool_free_extra_list,
@@ -48,6 +48,36 @@ extern _index_t** index_alloc(int n);
 
 void* generic_alloc(int n, size_t sze);
 
+/* A memory pool owned by its user, e.g. an FMU instance. The pooled
+ * allocator uses the pool activated on the calling thread, or a default
+ * pool of the thread that is freed by free_memory_pool(). */
+typedef struct omc_memory_pool omc_memory_pool;
+
+/* Position in the active memory pool. Everything allocated from the pool
+ * after get_memory_state() is released again by restore_memory_state(). */
+typedef struct {
+  void *pool;
+  void *chunk;
+  size_t used;
+} omc_pool_state;
+
+typedef struct {
+  size_t used;
+  size_t reserved;
+  size_t peakUsed;
+  size_t peakReserved;
+} omc_pool_statistics;
+
+omc_memory_pool* memory_pool_new(void);
+void memory_pool_free(omc_memory_pool *pool);
+/* Returns the previously active pool; NULL activates the default pool */
+omc_memory_pool* memory_pool_activate(omc_memory_pool *pool);
+
+omc_pool_state get_memory_state(void);
+void restore_memory_state(omc_pool_state state);
+/* Statistics of the given pool, or of the active one if pool is NULL */
+void memory_pool_statistics(omc_memory_pool *pool, omc_pool_statistics *stats);
+
 void free_memory_pool();
 
 #if defined(__cplusplus)
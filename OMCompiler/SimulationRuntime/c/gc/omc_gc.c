@@ -41,6 +41,7 @@
 #include "omc_gc.h"
 #include "../util/omc_error.h"
 #include "../util/omc_init.h"
+#include <string.h>
 
 static mmc_GC_state_type x_mmc_GC_state = {0};
 mmc_GC_state_type *mmc_GC_state = &x_mmc_GC_state;
@@ -124,4 +125,111 @@ size_t omc_GC_get_max_heap_size()
 {
   return max_heap_size;
 }
+
+#define MMC_GC_REGION_MIN_BLOCK (4*1024)
+#define MMC_GC_REGION_MAX_BLOCK (64*1024)
+
+typedef struct {
+  char *cur;
+  size_t left;
+  size_t blockSize;
+} mmc_GC_region_block;
+
+typedef struct {
+  mmc_GC_region_block traced; /* allocated with GC_malloc; scanned for pointers */
+  mmc_GC_region_block atomic; /* allocated with GC_malloc_atomic; strings and reals */
+} mmc_GC_region;
+
+static pthread_once_t mmc_GC_region_once = PTHREAD_ONCE_INIT;
+static pthread_key_t mmc_GC_region_key;
+static int mmc_GC_regions_supported = 0;
+
+static void mmc_GC_region_free(void *region)
+{
+  GC_free(region);
+}
+
+static void mmc_GC_region_make_key(void)
+{
+  pthread_key_create(&mmc_GC_region_key, mmc_GC_region_free);
+  /* Objects in the middle of a block are only kept alive if the collector
+   * recognizes interior pointers; otherwise fall back to GC_malloc */
+  mmc_GC_regions_supported = GC_get_all_interior_pointers();
+}
+
+void mmc_GC_region_enter(void)
+{
+  mmc_GC_region *region;
+  pthread_once(&mmc_GC_region_once, mmc_GC_region_make_key);
+  if (!mmc_GC_regions_supported) {
+    return;
+  }
+  region = (mmc_GC_region*) pthread_getspecific(mmc_GC_region_key);
+  if (region == NULL) {
+    /* Uncollectable so that the current blocks are roots while we bump into them */
+    region = (mmc_GC_region*) GC_malloc_uncollectable(sizeof(mmc_GC_region));
+    if (region == NULL) {
+      return;
+    }
+    pthread_setspecific(mmc_GC_region_key, region);
+  }
+  memset(region, 0, sizeof(mmc_GC_region));
+  region->traced.blockSize = MMC_GC_REGION_MIN_BLOCK;
+  region->atomic.blockSize = MMC_GC_REGION_MIN_BLOCK;
+}
+
+void mmc_GC_region_leave(void)
+{
+  mmc_GC_region *region;
+  pthread_once(&mmc_GC_region_once, mmc_GC_region_make_key);
+  region = (mmc_GC_region*) pthread_getspecific(mmc_GC_region_key);
+  if (region != NULL) {
+    /* The blocks stay in the GC heap for as long as anything points into them */
+    memset(region, 0, sizeof(mmc_GC_region));
+  }
+}
+
+static inline void* mmc_GC_region_bump(mmc_GC_region_block *block, size_t sz, int atomic)
+{
+  void *res;
+  sz = (sz + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+  if (block->blockSize == 0 || sz > MMC_GC_REGION_MAX_BLOCK/4) {
+    /* No active region or a large object (arrays); use the GC directly */
+    return atomic ? GC_malloc_atomic(sz) : GC_malloc(sz);
+  }
+  if (sz > block->left) {
+    char *mem = (char*) (atomic ? GC_malloc_atomic(block->blockSize) : GC_malloc(block->blockSize));
+    if (mem == NULL) {
+      return NULL;
+    }
+    block->cur = mem;
+    block->left = block->blockSize;
+    /* Grow geometrically so small files waste little of their last block */
+    if (block->blockSize < MMC_GC_REGION_MAX_BLOCK) {
+      block->blockSize *= 2;
+    }
+  }
+  res = block->cur;
+  block->cur += sz;
+  block->left -= sz;
+  return res;
+}
+
+void* mmc_GC_region_malloc(size_t sz)
+{
+  mmc_GC_region *region = mmc_GC_regions_supported ? (mmc_GC_region*) pthread_getspecific(mmc_GC_region_key) : NULL;
+  if (region == NULL) {
+    return GC_malloc(sz);
+  }
+  return mmc_GC_region_bump(&region->traced, sz, 0);
+}
+
+void* mmc_GC_region_malloc_atomic(size_t sz)
+{
+  mmc_GC_region *region = mmc_GC_regions_supported ? (mmc_GC_region*) pthread_getspecific(mmc_GC_region_key) : NULL;
+  if (region == NULL) {
+    return GC_malloc_atomic(sz);
+  }
+  return mmc_GC_region_bump(&region->atomic, sz, 1);
+}
 #endif
@@ -234,18 +234,41 @@ void mmc_record_alloc_words(size_t n);
 void mmc_set_current_pos(const char *str);
 #endif
 
+#if !(defined(OMC_MINIMAL_RUNTIME) || defined(OMC_FMI_RUNTIME))
+/* Per-thread allocation regions.
+ * A region hands out MetaModelica objects by bumping a pointer inside large
+ * blocks obtained from the GC, so a thread only takes the GC allocation lock
+ * once per block instead of once per object. The blocks are ordinary GC heap
+ * objects that are kept alive through interior pointers; leaving the region
+ * simply drops the thread's reference to its current blocks.
+ * Translation units compiled with OMC_GC_THREAD_REGIONS (the parser) route
+ * mmc_alloc_words through the active region; all other code is unaffected. */
+void mmc_GC_region_enter(void);
+void mmc_GC_region_leave(void);
+void* mmc_GC_region_malloc(size_t sz);
+void* mmc_GC_region_malloc_atomic(size_t sz);
+#endif
+
 static inline void* mmc_alloc_words_atomic(unsigned int nwords) {
 #if defined(OMC_RECORD_ALLOC_WORDS)
   mmc_record_alloc_words((nwords) * sizeof(void*));
 #endif
+#if defined(OMC_GC_THREAD_REGIONS)
+  GC_RETURN_REPORT_ALLOC_FAILED(mmc_GC_region_malloc_atomic((nwords) * sizeof(void*)));
+#else
   GC_RETURN_REPORT_ALLOC_FAILED(GC_malloc_atomic((nwords) * sizeof(void*)));
+#endif
 }
 
 static inline void* mmc_alloc_words(unsigned int nwords) {
 #if defined(OMC_RECORD_ALLOC_WORDS)
   mmc_record_alloc_words((nwords) * sizeof(void*));
 #endif
+#if defined(OMC_GC_THREAD_REGIONS)
+  GC_RETURN_REPORT_ALLOC_FAILED(mmc_GC_region_malloc((nwords) * sizeof(void*)));
+#else
   GC_RETURN_REPORT_ALLOC_FAILED(GC_malloc((nwords) * sizeof(void*)));
+#endif
 }
 
 /* for arrays only */
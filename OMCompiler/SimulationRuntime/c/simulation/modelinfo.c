@@ -31,6 +31,7 @@
 #include "../util/omc_error.h"
 #include "../simulation_data.h"
 #include "../util/rtclock.h"
+#include "../util/rtprofile.h"
 #include "modelinfo.h"
 #include "simulation_info_json.h"
 #include "simulation_runtime.h"
@@ -661,3 +662,53 @@ int printModelInfoJSON(DATA *data, threadData_t *threadData, const char *outputP
   fprintf(fout, "}");
   return 0;
 }
+
+static const char* profilingTimerName(void *userdata, int ix, char *buf, size_t bufSize)
+{
+  static const char *timerNames[SIM_TIMER_FIRST_FUNCTION] = {"total", "initialization", "step", "output", "event",
+    "jacobian", "pre-initialization", "overhead", "functionODE", "residuals", "algebraics", "zero-crossings", "solver",
+    "init.xml", "info.json", "DAE"};
+  MODEL_DATA_XML *xml = &((DATA*) userdata)->modelData->modelDataXml;
+  if (ix < SIM_TIMER_FIRST_FUNCTION) {
+    return timerNames[ix];
+  }
+  ix -= SIM_TIMER_FIRST_FUNCTION;
+  if (ix < xml->nFunctions) {
+    return modelInfoGetFunction(xml, ix).name;
+  }
+  ix -= xml->nFunctions;
+  if (ix < xml->nProfileBlocks) {
+    snprintf(buf, bufSize, "Equation %d", (int) modelInfoGetEquationIndexByProfileBlock(xml, ix).id);
+  } else {
+    snprintf(buf, bufSize, "Equation %d", ix - (int) xml->nProfileBlocks);
+  }
+  return buf;
+}
+
+int printProfilingStatistics(DATA *data, const char *outputPath, int writeTrace)
+{
+  const char *fullFileName;
+  double secondsPerCycle = rt_tsc_seconds_per_cycle();
+  int res = 0;
+
+  if (!rt_profile_active()) {
+    return 0;
+  }
+  if (0 > GC_asprintf(&fullFileName, "%s%s_prof.bin", outputPath, data->modelData->modelFilePrefix)) {
+    throwStreamPrint(NULL, "modelinfo.c: Error: can not allocate memory.");
+  }
+  if (rt_profile_write_binary(fullFileName, secondsPerCycle, profilingTimerName, data)) {
+    warningStreamPrint(LOG_STDOUT, 0, "Failed to write profiling statistics to %s: %s", fullFileName, strerror(errno));
+    res = 1;
+  }
+  if (writeTrace) {
+    if (0 > GC_asprintf(&fullFileName, "%s%s_prof.trace.json", outputPath, data->modelData->modelFilePrefix)) {
+      throwStreamPrint(NULL, "modelinfo.c: Error: can not allocate memory.");
+    }
+    if (rt_profile_write_trace(fullFileName, secondsPerCycle, profilingTimerName, data)) {
+      warningStreamPrint(LOG_STDOUT, 0, "Failed to write the profiling trace to %s: %s", fullFileName, strerror(errno));
+      res = 1;
+    }
+  }
+  return res;
+}
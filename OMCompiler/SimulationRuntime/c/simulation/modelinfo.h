@@ -37,6 +37,8 @@ extern "C" {
 
 int printModelInfo(DATA *data, threadData_t *threadData, const char *outputPath, const char *modelinfo, const char *plotinfo, const char *plotFormat, const char *method, const char *outputFormat, const char *outputFilename);
 int printModelInfoJSON(DATA *data, threadData_t *threadData, const char *outputPath, const char *filename, const char *outputFilename);
+/* Writes prefix_prof.bin and prefix_prof.trace.json if -clock=TSC collected histograms */
+int printProfilingStatistics(DATA *data, const char *outputPath, int writeTrace);
 
 #ifdef __cplusplus
 }
@@ -61,10 +61,15 @@ int setLogFormat(int argc, char** argv)
       setStreamPrintXML(1);
     } else if (0 == strcmp(value, "xmltcp")) {
       setStreamPrintXML(2);
+    } else if (0 == strcmp(value, "bintcp")) {
+      setStreamPrintXML(3);
     } else if (0 == strcmp(value, "text")) {
       setStreamPrintXML(0);
+    } else if (0 == strcmp(value, "binary")) {
+      /* messages before the binary log is opened (e.g. -help) are written as text */
+      setStreamPrintXML(0);
     } else {
-      warningStreamPrint(LOG_STDOUT, 0, "invalid command line option: -logFormat=%s, expected text, xml, or xmltcp", value);
+      warningStreamPrint(LOG_STDOUT, 0, "invalid command line option: -logFormat=%s, expected text, xml, xmltcp, bintcp, or binary", value);
       return 1;
     }
   }
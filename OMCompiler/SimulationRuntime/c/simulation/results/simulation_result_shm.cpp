@@ -0,0 +1,182 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+#include "util/omc_error.h"
+#include "util/omc_mmap.h"
+#include "util/omc_shm_stream.h"
+#include "simulation_result_shm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if HAVE_MMAP
+
+template<typename T>
+static int* shm_selected(int n, const T *vars, unsigned int *count, size_t *namesSize)
+{
+  int i, *index = (int*) malloc((n > 0 ? n : 1) * sizeof(int));
+  *count = 0;
+  for (i = 0; i < n; i++) {
+    if (!vars[i].filterOutput) {
+      index[(*count)++] = i;
+      *namesSize += strlen(vars[i].info.name) + 1;
+    }
+  }
+  return index;
+}
+
+template<typename T>
+static char* shm_names(char *dest, unsigned int count, const int *index, const T *vars)
+{
+  unsigned int i;
+  for (i = 0; i < count; i++) {
+    size_t len = strlen(vars[index[i]].info.name) + 1;
+    memcpy(dest, vars[index[i]].info.name, len);
+    dest += len;
+  }
+  return dest;
+}
+
+#endif
+
+extern "C" {
+
+#if HAVE_MMAP
+
+#define SHM_BARRIER() __sync_synchronize()
+
+typedef struct shm_storage {
+  omc_mmap_write map;
+  omc_shm_stream_header *header;
+  char *records;
+  int *realIndex;
+  int *integerIndex;
+  int *booleanIndex;
+  simulation_result chained; /* the result file the stream is attached to */
+} shm_storage;
+
+static shm_storage shm;
+
+static void shm_stream_emit(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+  omc_shm_stream_header *header = shm.header;
+  const SIMULATION_DATA *sData = data->localData[0];
+  uint64_t n = header->count;
+  char *record = shm.records + (n % header->capacity) * header->recordSize;
+  double *reals = (double*) (record + 16);
+  int64_t *integers = (int64_t*) (reals + header->nReal);
+  int8_t *booleans = (int8_t*) (integers + header->nInteger);
+  unsigned int i;
+
+  shm.chained.emit(self, data, threadData);
+
+  *(volatile uint64_t*) record = 2*n+1;
+  SHM_BARRIER();
+  ((double*) record)[1] = sData->timeValue;
+  for (i = 0; i < header->nReal; i++) {
+    reals[i] = sData->realVars[shm.realIndex[i]];
+  }
+  for (i = 0; i < header->nInteger; i++) {
+    integers[i] = sData->integerVars[shm.integerIndex[i]];
+  }
+  for (i = 0; i < header->nBoolean; i++) {
+    booleans[i] = sData->booleanVars[shm.booleanIndex[i]];
+  }
+  SHM_BARRIER();
+  *(volatile uint64_t*) record = 2*n+2;
+  header->count = n+1;
+}
+
+static void shm_stream_free(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+  shm.header->finished = 1;
+  omc_mmap_close_write(shm.map);
+  free(shm.realIndex);
+  free(shm.integerIndex);
+  free(shm.booleanIndex);
+  self->emit = shm.chained.emit;
+  self->free = shm.chained.free;
+  self->free(self, data, threadData);
+}
+
+void shm_stream_attach(simulation_result *self, DATA *data, threadData_t *threadData, const char *filename, int capacity)
+{
+  MODEL_DATA *modelData = data->modelData;
+  omc_shm_stream_header header;
+  size_t namesSize = 0, size;
+  char *names;
+
+  memset(&header, 0, sizeof(header));
+  shm.realIndex = shm_selected(modelData->nVariablesReal, modelData->realVarsData, &header.nReal, &namesSize);
+  shm.integerIndex = shm_selected(modelData->nVariablesInteger, modelData->integerVarsData, &header.nInteger, &namesSize);
+  shm.booleanIndex = shm_selected(modelData->nVariablesBoolean, modelData->booleanVarsData, &header.nBoolean, &namesSize);
+
+  memcpy(header.magic, OMC_SHM_STREAM_MAGIC, sizeof(header.magic));
+  header.namesOffset = sizeof(omc_shm_stream_header);
+  header.namesSize = namesSize;
+  header.headerSize = (header.namesOffset + namesSize + 7) & ~7;
+  header.recordSize = (16 + 8*(header.nReal + header.nInteger) + header.nBoolean + 7) & ~7;
+  header.capacity = capacity > 0 ? capacity : 1;
+  size = header.headerSize + (size_t) header.recordSize * header.capacity;
+
+  /* Readers that still map the file of an older run keep their copy */
+  remove(filename);
+  shm.map = omc_mmap_open_write(filename, size);
+  memset(shm.map.data, 0, size);
+  shm.header = (omc_shm_stream_header*) shm.map.data;
+  shm.records = shm.map.data + header.headerSize;
+  names = shm.map.data + header.namesOffset;
+  names = shm_names(names, header.nReal, shm.realIndex, modelData->realVarsData);
+  names = shm_names(names, header.nInteger, shm.integerIndex, modelData->integerVarsData);
+  shm_names(names, header.nBoolean, shm.booleanIndex, modelData->booleanVarsData);
+  /* The magic is written last, readers ignore the file until it is complete */
+  memcpy((char*) shm.header + sizeof(header.magic), (char*) &header + sizeof(header.magic), sizeof(header) - sizeof(header.magic));
+  SHM_BARRIER();
+  memcpy(shm.header->magic, header.magic, sizeof(header.magic));
+  SHM_BARRIER();
+
+  shm.chained = *self;
+  self->emit = shm_stream_emit;
+  self->free = shm_stream_free;
+  infoStreamPrint(LOG_SOLVER, 0, "Streaming %u real, %u integer and %u boolean variables to %s (%u records)",
+    header.nReal, header.nInteger, header.nBoolean, filename, header.capacity);
+}
+
+#else
+
+void shm_stream_attach(simulation_result *self, DATA *data, threadData_t *threadData, const char *filename, int capacity)
+{
+  warningStreamPrint(LOG_STDOUT, 0, "-shmStream is not supported on this platform.");
+}
+
+#endif
+
+}
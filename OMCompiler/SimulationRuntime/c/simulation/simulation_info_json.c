@@ -210,47 +210,21 @@ static inline const char *skipFieldIfExist(const char *str,const char *name)
   return s;
 }
 
-static const char* readEquation(const char *str,EQUATION_INFO *xml,int i)
+/* Reads the strings of a JSON array; str points behind the opening '['. */
+static const char* readStringArray(const char *str, int *n, const char ***values)
 {
-  int n=0,j;
+  int j;
   const char *str2;
-  str=assertChar(str,'{');
-  str=assertStringValue(str,"eqIndex");
-  str=assertChar(str,':');
-  str=assertNumber(str,i);
-  str=skipSpace(str);
-  xml->id = i;
-  str = skipFieldIfExist(str, "parent");
-  str = skipFieldIfExist(str, "section");
-  if ((measure_time_flag & 1) && 0==strncmp(",\"tag\":\"system\"", str, 15)) {
-    xml->profileBlockIndex = -1;
-    str += 15;
-  } else if ((measure_time_flag & 1) && 0==strncmp(",\"tag\":\"tornsystem\"", str, 19)) {
-    xml->profileBlockIndex = -1;
-    str += 19;
-  } else {
-    xml->profileBlockIndex = 0;
-  }
-  str = skipFieldIfExist(str, "tag");
-  str = skipFieldIfExist(str, "display");
-  str = skipFieldIfExist(str, "unknowns");
-  if (strncmp(",\"defines\":[", str, 12)) {
-    xml->numVar = 0;
-    xml->vars = 0;
-    str = skipObjectRest(str,0);
-    return str;
-  }
-  str += 12;
+  *n = 0;
+  *values = NULL;
   str = skipSpace(str);
   if (*str == ']') {
-    xml->numVar = 0;
-    xml->vars = 0;
-    return skipObjectRest(str-1,0);
+    return str+1;
   }
-  str2 = skipSpace(str);
+  str2 = str;
   while (1) {
     str=skipValue(str);
-    n++;
+    (*n)++;
     str=skipSpace(str);
     if (*str != ',') {
       break;
@@ -258,10 +232,9 @@ static const char* readEquation(const char *str,EQUATION_INFO *xml,int i)
     str++;
   };
   assertChar(str, ']');
-  xml->numVar = n;
-  xml->vars = malloc(sizeof(const char*)*n);
+  *values = malloc(sizeof(const char*)*(*n));
   str = str2;
-  for (j=0; j<n; j++) {
+  for (j=0; j<*n; j++) {
     const char *str3 = skipSpace(str);
     char *tmp;
     int len=0;
@@ -274,12 +247,57 @@ static const char* readEquation(const char *str,EQUATION_INFO *xml,int i)
     tmp = malloc(len+1);
     strncpy(tmp, str3+1, len);
     tmp[len] = '\0';
-    xml->vars[j] = tmp;
-    if (j != n-1) {
+    (*values)[j] = tmp;
+    if (j != *n-1) {
       str = assertChar(str, ',');
     }
   }
-  str = assertChar(skipSpace(str), ']');
+  return assertChar(skipSpace(str), ']');
+}
+
+static const char* readEquation(const char *str,EQUATION_INFO *xml,int i)
+{
+  str=assertChar(str,'{');
+  str=assertStringValue(str,"eqIndex");
+  str=assertChar(str,':');
+  str=assertNumber(str,i);
+  str=skipSpace(str);
+  xml->id = i;
+  xml->parent = 0;
+  if (0==strncmp(",\"parent\":", str, 10)) {
+    char *endptr = NULL;
+    xml->parent = strtol(str+10, &endptr, 10);
+    str = skipSpace(endptr);
+  }
+  str = skipFieldIfExist(str, "section");
+  if ((measure_time_flag & 1) && 0==strncmp(",\"tag\":\"system\"", str, 15)) {
+    xml->profileBlockIndex = -1;
+    str += 15;
+  } else if ((measure_time_flag & 1) && 0==strncmp(",\"tag\":\"tornsystem\"", str, 19)) {
+    xml->profileBlockIndex = -1;
+    str += 19;
+  } else {
+    xml->profileBlockIndex = 0;
+  }
+  str = skipFieldIfExist(str, "tag");
+  str = skipFieldIfExist(str, "display");
+  str = skipFieldIfExist(str, "unknowns");
+  xml->numVar = 0;
+  xml->vars = 0;
+  xml->numUses = -1;
+  xml->uses = 0;
+  xml->numExtObjs = 0;
+  xml->extObjs = 0;
+  if (0==strncmp(",\"defines\":[", str, 12)) {
+    str = readStringArray(str+12, &xml->numVar, &xml->vars);
+  }
+  /* the variables read by the equation, used for the parallel evaluation */
+  if (0==strncmp(",\"uses\":[", str, 9)) {
+    str = readStringArray(str+9, &xml->numUses, &xml->uses);
+  }
+  if (0==strncmp(",\"extObjs\":[", str, 12)) {
+    str = readStringArray(str+12, &xml->numExtObjs, &xml->extObjs);
+  }
   return skipObjectRest(str,0);
 }
 
@@ -398,6 +416,7 @@ void modelInfoInit(MODEL_DATA_XML* xml)
   xml->equationInfo[0].profileBlockIndex = -1;
   xml->equationInfo[0].numVar = 0;
   xml->equationInfo[0].vars = NULL;
+  xml->equationInfo[0].numUses = -1;
 
   // fprintf(stderr, "Loaded the JSON file in %fms...\n", rt_tock(0) * 1000.0);
   // fprintf(stderr, "Parse the JSON %s\n", xml->infoXMLData);
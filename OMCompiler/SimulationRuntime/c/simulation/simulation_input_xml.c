@@ -40,6 +40,7 @@
 
 #include "simulation_input_xml.h"
 #include "simulation_runtime.h"
+#include "variable_name_index.h"
 #include "options.h"
 #include "../util/omc_error.h"
 #include "../meta/meta_modelica.h"
@@ -206,6 +207,8 @@ typedef hash_string_long omc_CommandLineOverridesUses;
 
 // function to handle command line settings override
 void doOverride(omc_ModelInput *mi, MODEL_DATA* modelData, const char* override, const char* overrideFile);
+static void buildVariableNameIndex(omc_ModelInput *mi, MODEL_DATA *modelData);
+static long findAliasTarget(MODEL_DATA *modelData, const char *name, int varKind, int paramKind, char *aliasType);
 
 static const double REAL_MIN = -DBL_MAX;
 static const double REAL_MAX = DBL_MAX;
@@ -427,8 +430,6 @@ void read_input_xml(MODEL_DATA* modelData,
   const char *filename, *guid, *override, *overrideFile;
   FILE* file = NULL;
   XML_Parser parser = NULL;
-  hash_string_long *mapAlias = NULL, *mapAliasParam = NULL, *mapAliasSen = NULL;
-  long *it, *itParam;
   mmc_sint_t i;
   int inputIndex = 0;
   int k = 0;
@@ -521,6 +522,9 @@ void read_input_xml(MODEL_DATA* modelData,
     throwStreamPrint(NULL, "see last warning");
   }
 
+  /* one sorted index over all names, used for the overrides, the aliases and the output filter */
+  buildVariableNameIndex(&mi, modelData);
+
   // deal with override
   override = omc_flagValue[FLAG_OVERRIDE];
   overrideFile = omc_flagValue[FLAG_OVERRIDE_FILE];
@@ -597,7 +601,7 @@ void read_input_xml(MODEL_DATA* modelData,
 
   /* read all static data from File for every variable */
 
-#define READ_VARIABLES(out, in, attributeKind, read_var_attribute, debugName, start, nStates, mapAlias) \
+#define READ_VARIABLES(out, in, attributeKind, read_var_attribute, debugName, start, nStates) \
   infoStreamPrint(LOG_DEBUG, 1, "read xml file for %s", debugName); \
   for(i = 0; i < nStates; i++) \
   { \
@@ -617,14 +621,12 @@ void read_input_xml(MODEL_DATA* modelData,
       infoStreamPrint(LOG_DEBUG, 0, "filtering variable %s due to HideResult annotation", info->name); \
       out[j].filterOutput = 1; \
     } \
-    addHashStringLong(&mapAlias, info->name, j); /* create a mapping for Alias variable to get the correct index */ \
-    debugStreamPrint(LOG_DEBUG, 0, "real %s: mapAlias[%s] = %ld", debugName, info->name, (long) j); \
     if (omc_flag[FLAG_IDAS] && 0 == strcmp(debugName, "real sensitivities")) \
     { \
       if (0 == strcmp(findHashStringString(v, "isValueChangeable"), "true")) \
       { \
-        long *it = findHashStringLongPtr(mapAliasParam, info->name); \
-        simulationInfo->sensitivityParList[k] = *it; \
+        char aliasType; \
+        simulationInfo->sensitivityParList[k] = findAliasTarget(modelData, info->name, VAR_NAME_REAL_PARAM, VAR_NAME_REAL_PARAM, &aliasType); \
         infoStreamPrint(LOG_SOLVER, 0, "%d. sensitivity parameter %s at index %d", k, info->name, simulationInfo->sensitivityParList[k]); \
         k++; \
       } \
@@ -632,22 +634,22 @@ void read_input_xml(MODEL_DATA* modelData,
   } \
   messageClose(LOG_DEBUG);
 
-  READ_VARIABLES(modelData->realVarsData,mi.rSta,REAL_ATTRIBUTE,read_var_attribute_real,"real states",0,modelData->nStates,mapAlias);
-  READ_VARIABLES(modelData->realVarsData,mi.rDer,REAL_ATTRIBUTE,read_var_attribute_real,"real state derivatives",modelData->nStates,modelData->nStates,mapAlias);
-  READ_VARIABLES(modelData->realVarsData,mi.rAlg,REAL_ATTRIBUTE,read_var_attribute_real,"real algebraics",2*modelData->nStates,modelData->nVariablesReal - 2*modelData->nStates,mapAlias);
+  READ_VARIABLES(modelData->realVarsData,mi.rSta,REAL_ATTRIBUTE,read_var_attribute_real,"real states",0,modelData->nStates);
+  READ_VARIABLES(modelData->realVarsData,mi.rDer,REAL_ATTRIBUTE,read_var_attribute_real,"real state derivatives",modelData->nStates,modelData->nStates);
+  READ_VARIABLES(modelData->realVarsData,mi.rAlg,REAL_ATTRIBUTE,read_var_attribute_real,"real algebraics",2*modelData->nStates,modelData->nVariablesReal - 2*modelData->nStates);
 
-  READ_VARIABLES(modelData->integerVarsData,mi.iAlg,INTEGER_ATTRIBUTE,read_var_attribute_int,"integer variables",0,modelData->nVariablesInteger,mapAlias);
-  READ_VARIABLES(modelData->booleanVarsData,mi.bAlg,BOOLEAN_ATTRIBUTE,read_var_attribute_bool,"boolean variables",0,modelData->nVariablesBoolean,mapAlias);
-  READ_VARIABLES(modelData->stringVarsData,mi.sAlg,STRING_ATTRIBUTE,read_var_attribute_string,"string variables",0,modelData->nVariablesString,mapAlias);
+  READ_VARIABLES(modelData->integerVarsData,mi.iAlg,INTEGER_ATTRIBUTE,read_var_attribute_int,"integer variables",0,modelData->nVariablesInteger);
+  READ_VARIABLES(modelData->booleanVarsData,mi.bAlg,BOOLEAN_ATTRIBUTE,read_var_attribute_bool,"boolean variables",0,modelData->nVariablesBoolean);
+  READ_VARIABLES(modelData->stringVarsData,mi.sAlg,STRING_ATTRIBUTE,read_var_attribute_string,"string variables",0,modelData->nVariablesString);
 
-  READ_VARIABLES(modelData->realParameterData,mi.rPar,REAL_ATTRIBUTE,read_var_attribute_real,"real parameters",0,modelData->nParametersReal,mapAliasParam);
-  READ_VARIABLES(modelData->integerParameterData,mi.iPar,INTEGER_ATTRIBUTE,read_var_attribute_int,"integer parameters",0,modelData->nParametersInteger,mapAliasParam);
-  READ_VARIABLES(modelData->booleanParameterData,mi.bPar,BOOLEAN_ATTRIBUTE,read_var_attribute_bool,"boolean parameters",0,modelData->nParametersBoolean,mapAliasParam);
-  READ_VARIABLES(modelData->stringParameterData,mi.sPar,STRING_ATTRIBUTE,read_var_attribute_string,"string parameters",0,modelData->nParametersString,mapAliasParam);
+  READ_VARIABLES(modelData->realParameterData,mi.rPar,REAL_ATTRIBUTE,read_var_attribute_real,"real parameters",0,modelData->nParametersReal);
+  READ_VARIABLES(modelData->integerParameterData,mi.iPar,INTEGER_ATTRIBUTE,read_var_attribute_int,"integer parameters",0,modelData->nParametersInteger);
+  READ_VARIABLES(modelData->booleanParameterData,mi.bPar,BOOLEAN_ATTRIBUTE,read_var_attribute_bool,"boolean parameters",0,modelData->nParametersBoolean);
+  READ_VARIABLES(modelData->stringParameterData,mi.sPar,STRING_ATTRIBUTE,read_var_attribute_string,"string parameters",0,modelData->nParametersString);
 
   if (omc_flag[FLAG_IDAS])
   {
-    READ_VARIABLES(modelData->realSensitivityData,mi.rSen,REAL_ATTRIBUTE,read_var_attribute_real,"real sensitivities",0, modelData->nSensitivityVars,mapAliasSen);
+    READ_VARIABLES(modelData->realSensitivityData,mi.rSen,REAL_ATTRIBUTE,read_var_attribute_real,"real sensitivities",0, modelData->nSensitivityVars);
   }
 
   /*
@@ -680,19 +682,14 @@ void read_input_xml(MODEL_DATA* modelData,
 
     read_value_string(findHashStringStringNull(*findHashLongVar(mi.rAli,i),"aliasVariable"), &aliasTmp);
 
-    it = findHashStringLongPtr(mapAlias, aliasTmp);
-    itParam = findHashStringLongPtr(mapAliasParam, aliasTmp);
-
-    if (NULL != it) {
-      modelData->realAlias[i].nameID  = *it;
-      modelData->realAlias[i].aliasType = 0;
-    } else if (NULL != itParam) {
-      modelData->realAlias[i].nameID  = *itParam;
-      modelData->realAlias[i].aliasType = 1;
-    } else if (0==strcmp(aliasTmp,"time")) {
-      modelData->realAlias[i].aliasType = 2;
-    } else {
-      throwStreamPrint(NULL, "Real Alias variable %s not found.", aliasTmp);
+    modelData->realAlias[i].nameID = findAliasTarget(modelData, aliasTmp, VAR_NAME_REAL_VAR, VAR_NAME_REAL_PARAM, &modelData->realAlias[i].aliasType);
+    if (-1 == modelData->realAlias[i].nameID) {
+      if (0==strcmp(aliasTmp,"time")) {
+        modelData->realAlias[i].nameID = 0;
+        modelData->realAlias[i].aliasType = 2;
+      } else {
+        throwStreamPrint(NULL, "Real Alias variable %s not found.", aliasTmp);
+      }
     }
     debugStreamPrint(LOG_DEBUG, 0, "read for %s aliasID %d from %s from setup file",
                 modelData->realAlias[i].info.name,
@@ -731,16 +728,8 @@ void read_input_xml(MODEL_DATA* modelData,
     }
     read_value_string(findHashStringString(*findHashLongVar(mi.iAli,i),"aliasVariable"), &aliasTmp);
 
-    it = findHashStringLongPtr(mapAlias, aliasTmp);
-    itParam = findHashStringLongPtr(mapAliasParam, aliasTmp);
-
-    if(NULL != it) {
-      modelData->integerAlias[i].nameID  = *it;
-      modelData->integerAlias[i].aliasType = 0;
-    } else if(NULL != itParam) {
-      modelData->integerAlias[i].nameID  = *itParam;
-      modelData->integerAlias[i].aliasType = 1;
-    } else {
+    modelData->integerAlias[i].nameID = findAliasTarget(modelData, aliasTmp, VAR_NAME_INTEGER_VAR, VAR_NAME_INTEGER_PARAM, &modelData->integerAlias[i].aliasType);
+    if (-1 == modelData->integerAlias[i].nameID) {
       throwStreamPrint(NULL, "Integer Alias variable %s not found.", aliasTmp);
     }
     debugStreamPrint(LOG_DEBUG, 0, "read for %s aliasID %d from %s from setup file",
@@ -780,16 +769,8 @@ void read_input_xml(MODEL_DATA* modelData,
     }
     read_value_string(findHashStringString(*findHashLongVar(mi.bAli,i),"aliasVariable"), &aliasTmp);
 
-    it = findHashStringLongPtr(mapAlias, aliasTmp);
-    itParam = findHashStringLongPtr(mapAliasParam, aliasTmp);
-
-    if (NULL != it) {
-      modelData->booleanAlias[i].nameID  = *it;
-      modelData->booleanAlias[i].aliasType = 0;
-    } else if (NULL != itParam) {
-      modelData->booleanAlias[i].nameID  = *itParam;
-      modelData->booleanAlias[i].aliasType = 1;
-    } else {
+    modelData->booleanAlias[i].nameID = findAliasTarget(modelData, aliasTmp, VAR_NAME_BOOLEAN_VAR, VAR_NAME_BOOLEAN_PARAM, &modelData->booleanAlias[i].aliasType);
+    if (-1 == modelData->booleanAlias[i].nameID) {
       throwStreamPrint(NULL, "Boolean Alias variable %s not found.", aliasTmp);
     }
     debugStreamPrint(LOG_DEBUG, 0, "read for %s aliasID %d from %s from setup file",
@@ -829,16 +810,8 @@ void read_input_xml(MODEL_DATA* modelData,
 
     read_value_string(findHashStringString(*findHashLongVar(mi.sAli,i),"aliasVariable"), &aliasTmp);
 
-    it = findHashStringLongPtr(mapAlias, aliasTmp);
-    itParam = findHashStringLongPtr(mapAliasParam, aliasTmp);
-
-    if (NULL != it) {
-      modelData->stringAlias[i].nameID  = *it;
-      modelData->stringAlias[i].aliasType = 0;
-    } else if (NULL != itParam) {
-      modelData->stringAlias[i].nameID  = *itParam;
-      modelData->stringAlias[i].aliasType = 1;
-    } else {
+    modelData->stringAlias[i].nameID = findAliasTarget(modelData, aliasTmp, VAR_NAME_STRING_VAR, VAR_NAME_STRING_PARAM, &modelData->stringAlias[i].aliasType);
+    if (-1 == modelData->stringAlias[i].nameID) {
       throwStreamPrint(NULL, "String Alias variable %s not found.", aliasTmp);
     }
     debugStreamPrint(LOG_DEBUG, 0, "read for %s aliasID %d from %s from setup file",
@@ -848,6 +821,9 @@ void read_input_xml(MODEL_DATA* modelData,
   }
   messageClose(LOG_DEBUG);
 
+  /* the strings of mi are not needed anymore by the index */
+  useModelVariableNames(modelData);
+
   XML_ParserFree(parser);
 }
 
@@ -926,11 +902,104 @@ static const char* getOverrideValue(omc_CommandLineOverrides *mOverrides, omc_Co
   return findHashStringString(mOverrides, name);
 }
 
+static void overrideVariable(omc_ScalarVariable **v, int warnSmallValue, omc_CommandLineOverrides *mOverrides, omc_CommandLineOverridesUses **mOverridesUses)
+{
+  const char *name = findHashStringString(*v, "name");
+
+  if (0 == strcmp(findHashStringString(*v, "isValueChangeable"), "true")) {
+    const char *value = getOverrideValue(mOverrides, mOverridesUses, name);
+    infoStreamPrint(LOG_SOLVER, 0, "override %s = %s", name, value);
+    if (warnSmallValue && fabs(atof(value)) < 1e-6) {
+      warningStreamPrint(LOG_STDOUT, 0, "You are overriding %s with a small value or zero.\nThis could lead to numerically dirty solutions or divisions by zero if not tearingStrictness=veryStrict.", name);
+    }
+    addHashStringString(v, "start", value);
+  } else {
+    addHashStringLong(mOverridesUses, name, OMC_OVERRIDE_USED);
+    warningStreamPrint(LOG_STDOUT, 0, "It is not possible to override the following quantity: %s\nIt seems to be structural, final, protected or evaluated or has a non-constant binding.", name);
+  }
+}
+
+/* the variable of mi an entry of the variable name index refers to */
+static omc_ScalarVariable** findIndexedVariable(omc_ModelInput *mi, MODEL_DATA *modelData, const VAR_NAME_ENTRY *entry)
+{
+  long i = entry->index;
+
+  switch (entry->kind) {
+  case VAR_NAME_REAL_VAR:
+    if (i < modelData->nStates) {
+      return findHashLongVar(mi->rSta, i);
+    } else if (i < 2*modelData->nStates) {
+      return findHashLongVar(mi->rDer, i - modelData->nStates);
+    }
+    return findHashLongVar(mi->rAlg, i - 2*modelData->nStates);
+  case VAR_NAME_INTEGER_VAR: return findHashLongVar(mi->iAlg, i);
+  case VAR_NAME_BOOLEAN_VAR: return findHashLongVar(mi->bAlg, i);
+  case VAR_NAME_STRING_VAR: return findHashLongVar(mi->sAlg, i);
+  case VAR_NAME_REAL_PARAM: return findHashLongVar(mi->rPar, i);
+  case VAR_NAME_INTEGER_PARAM: return findHashLongVar(mi->iPar, i);
+  case VAR_NAME_BOOLEAN_PARAM: return findHashLongVar(mi->bPar, i);
+  case VAR_NAME_STRING_PARAM: return findHashLongVar(mi->sPar, i);
+  case VAR_NAME_REAL_ALIAS: return findHashLongVar(mi->rAli, i);
+  case VAR_NAME_INTEGER_ALIAS: return findHashLongVar(mi->iAli, i);
+  case VAR_NAME_BOOLEAN_ALIAS: return findHashLongVar(mi->bAli, i);
+  case VAR_NAME_STRING_ALIAS: return findHashLongVar(mi->sAli, i);
+  default:
+    throwStreamPrint(NULL, "simulation_input_xml.c: unknown kind %d in the variable name index", entry->kind);
+  }
+  return NULL;
+}
+
+static void buildVariableNameIndex(omc_ModelInput *mi, MODEL_DATA *modelData)
+{
+  VAR_NAME_INDEX *index = &modelData->variableNameIndex;
+  const long n[VAR_NAME_MAX] = {
+    modelData->nVariablesReal, modelData->nVariablesInteger, modelData->nVariablesBoolean, modelData->nVariablesString,
+    modelData->nParametersReal, modelData->nParametersInteger, modelData->nParametersBoolean, modelData->nParametersString,
+    modelData->nAliasReal, modelData->nAliasInteger, modelData->nAliasBoolean, modelData->nAliasString
+  };
+  VAR_NAME_ENTRY entry;
+  long total = 0;
+
+  for (entry.kind = 0; entry.kind < VAR_NAME_MAX; entry.kind++) {
+    total += n[entry.kind];
+  }
+  initVariableNameIndex(index, total);
+  for (entry.kind = 0; entry.kind < VAR_NAME_MAX; entry.kind++) {
+    for (entry.index = 0; entry.index < n[entry.kind]; entry.index++) {
+      addVariableName(index, findHashStringString(*findIndexedVariable(mi, modelData, &entry), "name"), entry.kind, entry.index);
+    }
+  }
+  sortVariableNameIndex(index);
+}
+
+/* index of the variable or else the parameter an alias refers to, -1 if there is none */
+static long findAliasTarget(MODEL_DATA *modelData, const char *name, int varKind, int paramKind, char *aliasType)
+{
+  long j, count;
+  const VAR_NAME_ENTRY *entry = findVariableName(&modelData->variableNameIndex, name, &count);
+
+  for (j = 0; j < count; j++) {
+    if (varKind == entry[j].kind) {
+      *aliasType = 0;
+      return entry[j].index;
+    }
+  }
+  for (j = 0; j < count; j++) {
+    if (paramKind == entry[j].kind) {
+      *aliasType = 1;
+      return entry[j].index;
+    }
+  }
+  return -1;
+}
+
 void doOverride(omc_ModelInput *mi, MODEL_DATA *modelData, const char *override, const char *overrideFile)
 {
   omc_CommandLineOverrides *mOverrides = NULL;
   omc_CommandLineOverridesUses *mOverridesUses = NULL, *it = NULL, *ittmp = NULL;
+  omc_CommandLineOverrides *override_it = NULL, *override_tmp = NULL;
   mmc_sint_t i;
+  long j, count;
   char* overrideStr = NULL;
   if((override != NULL) && (overrideFile != NULL)) {
     throwStreamPrint(NULL, "simulation_input_xml.c: usage error you cannot have both -override and -overrideFile active at the same time. see Model -? for more info!");
@@ -1025,64 +1094,14 @@ void doOverride(omc_ModelInput *mi, MODEL_DATA *modelData, const char *override,
       }
     }
 
-    #define CHECK_OVERRIDE(v,b) \
-      if (findHashStringStringNull(mOverrides, findHashStringString(*findHashLongVar(mi->v,i),"name"))) { \
-        if (0 == strcmp(findHashStringString(*findHashLongVar(mi->v,i), "isValueChangeable"), "true")){ \
-          infoStreamPrint(LOG_SOLVER, 0, "override %s = %s", findHashStringString(*findHashLongVar(mi->v,i),"name"), getOverrideValue(mOverrides, &mOverridesUses, findHashStringString(*findHashLongVar(mi->v,i),"name"))); \
-          if (b && fabs(atof(getOverrideValue(mOverrides, &mOverridesUses, findHashStringString(*findHashLongVar(mi->v,i),"name")))) < 1e-6) \
-            warningStreamPrint(LOG_STDOUT, 0, "You are overriding %s with a small value or zero.\nThis could lead to numerically dirty solutions or divisions by zero if not tearingStrictness=veryStrict.", findHashStringString(*findHashLongVar(mi->v,i),"name")); \
-          addHashStringString(findHashLongVar(mi->v,i), "start", getOverrideValue(mOverrides, &mOverridesUses, findHashStringString(*findHashLongVar(mi->v,i),"name"))); \
-        } \
-        else{ \
-          addHashStringLong(&mOverridesUses, findHashStringString(*findHashLongVar(mi->v,i),"name"), OMC_OVERRIDE_USED); \
-          warningStreamPrint(LOG_STDOUT, 0, "It is not possible to override the following quantity: %s\nIt seems to be structural, final, protected or evaluated or has a non-constant binding.", findHashStringString(*findHashLongVar(mi->v,i),"name")); \
-        } \
+    // override all found, each name is looked up in the variable name index
+    HASH_ITER(hh, mOverrides, override_it, override_tmp) {
+      const VAR_NAME_ENTRY *entry = findVariableName(&modelData->variableNameIndex, override_it->id, &count);
+      for (j = 0; j < count; j++) {
+        // TODO: only allow to override primary parameters
+        int warnSmallValue = VAR_NAME_REAL_PARAM == entry[j].kind || VAR_NAME_INTEGER_PARAM == entry[j].kind;
+        overrideVariable(findIndexedVariable(mi, modelData, &entry[j]), warnSmallValue, mOverrides, &mOverridesUses);
       }
-
-    // override all found!
-    for(i=0; i<modelData->nStates; i++) {
-      CHECK_OVERRIDE(rSta,0);
-      CHECK_OVERRIDE(rDer,0);
-    }
-    for(i=0; i<(modelData->nVariablesReal - 2*modelData->nStates); i++) {
-      CHECK_OVERRIDE(rAlg,0);
-    }
-    for(i=0; i<modelData->nVariablesInteger; i++) {
-      CHECK_OVERRIDE(iAlg,0);
-    }
-    for(i=0; i<modelData->nVariablesBoolean; i++) {
-      CHECK_OVERRIDE(bAlg,0);
-    }
-    for(i=0; i<modelData->nVariablesString; i++) {
-      CHECK_OVERRIDE(sAlg,0);
-    }
-    for(i=0; i<modelData->nParametersReal; i++) {
-      // TODO: only allow to override primary parameters
-      CHECK_OVERRIDE(rPar,1);
-    }
-    for(i=0; i<modelData->nParametersInteger; i++) {
-      // TODO: only allow to override primary parameters
-      CHECK_OVERRIDE(iPar,1);
-    }
-    for(i=0; i<modelData->nParametersBoolean; i++) {
-      // TODO: only allow to override primary parameters
-      CHECK_OVERRIDE(bPar,0);
-    }
-    for(i=0; i<modelData->nParametersString; i++) {
-      // TODO: only allow to override primary parameters
-      CHECK_OVERRIDE(sPar,0);
-    }
-    for(i=0; i<modelData->nAliasReal; i++) {
-      CHECK_OVERRIDE(rAli,0);
-    }
-    for(i=0; i<modelData->nAliasInteger; i++) {
-      CHECK_OVERRIDE(iAli,0);
-    }
-    for(i=0; i<modelData->nAliasBoolean; i++) {
-      CHECK_OVERRIDE(bAli,0);
-    }
-    for(i=0; i<modelData->nAliasString; i++) {
-      CHECK_OVERRIDE(sAli,0);
     }
 
     // give a warning if an override is not used #3204
@@ -46,9 +46,6 @@
 #include <fstream>
 #include <stdarg.h>
 
-#ifndef _MSC_VER
-  #include <regex.h>
-#endif
 
 
 /* ppriv - NO_INTERACTIVE_DEPENDENCY - for simpler debugging in Visual Studio
@@ -56,6 +53,7 @@
  */
 #ifndef NO_INTERACTIVE_DEPENDENCY
   #include "socket.h"
+  #include <pthread.h>
   extern Socket sim_communication_port;
 #endif
 
@@ -68,11 +66,13 @@
 #include "options.h"
 #include "simulation_runtime.h"
 #include "simulation_input_xml.h"
+#include "variable_name_index.h"
 #include "simulation/results/simulation_result_plt.h"
 #include "simulation/results/simulation_result_csv.h"
 #include "simulation/results/simulation_result_mat4.h"
 #include "simulation/results/simulation_result_wall.h"
 #include "simulation/results/simulation_result_ia.h"
+#include "simulation/results/simulation_result_shm.h"
 #include "simulation/solver/solver_main.h"
 #include "simulation_info_json.h"
 #include "modelinfo.h"
@@ -82,6 +82,8 @@
 #include "simulation/solver/linearSystem.h"
 #include "simulation/solver/nonlinearSystem.h"
 #include "util/rtclock.h"
+#include "util/rtprofile.h"
+#include "util/omc_binlog.h"
 #include "omc_config.h"
 #include "simulation/solver/initialization/initialization.h"
 #include "simulation/solver/dae_mode.h"
@@ -97,10 +99,16 @@ using namespace std;
   Socket sim_communication_port;
   static int sim_communication_port_open = 0;
   static int isXMLTCP=0;
+  static int isBinTCP=0;
 #endif
 
 extern "C" {
 
+#ifndef NO_INTERACTIVE_DEPENDENCY
+static void startBinTCPFlusher();
+static void closeBinTCP();
+#endif
+
 int sim_noemit = 0;           /* Flag for not emitting data */
 
 const std::string *init_method = NULL; /* method for  initialization. */
@@ -262,97 +270,78 @@ static double getFlagReal(enum _FLAG flag, double res)
   return res;
 }
 
+static DATA_ALIAS* aliasData(MODEL_DATA *modelData, const VAR_NAME_ENTRY *entry)
+{
+  switch(entry->kind) {
+  case VAR_NAME_REAL_ALIAS: return &modelData->realAlias[entry->index];
+  case VAR_NAME_INTEGER_ALIAS: return &modelData->integerAlias[entry->index];
+  case VAR_NAME_BOOLEAN_ALIAS: return &modelData->booleanAlias[entry->index];
+  default: return &modelData->stringAlias[entry->index];
+  }
+}
+
 /**
  * Read the variable filter and mark variables that should not be part of the result file.
  * This phase is skipped for interactive simulations
  */
 void initializeOutputFilter(MODEL_DATA *modelData, const char *variableFilter, int resultFormatHasCheapAliasesAndParameters)
 {
-#ifndef _MSC_VER
-  regex_t myregex;
-  int flags = REG_EXTENDED;
-  int rc;
-  string tmp = ("^(" + string(variableFilter) + ")$");
-  const char *filter = tmp.c_str(); // C++ strings are horrible to work with...
-
-  if(0 == strcmp(filter, ".*")) { // This matches all variables, so we don't need to do anything
+  const VAR_NAME_INDEX *index;
+  long *matches = NULL;
+  long nMatches, i;
+  char *candidate;
+
+  if(0 == strcmp(variableFilter, ".*")) { // This matches all variables, so we don't need to do anything
     return;
   }
 
-  rc = regcomp(&myregex, filter, flags);
-  if(rc) {
-    char err_buf[2048] = {0};
-    regerror(rc, &myregex, err_buf, 2048);
-    std::cerr << "Failed to compile regular expression: " << filter << " with error: " << err_buf << ". Defaulting to outputting all variables." << std::endl;
+  /* the filter is compiled to the positions of the matching names in the index */
+  index = getVariableNameIndex(modelData);
+  nMatches = filterVariableNames(index, variableFilter, &matches);
+  if(nMatches < 0) {
     return;
   }
 
-  for(mmc_sint_t i=0; i<modelData->nVariablesReal; i++) if(!modelData->realVarsData[i].filterOutput) {
-    modelData->realVarsData[i].filterOutput = regexec(&myregex, modelData->realVarsData[i].info.name, 0, NULL, 0) != 0;
-  }
-  for(mmc_sint_t i=0; i<modelData->nAliasReal; i++) if(!modelData->realAlias[i].filterOutput) {
-    if(modelData->realAlias[i].aliasType == 0)  /* variable */ {
-      modelData->realAlias[i].filterOutput = regexec(&myregex, modelData->realAlias[i].info.name, 0, NULL, 0) != 0;
-      if (0 == modelData->realAlias[i].filterOutput) {
-        modelData->realVarsData[modelData->realAlias[i].nameID].filterOutput = 0;
-      }
-    } else if(modelData->realAlias[i].aliasType == 1)  /* parameter */ {
-      modelData->realAlias[i].filterOutput = regexec(&myregex, modelData->realAlias[i].info.name, 0, NULL, 0) != 0;
-      if (0 == modelData->realAlias[i].filterOutput && resultFormatHasCheapAliasesAndParameters) {
-        modelData->realParameterData[modelData->realAlias[i].nameID].filterOutput = 0;
-      }
+  /* variables and aliases that are not filtered yet are filtered unless they match; parameters are kept */
+  candidate = (char*) calloc(index->n > 0 ? index->n : 1, sizeof(char));
+  for(i=0; i<index->n; i++) {
+    const VAR_NAME_ENTRY *entry = &index->entries[i];
+    modelica_boolean *filterOutput = variableNameFilterOutput(modelData, entry);
+    if(entry->kind >= VAR_NAME_REAL_PARAM && entry->kind <= VAR_NAME_STRING_PARAM) {
+      continue;
     }
-  }
-  for (mmc_sint_t i=0; i<modelData->nVariablesInteger; i++) if(!modelData->integerVarsData[i].filterOutput) {
-    modelData->integerVarsData[i].filterOutput = regexec(&myregex, modelData->integerVarsData[i].info.name, 0, NULL, 0) != 0;
-  }
-  for (mmc_sint_t i=0; i<modelData->nAliasInteger; i++) if(!modelData->integerAlias[i].filterOutput) {
-    if(modelData->integerAlias[i].aliasType == 0)  /* variable */ {
-      modelData->integerAlias[i].filterOutput = regexec(&myregex, modelData->integerAlias[i].info.name, 0, NULL, 0) != 0;
-      if (0 == modelData->integerAlias[i].filterOutput) {
-        modelData->integerVarsData[modelData->integerAlias[i].nameID].filterOutput = 0;
-      }
-    } else if(modelData->integerAlias[i].aliasType == 1)  /* parameter */ {
-      modelData->integerAlias[i].filterOutput = regexec(&myregex, modelData->integerAlias[i].info.name, 0, NULL, 0) != 0;
-      if (0 == modelData->integerAlias[i].filterOutput && resultFormatHasCheapAliasesAndParameters) {
-        modelData->integerParameterData[modelData->integerAlias[i].nameID].filterOutput = 0;
-      }
+    if(entry->kind >= VAR_NAME_REAL_ALIAS && aliasData(modelData, entry)->aliasType > 1) {
+      continue;
     }
-  }
-  for (mmc_sint_t i=0; i<modelData->nVariablesBoolean; i++) if(!modelData->booleanVarsData[i].filterOutput) {
-    modelData->booleanVarsData[i].filterOutput = regexec(&myregex, modelData->booleanVarsData[i].info.name, 0, NULL, 0) != 0;
-  }
-  for (mmc_sint_t i=0; i<modelData->nAliasBoolean; i++) if(!modelData->booleanAlias[i].filterOutput) {
-    if(modelData->booleanAlias[i].aliasType == 0)  /* variable */ {
-      modelData->booleanAlias[i].filterOutput = regexec(&myregex, modelData->booleanAlias[i].info.name, 0, NULL, 0) != 0;
-      if (0 == modelData->booleanAlias[i].filterOutput) {
-        modelData->booleanVarsData[modelData->booleanAlias[i].nameID].filterOutput = 0;
-      }
-    } else if(modelData->booleanAlias[i].aliasType == 1)  /* parameter */ {
-      modelData->booleanAlias[i].filterOutput = regexec(&myregex, modelData->booleanAlias[i].info.name, 0, NULL, 0) != 0;
-      if (0 == modelData->booleanAlias[i].filterOutput && resultFormatHasCheapAliasesAndParameters) {
-        modelData->booleanParameterData[modelData->booleanAlias[i].nameID].filterOutput = 0;
-      }
+    if(!*filterOutput) {
+      *filterOutput = 1;
+      candidate[i] = 1;
     }
   }
-  for (mmc_sint_t i=0; i<modelData->nVariablesString; i++) if(!modelData->stringVarsData[i].filterOutput) {
-    modelData->stringVarsData[i].filterOutput = regexec(&myregex, modelData->stringVarsData[i].info.name, 0, NULL, 0) != 0;
-  }
-  for (mmc_sint_t i=0; i<modelData->nAliasString; i++) if(!modelData->stringAlias[i].filterOutput) {
-    if(modelData->stringAlias[i].aliasType == 0)  /* variable */ {
-      modelData->stringAlias[i].filterOutput = regexec(&myregex, modelData->stringAlias[i].info.name, 0, NULL, 0) != 0;
-      if (0 == modelData->stringAlias[i].filterOutput) {
-        modelData->stringVarsData[modelData->stringAlias[i].nameID].filterOutput = 0;
-      }
-    } else if(modelData->stringAlias[i].aliasType == 1)  /* parameter */ {
-      modelData->stringAlias[i].filterOutput = regexec(&myregex, modelData->stringAlias[i].info.name, 0, NULL, 0) != 0;
-      if (0 == modelData->stringAlias[i].filterOutput && resultFormatHasCheapAliasesAndParameters) {
-        modelData->stringParameterData[modelData->stringAlias[i].nameID].filterOutput = 0;
+
+  for(i=0; i<nMatches; i++) {
+    const VAR_NAME_ENTRY *entry = &index->entries[matches[i]];
+    if(!candidate[matches[i]]) {
+      continue;
+    }
+    *variableNameFilterOutput(modelData, entry) = 0;
+    if(entry->kind >= VAR_NAME_REAL_ALIAS) {
+      /* the aliased variable has to be stored as well */
+      DATA_ALIAS *alias = aliasData(modelData, entry);
+      VAR_NAME_ENTRY target;
+      target.index = alias->nameID;
+      if(alias->aliasType == 0) {
+        target.kind = entry->kind - VAR_NAME_REAL_ALIAS + VAR_NAME_REAL_VAR;
+        *variableNameFilterOutput(modelData, &target) = 0;
+      } else if(resultFormatHasCheapAliasesAndParameters) {
+        target.kind = entry->kind - VAR_NAME_REAL_ALIAS + VAR_NAME_REAL_PARAM;
+        *variableNameFilterOutput(modelData, &target) = 0;
       }
     }
   }
-  regfree(&myregex);
-#endif
+
+  free(candidate);
+  free(matches);
   return;
 }
 
@@ -399,8 +388,10 @@ int startNonInteractiveSimulation(int argc, char**argv, DATA* data, threadData_t
         clock = OMC_CLOCK_REALTIME;
       } else if(0 == strcmp(clockName, "CYC")) {
         clock = OMC_CPU_CYCLES;
+      } else if(0 == strcmp(clockName, "TSC")) {
+        clock = OMC_CLOCK_TSC;
       } else {
-        warningStreamPrint(LOG_STDOUT, 0, "[unknown clock-type] got %s, expected CPU|RT|CYC. Defaulting to RT.", clockName);
+        warningStreamPrint(LOG_STDOUT, 0, "[unknown clock-type] got %s, expected CPU|RT|CYC|TSC. Defaulting to RT.", clockName);
       }
     }
     if(rt_set_clock(clock)) {
@@ -416,6 +407,12 @@ int startNonInteractiveSimulation(int argc, char**argv, DATA* data, threadData_t
     rt_init(SIM_TIMER_FIRST_FUNCTION + data->modelData->modelDataXml.nFunctions + data->modelData->modelDataXml.nEquations + data->modelData->modelDataXml.nProfileBlocks + 4 /* sentinel */);
     rt_measure_overhead(SIM_TIMER_TOTAL);
     rt_clear(SIM_TIMER_TOTAL);
+    if (rt_get_clock() == OMC_CLOCK_TSC) {
+      rt_profile_init(SIM_TIMER_FIRST_FUNCTION + data->modelData->modelDataXml.nFunctions + data->modelData->modelDataXml.nEquations + data->modelData->modelDataXml.nProfileBlocks + 4,
+        SIM_TIMER_FIRST_FUNCTION,
+        omc_flag[FLAG_PROFILE_SAMPLING] ? atoi(omc_flagValue[FLAG_PROFILE_SAMPLING]) : 1,
+        omc_flag[FLAG_PROFILE_TRACE] ? atoi(omc_flagValue[FLAG_PROFILE_TRACE]) : 0);
+    }
     rt_tick(SIM_TIMER_TOTAL);
     rt_clear(SIM_TIMER_PREINIT);
     rt_tick(SIM_TIMER_PREINIT);
@@ -550,7 +547,9 @@ int startNonInteractiveSimulation(int argc, char**argv, DATA* data, threadData_t
     retVal = printModelInfo(data, threadData, output_path.c_str(), modelInfo.c_str(), plotFile.c_str(), plotFormat ? plotFormat : "svg",
         data->simulationInfo->solverMethod, data->simulationInfo->outputFormat, data->modelData->resultFileName) && retVal;
     retVal = printModelInfoJSON(data, threadData, output_path.c_str(), jsonInfo.c_str(), data->modelData->resultFileName) && retVal;
+    retVal = printProfilingStatistics(data, output_path.c_str(), omc_flag[FLAG_PROFILE_TRACE]) && retVal;
   }
+  rt_profile_free();
 
   TRACE_POP
   return retVal;
@@ -611,6 +610,12 @@ int initializeResultData(DATA* simData, threadData_t *threadData, int cpuTime)
   initializeOutputFilter(simData->modelData, simData->simulationInfo->variableFilter, resultFormatHasCheapAliasesAndParameters);
   sim_result.init(&sim_result, simData, threadData);
   infoStreamPrint(LOG_SOLVER, 0, "Allocated simulation result data storage for method '%s' and file='%s'", (char*) simData->simulationInfo->outputFormat, sim_result.filename);
+#if !defined(OMC_MINIMAL_RUNTIME)
+  if (omc_flag[FLAG_SHM_STREAM]) {
+    shm_stream_attach(&sim_result, simData, threadData, omc_flagValue[FLAG_SHM_STREAM],
+      omc_flag[FLAG_SHM_STREAM_SIZE] ? atoi(omc_flagValue[FLAG_SHM_STREAM_SIZE]) : 1024);
+  }
+#endif
   return 0;
 }
 
@@ -818,6 +823,17 @@ int initRuntimeAndSimulation(int argc, char**argv, DATA *data, threadData_t *thr
     EXIT(0);
   }
 
+  if(omc_flag[FLAG_DECODE_LOG]) {
+    EXIT(omc_binlog_decode(omc_flagValue[FLAG_DECODE_LOG]));
+  }
+
+  if(omc_flag[FLAG_LOG_FORMAT] && 0 == strcmp(omc_flagValue[FLAG_LOG_FORMAT], "binary")) {
+    std::string logFile = std::string(data->modelData->modelFilePrefix) + "_log.bin";
+    if(omc_binlog_open(logFile.c_str())) {
+      warningStreamPrint(LOG_STDOUT, 0, "could not open %s, using -logFormat=text", logFile.c_str());
+    }
+  }
+
   setGlobalVerboseLevel(argc, argv);
   initializeDataStruc(data, threadData);
   if(!data)
@@ -964,6 +980,13 @@ int initRuntimeAndSimulation(int argc, char**argv, DATA *data, threadData_t *thr
     errorStreamPrint(LOG_STDOUT, 0, "xmltcp log format requires a TCP-port to be passed (and successfully open)");
     EXIT(1);
   }
+  if (isBinTCP && !sim_communication_port_open) {
+    errorStreamPrint(LOG_STDOUT, 0, "bintcp log format requires a TCP-port to be passed (and successfully open)");
+    EXIT(1);
+  }
+  if (isBinTCP) {
+    startBinTCPFlusher();
+  }
 #endif
   // ppriv - NO_INTERACTIVE_DEPENDENCY - for simpler debugging in Visual Studio
 
@@ -1039,6 +1062,7 @@ int _main_SimulationRuntime(int argc, char**argv, DATA *data, threadData_t *thre
 #ifndef NO_INTERACTIVE_DEPENDENCY
   if(sim_communication_port_open)
   {
+    closeBinTCP();
     sim_communication_port.close();
   }
 #endif
@@ -1138,6 +1162,195 @@ static void messageCloseXMLTCPWarning(int stream)
     sendXMLTCPIfClosed();
   }
 }
+
+/* -logFormat=bintcp
+ * The records are collected in batches that are sent as frames of a uint32
+ * payload length followed by the records. All numbers are little endian.
+ *   message:     uint8 1, stream (uint8 length, chars), type (uint8 length, chars),
+ *                uint8 indentNext, text (uint32 length, chars), uint32 number of
+ *                indexes, int32 indexes
+ *   message end: uint8 2
+ *   status:      uint8 3, int32 progress (0 to 10000), double time,
+ *                double step size, phase (uint8 length, chars)
+ * A batch is sent if it is large, older than BINTCP_FLUSH_INTERVAL seconds,
+ * or ends with an error or with the final status. A status record that is
+ * still the last record of the batch is replaced by the next status. Records may come from
+ * several threads, so the batch is guarded by binTcpMutex; a flusher thread
+ * sends a due batch even if no further record arrives.
+ */
+enum BINTCP_RECORD {
+  BINTCP_MESSAGE = 1,
+  BINTCP_MESSAGE_END,
+  BINTCP_STATUS
+};
+
+#define BINTCP_FLUSH_SIZE 65536
+#define BINTCP_FLUSH_INTERVAL 0.1
+
+static std::string binTcpBuffer;
+static rtclock_t binTcpClock;
+static size_t binTcpLastStatus = std::string::npos;  /* position of a status record that is the last record of the batch */
+static pthread_mutex_t binTcpMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t binTcpFlusher;
+static volatile int binTcpFlusherRunning = 0;
+
+static void putBinTCPUInt(unsigned int value, int bytes)
+{
+  for (int i = 0; i < bytes; i++) {
+    binTcpBuffer += (char)((value >> (8*i)) & 0xff);
+  }
+}
+
+static void putBinTCPDouble(double value)
+{
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(double));
+  putBinTCPUInt((unsigned int)(bits & 0xffffffff), 4);
+  putBinTCPUInt((unsigned int)(bits >> 32), 4);
+}
+
+static void putBinTCPString(const char *str, int lengthBytes)
+{
+  size_t len = strlen(str);
+  if (lengthBytes == 1 && len > 255) {
+    len = 255;
+  }
+  putBinTCPUInt((unsigned int)len, lengthBytes);
+  binTcpBuffer.append(str, len);
+}
+
+/* binTcpMutex has to be held */
+static void flushBinTCP()
+{
+  if (!binTcpBuffer.empty()) {
+    std::string frame;
+    frame.reserve(4 + binTcpBuffer.size());
+    binTcpBuffer.swap(frame);
+    putBinTCPUInt((unsigned int)frame.size(), 4);
+    binTcpBuffer.append(frame);
+    sim_communication_port.sendBytes(&binTcpBuffer[0], (int)binTcpBuffer.size());
+    binTcpBuffer.clear();
+  }
+  binTcpLastStatus = std::string::npos;
+  rt_ext_tp_tick(&binTcpClock);
+}
+
+/* binTcpMutex has to be held */
+static inline void sendBinTCPIfDue(int urgent)
+{
+  if (urgent || binTcpBuffer.size() >= BINTCP_FLUSH_SIZE || rt_ext_tp_tock(&binTcpClock) >= BINTCP_FLUSH_INTERVAL) {
+    flushBinTCP();
+  }
+}
+
+static void binTcpSleep(double seconds)
+{
+#if defined(__MINGW32__) || defined(_MSC_VER)
+  Sleep((DWORD)(seconds * 1000));
+#else
+  struct timespec ts;
+  ts.tv_sec = (time_t)seconds;
+  ts.tv_nsec = (long)((seconds - ts.tv_sec) * 1e9);
+  nanosleep(&ts, NULL);
+#endif
+}
+
+static void* binTcpFlushThread(void *arg)
+{
+  while (binTcpFlusherRunning) {
+    binTcpSleep(BINTCP_FLUSH_INTERVAL);
+    pthread_mutex_lock(&binTcpMutex);
+    if (!binTcpBuffer.empty()) {
+      sendBinTCPIfDue(0);
+    }
+    pthread_mutex_unlock(&binTcpMutex);
+  }
+  return NULL;
+}
+
+static void startBinTCPFlusher()
+{
+  binTcpFlusherRunning = 1;
+  if (pthread_create(&binTcpFlusher, NULL, binTcpFlushThread, NULL)) {
+    /* the batches are still sent with the next record */
+    binTcpFlusherRunning = 0;
+  }
+}
+
+/* stops the flusher and sends the rest of the batch */
+static void closeBinTCP()
+{
+  if (binTcpFlusherRunning) {
+    binTcpFlusherRunning = 0;
+    pthread_join(binTcpFlusher, NULL);
+  }
+  pthread_mutex_lock(&binTcpMutex);
+  flushBinTCP();
+  pthread_mutex_unlock(&binTcpMutex);
+}
+
+static void messageBinTCP(int type, int stream, int indentNext, char *msg, int subline, const int *indexes)
+{
+  pthread_mutex_lock(&binTcpMutex);
+  /* the pending status is followed by this record and must be kept */
+  binTcpLastStatus = std::string::npos;
+  putBinTCPUInt(BINTCP_MESSAGE, 1);
+  putBinTCPString(LOG_STREAM_NAME[stream], 1);
+  putBinTCPString(LOG_TYPE_DESC[type], 1);
+  putBinTCPUInt(indentNext ? 1 : 0, 1);
+  putBinTCPString(msg, 4);
+  if (indexes) {
+    putBinTCPUInt(*indexes, 4);
+    for (int i=1; i<=*indexes; i++) {
+      putBinTCPUInt((unsigned int)indexes[i], 4);
+    }
+  } else {
+    putBinTCPUInt(0, 4);
+  }
+  /* errors are sent at once, the simulation might stop */
+  sendBinTCPIfDue(type == LOG_TYPE_ERROR || type == LOG_TYPE_ASSERT);
+  pthread_mutex_unlock(&binTcpMutex);
+}
+
+static void messageCloseBinTCP(int stream)
+{
+  if (ACTIVE_STREAM(stream)) {
+    pthread_mutex_lock(&binTcpMutex);
+    binTcpLastStatus = std::string::npos;
+    putBinTCPUInt(BINTCP_MESSAGE_END, 1);
+    sendBinTCPIfDue(0);
+    pthread_mutex_unlock(&binTcpMutex);
+  }
+}
+
+static void messageCloseBinTCPWarning(int stream)
+{
+  if (ACTIVE_WARNING_STREAM(stream)) {
+    pthread_mutex_lock(&binTcpMutex);
+    binTcpLastStatus = std::string::npos;
+    putBinTCPUInt(BINTCP_MESSAGE_END, 1);
+    sendBinTCPIfDue(0);
+    pthread_mutex_unlock(&binTcpMutex);
+  }
+}
+
+static void statusBinTCP(const char *phase, double completionPercent, double currentTime, double currentStepSize)
+{
+  pthread_mutex_lock(&binTcpMutex);
+  /* only the latest progress of a batch is of interest, a status directly
+   * before this one is replaced */
+  if (binTcpLastStatus != std::string::npos) {
+    binTcpBuffer.resize(binTcpLastStatus);
+  }
+  binTcpLastStatus = binTcpBuffer.size();
+  putBinTCPUInt(BINTCP_STATUS, 1);
+  putBinTCPUInt((unsigned int)(int)(completionPercent*10000), 4);
+  putBinTCPDouble(currentTime);
+  putBinTCPDouble(currentStepSize);
+  putBinTCPString(phase, 1);
+  sendBinTCPIfDue(0 == strcmp(phase, "Finished"));
+  pthread_mutex_unlock(&binTcpMutex);
+}
 #endif
 
 static void printEscapedXML(const char *msg)
@@ -1199,6 +1412,12 @@ void setStreamPrintXML(int isXML)
     messageClose = messageCloseXMLTCP;
     messageCloseWarning = messageCloseXMLTCPWarning;
     isXMLTCP = 1;
+  } else if (isXML==3) {
+    messageFunction = messageBinTCP;
+    messageClose = messageCloseBinTCP;
+    messageCloseWarning = messageCloseBinTCPWarning;
+    isBinTCP = 1;
+    rt_ext_tp_tick(&binTcpClock);
 #endif
   } else {
     /* Already set... */
@@ -1208,7 +1427,9 @@ void setStreamPrintXML(int isXML)
 void communicateStatus(const char *phase, double completionPercent /*0.0 to 1.0*/, double currentTime, double currentStepSize)
 {
 #ifndef NO_INTERACTIVE_DEPENDENCY
-  if (sim_communication_port_open && isXMLTCP) {
+  if (sim_communication_port_open && isBinTCP) {
+    statusBinTCP(phase, completionPercent, currentTime, currentStepSize);
+  } else if (sim_communication_port_open && isXMLTCP) {
     std::stringstream s;
     s << "<status phase=\"" << phase << "\" currentStepSize=\"" << currentStepSize << "\" time=\"" << currentTime << "\" progress=\"" << (int)(completionPercent*10000) << "\" />" << std::endl;
     std::string str(s.str());
@@ -0,0 +1,327 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2014, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/*! \file ensemble.c
+ *
+ *  Ensemble mode, a batch runner for variants of a model.
+ *
+ *  Every row of the ensemble file describes one member, a variant of the
+ *  model with other parameter or start values. After the model itself has
+ *  finished, the members are initialized and simulated one after another
+ *  with the standard solver loop, reusing the DATA of the model. Each member
+ *  therefore handles its own events, samples and discrete variables, but the
+ *  cost is the same as for separate runs; only the translation and the
+ *  process start are shared. The states of all members are written to
+ *  <model>_ensemble.csv.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "ensemble.h"
+#include "model_help.h"
+#include "openmodelica_func.h"
+#include "simulation/options.h"
+#include "simulation/results/simulation_result.h"
+#include "util/omc_error.h"
+#include "util/read_csv.h"
+#include "meta/meta_modelica.h"
+
+enum ENSEMBLE_COLUMN_KIND
+{
+  ENS_COLUMN_UNKNOWN = 0,
+  ENS_COLUMN_REAL_PARAMETER,
+  ENS_COLUMN_INTEGER_PARAMETER,
+  ENS_COLUMN_BOOLEAN_PARAMETER,
+  ENS_COLUMN_STATE
+};
+
+/* maps the columns of the ensemble file to parameters or states */
+static void findColumns(DATA* data, ENSEMBLE_DATA* ens, struct csv_data *csv)
+{
+  MODEL_DATA *mData = data->modelData;
+  int j;
+  long i;
+
+  for(j=0; j<ens->nColumns; ++j)
+  {
+    const char *name = csv->variables[j];
+    ens->columnKind[j] = ENS_COLUMN_UNKNOWN;
+    for(i=0; i<mData->nParametersReal && !ens->columnKind[j]; ++i)
+    {
+      if(0 == strcmp(name, mData->realParameterData[i].info.name))
+      {
+        ens->columnKind[j] = ENS_COLUMN_REAL_PARAMETER;
+        ens->columnIndex[j] = i;
+        ens->startSave[j] = mData->realParameterData[i].attribute.start;
+      }
+    }
+    for(i=0; i<mData->nParametersInteger && !ens->columnKind[j]; ++i)
+    {
+      if(0 == strcmp(name, mData->integerParameterData[i].info.name))
+      {
+        ens->columnKind[j] = ENS_COLUMN_INTEGER_PARAMETER;
+        ens->columnIndex[j] = i;
+        ens->startSave[j] = mData->integerParameterData[i].attribute.start;
+      }
+    }
+    for(i=0; i<mData->nParametersBoolean && !ens->columnKind[j]; ++i)
+    {
+      if(0 == strcmp(name, mData->booleanParameterData[i].info.name))
+      {
+        ens->columnKind[j] = ENS_COLUMN_BOOLEAN_PARAMETER;
+        ens->columnIndex[j] = i;
+        ens->startSave[j] = mData->booleanParameterData[i].attribute.start;
+      }
+    }
+    for(i=0; i<mData->nStates && !ens->columnKind[j]; ++i)
+    {
+      if(0 == strcmp(name, mData->realVarsData[i].info.name))
+      {
+        ens->columnKind[j] = ENS_COLUMN_STATE;
+        ens->columnIndex[j] = i;
+        ens->startSave[j] = mData->realVarsData[i].attribute.start;
+      }
+    }
+    if(!ens->columnKind[j])
+    {
+      warningStreamPrint(LOG_STDOUT, 0, "Ensemble: %s is neither a parameter nor a state, the column is ignored.", name);
+    }
+  }
+}
+
+/* sets the start values of member m, or the ones of the leader if m < 0 */
+static void setStartValues(DATA* data, ENSEMBLE_DATA* ens, int m)
+{
+  MODEL_DATA *mData = data->modelData;
+  int j;
+
+  for(j=0; j<ens->nColumns; ++j)
+  {
+    double value = m < 0 ? ens->startSave[j] : ens->values[m*ens->nColumns+j];
+    switch(ens->columnKind[j])
+    {
+    case ENS_COLUMN_REAL_PARAMETER:
+      mData->realParameterData[ens->columnIndex[j]].attribute.start = value;
+      break;
+    case ENS_COLUMN_INTEGER_PARAMETER:
+      mData->integerParameterData[ens->columnIndex[j]].attribute.start = (modelica_integer) value;
+      break;
+    case ENS_COLUMN_BOOLEAN_PARAMETER:
+      mData->booleanParameterData[ens->columnIndex[j]].attribute.start = value != 0.0;
+      break;
+    case ENS_COLUMN_STATE:
+      mData->realVarsData[ens->columnIndex[j]].attribute.start = value;
+      break;
+    }
+  }
+}
+
+static void writeHeader(DATA* data, ENSEMBLE_DATA* ens)
+{
+  long i;
+
+  fputs("\"time\",\"member\"", ens->fout);
+  for(i=0; i<ens->nStates; ++i)
+  {
+    fprintf(ens->fout, ",\"%s\"", data->modelData->realVarsData[i].info.name);
+  }
+  fputc('\n', ens->fout);
+}
+
+/*! \fn allocateEnsemble
+ *
+ *  Reads the ensemble file and opens the ensemble result.
+ *
+ *  \return NULL if the ensemble could not be set up
+ */
+ENSEMBLE_DATA* allocateEnsemble(DATA* data, SOLVER_INFO* solverInfo, const char* filename)
+{
+  MODEL_DATA *mData = data->modelData;
+  ENSEMBLE_DATA* ens;
+  struct csv_data *csv;
+  const char *outputName;
+  int j, m, K;
+
+  if(solverInfo->solverMethod == S_QSS || solverInfo->solverMethod == S_OPTIMIZATION)
+  {
+    warningStreamPrint(LOG_STDOUT, 0, "Ensemble simulation is not supported by the solver %s, the flag -%s is ignored.", SOLVER_METHOD_NAME[solverInfo->solverMethod], FLAG_NAME[FLAG_ENSEMBLE]);
+    return NULL;
+  }
+  if(compiledInDAEMode || mData->nDelayExpressions > 0)
+  {
+    warningStreamPrint(LOG_STDOUT, 0, "Ensemble simulation is not supported for models in DAE mode or with delay expressions, the flag -%s is ignored.", FLAG_NAME[FLAG_ENSEMBLE]);
+    return NULL;
+  }
+
+  csv = read_csv(filename);
+  if(!csv)
+  {
+    warningStreamPrint(LOG_STDOUT, 0, "Ensemble: failed to read %s.", filename);
+    return NULL;
+  }
+  if(csv->numsteps < 1 || csv->numvars < 1)
+  {
+    warningStreamPrint(LOG_STDOUT, 0, "Ensemble: %s does not contain any members.", filename);
+    omc_free_csv_reader(csv);
+    return NULL;
+  }
+
+  ens = (ENSEMBLE_DATA*) calloc(1, sizeof(ENSEMBLE_DATA));
+  ens->nMembers = K = csv->numsteps;
+  ens->nStates = mData->nStates;
+  ens->nColumns = csv->numvars;
+  ens->columnKind = (int*) malloc(ens->nColumns*sizeof(int));
+  ens->columnIndex = (long*) malloc(ens->nColumns*sizeof(long));
+  ens->startSave = (double*) malloc(ens->nColumns*sizeof(double));
+  ens->values = (double*) malloc(K*ens->nColumns*sizeof(double));
+  for(m=0; m<K; ++m)
+  {
+    for(j=0; j<ens->nColumns; ++j)
+    {
+      ens->values[m*ens->nColumns+j] = csv->data[j*csv->numsteps+m];
+    }
+  }
+  findColumns(data, ens, csv);
+  omc_free_csv_reader(csv);
+
+  ens->stopTime = data->simulationInfo->stopTime;
+  ens->emitMember = -1;
+
+  if (omc_flag[FLAG_OUTPUT_PATH]) {
+    GC_asprintf(&outputName, "%s/%s_ensemble.csv", omc_flagValue[FLAG_OUTPUT_PATH], mData->modelFilePrefix);
+  } else {
+    GC_asprintf(&outputName, "%s_ensemble.csv", mData->modelFilePrefix);
+  }
+  ens->fout = fopen(outputName, "w");
+  if(!ens->fout)
+  {
+    warningStreamPrint(LOG_STDOUT, 0, "Ensemble: failed to open %s for writing.", outputName);
+    freeEnsemble(ens);
+    return NULL;
+  }
+  writeHeader(data, ens);
+
+  infoStreamPrint(LOG_SOLVER, 0, "Ensemble with %d members, results are written to %s", K, outputName);
+  return ens;
+}
+
+void freeEnsemble(ENSEMBLE_DATA* ens)
+{
+  if(!ens)
+    return;
+  if(ens->fout)
+    fclose(ens->fout);
+  free(ens->columnKind);
+  free(ens->columnIndex);
+  free(ens->startSave);
+  free(ens->values);
+  free(ens);
+}
+
+/* result interface of the simulation of a member */
+static void ensembleEmit(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+  ENSEMBLE_DATA* ens = (ENSEMBLE_DATA*) self->storage;
+  SIMULATION_DATA *sData = data->localData[0];
+  long i;
+
+  fprintf(ens->fout, "%.16g,%d", sData->timeValue, ens->emitMember+1);
+  for(i=0; i<ens->nStates; ++i)
+  {
+    fprintf(ens->fout, ",%.16g", sData->realVars[i]);
+  }
+  fputc('\n', ens->fout);
+}
+
+static void ensembleWriteParameterData(simulation_result *self, DATA *data, threadData_t *threadData)
+{
+}
+
+/*! \fn ensembleSimulateMembers
+ *
+ *  Simulates the members one after another with the standard solver loop
+ *  and writes their states to the ensemble result. Has to be called after
+ *  the model itself has finished.
+ *
+ *  \return 0 if all members were simulated
+ */
+int ensembleSimulateMembers(DATA* data, threadData_t *threadData, ENSEMBLE_DATA* ens, int solverMethod,
+    const char* init_initMethod, const char* init_file, double init_time)
+{
+  simulation_result modelResult = sim_result;
+  int m, retValue = 0;
+
+  for(m=0; m<ens->nMembers; ++m)
+  {
+    SOLVER_INFO solverInfo;
+
+    infoStreamPrint(LOG_SOLVER, 0, "Ensemble: simulate member %d", m+1);
+    sim_result.storage = ens;
+    sim_result.emit = ensembleEmit;
+    sim_result.writeParameterData = ensembleWriteParameterData;
+    ens->emitMember = m;
+
+    data->simulationInfo->stopTime = ens->stopTime;
+    data->simulationInfo->terminal = 0;
+    solverInfo.solverMethod = solverMethod;
+    if(0 == initializeSolverData(data, threadData, &solverInfo))
+    {
+      setStartValues(data, ens, m);
+      if(0 == initializeModel(data, threadData, init_initMethod, init_file, init_time))
+      {
+        sim_result.emit(&sim_result, data, threadData);
+        overwriteOldSimulationData(data);
+        storeOldValues(data);
+        if(data->callback->performSimulation(data, threadData, &solverInfo))
+        {
+          warningStreamPrint(LOG_STDOUT, 0, "Ensemble: simulation of member %d failed at time %g.", m+1, solverInfo.currentTime);
+          retValue = 1;
+        }
+      }
+      else
+      {
+        warningStreamPrint(LOG_STDOUT, 0, "Ensemble: initialization of member %d failed, the member is skipped.", m+1);
+        retValue = 1;
+      }
+      setStartValues(data, ens, -1);
+    }
+    else
+    {
+      retValue = 1;
+    }
+    freeSolverData(data, &solverInfo);
+  }
+
+  sim_result = modelResult;
+  ens->emitMember = -1;
+  fflush(ens->fout);
+  return retValue;
+}
@@ -0,0 +1,76 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2010, Linköpings University,
+ * Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THIS OSMC PUBLIC
+ * LICENSE (OSMC-PL). ANY USE, REPRODUCTION OR DISTRIBUTION OF
+ * THIS PROGRAM CONSTITUTES RECIPIENT'S ACCEPTANCE OF THE OSMC
+ * PUBLIC LICENSE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from Linköpings University, either from the above address,
+ * from the URL: http://www.ida.liu.se/projects/OpenModelica
+ * and in the OpenModelica distribution.
+ *
+ * This program is distributed  WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS
+ * OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+/*! \file ensemble.h
+ *
+ *  Ensemble of model variants (-ensemble=<file.csv>), simulated one after
+ *  another once the model itself has finished.
+ */
+
+#ifndef _ENSEMBLE_H_
+#define _ENSEMBLE_H_
+
+#include <stdio.h>
+
+#include "simulation_data.h"
+#include "solver_main.h"
+
+typedef struct ENSEMBLE_DATA
+{
+  int nMembers;               /* number of members, one per row of the ensemble file */
+  int nStates;
+
+  /* columns of the ensemble file */
+  int nColumns;
+  int *columnKind;
+  long *columnIndex;
+  double *values;             /* value of column j for member m at [m*nColumns+j] */
+  double *startSave;          /* start values of the model itself */
+
+  double stopTime;
+  int emitMember;             /* member that is simulated, -1 if none */
+  FILE *fout;
+} ENSEMBLE_DATA;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+ENSEMBLE_DATA* allocateEnsemble(DATA* data, SOLVER_INFO* solverInfo, const char* filename);
+void freeEnsemble(ENSEMBLE_DATA* ens);
+
+int ensembleSimulateMembers(DATA* data, threadData_t *threadData, ENSEMBLE_DATA* ens, int solverMethod,
+    const char* init_initMethod, const char* init_file, double init_time);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
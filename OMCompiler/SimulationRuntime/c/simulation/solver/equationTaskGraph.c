@@ -0,0 +1,711 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2010, Linköpings University,
+ * Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THIS OSMC PUBLIC
+ * LICENSE (OSMC-PL). ANY USE, REPRODUCTION OR DISTRIBUTION OF
+ * THIS PROGRAM CONSTITUTES RECIPIENT'S ACCEPTANCE OF THE OSMC
+ * PUBLIC LICENSE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from Linköpings University, either from the above address,
+ * from the URL: http://www.ida.liu.se/projects/OpenModelica
+ * and in the OpenModelica distribution.
+ *
+ * This program is distributed  WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS
+ * OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+/*! \file equationTaskGraph.c
+ *
+ *  The equations of functionODE and functionAlgebraics are evaluated as a
+ *  task graph. The dependencies between the equations are computed from the
+ *  defined and used variables in the model info file: the variables of the
+ *  equations inside a linear or non-linear system are added to the system.
+ *  Equations whose used variables are not known (e.g. algorithms with several
+ *  statements or if-equations) are barriers for all other equations. External
+ *  objects are read and written by every equation using them, so calls on the
+ *  same object (e.g. a table) are never evaluated concurrently.
+ *
+ *  The first evaluations are sequential and timed. The graph is only
+ *  evaluated in parallel if there is enough work and enough parallelism in
+ *  it, otherwise the generated code evaluates the equations sequentially.
+ *
+ *  The parallel evaluation uses one deque of ready tasks per thread. A thread
+ *  continues with the first successor it makes ready, pushes the other ones
+ *  on its own deque and steals from the other deques when it runs out of
+ *  work. The calling thread is thread 0 of the pool.
+ */
+
+#include "equationTaskGraph.h"
+
+#if !defined(OMC_MINIMAL_RUNTIME) && !defined(OMC_FMI_RUNTIME) && !defined(OMC_NO_THREADS)
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "model_help.h"
+#include "simulation/options.h"
+#include "simulation/simulation_info_json.h"
+#include "util/omc_error.h"
+#include "util/rtclock.h"
+#include "util/uthash.h"
+#include "meta/meta_modelica.h"
+
+#if defined(_MSC_VER)
+#include <windows.h>
+#define TASK_ATOMIC_DEC(X) InterlockedDecrement((volatile LONG*) (X))
+#define TASK_ATOMIC_CAS(X,OLD,NEW) InterlockedCompareExchange((volatile LONG*) (X), (NEW), (OLD))
+#else
+#define TASK_ATOMIC_DEC(X) __sync_sub_and_fetch((X), 1)
+#define TASK_ATOMIC_CAS(X,OLD,NEW) __sync_val_compare_and_swap((X), (OLD), (NEW))
+#endif
+
+#define TASKGRAPH_PROFILE_CALLS 10  /* timed sequential evaluations before the decision */
+#define TASKGRAPH_MIN_WORK 2e-5     /* [s] less work than this is always evaluated sequentially */
+#define TASKGRAPH_OVERHEAD 5e-6     /* [s] estimated cost of waking up and joining the pool */
+#define TASKGRAPH_MIN_SPEEDUP 1.5   /* required estimated speedup of the parallel evaluation */
+#define TASKGRAPH_SPIN 20000        /* polls of an idle worker before it blocks */
+
+enum TASKGRAPH_MODE
+{
+  TASKGRAPH_PROFILE = 0,
+  TASKGRAPH_SEQUENTIAL,
+  TASKGRAPH_PARALLEL
+};
+
+typedef struct INT_LIST
+{
+  int *values;
+  int n;
+  int capacity;
+} INT_LIST;
+
+typedef struct VAR_ACCESS
+{
+  const char *name;
+  int writer;                 /* last task defining the variable, -1 if none */
+  INT_LIST readers;           /* tasks using the variable since the last definition */
+  UT_hash_handle hh;
+} VAR_ACCESS;
+
+typedef struct TASK_GRAPH
+{
+  int nTasks;
+  int *nPred;                 /* number of predecessors of each task */
+  int *succStart;             /* successors of task i are succ[succStart[i]..succStart[i+1]-1] */
+  int *succ;
+  int *roots;                 /* tasks without predecessors */
+  int nRoots;
+  double *cost;               /* minimal measured time of each task */
+  int nProfiled;
+  int mode;
+  volatile long *pending;     /* unfinished predecessors during the parallel evaluation */
+} TASK_GRAPH;
+
+typedef struct TASK_DEQUE
+{
+  pthread_mutex_t mutex;
+  int *tasks;
+  volatile int top;           /* thieves take tasks from the top */
+  volatile int bottom;        /* the owner pushes and pops at the bottom */
+} TASK_DEQUE;
+
+static struct
+{
+  int nThreads;               /* including the calling thread, 0 if not yet read from the flag */
+  int started;
+  pthread_t *threads;
+  threadData_t **threadData;
+  TASK_DEQUE *deques;
+  int capacity;
+  DATA *workerData;           /* shallow copies, so the scalar fields of simulationInfo are per thread */
+  SIMULATION_INFO *workerInfo;
+  pthread_mutex_t mutex;
+  pthread_cond_t wakeup;
+  int nReady;
+  int shutdown;
+  volatile unsigned long generation;
+  volatile long busyWorkers;
+  volatile long inUse;
+
+  /* the current evaluation */
+  TASK_GRAPH *graph;
+  EQUATION_TASK_FUNCTION const *tasks;
+  volatile long remaining;
+  volatile long failedTask;
+} pool;
+
+static void pushInt(INT_LIST *list, int value)
+{
+  if (list->n == list->capacity) {
+    list->capacity = list->capacity ? 2*list->capacity : 4;
+    list->values = (int*) realloc(list->values, list->capacity*sizeof(int));
+  }
+  list->values[list->n++] = value;
+}
+
+static int compareInt(const void *a, const void *b)
+{
+  return *(const int*)a - *(const int*)b;
+}
+
+static void addEdge(INT_LIST *pred, int from, int to)
+{
+  if (from >= 0 && from != to) {
+    pushInt(&pred[to], from);
+  }
+}
+
+static VAR_ACCESS* lookupVar(VAR_ACCESS **vars, const char *name)
+{
+  VAR_ACCESS *var;
+  HASH_FIND_STR(*vars, name, var);
+  if (!var) {
+    var = (VAR_ACCESS*) calloc(1, sizeof(VAR_ACCESS));
+    var->name = name;
+    var->writer = -1;
+    HASH_ADD_KEYPTR(hh, *vars, var->name, strlen(var->name), var);
+  }
+  return var;
+}
+
+static TASK_GRAPH* buildTaskGraph(DATA *data, int nTasks, const int *eqIndex)
+{
+  MODEL_DATA_XML *xml = &data->modelData->modelDataXml;
+  TASK_GRAPH *graph = (TASK_GRAPH*) calloc(1, sizeof(TASK_GRAPH));
+  INT_LIST *members = (INT_LIST*) calloc(nTasks, sizeof(INT_LIST));
+  INT_LIST *pred = (INT_LIST*) calloc(nTasks, sizeof(INT_LIST));
+  VAR_ACCESS *vars = NULL, *var, *tmp;
+  EQUATION_INFO *info;
+  long nEquations;
+  int *taskOf, *count;
+  char *hasChild;
+  int t, i, j, k, e, p, depth, nEdges = 0, lastBarrier = -1;
+
+  modelInfoGetEquation(xml, 0);
+  info = xml->equationInfo;
+  nEquations = xml->nEquations;
+
+  /* every equation belongs to the task of its outermost system */
+  taskOf = (int*) malloc(nEquations*sizeof(int));
+  hasChild = (char*) calloc(nEquations, sizeof(char));
+  for (e = 0; e < nEquations; e++) {
+    taskOf[e] = -1;
+    if (info[e].parent > 0 && info[e].parent < nEquations) {
+      hasChild[info[e].parent] = 1;
+    }
+  }
+  for (t = nTasks-1; t >= 0; t--) {
+    if (eqIndex[t] > 0 && eqIndex[t] < nEquations) {
+      taskOf[eqIndex[t]] = t;
+    }
+  }
+  for (e = 1; e < nEquations; e++) {
+    for (p = e, depth = 0; p > 0 && p < nEquations && taskOf[p] < 0 && depth < 64; depth++) {
+      p = info[p].parent;
+    }
+    if (p > 0 && p < nEquations && taskOf[p] >= 0) {
+      pushInt(&members[taskOf[p]], e);
+    }
+  }
+
+  /* read-after-write, write-after-read and write-after-write dependencies in the order of the generated code */
+  for (t = 0; t < nTasks; t++) {
+    /* the uses of a system are the ones of its inner equations */
+    int barrier = members[t].n == 0;
+    for (i = 0; i < members[t].n; i++) {
+      e = members[t].values[i];
+      if (info[e].numUses < 0 && !hasChild[e]) {
+        barrier = 1;
+      }
+    }
+    if (barrier) {
+      for (k = lastBarrier < 0 ? 0 : lastBarrier; k < t; k++) {
+        addEdge(pred, k, t);
+      }
+      lastBarrier = t;
+      continue;
+    }
+    addEdge(pred, lastBarrier, t);
+    for (i = 0; i < members[t].n; i++) {
+      e = members[t].values[i];
+      for (j = 0; j < info[e].numUses; j++) {
+        var = lookupVar(&vars, info[e].uses[j]);
+        addEdge(pred, var->writer, t);
+        pushInt(&var->readers, t);
+      }
+    }
+    for (i = 0; i < members[t].n; i++) {
+      e = members[t].values[i];
+      for (j = 0; j < info[e].numExtObjs; j++) {
+        var = lookupVar(&vars, info[e].extObjs[j]);
+        addEdge(pred, var->writer, t);
+        for (k = 0; k < var->readers.n; k++) {
+          addEdge(pred, var->readers.values[k], t);
+        }
+        var->readers.n = 0;
+        var->writer = t;
+      }
+    }
+    for (i = 0; i < members[t].n; i++) {
+      e = members[t].values[i];
+      for (j = 0; j < info[e].numVar; j++) {
+        var = lookupVar(&vars, info[e].vars[j]);
+        addEdge(pred, var->writer, t);
+        for (k = 0; k < var->readers.n; k++) {
+          addEdge(pred, var->readers.values[k], t);
+        }
+        var->readers.n = 0;
+        var->writer = t;
+      }
+    }
+  }
+
+  HASH_ITER(hh, vars, var, tmp) {
+    HASH_DEL(vars, var);
+    free(var->readers.values);
+    free(var);
+  }
+
+  /* remove duplicate edges and store the successors */
+  graph->nTasks = nTasks;
+  graph->nPred = (int*) calloc(nTasks, sizeof(int));
+  graph->succStart = (int*) calloc(nTasks+1, sizeof(int));
+  graph->roots = (int*) malloc(nTasks*sizeof(int));
+  graph->cost = (double*) calloc(nTasks, sizeof(double));
+  graph->pending = (volatile long*) calloc(nTasks, sizeof(long));
+  for (t = 0; t < nTasks; t++) {
+    qsort(pred[t].values, pred[t].n, sizeof(int), compareInt);
+    for (i = 0, k = 0; i < pred[t].n; i++) {
+      if (k == 0 || pred[t].values[k-1] != pred[t].values[i]) {
+        pred[t].values[k++] = pred[t].values[i];
+        graph->succStart[pred[t].values[i]+1]++;
+      }
+    }
+    pred[t].n = k;
+    graph->nPred[t] = k;
+    nEdges += k;
+    if (k == 0) {
+      graph->roots[graph->nRoots++] = t;
+    }
+  }
+  for (t = 0; t < nTasks; t++) {
+    graph->succStart[t+1] += graph->succStart[t];
+  }
+  graph->succ = (int*) malloc((nEdges ? nEdges : 1)*sizeof(int));
+  count = (int*) calloc(nTasks, sizeof(int));
+  for (t = 0; t < nTasks; t++) {
+    for (i = 0; i < pred[t].n; i++) {
+      p = pred[t].values[i];
+      graph->succ[graph->succStart[p] + count[p]++] = t;
+    }
+    free(pred[t].values);
+    free(members[t].values);
+  }
+
+  free(count);
+  free(hasChild);
+  free(taskOf);
+  free(pred);
+  free(members);
+  return graph;
+}
+
+static void freeTaskGraph(TASK_GRAPH *graph)
+{
+  free(graph->nPred);
+  free(graph->succStart);
+  free(graph->succ);
+  free(graph->roots);
+  free(graph->cost);
+  free((void*) graph->pending);
+  free(graph);
+}
+
+/* Evaluates all tasks in the generated order and keeps the fastest time of each task */
+static void profileTaskGraph(TASK_GRAPH *graph, DATA *data, threadData_t *threadData, EQUATION_TASK_FUNCTION const *tasks)
+{
+  rtclock_t clock;
+  double time;
+  int t;
+
+  for (t = 0; t < graph->nTasks; t++) {
+    rt_ext_tp_tick(&clock);
+    tasks[t](data, threadData);
+    time = rt_ext_tp_tock(&clock);
+    if (graph->nProfiled == 0 || time < graph->cost[t]) {
+      graph->cost[t] = time;
+    }
+  }
+  graph->nProfiled++;
+}
+
+/* Compares the measured work with the critical path of the graph */
+static void decideTaskGraph(TASK_GRAPH *graph, int kind)
+{
+  double *start = (double*) calloc(graph->nTasks, sizeof(double));
+  double total = 0.0, critical = 0.0, finish, estimate;
+  int t, i;
+
+  for (t = 0; t < graph->nTasks; t++) {
+    total += graph->cost[t];
+    finish = start[t] + graph->cost[t];
+    critical = finish > critical ? finish : critical;
+    for (i = graph->succStart[t]; i < graph->succStart[t+1]; i++) {
+      if (start[graph->succ[i]] < finish) {
+        start[graph->succ[i]] = finish;
+      }
+    }
+  }
+  free(start);
+
+  estimate = (critical > total/pool.nThreads ? critical : total/pool.nThreads) + TASKGRAPH_OVERHEAD;
+  graph->mode = (total >= TASKGRAPH_MIN_WORK && total >= TASKGRAPH_MIN_SPEEDUP*estimate) ? TASKGRAPH_PARALLEL : TASKGRAPH_SEQUENTIAL;
+
+  infoStreamPrint(LOG_STATS_V, 0, "%s: %d equation tasks, %d roots, work %gs, critical path %gs, %s evaluation with %d threads",
+                  kind == EQUATION_TASKGRAPH_ODE ? "functionODE" : "functionAlgebraics", graph->nTasks, graph->nRoots,
+                  total, critical, graph->mode == TASKGRAPH_PARALLEL ? "parallel" : "sequential", pool.nThreads);
+}
+
+static void pushTask(TASK_DEQUE *deque, int task)
+{
+  pthread_mutex_lock(&deque->mutex);
+  deque->tasks[deque->bottom++] = task;
+  pthread_mutex_unlock(&deque->mutex);
+}
+
+static int popTask(TASK_DEQUE *deque)
+{
+  int task = -1;
+  if (deque->bottom == deque->top) {
+    return -1;
+  }
+  pthread_mutex_lock(&deque->mutex);
+  if (deque->bottom > deque->top) {
+    task = deque->tasks[--deque->bottom];
+  }
+  pthread_mutex_unlock(&deque->mutex);
+  return task;
+}
+
+static int stealTask(TASK_DEQUE *deque)
+{
+  int task = -1;
+  if (deque->bottom == deque->top) {
+    return -1;
+  }
+  pthread_mutex_lock(&deque->mutex);
+  if (deque->bottom > deque->top) {
+    task = deque->tasks[deque->top++];
+  }
+  pthread_mutex_unlock(&deque->mutex);
+  return task;
+}
+
+/* Runs one equation; an error thrown by it is recorded and reported by the calling thread */
+static void runTask(int task, DATA *data, threadData_t *threadData)
+{
+  jmp_buf *oldMmcJumper = threadData->mmc_jumper;
+  jmp_buf *oldGlobalJumpBuffer = threadData->globalJumpBuffer;
+  jmp_buf *oldSimulationJumpBuffer = threadData->simulationJumpBuffer;
+  errorStage oldErrorStage = threadData->currentErrorStage;
+  jmp_buf taskJumper;
+
+  threadData->mmc_jumper = &taskJumper;
+  threadData->globalJumpBuffer = &taskJumper;
+  threadData->simulationJumpBuffer = &taskJumper;
+  if (setjmp(taskJumper) == 0) {
+    pool.tasks[task](data, threadData);
+  } else {
+    TASK_ATOMIC_CAS(&pool.failedTask, -1, task);
+  }
+  threadData->mmc_jumper = oldMmcJumper;
+  threadData->globalJumpBuffer = oldGlobalJumpBuffer;
+  threadData->simulationJumpBuffer = oldSimulationJumpBuffer;
+  threadData->currentErrorStage = oldErrorStage;
+}
+
+/* Runs the task and releases its successors. Returns the successor to continue with or -1. */
+static int executeTask(int task, int self, DATA *data, threadData_t *threadData)
+{
+  TASK_GRAPH *graph = pool.graph;
+  int i, succ, next = -1;
+
+  /* after an error the remaining tasks are only counted down */
+  if (pool.failedTask < 0) {
+    runTask(task, data, threadData);
+  }
+  for (i = graph->succStart[task]; i < graph->succStart[task+1]; i++) {
+    succ = graph->succ[i];
+    if (0 == TASK_ATOMIC_DEC(&graph->pending[succ])) {
+      if (next < 0) {
+        next = succ;
+      } else {
+        pushTask(&pool.deques[self], succ);
+      }
+    }
+  }
+  TASK_ATOMIC_DEC(&pool.remaining);
+  return next;
+}
+
+static void runTasks(int self, DATA *data, threadData_t *threadData)
+{
+  int i, task, idle = 0;
+
+  while (pool.remaining > 0) {
+    task = popTask(&pool.deques[self]);
+    for (i = 1; task < 0 && i < pool.nThreads; i++) {
+      task = stealTask(&pool.deques[(self+i) % pool.nThreads]);
+    }
+    if (task < 0) {
+      if (++idle > 100) {
+        sched_yield();
+      }
+      continue;
+    }
+    idle = 0;
+    while (task >= 0) {
+      task = executeTask(task, self, data, threadData);
+    }
+  }
+}
+
+static unsigned long waitForWork(unsigned long seen)
+{
+  int i;
+  for (i = 0; i < TASKGRAPH_SPIN && pool.generation == seen; i++);
+  pthread_mutex_lock(&pool.mutex);
+  while (pool.generation == seen && !pool.shutdown) {
+    pthread_cond_wait(&pool.wakeup, &pool.mutex);
+  }
+  seen = pool.generation;
+  pthread_mutex_unlock(&pool.mutex);
+  return seen;
+}
+
+static void* taskWorker(void *arg)
+{
+  int self = (int) (intptr_t) arg;
+  unsigned long seen = 0;
+  threadData_t *threadData;
+
+  MMC_ALLOC_AND_INIT_THREADDATA(threadData);
+  pthread_mutex_lock(&pool.mutex);
+  pool.threadData[self] = threadData;
+  pool.nReady++;
+  pthread_cond_broadcast(&pool.wakeup);
+  pthread_mutex_unlock(&pool.mutex);
+
+  while (1) {
+    seen = waitForWork(seen);
+    if (pool.shutdown) {
+      break;
+    }
+    runTasks(self, &pool.workerData[self], threadData);
+    TASK_ATOMIC_DEC(&pool.busyWorkers);
+  }
+  return NULL;
+}
+
+static void startPool(threadData_t *threadData)
+{
+  int i;
+
+  pool.threads = (pthread_t*) calloc(pool.nThreads, sizeof(pthread_t));
+  pool.threadData = (threadData_t**) calloc(pool.nThreads, sizeof(threadData_t*));
+  pool.deques = (TASK_DEQUE*) calloc(pool.nThreads, sizeof(TASK_DEQUE));
+  pool.workerData = (DATA*) calloc(pool.nThreads, sizeof(DATA));
+  pool.workerInfo = (SIMULATION_INFO*) calloc(pool.nThreads, sizeof(SIMULATION_INFO));
+  pthread_mutex_init(&pool.mutex, NULL);
+  pthread_cond_init(&pool.wakeup, NULL);
+  for (i = 0; i < pool.nThreads; i++) {
+    pthread_mutex_init(&pool.deques[i].mutex, NULL);
+  }
+  pool.threadData[0] = threadData;
+  pool.nReady = 0;
+  pool.shutdown = 0;
+  pool.started = 1;
+
+  for (i = 1; i < pool.nThreads; i++) {
+    if (GC_pthread_create(&pool.threads[i], NULL, taskWorker, (void*) (intptr_t) i)) {
+      throwStreamPrint(threadData, "Failed to start the threads for -%s", FLAG_NAME[FLAG_PARALLEL_EQUATIONS]);
+    }
+  }
+  pthread_mutex_lock(&pool.mutex);
+  while (pool.nReady < pool.nThreads-1) {
+    pthread_cond_wait(&pool.wakeup, &pool.mutex);
+  }
+  pthread_mutex_unlock(&pool.mutex);
+  for (i = 1; i < pool.nThreads; i++) {
+    pool.threadData[i]->parent = threadData;
+  }
+}
+
+static void stopPool()
+{
+  int i;
+
+  pthread_mutex_lock(&pool.mutex);
+  pool.shutdown = 1;
+  pthread_cond_broadcast(&pool.wakeup);
+  pthread_mutex_unlock(&pool.mutex);
+  for (i = 1; i < pool.nThreads; i++) {
+    GC_pthread_join(pool.threads[i], NULL);
+  }
+  for (i = 0; i < pool.nThreads; i++) {
+    pthread_mutex_destroy(&pool.deques[i].mutex);
+    free(pool.deques[i].tasks);
+  }
+  pthread_cond_destroy(&pool.wakeup);
+  pthread_mutex_destroy(&pool.mutex);
+  free(pool.threads);
+  free(pool.threadData);
+  free(pool.deques);
+  free(pool.workerData);
+  free(pool.workerInfo);
+  memset(&pool, 0, sizeof(pool));
+}
+
+static void evaluateParallel(TASK_GRAPH *graph, DATA *data, threadData_t *threadData, EQUATION_TASK_FUNCTION const *tasks)
+{
+  TASK_DEQUE *deque;
+  threadData_t *workerThreadData;
+  int i;
+
+  if (!pool.started) {
+    startPool(threadData);
+  }
+  if (pool.capacity < graph->nTasks) {
+    for (i = 0; i < pool.nThreads; i++) {
+      pool.deques[i].tasks = (int*) realloc(pool.deques[i].tasks, graph->nTasks*sizeof(int));
+    }
+    pool.capacity = graph->nTasks;
+  }
+
+  for (i = 0; i < graph->nTasks; i++) {
+    graph->pending[i] = graph->nPred[i];
+  }
+  for (i = 0; i < pool.nThreads; i++) {
+    pool.deques[i].top = 0;
+    pool.deques[i].bottom = 0;
+  }
+  for (i = 0; i < graph->nRoots; i++) {
+    deque = &pool.deques[i % pool.nThreads];
+    deque->tasks[deque->bottom++] = graph->roots[i];
+  }
+  for (i = 1; i < pool.nThreads; i++) {
+    pool.workerInfo[i] = *data->simulationInfo;
+    pool.workerData[i] = *data;
+    pool.workerData[i].simulationInfo = &pool.workerInfo[i];
+    workerThreadData = pool.threadData[i];
+    workerThreadData->currentErrorStage = threadData->currentErrorStage;
+    memcpy(workerThreadData->localRoots, threadData->localRoots, sizeof(threadData->localRoots));
+    workerThreadData->localRoots[LOCAL_ROOT_SIMULATION_DATA] = &pool.workerData[i];
+  }
+  pool.graph = graph;
+  pool.tasks = tasks;
+  pool.remaining = graph->nTasks;
+  pool.failedTask = -1;
+  pool.busyWorkers = pool.nThreads-1;
+
+  pthread_mutex_lock(&pool.mutex);
+  pool.generation++;
+  pthread_cond_broadcast(&pool.wakeup);
+  pthread_mutex_unlock(&pool.mutex);
+
+  runTasks(0, data, threadData);
+  /* the compare-and-swap is a full barrier, the results of the workers are visible afterwards */
+  while (TASK_ATOMIC_CAS(&pool.busyWorkers, 0, 0) != 0) {
+    sched_yield();
+  }
+
+  for (i = 1; i < pool.nThreads; i++) {
+    if (pool.workerInfo[i].needToIterate) {
+      data->simulationInfo->needToIterate = 1;
+    }
+  }
+}
+
+int evaluateEquationTaskGraph(DATA *data, threadData_t *threadData, int kind, int nTasks, EQUATION_TASK_FUNCTION const *tasks, const int *eqIndex)
+{
+  TASK_GRAPH *graph;
+  long failedTask;
+  int indexes[2] = {1, 0};
+
+  if (nTasks < 2 || measure_time_flag || !omc_flag[FLAG_PARALLEL_EQUATIONS]) {
+    return 0;
+  }
+  if (pool.nThreads == 0) {
+    pool.nThreads = atoi(omc_flagValue[FLAG_PARALLEL_EQUATIONS]);
+    pool.nThreads = pool.nThreads > 1 ? pool.nThreads : 1;
+  }
+  if (pool.nThreads == 1) {
+    return 0;
+  }
+
+  graph = (TASK_GRAPH*) data->simulationInfo->equationTaskGraphs[kind];
+  if (!graph) {
+    graph = buildTaskGraph(data, nTasks, eqIndex);
+    data->simulationInfo->equationTaskGraphs[kind] = graph;
+  }
+
+  switch (graph->mode) {
+  case TASKGRAPH_SEQUENTIAL:
+    return 0;
+  case TASKGRAPH_PROFILE:
+    profileTaskGraph(graph, data, threadData, tasks);
+    if (graph->nProfiled == TASKGRAPH_PROFILE_CALLS) {
+      decideTaskGraph(graph, kind);
+    }
+    return 1;
+  }
+
+  /* the pool is already evaluating a graph */
+  if (TASK_ATOMIC_CAS(&pool.inUse, 0, 1) != 0) {
+    return 0;
+  }
+  evaluateParallel(graph, data, threadData, tasks);
+  failedTask = pool.failedTask;
+  pool.inUse = 0;
+
+  if (failedTask >= 0) {
+    indexes[1] = eqIndex[failedTask];
+    throwStreamPrintWithEquationIndexes(threadData, indexes, "The parallel evaluation of equation %d failed.", eqIndex[failedTask]);
+  }
+  return 1;
+}
+
+void freeEquationTaskGraphs(DATA *data)
+{
+  int kind;
+
+  for (kind = 0; kind < EQUATION_TASKGRAPH_MAX; kind++) {
+    if (data->simulationInfo->equationTaskGraphs[kind]) {
+      freeTaskGraph((TASK_GRAPH*) data->simulationInfo->equationTaskGraphs[kind]);
+      data->simulationInfo->equationTaskGraphs[kind] = NULL;
+    }
+  }
+  if (pool.started) {
+    stopPool();
+  }
+}
+
+#endif
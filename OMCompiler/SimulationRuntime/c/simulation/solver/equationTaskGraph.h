@@ -0,0 +1,80 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-2010, Linköpings University,
+ * Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THIS OSMC PUBLIC
+ * LICENSE (OSMC-PL). ANY USE, REPRODUCTION OR DISTRIBUTION OF
+ * THIS PROGRAM CONSTITUTES RECIPIENT'S ACCEPTANCE OF THE OSMC
+ * PUBLIC LICENSE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from Linköpings University, either from the above address,
+ * from the URL: http://www.ida.liu.se/projects/OpenModelica
+ * and in the OpenModelica distribution.
+ *
+ * This program is distributed  WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS
+ * OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+/*! \file equationTaskGraph.h
+ *
+ *  Parallel evaluation of the equations of functionODE and
+ *  functionAlgebraics on a work-stealing thread pool
+ *  (-d=parallelEquations and -parallelEquations=<threads>).
+ */
+
+#ifndef _EQUATIONTASKGRAPH_H_
+#define _EQUATIONTASKGRAPH_H_
+
+#include "simulation_data.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum EQUATION_TASKGRAPH_KIND
+{
+  EQUATION_TASKGRAPH_ODE = 0,
+  EQUATION_TASKGRAPH_ALG,
+
+  EQUATION_TASKGRAPH_MAX
+};
+
+typedef void (*EQUATION_TASK_FUNCTION)(DATA*, threadData_t*);
+
+#if defined(OMC_MINIMAL_RUNTIME) || defined(OMC_FMI_RUNTIME) || defined(OMC_NO_THREADS)
+
+#define evaluateEquationTaskGraph(data, threadData, kind, nTasks, tasks, eqIndex) 0
+#define freeEquationTaskGraphs(data)
+
+#else
+
+/*! \fn evaluateEquationTaskGraph
+ *
+ *  Evaluates the equations tasks[0..nTasks-1] (with the equation indices
+ *  eqIndex) in an order respecting their dependencies.
+ *
+ *  \return 0 if the caller has to evaluate the equations sequentially
+ */
+int evaluateEquationTaskGraph(DATA *data, threadData_t *threadData, int kind, int nTasks, EQUATION_TASK_FUNCTION const *tasks, const int *eqIndex);
+void freeEquationTaskGraphs(DATA *data);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
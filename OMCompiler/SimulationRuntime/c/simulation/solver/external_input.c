@@ -36,18 +36,56 @@
 #include "simulation_data.h"
 
 #include "util/omc_error.h"
+#include "util/omc_mmap.h"
 #include "gc/omc_gc.h"
 #include "util/read_csv.h"
 #include "util/libcsv.h"
 #include "util/read_matlab4.h"
 
 #include "simulation/simulation_runtime.h"
+#include "simulation/variable_name_index.h"
 #include "simulation/solver/solver_main.h"
 #include "simulation/solver/model_help.h"
 #include "simulation/options.h"
 
+#define EXTERNAL_INPUT_DEFAULT_WINDOW 1024
+
+/* Reader for the input file if only a window of rows is kept in memory.
+ * CSV files are memory-mapped and the offset of every stride-th row is
+ * remembered, so any row can be found again without parsing the file from
+ * the start. MAT v4 files store data_2 row-wise and are read with fseek. */
+typedef struct EXTERNAL_INPUT_STREAM
+{
+  int isMat;
+  int inMemory;                        /* binNormal MAT files are loaded completely by the reader */
+  size_t nrows;                        /* rows in the input file */
+  /* csv */
+  omc_mmap_read map;
+  unsigned char delim;
+  size_t stride;
+  size_t *checkpoints;                 /* offset of row k*stride */
+  int ncols;
+  int *columnInput;                    /* input for every column, -1 if unused; column 0 is time */
+  char *line;
+  size_t lineSize;
+  /* mat */
+  ModelicaMatReader reader;
+  double *row;
+  int timeIndex;
+  int *inputIndex;                     /* signed 1-based index in data_2 (or data_1 if isParam), 0 if unused */
+  modelica_boolean *inputIsParam;
+} EXTERNAL_INPUT_STREAM;
+
 static inline void externalInputallocate1(DATA* data, FILE * pFile);
 static inline void externalInputallocate2(DATA* data, char *filename);
+static void externalInputallocateStream(DATA* data, const char *filename, int isMat, long window);
+static void externalInputStreamFree(EXTERNAL_INPUT_STREAM *s);
+
+static int hasExtension(const char *filename, const char *ext)
+{
+  size_t len = strlen(filename), extLen = strlen(ext);
+  return len >= extLen && 0 == strcmp(filename + len - extLen, ext);
+}
 
 int externalInputallocate(DATA* data)
 {
@@ -55,31 +93,51 @@ int externalInputallocate(DATA* data)
   int i,j;
   short useLibCsvH = 1;
   char * cflags = NULL;
+  long window = omc_flag[FLAG_INPUT_WINDOW] ? atol(omc_flagValue[FLAG_INPUT_WINDOW]) : 0;
 
+  data->simulationInfo->external_input.u = NULL;
+  data->simulationInfo->external_input.t = NULL;
+  data->simulationInfo->external_input.first = 0;
+  data->simulationInfo->external_input.stream = NULL;
 
   cflags = (char*)omc_flagValue[FLAG_INPUT_CSV];
   if(!cflags){
     cflags = (char*)omc_flagValue[FLAG_INPUT_FILE];
     useLibCsvH = 0;
-    if(cflags){
+    if(cflags && hasExtension(cflags, ".mat")){
+      /* MAT files are always streamed; a whole result file can be much larger than the inputs in it */
+      externalInputallocateStream(data, cflags, 1, window > 0 ? window : EXTERNAL_INPUT_DEFAULT_WINDOW);
+      useLibCsvH = 1;
+    }else if(cflags){
       pFile = fopen(cflags,"r");
       if(pFile == NULL)
         warningStreamPrint(LOG_STDOUT, 0, "OMC can't find the file %s.",cflags);
     }else{
       pFile = fopen("externalInput.csv","r");
     }
+  }else if(hasExtension(cflags, ".mat")){
+    externalInputallocateStream(data, cflags, 1, window > 0 ? window : EXTERNAL_INPUT_DEFAULT_WINDOW);
+  }else if(window > 0){
+    externalInputallocateStream(data, cflags, 0, window);
+  }else{
+    externalInputallocate2(data, cflags);
   }
 
-  data->simulationInfo->external_input.active = (modelica_boolean) (pFile != NULL);
-  if(data->simulationInfo->external_input.active || useLibCsvH){
-    if(useLibCsvH){
-      externalInputallocate2(data, cflags);
-    }else
+  if(!useLibCsvH){
+    data->simulationInfo->external_input.active = (modelica_boolean) (pFile != NULL);
+    if(pFile != NULL){
       externalInputallocate1(data, pFile);
+    }
+  }
 
+  if(data->simulationInfo->external_input.active){
     if(ACTIVE_STREAM(LOG_SIMULATION))
     {
       printf("\nExternal Input");
+      if(data->simulationInfo->external_input.stream){
+        printf(" (first %ld rows of %ld)", (long) data->simulationInfo->external_input.n,
+          (long) ((EXTERNAL_INPUT_STREAM*) data->simulationInfo->external_input.stream)->nrows);
+      }
       printf("\n========================================================");
       for(i = 0; i < data->simulationInfo->external_input.n; ++i){
         printf("\nInput: t=%f   \t", data->simulationInfo->external_input.t[i]);
@@ -96,54 +154,91 @@ int externalInputallocate(DATA* data)
   return 0;
 }
 
+/* Allocates rows+1 zeroed rows of all inputs in one contiguous buffer.
+ * The extra row keeps t[i+1] valid for files with a single row. */
+static void externalInputAllocRows(DATA* data, modelica_integer rows)
+{
+  EXTERNAL_INPUT *in = &data->simulationInfo->external_input;
+  const modelica_integer m = modelica_integer_max(1, data->modelData->nInputVars);
+  modelica_real *buffer = (modelica_real*) calloc((rows+1)*m, sizeof(modelica_real));
+  modelica_integer i;
+
+  in->u = (modelica_real**) malloc((rows+1)*sizeof(modelica_real*));
+  in->t = (modelica_real*) calloc(rows+1, sizeof(modelica_real));
+  if(!buffer || !in->u || !in->t){
+    throwStreamPrint(NULL, "Failed to allocate memory for %ld rows of external input", (long) rows);
+  }
+  for(i = 0; i <= rows; ++i){
+    in->u[i] = buffer + i*m;
+  }
+  in->N = rows;
+  in->n = 0;
+}
+
+/* Sets indx[i] to the position of input i in names (or -1). The input and
+ * column names are looked up in the variable name index of the model, so
+ * the first column naming the real variable of an input wins. */
+static void externalInputMatchNames(DATA* data, char **names, int numNames, int *indx)
+{
+  const VAR_NAME_INDEX *index = getVariableNameIndex(data->modelData);
+  const VAR_NAME_ENTRY *entry;
+  const int nu = data->modelData->nInputVars;
+  const long nx = data->modelData->nVariablesReal;
+  char **inputNames = (char**) malloc(modelica_integer_max(1, nu)*sizeof(char*));
+  int *inputOfVar = (int*) malloc(modelica_integer_max(1, nx)*sizeof(int));
+  long j, count;
+  int i;
+
+  for(j = 0; j < nx; ++j){
+    inputOfVar[j] = -1;
+  }
+  data->callback->inputNames(data, inputNames);
+  for(i = 0; i < nu; ++i){
+    indx[i] = -1;
+    entry = findVariableName(index, inputNames[i], &count);
+    for(j = 0; j < count; ++j){
+      if(VAR_NAME_REAL_VAR == entry[j].kind){
+        inputOfVar[entry[j].index] = i;
+      }
+    }
+  }
+
+  for(i = 0; i < numNames; ++i){
+    entry = findVariableName(index, names[i], &count);
+    for(j = 0; j < count; ++j){
+      if(VAR_NAME_REAL_VAR == entry[j].kind && -1 != inputOfVar[entry[j].index] && -1 == indx[inputOfVar[entry[j].index]]){
+        indx[inputOfVar[entry[j].index]] = i;
+      }
+    }
+  }
 
+  free(inputOfVar);
+  free(inputNames);
+}
 
 void externalInputallocate2(DATA* data, char *filename){
   int i, j, k;
   struct csv_data *res = read_csv(filename);
-  char ** names;
   int * indx;
   const int nu = data->modelData->nInputVars;
-  const int nnu = modelica_integer_min(nu, res ? res->numvars - 1 : 0);
 
   if (NULL == res) {
     fprintf(stderr, "Failed to read CSV-file %s", filename);
     EXIT(1);
   }
 
-  data->modelData->nInputVars = nu;
+  externalInputAllocRows(data, res->numsteps);
   data->simulationInfo->external_input.n = res->numsteps;
-  data->simulationInfo->external_input.N = data->simulationInfo->external_input.n;
-
-  data->simulationInfo->external_input.u = (modelica_real**)calloc(data->simulationInfo->external_input.n+1, sizeof(modelica_real*));
-
-  names = (char**)malloc(nu * sizeof(char*));
-
-  for(i = 0; i<data->simulationInfo->external_input.n; ++i){
-    data->simulationInfo->external_input.u[i] = (modelica_real*)calloc(nnu, sizeof(modelica_real));
-  }
-
-  data->simulationInfo->external_input.t = (modelica_real*)calloc(data->simulationInfo->external_input.n+1, sizeof(modelica_real));
-
-  data->callback->inputNames(data, names);
 
-  indx = (int*)malloc(nu*sizeof(int));
-  for(i = 0; i < nu; ++i){
-    indx[i] = -1;
-    for(j = 0; j < (res->numvars - 1); ++j){
-      if(strcmp(names[i], res->variables[j]) == 0){
-        indx[i] = j;
-        break;
-      }
-    }
-  }
+  indx = (int*)malloc(modelica_integer_max(1, nu)*sizeof(int));
+  externalInputMatchNames(data, res->variables+1, res->numvars-1, indx);
 
   for(i = 0, k= 0; i < data->simulationInfo->external_input.n; ++i)
     data->simulationInfo->external_input.t[i] = res->data[k++];
 
   for(j = 0; j < nu; ++j){
     if(indx[j] != -1){
-      k = (indx[j])*data->simulationInfo->external_input.n;
+      k = (indx[j]+1)*data->simulationInfo->external_input.n;
       for(i = 0; i < data->simulationInfo->external_input.n; ++i){
         data->simulationInfo->external_input.u[i][j] = res->data[k++];
       }
@@ -151,7 +246,6 @@ void externalInputallocate2(DATA* data, char *filename){
   }
 
   omc_free_csv_reader(res);
-  free(names);
   free(indx);
   data->simulationInfo->external_input.active = data->simulationInfo->external_input.n > 0;
 }
@@ -174,8 +268,6 @@ static inline void externalInputallocate1(DATA* data, FILE * pFile){
   }
 
   --n;
-  data->simulationInfo->external_input.n = n;
-  data->simulationInfo->external_input.N = data->simulationInfo->external_input.n;
   rewind(pFile);
 
   do{
@@ -184,10 +276,8 @@ static inline void externalInputallocate1(DATA* data, FILE * pFile){
   }while(c!='\n');
 
   m = data->modelData->nInputVars;
-  data->simulationInfo->external_input.u = (modelica_real**)calloc(modelica_integer_max(1,n),sizeof(modelica_real*));
-  for(i = 0; i<data->simulationInfo->external_input.n; ++i)
-    data->simulationInfo->external_input.u[i] = (modelica_real*)calloc(modelica_integer_max(1,m),sizeof(modelica_real));
-  data->simulationInfo->external_input.t = (modelica_real*)calloc(modelica_integer_max(1,data->simulationInfo->external_input.n),sizeof(modelica_real));
+  externalInputAllocRows(data, n);
+  data->simulationInfo->external_input.n = n;
 
   for(i = 0; i < data->simulationInfo->external_input.n; ++i){
     c = fscanf(pFile, "%lf", &data->simulationInfo->external_input.t[i]);
@@ -200,17 +290,324 @@ static inline void externalInputallocate1(DATA* data, FILE * pFile){
   fclose(pFile);
 }
 
-int externalInputFree(DATA* data)
+/* Offset of the first non-empty line at or after pos */
+static size_t csvSkipEmptyLines(const char *buf, size_t size, size_t pos)
 {
-  if(data->simulationInfo->external_input.active){
-    int j;
+  while(pos < size && (buf[pos] == '\n' || buf[pos] == '\r')){
+    pos++;
+  }
+  return pos;
+}
+
+/* Offset of the newline ending the line at pos, or size */
+static size_t csvEndOfLine(const char *buf, size_t size, size_t pos)
+{
+  const char *nl = (const char*) memchr(buf + pos, '\n', size - pos);
+  return nl ? (size_t) (nl - buf) : size;
+}
+
+/* Parses the row at pos into t and u; returns 0 on success */
+static int csvParseRow(EXTERNAL_INPUT_STREAM *s, size_t pos, modelica_real *t, modelica_real *u)
+{
+  size_t end = csvEndOfLine(s->map.data, s->map.size, pos);
+  char *p, *next;
+  double val;
+  int col;
+
+  /* copy the line; strtod must not read beyond the end of the mapping */
+  if(end - pos + 1 > s->lineSize){
+    s->lineSize = 2*(end - pos + 1);
+    s->line = (char*) realloc(s->line, s->lineSize);
+  }
+  memcpy(s->line, s->map.data + pos, end - pos);
+  s->line[end - pos] = '\0';
+
+  p = s->line;
+  for(col = 0; col < s->ncols; ++col){
+    while(*p == ' ' || *p == '\t' || *p == '"') p++;
+    val = 0.0; /* empty cells are 0, as in read_csv */
+    if(*p && *p != s->delim && *p != '\r'){
+      val = strtod(p, &next);
+      if(next == p){
+        return 1;
+      }
+      p = next;
+    }
+    while(*p == ' ' || *p == '\t' || *p == '"') p++;
+    if(col == 0){
+      *t = val;
+    }else if(s->columnInput[col] >= 0){
+      u[s->columnInput[col]] = val;
+    }
+    if(*p == s->delim){
+      p++;
+    }else if(col+1 < s->ncols || (*p && *p != '\r')){
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void csvStreamOpen(DATA* data, EXTERNAL_INPUT_STREAM *s, const char *filename, size_t stride)
+{
+  const int nu = data->modelData->nInputVars;
+  char buf[8] = {0};
+  char **variables;
+  int *indx;
+  int numVars, i, inQuote = 0;
+  size_t offset = 0, pos, nCheckpoints = 0;
+  FILE *fin = fopen(filename, "r");
+
+  if(!fin){
+    throwStreamPrint(NULL, "Failed to open input file %s", filename);
+  }
+  s->delim = CSV_COMMA;
+  if(5 == fread(buf, 1, 5, fin) && 0 == strcmp(buf, "\"sep=")){
+    fread(&s->delim, 1, 1, fin);
+    offset = 8;
+  }
+  fseek(fin, offset, SEEK_SET);
+  variables = read_csv_variables(fin, &numVars, s->delim);
+  fclose(fin);
+  if(!variables){
+    throwStreamPrint(NULL, "Failed to read the header of CSV-file %s", filename);
+  }
 
+  s->ncols = numVars+1;
+  s->columnInput = (int*) malloc(s->ncols*sizeof(int));
+  indx = (int*) malloc(modelica_integer_max(1, nu)*sizeof(int));
+  externalInputMatchNames(data, variables+1, numVars, indx);
+  for(i = 0; i < s->ncols; ++i){
+    s->columnInput[i] = -1;
+  }
+  for(i = 0; i < nu; ++i){
+    if(indx[i] >= 0){
+      s->columnInput[indx[i]+1] = i;
+    }
+  }
+  free(indx);
+  for(i = 0; i < s->ncols; ++i){
+    free(variables[i]);
+  }
+  free(variables);
+
+  s->map = omc_mmap_open_read(filename);
+
+  /* skip the header; names may contain quoted newlines */
+  for(pos = offset; pos < s->map.size && (inQuote || s->map.data[pos] != '\n'); ++pos){
+    if(s->map.data[pos] == '"'){
+      inQuote = !inQuote;
+    }
+  }
+
+  /* count the rows and remember every stride-th offset */
+  s->stride = stride;
+  s->nrows = 0;
+  for(pos = csvSkipEmptyLines(s->map.data, s->map.size, pos); pos < s->map.size;
+      pos = csvSkipEmptyLines(s->map.data, s->map.size, csvEndOfLine(s->map.data, s->map.size, pos))){
+    if(s->nrows % stride == 0){
+      if(s->nrows/stride >= nCheckpoints){
+        nCheckpoints = nCheckpoints ? 2*nCheckpoints : 64;
+        s->checkpoints = (size_t*) realloc(s->checkpoints, nCheckpoints*sizeof(size_t));
+      }
+      s->checkpoints[s->nrows/stride] = pos;
+    }
+    s->nrows++;
+  }
+}
+
+static void matStreamOpen(DATA* data, EXTERNAL_INPUT_STREAM *s, const char *filename)
+{
+  const int nu = data->modelData->nInputVars;
+  char **names = (char**) malloc(modelica_integer_max(1, nu)*sizeof(char*));
+  ModelicaMatVariable_t *var;
+  const char *msg;
+  int i;
+
+  msg = omc_new_matlab4_reader(filename, &s->reader);
+  if(msg){
+    free(names);
+    throwStreamPrint(NULL, "Failed to read MAT-file %s: %s", filename, msg);
+  }
+  s->isMat = 1;
+  s->nrows = s->reader.nrows;
+  s->inMemory = s->reader.nvar > 0 && s->reader.vars[0] != NULL;
+  s->row = (double*) malloc(modelica_integer_max(1, s->reader.nvar)*sizeof(double));
+
+  var = omc_matlab4_find_var(&s->reader, "time");
+  if(!var || var->isParam){
+    free(names);
+    throwStreamPrint(NULL, "MAT-file %s does not contain the variable time", filename);
+  }
+  s->timeIndex = var->index;
+
+  /* the reader keeps its variables sorted, so every name is found by binary search */
+  s->inputIndex = (int*) calloc(modelica_integer_max(1, nu), sizeof(int));
+  s->inputIsParam = (modelica_boolean*) calloc(modelica_integer_max(1, nu), sizeof(modelica_boolean));
+  data->callback->inputNames(data, names);
+  for(i = 0; i < nu; ++i){
+    var = omc_matlab4_find_var(&s->reader, names[i]);
+    if(var){
+      s->inputIndex[i] = var->index;
+      s->inputIsParam[i] = var->isParam;
+    }
+  }
+  free(names);
+}
+
+static double matStreamValue(EXTERNAL_INPUT_STREAM *s, int index, modelica_boolean isParam)
+{
+  const double *values = isParam ? s->reader.params : s->row;
+  return index < 0 ? -values[-index-1] : values[index-1];
+}
+
+/* Reads up to count rows starting at row first of the input file; returns
+ * the number of rows read */
+static modelica_integer externalInputStreamRead(DATA* data, EXTERNAL_INPUT_STREAM *s, size_t first, modelica_integer count, modelica_real *t, modelica_real **u)
+{
+  const int nu = data->modelData->nInputVars;
+  modelica_integer k;
+  int i;
+
+  if(first >= s->nrows){
+    return 0;
+  }
+  if((size_t) count > s->nrows - first){
+    count = s->nrows - first;
+  }
+
+  if(s->isMat){
+    const size_t elemSize = s->reader.doublePrecision == 1 ? sizeof(double) : sizeof(float);
+    if(!s->inMemory && 0 != fseek(s->reader.file, s->reader.var_offset + elemSize*first*s->reader.nvar, SEEK_SET)){
+      throwStreamPrint(NULL, "Failed to seek to row %ld of MAT-file %s", (long) first, s->reader.fileName);
+    }
+    for(k = 0; k < count; ++k){
+      if(s->inMemory){
+        for(i = 0; i < s->reader.nvar; ++i){
+          s->row[i] = s->reader.vars[i][first+k];
+        }
+      }else if(elemSize == sizeof(double)){
+        if(s->reader.nvar != fread(s->row, sizeof(double), s->reader.nvar, s->reader.file)){
+          throwStreamPrint(NULL, "Corrupt MAT-file %s at row %ld", s->reader.fileName, (long) (first+k));
+        }
+      }else{
+        float *buffer = (float*) s->row;
+        if(s->reader.nvar != fread(buffer, sizeof(float), s->reader.nvar, s->reader.file)){
+          throwStreamPrint(NULL, "Corrupt MAT-file %s at row %ld", s->reader.fileName, (long) (first+k));
+        }
+        /* widen in place from the back */
+        for(i = s->reader.nvar-1; i >= 0; --i){
+          s->row[i] = buffer[i];
+        }
+      }
+      t[k] = matStreamValue(s, s->timeIndex, 0);
+      for(i = 0; i < nu; ++i){
+        if(s->inputIndex[i]){
+          u[k][i] = matStreamValue(s, s->inputIndex[i], s->inputIsParam[i]);
+        }
+      }
+    }
+  }else{
+    size_t pos = s->checkpoints[first/s->stride], skip;
+    for(skip = first % s->stride; skip > 0; --skip){
+      pos = csvSkipEmptyLines(s->map.data, s->map.size, csvEndOfLine(s->map.data, s->map.size, pos));
+    }
+    for(k = 0; k < count; ++k){
+      if(csvParseRow(s, pos, &t[k], u[k])){
+        throwStreamPrint(NULL, "Found non-double data or a wrong number of cells in row %ld of the CSV input", (long) (first+k+1));
+      }
+      pos = csvSkipEmptyLines(s->map.data, s->map.size, csvEndOfLine(s->map.data, s->map.size, pos));
+    }
+  }
+  return count;
+}
+
+/* Keeps only a window of rows of the input file in memory; see
+ * externalInputStreamSlide for how the window follows the time */
+static void externalInputallocateStream(DATA* data, const char *filename, int isMat, long window)
+{
+  EXTERNAL_INPUT *in = &data->simulationInfo->external_input;
+  EXTERNAL_INPUT_STREAM *s = (EXTERNAL_INPUT_STREAM*) calloc(1, sizeof(EXTERNAL_INPUT_STREAM));
+
+  /* the window must keep some rows on both sides of the current interval */
+  window = window < 4 ? 4 : window;
+  in->stream = s;
+  if(isMat){
+    matStreamOpen(data, s, filename);
+  }else{
+    csvStreamOpen(data, s, filename, window);
+  }
+
+  externalInputAllocRows(data, modelica_integer_min(window, modelica_integer_max(1, s->nrows)));
+  in->first = 0;
+  in->n = externalInputStreamRead(data, s, 0, in->N, in->t, in->u);
+  in->active = in->n > 0;
+  if(!in->active){
+    warningStreamPrint(LOG_STDOUT, 0, "The input file %s contains no rows.", filename);
+    externalInputStreamFree(s);
+    in->stream = NULL;
+  }else{
+    infoStreamPrint(LOG_SIMULATION, 0, "Reading %ld rows of input file %s in windows of %ld rows",
+      (long) s->nrows, filename, (long) in->N);
+  }
+}
+
+static void externalInputStreamFree(EXTERNAL_INPUT_STREAM *s)
+{
+  if(s->isMat){
+    omc_free_matlab4_reader(&s->reader);
+    free(s->row);
+    free(s->inputIndex);
+    free(s->inputIsParam);
+  }else{
+    if(s->map.data){
+      omc_mmap_close_read(s->map);
+    }
+    free(s->checkpoints);
+    free(s->columnInput);
+    free(s->line);
+  }
+  free(s);
+}
+
+/* Moves the window until it contains time t. Moving forward keeps a quarter
+ * of the window before the current interval, since solvers and event
+ * iterations may step back a little. */
+static void externalInputStreamSlide(DATA* data, double t)
+{
+  EXTERNAL_INPUT *in = &data->simulationInfo->external_input;
+  EXTERNAL_INPUT_STREAM *s = (EXTERNAL_INPUT_STREAM*) in->stream;
+  size_t first;
+
+  while(t > in->t[in->n-1] && (size_t) (in->first + in->n) < s->nrows){
+    first = in->first + in->n - 1 - in->N/4;
+    in->n = externalInputStreamRead(data, s, first, in->N, in->t, in->u);
+    in->first = first;
+    in->i = 0;
+  }
+  while(t < in->t[0] && in->first > 0){
+    first = in->first > (size_t) (in->N - in->N/4) ? in->first - (in->N - in->N/4) : 0;
+    in->n = externalInputStreamRead(data, s, first, in->N, in->t, in->u);
+    in->first = first;
+    in->i = modelica_integer_max(0, in->n-2);
+  }
+}
+
+int externalInputFree(DATA* data)
+{
+  /* the rows are also allocated for files without rows, which leave the input inactive */
+  if(data->simulationInfo->external_input.u){
     free(data->simulationInfo->external_input.t);
-    for(j = 0; j < data->simulationInfo->external_input.N; ++j)
-      free(data->simulationInfo->external_input.u[j]);
+    free(data->simulationInfo->external_input.u[0]);
     free(data->simulationInfo->external_input.u);
-    data->simulationInfo->external_input.active = 0;
+    data->simulationInfo->external_input.t = NULL;
+    data->simulationInfo->external_input.u = NULL;
   }
+  if(data->simulationInfo->external_input.stream){
+    externalInputStreamFree((EXTERNAL_INPUT_STREAM*) data->simulationInfo->external_input.stream);
+    data->simulationInfo->external_input.stream = NULL;
+  }
+  data->simulationInfo->external_input.active = 0;
   return 0;
 }
 
@@ -227,6 +624,9 @@ int externalInputUpdate(DATA* data)
   }
 
   t = data->localData[0]->timeValue;
+  if(data->simulationInfo->external_input.stream){
+    externalInputStreamSlide(data, t);
+  }
   t1 = data->simulationInfo->external_input.t[data->simulationInfo->external_input.i];
   t2 = data->simulationInfo->external_input.t[data->simulationInfo->external_input.i+1];
 
@@ -43,12 +43,18 @@
 #include "model_help.h"
 #include "external_input.h"
 #include "newtonIteration.h"
+#include "linearSolverKlu.h"
 #include "irksco.h"
+#include "simulation/options.h"
 
 int wrapper_fvec_irksco(int* n, double* x, double* f, void* userdata, int fj);
 static int refreshModel(DATA* data, threadData_t *threadData, double* x, double time);
 void irksco_first_step(DATA* data, threadData_t* threadData, SOLVER_INFO* solverInfo);
 int rk_imp_step(DATA* data, threadData_t* threadData, SOLVER_INFO* solverInfo, double* y_new);
+#ifdef WITH_UMFPACK
+static int allocateIrkscoKlu(DATA* data, threadData_t *threadData, DATA_IRKSCO* userdata);
+static int irksco_newton_klu(DATA_IRKSCO* userdata, DATA_NEWTON* solverData);
+#endif
 
 
 /*! \fn allocateIrksco
@@ -59,14 +65,44 @@ int rk_imp_step(DATA* data, threadData_t* threadData, SOLVER_INFO* solverInfo, d
  *      (1) implicit euler method
  *
  */
-int allocateIrksco(SOLVER_INFO* solverInfo, int size, int zcSize)
+int allocateIrksco(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo, int size, int zcSize)
 {
   DATA_IRKSCO* userdata = (DATA_IRKSCO*) malloc(sizeof(DATA_IRKSCO));
   solverInfo->solverData = (void*) userdata;
   userdata->order = 1;
   userdata->ordersize = 1;
 
-  allocateNewtonData(userdata->ordersize*size, &(userdata->solverData));
+  userdata->useKlu = 0;
+  userdata->kluData = NULL;
+  userdata->jacIndex = NULL;
+  userdata->jacA = NULL;
+  userdata->xTmp = NULL;
+  userdata->fTmp = NULL;
+  userdata->delta = NULL;
+  userdata->xStart = NULL;
+  if (omc_flag[FLAG_IMPRK_LS] && !strcmp(omc_flagValue[FLAG_IMPRK_LS], IMPRK_LS_METHOD[IMPRK_LS_KLU]))
+  {
+#ifdef WITH_UMFPACK
+    userdata->useKlu = !allocateIrkscoKlu(data, threadData, userdata);
+#else
+    warningStreamPrint(LOG_STDOUT, 0, "irksco: -impRKLS=klu is not available, the runtime was built without KLU. Using dense Newton iteration.");
+#endif
+  }
+
+  if (userdata->useKlu)
+  {
+    /* only x and fvec of the Newton data are used; skip the dense Jacobian */
+    DATA_NEWTON* solverData;
+    allocateNewtonData(0, &(userdata->solverData));
+    solverData = (DATA_NEWTON*) userdata->solverData;
+    solverData->n = size;
+    solverData->x = (double*) realloc(solverData->x, size*sizeof(double));
+    solverData->fvec = (double*) realloc(solverData->fvec, size*sizeof(double));
+  }
+  else
+  {
+    allocateNewtonData(userdata->ordersize*size, &(userdata->solverData));
+  }
   userdata->firstStep = 1;
   userdata->y0 = malloc(sizeof(double)*size);
   userdata->y05= malloc(sizeof(double)*size);
@@ -118,9 +154,263 @@ int freeIrksco(SOLVER_INFO* solverInfo)
   free(userdata->zeroCrossingValues);
   free(userdata->zeroCrossingValuesOld);
 
+#ifdef WITH_UMFPACK
+  if (userdata->useKlu)
+  {
+    freeKluData(&userdata->kluData);
+    free(userdata->kluData);
+    free(userdata->jacIndex);
+    free(userdata->jacA);
+    free(userdata->xTmp);
+    free(userdata->fTmp);
+    free(userdata->delta);
+    free(userdata->xStart);
+  }
+#endif
+
+  return 0;
+}
+
+#ifdef WITH_UMFPACK
+/*! \fn allocateIrkscoKlu
+ *
+ *   Sets up the sparse Newton matrix I - h*A from the sparsity pattern of the
+ *   ODE Jacobian A. Returns 0 on success, otherwise the dense Newton iteration
+ *   is used.
+ */
+static int allocateIrkscoKlu(DATA* data, threadData_t *threadData, DATA_IRKSCO* userdata)
+{
+  ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A]);
+  SPARSE_PATTERN* sparsePattern;
+  DATA_KLU* kluData;
+  const int n = data->modelData->nStates;
+  int i, j, nz, hasDiagonal;
+
+  if (n == 0 || data->callback->initialAnalyticJacobianA(data, threadData, jacobian))
+  {
+    warningStreamPrint(LOG_STDOUT, 0, "irksco: sparsity pattern of the Jacobian is not available, using dense Newton iteration.");
+    return 1;
+  }
+  sparsePattern = &(jacobian->sparsePattern);
+
+  /* the pattern of A plus the missing diagonal elements */
+  allocateKluData(n, n, sparsePattern->numberOfNoneZeros + n, &userdata->kluData);
+  kluData = (DATA_KLU*) userdata->kluData;
+  userdata->jacIndex = (int*) malloc((sparsePattern->numberOfNoneZeros + n)*sizeof(int));
+  for (i=0, nz=0; i<n; i++)
+  {
+    kluData->Ap[i] = nz;
+    hasDiagonal = 0;
+    for (j=sparsePattern->leadindex[i]; j<sparsePattern->leadindex[i+1]; j++)
+    {
+      kluData->Ai[nz] = sparsePattern->index[j];
+      userdata->jacIndex[nz++] = j;
+      hasDiagonal |= sparsePattern->index[j] == i;
+    }
+    if (!hasDiagonal)
+    {
+      kluData->Ai[nz] = i;
+      userdata->jacIndex[nz++] = -1;
+    }
+  }
+  kluData->Ap[n] = nz;
+  kluData->nnz = nz;
+
+  userdata->jacA = (double*) calloc(sparsePattern->numberOfNoneZeros, sizeof(double));
+  userdata->xTmp = (double*) malloc(n*sizeof(double));
+  userdata->fTmp = (double*) malloc(n*sizeof(double));
+  userdata->delta = (double*) malloc(n*sizeof(double));
+  userdata->xStart = (double*) malloc(n*sizeof(double));
+  userdata->jacobianValid = 0;
+  userdata->jacStepSize = 0;
+
+  infoStreamPrint(LOG_SOLVER, 1, "irksco: sparse Newton iteration with KLU");
+  infoStreamPrint(LOG_SOLVER, 0, "NNZ: %d colors: %d", nz, sparsePattern->maxColors);
+  messageClose(LOG_SOLVER);
+  return 0;
+}
+
+/*! \fn irksco_jacobian_klu
+ *
+ *  Evaluates the ODE Jacobian at y0 + x by finite differences over the
+ *  colors of its sparsity pattern.
+ */
+static void irksco_jacobian_klu(DATA_IRKSCO* userdata, double* x, double time)
+{
+  DATA* data = userdata->data;
+  threadData_t* threadData = userdata->threadData;
+  ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A]);
+  SPARSE_PATTERN* sparsePattern = &(jacobian->sparsePattern);
+  modelica_real* stateDer = data->localData[0]->realVars + data->modelData->nStates;
+  const double delta_h = sqrt(DBL_EPSILON*2e1);
+  const int n = data->modelData->nStates;
+  unsigned int i, j, color;
+
+  /* profiling */
+  rt_tick(SIM_TIMER_JACOBIAN);
+
+  for (i=0; i<n; i++)
+  {
+    userdata->xTmp[i] = userdata->y0[i] + x[i];
+  }
+  refreshModel(data, threadData, userdata->xTmp, time);
+  memcpy(userdata->fTmp, stateDer, n*sizeof(double));
+
+  for (color=0; color<sparsePattern->maxColors; color++)
+  {
+    for (i=0; i<n; i++)
+    {
+      if (sparsePattern->colorCols[i]-1 == color)
+      {
+        userdata->delta[i] = delta_h*(fabs(userdata->xTmp[i]) + 1.0);
+        userdata->xTmp[i] += userdata->delta[i];
+      }
+    }
+    refreshModel(data, threadData, userdata->xTmp, time);
+    for (i=0; i<n; i++)
+    {
+      if (sparsePattern->colorCols[i]-1 == color)
+      {
+        for (j=sparsePattern->leadindex[i]; j<sparsePattern->leadindex[i+1]; j++)
+        {
+          userdata->jacA[j] = (stateDer[sparsePattern->index[j]] - userdata->fTmp[sparsePattern->index[j]]) / userdata->delta[i];
+        }
+        userdata->xTmp[i] = userdata->y0[i] + x[i];
+      }
+    }
+  }
+
+  userdata->evalFunctionODE += sparsePattern->maxColors + 1;
+  userdata->evalJacobians++;
+  userdata->jacobianValid = 1;
+  userdata->jacStepSize = 0;
+
+  /* profiling */
+  rt_accumulate(SIM_TIMER_JACOBIAN);
+}
+
+/*! \fn irksco_factorize_klu
+ *
+ *  Factorizes the Newton matrix I - h*A for the current step size. The
+ *  pivots of the previous factorization are reused as long as they are
+ *  accurate enough.
+ */
+static int irksco_factorize_klu(DATA_IRKSCO* userdata)
+{
+  DATA_KLU* kluData = (DATA_KLU*) userdata->kluData;
+  const double h = userdata->radauStepSize;
+  int i, nz;
+
+  for (i=0; i<kluData->n_col; i++)
+  {
+    for (nz=kluData->Ap[i]; nz<kluData->Ap[i+1]; nz++)
+    {
+      kluData->Ax[nz] = (userdata->jacIndex[nz] < 0 ? 0.0 : -h*userdata->jacA[userdata->jacIndex[nz]]) + (kluData->Ai[nz] == i ? 1.0 : 0.0);
+    }
+  }
+
+  if (!kluData->symbolic)
+  {
+    kluData->symbolic = klu_analyze(kluData->n_col, kluData->Ap, kluData->Ai, &kluData->common);
+  }
+  if (kluData->numeric)
+  {
+    klu_refactor(kluData->Ap, kluData->Ai, kluData->Ax, kluData->symbolic, kluData->numeric, &kluData->common);
+    klu_rgrowth(kluData->Ap, kluData->Ai, kluData->Ax, kluData->symbolic, kluData->numeric, &kluData->common);
+    if (kluData->common.status != KLU_OK || kluData->common.rgrowth < 1e-3)
+    {
+      klu_free_numeric(&kluData->numeric, &kluData->common);
+    }
+  }
+  if (!kluData->numeric && kluData->symbolic)
+  {
+    kluData->numeric = klu_factor(kluData->Ap, kluData->Ai, kluData->Ax, kluData->symbolic, &kluData->common);
+  }
+  if (!kluData->numeric || kluData->common.status != KLU_OK)
+  {
+    return -1;
+  }
+  userdata->jacStepSize = h;
   return 0;
 }
 
+/*! \fn irksco_newton_klu
+ *
+ *  Simplified Newton iteration with the sparse matrix I - h*A. The ODE
+ *  Jacobian A is kept over iterations and steps; it is only evaluated again
+ *  if the iteration does not converge. A new step size only needs a new
+ *  numeric factorization.
+ *  Sets solverData->info to 1 on success and -1 otherwise.
+ */
+static int irksco_newton_klu(DATA_IRKSCO* userdata, DATA_NEWTON* solverData)
+{
+  DATA_KLU* kluData = (DATA_KLU*) userdata->kluData;
+  int n = solverData->n;
+  double *x = solverData->x, *fvec = solverData->fvec;
+  double norm, normOld, sc;
+  int i, iter, fresh;
+  const int maxIter = 10;
+
+  memcpy(userdata->xStart, x, n*sizeof(double));
+  do
+  {
+    fresh = !userdata->jacobianValid;
+    if (fresh)
+    {
+      irksco_jacobian_klu(userdata, x, userdata->radauTimeOld + userdata->c[0] * userdata->radauStepSize);
+    }
+    if (userdata->jacStepSize != userdata->radauStepSize && irksco_factorize_klu(userdata))
+    {
+      userdata->jacobianValid = 0;
+      if (fresh)
+      {
+        break;
+      }
+      continue;
+    }
+
+    normOld = DBL_MAX;
+    for (iter=0; iter<maxIter; iter++)
+    {
+      wrapper_fvec_irksco(&n, x, fvec, userdata, 1);
+      solverData->numberOfFunctionEvaluations++;
+      solverData->numberOfIterations++;
+      if (!klu_solve(kluData->symbolic, kluData->numeric, n, 1, fvec, &kluData->common))
+      {
+        break;
+      }
+      for (i=0, norm=0.0; i<n; i++)
+      {
+        x[i] -= fvec[i];
+        sc = fabs(fvec[i]) / (fabs(userdata->y0[i] + x[i]) + 1.0);
+        norm = fmax(norm, sc);
+      }
+      if (isnan(norm))
+      {
+        break;
+      }
+      if (norm <= solverData->xtol)
+      {
+        solverData->info = 1;
+        return 0;
+      }
+      /* too slow, the Jacobian is probably outdated */
+      if (norm > 0.9*normOld)
+      {
+        break;
+      }
+      normOld = norm;
+    }
+
+    memcpy(x, userdata->xStart, n*sizeof(double));
+    userdata->jacobianValid = 0;
+  } while (!fresh);
+
+  solverData->info = -1;
+  return -1;
+}
+#endif
+
 /*! \fn checkForZeroCrossingsIrksco
  *
  *   This function checks for ZeroCrossings.
@@ -229,11 +519,23 @@ int rk_imp_step(DATA* data, threadData_t* threadData, SOLVER_INFO* solverInfo, d
     }
   }
 
-  solverData->newtonStrategy = NEWTON_DAMPED2;
-  _omc_newton(wrapper_fvec_irksco, solverData, (void*)userdata);
+#ifdef WITH_UMFPACK
+  if (userdata->useKlu)
+  {
+    if (irksco_newton_klu(userdata, solverData))
+    {
+      warningStreamPrint(LOG_SOLVER, 0, "sparse Newton iteration did not converge at time %e", solverInfo->currentTime);
+    }
+  }
+  else
+#endif
+  {
+    solverData->newtonStrategy = NEWTON_DAMPED2;
+    _omc_newton(wrapper_fvec_irksco, solverData, (void*)userdata);
+  }
 
   /* if newton solver did not converge, do iteration again but calculate jacobian in every step */
-  if (solverData->info == -1)
+  if (solverData->info == -1 && !userdata->useKlu)
   {
     for (i=0; i<userdata->ordersize; i++)
     {
@@ -590,6 +892,9 @@ void irksco_first_step(DATA* data, threadData_t* threadData, SOLVER_INFO* solver
 
   int i,j;
 
+  /* the iteration matrix is evaluated again after an event */
+  userdata->jacobianValid = 0;
+
   /* initialize radau values */
   for (i=0; i<data->modelData->nStates; i++)
   {
@@ -59,10 +59,19 @@ typedef struct DATA_IRKSCO{
   unsigned int stepsDone;
   unsigned int evalFunctionODE;
   unsigned int evalJacobians;
+
+  /* sparse Newton iteration (-impRKLS=klu) */
+  int useKlu;
+  void* kluData;                        /* DATA_KLU of the Newton matrix I - h*A */
+  int *jacIndex;                        /* element of jacA for each element of the Newton matrix, -1 for added diagonals */
+  double *jacA;                         /* ODE Jacobian in the sparse pattern of INDEX_JAC_A */
+  double *xTmp, *fTmp, *delta, *xStart;
+  double jacStepSize;                   /* step size of the factorized Newton matrix */
+  int jacobianValid;                    /* 0 if the ODE Jacobian has to be evaluated again */
 }DATA_IRKSCO;
 
 
-int allocateIrksco(SOLVER_INFO* solverInfo, int size, int zcSize);
+int allocateIrksco(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo, int size, int zcSize);
 int freeIrksco(SOLVER_INFO* solverInfo);
 int irksco_richardson(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo);
 int irksco_midpoint_rule(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo);
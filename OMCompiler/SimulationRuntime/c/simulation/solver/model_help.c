@@ -50,6 +50,7 @@
 #include "epsilon.h"
 #include "fmi_events.h"
 #include "stateset.h"
+#include "equationTaskGraph.h"
 #include "../../meta/meta_modelica.h"
 
 int maxEventIterations = 20;
@@ -1044,6 +1045,10 @@ void initializeDataStruc(DATA *data, threadData_t *threadData)
   data->modelData->modelDataXml.functionNames = NULL;
   data->modelData->modelDataXml.equationInfo = NULL;
 
+  /* task graphs for the parallel evaluation of the equations, built on first use */
+  data->simulationInfo->equationTaskGraphs[0] = NULL;
+  data->simulationInfo->equationTaskGraphs[1] = NULL;
+
   /* buffer for external objects */
   data->simulationInfo->extObjs = NULL;
   data->simulationInfo->extObjs = (void**) calloc(data->modelData->nExtObjs, sizeof(void*));
@@ -1105,6 +1110,9 @@ void initializeDataStruc(DATA *data, threadData_t *threadData)
     data->modelData->realSensitivityData = (STATIC_REAL_DATA*) omc_alloc_interface.malloc_uncollectable(data->modelData->nSensitivityVars * sizeof(STATIC_REAL_DATA));
   }
 
+  /* the name index is built when the variables are read */
+  data->modelData->variableNameIndex.n = 0;
+  data->modelData->variableNameIndex.entries = NULL;
 
   TRACE_POP
 }
@@ -1211,6 +1219,9 @@ void deInitializeDataStruc(DATA *data)
   /* free buffer jacobians */
   omc_alloc_interface.free_uncollectable(data->simulationInfo->analyticJacobians);
 
+  /* free task graphs of the parallel evaluation */
+  freeEquationTaskGraphs(data);
+
   /* free buffer for state sets */
   omc_alloc_interface.free_uncollectable(data->simulationInfo->daeModeData);
 
@@ -1250,6 +1261,11 @@ void deInitializeDataStruc(DATA *data)
     FREE_VARS(nSensitivityVars, realSensitivityData)
   }
 
+  /* free variable name index */
+  free(data->modelData->variableNameIndex.entries);
+  data->modelData->variableNameIndex.entries = NULL;
+  data->modelData->variableNameIndex.n = 0;
+
   TRACE_POP
 }
 
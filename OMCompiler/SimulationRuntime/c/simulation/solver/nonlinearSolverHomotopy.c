@@ -1313,7 +1313,7 @@ static int newtonAlgorithm(DATA_HOMOTOPY* solverData, double* x)
 
   int assert = 1;
   threadData_t *threadData = solverData->threadData;
-  NONLINEAR_SYSTEM_DATA* nonlinsys = &(solverData->data->simulationInfo->nonlinearSystemData[solverData->data->simulationInfo->currentNonlinearSystemIndex]);
+  NONLINEAR_SYSTEM_DATA* nonlinsys = &(solverData->data->simulationInfo->nonlinearSystemData[solverData->sysNumber]);
   int linearSolverMethod = solverData->data->simulationInfo->nlsLinearSolver;
 
   /* debug information */
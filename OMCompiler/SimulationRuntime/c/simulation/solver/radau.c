@@ -37,6 +37,7 @@
 
 #include <string.h>
 #include <math.h>
+#include <float.h>
 
 #include "radau.h"
 #include "external_input.h"
@@ -53,6 +54,7 @@
 #include <kinsol/kinsol_dense.h>
 #include <kinsol/kinsol_spgmr.h>
 #include <kinsol/kinsol_sptfqmr.h>
+#include <kinsol/kinsol_klu.h>
 #include <sundials/sundials_types.h>
 #include <sundials/sundials_math.h>
 
@@ -78,6 +80,9 @@ static int freeKinsol(void * kOde);
 
 static int boundsVars(KINODE *kinOde);
 
+static int allocateSparseJacobian(KINODE *kinOde);
+static int radauSparseJac(N_Vector x, N_Vector f, SlsMat Jac, void* user_data, N_Vector tmp1, N_Vector tmp2);
+
 static int radau1Coeff(KINODE *kinOd);
 static int radau3Coeff(KINODE *kinOde);
 static int radau5Coeff(KINODE *kinOd);
@@ -91,6 +96,8 @@ static int lobatto2Res(N_Vector z, N_Vector f, void* user_data);
 static int lobatto4Res(N_Vector z, N_Vector f, void* user_data);
 static int lobatto6Res(N_Vector z, N_Vector f, void* user_data);
 
+static int refreshModell(DATA* data, threadData_t *threadData, double* x, double time);
+
 int allocateKinOde(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo, int order)
 {
   int i;
@@ -101,6 +108,17 @@ int allocateKinOde(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo
   kinOde->N = ceil((double)order/2.0);
   kinOde->data = data;
   kinOde->threadData = threadData;
+  kinOde->nnz = 0;
+  kinOde->colPtr = NULL;
+  kinOde->rowIdx = NULL;
+  kinOde->jacIndex = NULL;
+  kinOde->coeff = NULL;
+  kinOde->jacScale = NULL;
+  kinOde->jacA = NULL;
+  kinOde->xTmp = NULL;
+  kinOde->fTmp = NULL;
+  kinOde->delta = NULL;
+  kinOde->reuseJacobian = 0;
   allocateNlpOde(kinOde, order);
   allocateKINSOLODE(kinOde);
   kinOde->solverInfo = solverInfo;
@@ -186,6 +204,19 @@ int allocateKinOde(DATA* data, threadData_t *threadData, SOLVER_INFO* solverInfo
     case IMPRK_LS_DENSE:
       KINDense(kinOde->kData->kmem, kinOde->N*kinOde->nlp->nStates);
       break;
+    case IMPRK_LS_KLU:
+      if (allocateSparseJacobian(kinOde))
+      {
+        warningStreamPrint(LOG_STDOUT, 0, "Sparsity pattern of the Jacobian is not available, using dense linear solver for the stages.");
+        kinOde->lsMethod = IMPRK_LS_DENSE;
+        KINDense(kinOde->kData->kmem, kinOde->N*kinOde->nlp->nStates);
+      }
+      else
+      {
+        KINKLU(kinOde->kData->kmem, kinOde->N*kinOde->nlp->nStates, kinOde->nnz);
+        KINSlsSetSparseJacFn(kinOde->kData->kmem, radauSparseJac);
+      }
+      break;
     default:
       throwStreamPrint(threadData,"unrecognized linear solver method %s", (const char*)omc_flagValue[FLAG_IMPRK_LS]);
     break;
@@ -270,10 +301,189 @@ int freeKinOde(DATA* data, SOLVER_INFO* solverInfo)
   KINODE *kinOde = (KINODE*) solverInfo->solverData;
   freeImOde((void*) kinOde->nlp, kinOde->N);
   freeKinsol((void*) kinOde->kData);
+  free(kinOde->colPtr);
+  free(kinOde->rowIdx);
+  free(kinOde->jacIndex);
+  free(kinOde->coeff);
+  free(kinOde->jacScale);
+  free(kinOde->jacA);
+  free(kinOde->xTmp);
+  free(kinOde->fTmp);
+  free(kinOde->delta);
   free(kinOde);
   return 0;
 }
 
+/* Coefficients of the stage states x_k in the residual of stage j (lin[j*N+k])
+ * and the factor of dt*f(x_j) in it (derScale[j]), see the residual functions */
+static void stageCoefficients(KINODE *kinOde, double *lin, double *derScale)
+{
+  long double **c = kinOde->nlp->c;
+  int j;
+
+  for(j=0; j<kinOde->N; ++j)
+    derScale[j] = 1.0;
+
+  switch(kinOde->order)
+  {
+    case 1:
+      lin[0] = -1.0;
+      break;
+    case 2:
+      lin[0] = -1.0;
+      derScale[0] = 0.5;
+      break;
+    case 3:
+      lin[0] = -c[0][1]; lin[1] = -c[0][2];
+      lin[2] =  c[1][1]; lin[3] = -c[1][2];
+      break;
+    case 4:
+      lin[0] = -4.0; lin[1] = -1.0;
+      lin[2] = 16.0; lin[3] = -8.0;
+      derScale[0] = derScale[1] = 2.0;
+      break;
+    case 5:
+    case 6:
+      lin[0] = -c[0][1]; lin[1] = -c[0][2]; lin[2] =  c[0][3];
+      lin[3] =  c[1][1]; lin[4] = -c[1][2]; lin[5] = -c[1][3];
+      lin[6] = -c[2][1]; lin[7] =  c[2][2]; lin[8] = -c[2][3];
+      break;
+    default:
+      assert(0);
+  }
+}
+
+/* Sets up the pattern of the stage Jacobian
+ *   J(j,k) = lin[j*N+k]*I + delta_jk*derScale[j]*dt*A
+ * from the sparsity pattern of the ODE Jacobian A. Returns 0 on success. */
+static int allocateSparseJacobian(KINODE *kinOde)
+{
+  DATA *data = kinOde->data;
+  ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A]);
+  SPARSE_PATTERN* sparsePattern;
+  const int n = kinOde->nlp->nStates, N = kinOde->N;
+  double lin[9], derScale[3];
+  int i, j, k, l, nz, col, hasDiagonal;
+
+  if (n == 0 || data->callback->initialAnalyticJacobianA(data, kinOde->threadData, jacobian))
+  {
+    return 1;
+  }
+  sparsePattern = &(jacobian->sparsePattern);
+  stageCoefficients(kinOde, lin, derScale);
+
+  kinOde->nnz = N*sparsePattern->numberOfNoneZeros + N*N*n;
+  kinOde->colPtr = (int*) malloc((N*n+1)*sizeof(int));
+  kinOde->rowIdx = (int*) malloc(kinOde->nnz*sizeof(int));
+  kinOde->jacIndex = (int*) malloc(kinOde->nnz*sizeof(int));
+  kinOde->coeff = (double*) malloc(kinOde->nnz*sizeof(double));
+  kinOde->jacScale = (double*) malloc(kinOde->nnz*sizeof(double));
+  kinOde->jacA = (double*) calloc(sparsePattern->numberOfNoneZeros, sizeof(double));
+  kinOde->xTmp = (double*) malloc(n*sizeof(double));
+  kinOde->fTmp = (double*) malloc(n*sizeof(double));
+  kinOde->delta = (double*) malloc(n*sizeof(double));
+
+  for(k=0, nz=0, col=0; k<N; ++k)
+  {
+    for(i=0; i<n; ++i, ++col)
+    {
+      kinOde->colPtr[col] = nz;
+      for(j=0; j<N; ++j)
+      {
+        if (j == k)
+        {
+          hasDiagonal = 0;
+          for(l=sparsePattern->leadindex[i]; l<sparsePattern->leadindex[i+1]; ++l, ++nz)
+          {
+            kinOde->rowIdx[nz] = j*n + sparsePattern->index[l];
+            kinOde->jacIndex[nz] = l;
+            kinOde->coeff[nz] = sparsePattern->index[l] == i ? lin[j*N+k] : 0.0;
+            kinOde->jacScale[nz] = derScale[j];
+            hasDiagonal |= sparsePattern->index[l] == i;
+          }
+          if (hasDiagonal)
+            continue;
+        }
+        kinOde->rowIdx[nz] = j*n + i;
+        kinOde->jacIndex[nz] = -1;
+        kinOde->coeff[nz] = lin[j*N+k];
+        kinOde->jacScale[nz] = 0.0;
+        ++nz;
+      }
+    }
+  }
+  kinOde->colPtr[col] = nz;
+  kinOde->nnz = nz;
+
+  infoStreamPrint(LOG_SOLVER, 1, "Sparse stage Jacobian for KLU:");
+  infoStreamPrint(LOG_SOLVER, 0, "columns: %d NNZ: %d colors of the ODE Jacobian: %d", col, nz, sparsePattern->maxColors);
+  messageClose(LOG_SOLVER);
+  return 0;
+}
+
+/* ODE Jacobian at the states x by finite differences over the colors of its
+ * sparsity pattern */
+static void radauJacobianA(KINODE *kinOde, double *x, double time)
+{
+  DATA *data = kinOde->data;
+  ANALYTIC_JACOBIAN* jacobian = &(data->simulationInfo->analyticJacobians[data->callback->INDEX_JAC_A]);
+  SPARSE_PATTERN* sparsePattern = &(jacobian->sparsePattern);
+  const int n = kinOde->nlp->nStates;
+  const double delta_h = sqrt(DBL_EPSILON*2e1);
+  double *derx = data->localData[0]->realVars + n;
+  unsigned int i, l, color;
+
+  memcpy(kinOde->xTmp, x, n*sizeof(double));
+  refreshModell(data, kinOde->threadData, kinOde->xTmp, time);
+  memcpy(kinOde->fTmp, derx, n*sizeof(double));
+
+  for(color=0; color<sparsePattern->maxColors; ++color)
+  {
+    for(i=0; i<n; ++i)
+    {
+      if (sparsePattern->colorCols[i]-1 == color)
+      {
+        kinOde->delta[i] = delta_h*(fabs(x[i]) + 1.0);
+        kinOde->xTmp[i] += kinOde->delta[i];
+      }
+    }
+    refreshModell(data, kinOde->threadData, kinOde->xTmp, time);
+    for(i=0; i<n; ++i)
+    {
+      if (sparsePattern->colorCols[i]-1 == color)
+      {
+        for(l=sparsePattern->leadindex[i]; l<sparsePattern->leadindex[i+1]; ++l)
+        {
+          kinOde->jacA[l] = (derx[sparsePattern->index[l]] - kinOde->fTmp[sparsePattern->index[l]]) / kinOde->delta[i];
+        }
+        kinOde->xTmp[i] = x[i];
+      }
+    }
+  }
+}
+
+/* Stage Jacobian for KINKLU. Like the simplified Newton method of RADAU5 one
+ * ODE Jacobian, evaluated at the last stage, is used for all stages. */
+static int radauSparseJac(N_Vector x, N_Vector f, SlsMat Jac, void* user_data, N_Vector tmp1, N_Vector tmp2)
+{
+  KINODE* kinOde = (KINODE*)user_data;
+  NLPODE *nlp = kinOde->nlp;
+  const int m = kinOde->N*nlp->nStates;
+  int nz;
+
+  radauJacobianA(kinOde, NV_DATA_S(x) + (kinOde->N-1)*nlp->nStates, nlp->t0 + nlp->dt);
+
+  memcpy(Jac->colptrs, kinOde->colPtr, (m+1)*sizeof(int));
+  memcpy(Jac->rowvals, kinOde->rowIdx, kinOde->nnz*sizeof(int));
+  for(nz=0; nz<kinOde->nnz; ++nz)
+  {
+    Jac->data[nz] = kinOde->coeff[nz];
+    if (kinOde->jacIndex[nz] >= 0)
+      Jac->data[nz] += nlp->dt*kinOde->jacScale[nz]*kinOde->jacA[kinOde->jacIndex[nz]];
+  }
+  return 0;
+}
+
 static int freeImOde(void *nlpode, int N)
 {
   int i;
@@ -391,6 +601,20 @@ int kinsolOde(SOLVER_INFO* solverInfo)
           try_again= 0;
         }
         break;
+      case IMPRK_LS_KLU:
+        /* the factorization of an earlier step may be outdated, retry with a new one */
+        if (kData->error_code < 0 && kinOde->reuseJacobian)
+        {
+          kinOde->reuseJacobian = 0;
+          KINSetNoInitSetup(kinOde->kData->kmem, FALSE);
+          initKinsol(kinOde);
+          warningStreamPrint(LOG_SOLVER,0,"Restart Kinsol: evaluate the stage Jacobian again.");
+        }
+        else
+        {
+          try_again= 0;
+        }
+        break;
       case IMPRK_LS_DENSE:
         dense=1;
         if (retries== 1)
@@ -410,6 +634,13 @@ int kinsolOde(SOLVER_INFO* solverInfo)
 
   }while(kData->error_code < 0 && try_again);
 
+  if (kinOde->lsMethod == IMPRK_LS_KLU)
+  {
+    /* reuse the factorization in the next step, KINSOL sets it up again if it does not converge */
+    kinOde->reuseJacobian = kData->error_code >= 0;
+    KINSetNoInitSetup(kinOde->kData->kmem, kinOde->reuseJacobian);
+  }
+
   /* save stats */
   /* steps */
   solverInfo->solverStatsTmp[0] += 1;
@@ -426,7 +657,11 @@ int kinsolOde(SOLVER_INFO* solverInfo)
   /* Jacobians evaluations */
   {
     long int tmp = 0;
-    if (dense)
+    if (kinOde->lsMethod == IMPRK_LS_KLU)
+    {
+      flag = KINSlsGetNumJacEvals(kData->kmem, &tmp);
+    }
+    else if (dense)
     {
       flag = KINDlsGetNumJacEvals(kData->kmem, &tmp);
     }
@@ -94,6 +94,17 @@
       int N;
       int order;
       int lsMethod;        /* specifies the method the used linear solver */
+
+      /* sparse stage Jacobian for IMPRK_LS_KLU */
+      int nnz;
+      int *colPtr;         /* column compressed pattern of the stage Jacobian */
+      int *rowIdx;
+      int *jacIndex;       /* element of jacA, -1 if the element does not depend on the ODE Jacobian */
+      double *coeff;       /* constant part of each element */
+      double *jacScale;    /* factor of dt*jacA of each element */
+      double *jacA;        /* ODE Jacobian in the sparse pattern of INDEX_JAC_A */
+      double *xTmp, *fTmp, *delta;
+      int reuseJacobian;   /* keep the factorization of the previous step */
     }KINODE;
 
 #else
@@ -52,6 +52,7 @@
 #include "linearSystem.h"
 #include "sym_solver_ssc.h"
 #include "irksco.h"
+#include "ensemble.h"
 #if !defined(OMC_MINIMAL_RUNTIME)
 #include "simulation/solver/embedded_server.h"
 #include "simulation/solver/real_time_sync.h"
@@ -239,7 +240,7 @@ int initializeSolverData(DATA* data, threadData_t *threadData, SOLVER_INFO* solv
   }
   case S_IRKSCO:
   {
-    allocateIrksco(solverInfo, data->modelData->nStates, data->modelData->nZeroCrossings);
+    allocateIrksco(data, threadData, solverInfo, data->modelData->nStates, data->modelData->nZeroCrossings);
     break;
   }
   case S_ERKSSC:
@@ -668,6 +669,7 @@ int solver_main(DATA* data, threadData_t *threadData, const char* init_initMetho
   int i, retVal = 1, initSolverInfo = 0;
   unsigned int ui;
   SOLVER_INFO solverInfo;
+  ENSEMBLE_DATA* ensemble = NULL;
   SIMULATION_INFO *simInfo = data->simulationInfo;
   void *dllHandle=NULL;
 
@@ -722,6 +724,11 @@ int solver_main(DATA* data, threadData_t *threadData, const char* init_initMetho
   retVal = initializeSolverData(data, threadData, &solverInfo);
   initSolverInfo = 1;
 
+  /* the members of an ensemble are simulated after the model itself */
+  if (0 == retVal && omc_flag[FLAG_ENSEMBLE]){
+    ensemble = allocateEnsemble(data, &solverInfo, omc_flagValue[FLAG_ENSEMBLE]);
+  }
+
   /* initialize all parts of the model */
   if (0 == retVal){
     retVal = initializeModel(data, threadData, init_initMethod, init_file, init_time);
@@ -801,6 +808,12 @@ int solver_main(DATA* data, threadData_t *threadData, const char* init_initMetho
       //if (solverInfo.solverMethod == S_SYM_SOLVER_SSC) data->callback->symbolicInlineSystems(data, threadData, 0, 2);
       finishSimulation(data, threadData, &solverInfo, outputVariablesAtEnd);
       omc_alloc_interface.collect_a_little();
+
+      if (ensemble) {
+        if (ensembleSimulateMembers(data, threadData, ensemble, solverInfo.solverMethod, init_initMethod, init_file, init_time)) {
+          warningStreamPrint(LOG_STDOUT, 0, "Not all members of the ensemble could be simulated.");
+        }
+      }
     }
   }
 
@@ -821,6 +834,8 @@ int solver_main(DATA* data, threadData_t *threadData, const char* init_initMetho
   /*  free external input data */
   externalInputFree(data);
 
+  freeEnsemble(ensemble);
+
   /* free SolverInfo memory */
   if (initSolverInfo)
   {
@@ -0,0 +1,336 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/*
+ * file variable_name_index.c
+ * Sorted name index of all model variables, see variable_name_index.h.
+ * Lookups are binary searches, so each of them is O(log n) without any
+ * per-consumer hash map and the index is built with a single sort.
+ */
+
+#include "variable_name_index.h"
+#include "../util/omc_error.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _MSC_VER
+  #include <regex.h>
+#endif
+
+static int compareVariableNames(const void *a, const void *b)
+{
+  const VAR_NAME_ENTRY *x = (const VAR_NAME_ENTRY*) a;
+  const VAR_NAME_ENTRY *y = (const VAR_NAME_ENTRY*) b;
+  int c = strcmp(x->name, y->name);
+  if (c) {
+    return c;
+  }
+  /* keep duplicated names in a reproducible order */
+  if (x->kind != y->kind) {
+    return x->kind < y->kind ? -1 : 1;
+  }
+  return x->index < y->index ? -1 : x->index > y->index;
+}
+
+void initVariableNameIndex(VAR_NAME_INDEX *index, long capacity)
+{
+  free(index->entries);
+  index->n = 0;
+  index->entries = (VAR_NAME_ENTRY*) malloc((capacity > 0 ? capacity : 1) * sizeof(VAR_NAME_ENTRY));
+  assertStreamPrint(NULL, NULL != index->entries, "Out of memory while allocating the variable name index");
+}
+
+/* the index has to be initialized with a sufficient capacity */
+void addVariableName(VAR_NAME_INDEX *index, const char *name, int kind, long i)
+{
+  VAR_NAME_ENTRY *entry = &index->entries[index->n++];
+  entry->name = name;
+  entry->kind = kind;
+  entry->index = i;
+}
+
+void sortVariableNameIndex(VAR_NAME_INDEX *index)
+{
+  qsort(index->entries, index->n, sizeof(VAR_NAME_ENTRY), compareVariableNames);
+}
+
+static long numberOfNames(MODEL_DATA *modelData, int kind)
+{
+  switch (kind) {
+  case VAR_NAME_REAL_VAR: return modelData->nVariablesReal;
+  case VAR_NAME_INTEGER_VAR: return modelData->nVariablesInteger;
+  case VAR_NAME_BOOLEAN_VAR: return modelData->nVariablesBoolean;
+  case VAR_NAME_STRING_VAR: return modelData->nVariablesString;
+  case VAR_NAME_REAL_PARAM: return modelData->nParametersReal;
+  case VAR_NAME_INTEGER_PARAM: return modelData->nParametersInteger;
+  case VAR_NAME_BOOLEAN_PARAM: return modelData->nParametersBoolean;
+  case VAR_NAME_STRING_PARAM: return modelData->nParametersString;
+  case VAR_NAME_REAL_ALIAS: return modelData->nAliasReal;
+  case VAR_NAME_INTEGER_ALIAS: return modelData->nAliasInteger;
+  case VAR_NAME_BOOLEAN_ALIAS: return modelData->nAliasBoolean;
+  case VAR_NAME_STRING_ALIAS: return modelData->nAliasString;
+  default: return 0;
+  }
+}
+
+VAR_INFO* variableNameInfo(MODEL_DATA *modelData, const VAR_NAME_ENTRY *entry)
+{
+  switch (entry->kind) {
+  case VAR_NAME_REAL_VAR: return &modelData->realVarsData[entry->index].info;
+  case VAR_NAME_INTEGER_VAR: return &modelData->integerVarsData[entry->index].info;
+  case VAR_NAME_BOOLEAN_VAR: return &modelData->booleanVarsData[entry->index].info;
+  case VAR_NAME_STRING_VAR: return &modelData->stringVarsData[entry->index].info;
+  case VAR_NAME_REAL_PARAM: return &modelData->realParameterData[entry->index].info;
+  case VAR_NAME_INTEGER_PARAM: return &modelData->integerParameterData[entry->index].info;
+  case VAR_NAME_BOOLEAN_PARAM: return &modelData->booleanParameterData[entry->index].info;
+  case VAR_NAME_STRING_PARAM: return &modelData->stringParameterData[entry->index].info;
+  case VAR_NAME_REAL_ALIAS: return &modelData->realAlias[entry->index].info;
+  case VAR_NAME_INTEGER_ALIAS: return &modelData->integerAlias[entry->index].info;
+  case VAR_NAME_BOOLEAN_ALIAS: return &modelData->booleanAlias[entry->index].info;
+  case VAR_NAME_STRING_ALIAS: return &modelData->stringAlias[entry->index].info;
+  default: return NULL;
+  }
+}
+
+modelica_boolean* variableNameFilterOutput(MODEL_DATA *modelData, const VAR_NAME_ENTRY *entry)
+{
+  switch (entry->kind) {
+  case VAR_NAME_REAL_VAR: return &modelData->realVarsData[entry->index].filterOutput;
+  case VAR_NAME_INTEGER_VAR: return &modelData->integerVarsData[entry->index].filterOutput;
+  case VAR_NAME_BOOLEAN_VAR: return &modelData->booleanVarsData[entry->index].filterOutput;
+  case VAR_NAME_STRING_VAR: return &modelData->stringVarsData[entry->index].filterOutput;
+  case VAR_NAME_REAL_PARAM: return &modelData->realParameterData[entry->index].filterOutput;
+  case VAR_NAME_INTEGER_PARAM: return &modelData->integerParameterData[entry->index].filterOutput;
+  case VAR_NAME_BOOLEAN_PARAM: return &modelData->booleanParameterData[entry->index].filterOutput;
+  case VAR_NAME_STRING_PARAM: return &modelData->stringParameterData[entry->index].filterOutput;
+  case VAR_NAME_REAL_ALIAS: return &modelData->realAlias[entry->index].filterOutput;
+  case VAR_NAME_INTEGER_ALIAS: return &modelData->integerAlias[entry->index].filterOutput;
+  case VAR_NAME_BOOLEAN_ALIAS: return &modelData->booleanAlias[entry->index].filterOutput;
+  case VAR_NAME_STRING_ALIAS: return &modelData->stringAlias[entry->index].filterOutput;
+  default: return NULL;
+  }
+}
+
+const VAR_NAME_INDEX* getVariableNameIndex(MODEL_DATA *modelData)
+{
+  VAR_NAME_INDEX *index = &modelData->variableNameIndex;
+  VAR_NAME_ENTRY tmp;
+  long n = 0, i;
+  int kind;
+
+  if (index->entries) {
+    return index;
+  }
+
+  for (kind = 0; kind < VAR_NAME_MAX; kind++) {
+    n += numberOfNames(modelData, kind);
+  }
+  initVariableNameIndex(index, n);
+  for (kind = 0; kind < VAR_NAME_MAX; kind++) {
+    tmp.kind = kind;
+    for (i = 0; i < numberOfNames(modelData, kind); i++) {
+      tmp.index = i;
+      addVariableName(index, variableNameInfo(modelData, &tmp)->name, kind, i);
+    }
+  }
+  sortVariableNameIndex(index);
+  return index;
+}
+
+void useModelVariableNames(MODEL_DATA *modelData)
+{
+  VAR_NAME_INDEX *index = &modelData->variableNameIndex;
+  long i;
+
+  for (i = 0; i < index->n; i++) {
+    index->entries[i].name = variableNameInfo(modelData, &index->entries[i])->name;
+  }
+}
+
+/* first entry whose name is not less than the first len characters of name */
+static long lowerBound(const VAR_NAME_INDEX *index, const char *name, size_t len)
+{
+  long lo = 0, hi = index->n, mid;
+
+  while (lo < hi) {
+    mid = lo + (hi - lo) / 2;
+    if (strncmp(index->entries[mid].name, name, len) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+const VAR_NAME_ENTRY* findVariableName(const VAR_NAME_INDEX *index, const char *name, long *count)
+{
+  long first = lowerBound(index, name, strlen(name) + 1), last = first;
+
+  while (last < index->n && 0 == strcmp(index->entries[last].name, name)) {
+    last++;
+  }
+  if (count) {
+    *count = last - first;
+  }
+  return last > first ? &index->entries[first] : NULL;
+}
+
+/* end of the alternative of a regular expression that starts at str */
+static const char* endOfAlternative(const char *str)
+{
+  int depth = 0;
+  const char *c = str;
+
+  for (; *c; c++) {
+    if ('\\' == *c) {
+      if (c[1]) c++;
+    } else if ('[' == *c) {
+      /* bracket expression; a ']' directly after '[' or '[^' is part of it */
+      c++;
+      if ('^' == *c) c++;
+      if (']' == *c) c++;
+      while (*c && ']' != *c) c++;
+      if (!*c) break;
+    } else if ('(' == *c) {
+      depth++;
+    } else if (')' == *c) {
+      depth--;
+    } else if ('|' == *c && 0 == depth) {
+      break;
+    }
+  }
+  return c;
+}
+
+/* Copies the literal prefix of the alternative [str,end) to prefix and
+ * returns 1 if the whole alternative is literal. */
+static int literalPrefix(const char *str, const char *end, char *prefix, size_t *len)
+{
+  size_t last = 0;
+  const char *c;
+
+  *len = 0;
+  for (c = str; c < end; c++) {
+    if (strchr("*?{", *c)) {
+      /* the preceding character is optional */
+      *len = last;
+      return 0;
+    } else if ('+' == *c) {
+      return 0;
+    } else if ('\\' == *c && c+1 < end && strchr(".[]()*+?{}|^$\\", c[1])) {
+      last = *len;
+      prefix[(*len)++] = *++c;
+    } else if (strchr(".[]()|^$\\", *c)) {
+      return 0;
+    } else {
+      last = *len;
+      prefix[(*len)++] = *c;
+    }
+  }
+  return 1;
+}
+
+long filterVariableNames(const VAR_NAME_INDEX *index, const char *filter, long **matches)
+{
+  size_t filterLen = strlen(filter), len;
+  char *prefix = (char*) malloc(filterLen + 1);
+  char *regex = (char*) malloc(filterLen + 5);
+  char *matched = (char*) calloc(index->n > 0 ? index->n : 1, sizeof(char));
+  const char *alt, *end;
+  long nMatches = 0, i, j, count;
+  const VAR_NAME_ENTRY *entry;
+#ifndef _MSC_VER
+  regex_t re;
+  int rc;
+
+  /* check the whole filter first, the alternatives are only valid if it is */
+  sprintf(regex, "^(%s)$", filter);
+  rc = regcomp(&re, regex, REG_EXTENDED | REG_NOSUB);
+  if (rc) {
+    char err_buf[2048] = {0};
+    regerror(rc, &re, err_buf, 2048);
+    warningStreamPrint(LOG_STDOUT, 0, "Failed to compile regular expression: %s with error: %s. Defaulting to outputting all variables.", regex, err_buf);
+    free(prefix); free(regex); free(matched);
+    return -1;
+  }
+  regfree(&re);
+#endif
+
+  for (alt = filter; ; alt = end + 1) {
+    end = endOfAlternative(alt);
+    if (literalPrefix(alt, end, prefix, &len)) {
+      prefix[len] = '\0';
+      entry = findVariableName(index, prefix, &count);
+      for (j = 0; j < count; j++) {
+        matched[entry - index->entries + j] = 1;
+      }
+    } else {
+#ifndef _MSC_VER
+      sprintf(regex, "^(%.*s)$", (int)(end - alt), alt);
+      if (regcomp(&re, regex, REG_EXTENDED | REG_NOSUB)) {
+        /* could not split the filter, match all names against all of it */
+        sprintf(regex, "^(%s)$", filter);
+        regcomp(&re, regex, REG_EXTENDED | REG_NOSUB);
+        len = 0;
+      }
+      for (i = lowerBound(index, prefix, len); i < index->n && 0 == strncmp(index->entries[i].name, prefix, len); i++) {
+        if (!matched[i] && 0 == regexec(&re, index->entries[i].name, 0, NULL, 0)) {
+          matched[i] = 1;
+        }
+      }
+      regfree(&re);
+#else
+      /* no regular expressions available */
+      free(prefix); free(regex); free(matched);
+      return -1;
+#endif
+    }
+    if (!*end) {
+      break;
+    }
+  }
+
+  for (i = 0; i < index->n; i++) {
+    nMatches += matched[i];
+  }
+  *matches = (long*) malloc((nMatches > 0 ? nMatches : 1) * sizeof(long));
+  for (i = 0, j = 0; i < index->n; i++) {
+    if (matched[i]) {
+      (*matches)[j++] = i;
+    }
+  }
+
+  free(prefix);
+  free(regex);
+  free(matched);
+  return nMatches;
+}
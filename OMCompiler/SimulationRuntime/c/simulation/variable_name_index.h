@@ -0,0 +1,73 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/*
+ * file variable_name_index.h
+ * One sorted index over the names of all variables, parameters and aliases
+ * of a model. It is built once while the init.xml file is read and replaces
+ * the per-consumer hash maps and linear scans of the overrides, the alias
+ * resolution, the variable filter and the external input matching.
+ */
+
+#ifndef _VARIABLE_NAME_INDEX_H
+#define _VARIABLE_NAME_INDEX_H
+
+#include "../simulation_data.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void initVariableNameIndex(VAR_NAME_INDEX *index, long capacity);
+void addVariableName(VAR_NAME_INDEX *index, const char *name, int kind, long i);
+void sortVariableNameIndex(VAR_NAME_INDEX *index);
+
+/* builds the index from the names in modelData if it is not built yet */
+const VAR_NAME_INDEX* getVariableNameIndex(MODEL_DATA *modelData);
+/* lets the index point to the names in modelData instead of the init.xml data */
+void useModelVariableNames(MODEL_DATA *modelData);
+
+/* returns the first entry with the given name and the number of entries with that name in count */
+const VAR_NAME_ENTRY* findVariableName(const VAR_NAME_INDEX *index, const char *name, long *count);
+VAR_INFO* variableNameInfo(MODEL_DATA *modelData, const VAR_NAME_ENTRY *entry);
+modelica_boolean* variableNameFilterOutput(MODEL_DATA *modelData, const VAR_NAME_ENTRY *entry);
+
+/* Compiles a variable filter (POSIX extended regular expression) to the sorted
+ * positions of the matching entries. Alternatives without meta characters are
+ * looked up directly, the others are only matched against the names sharing
+ * their literal prefix. Returns the number of matches or -1 if the filter is
+ * not valid; *matches has to be freed by the caller. */
+long filterVariableNames(const VAR_NAME_INDEX *index, const char *filter, long **matches);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
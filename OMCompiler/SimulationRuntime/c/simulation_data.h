@@ -74,6 +74,10 @@ typedef struct EQUATION_INFO
   int parent;
   int numVar;
   const char **vars;
+  int numUses;                 /* -1 if the used variables are unknown */
+  const char **uses;
+  int numExtObjs;
+  const char **extObjs;        /* external objects passed to function calls */
 }EQUATION_INFO;
 
 typedef struct FUNCTION_INFO
@@ -162,11 +166,13 @@ typedef struct ANALYTIC_JACOBIAN
 typedef struct EXTERNAL_INPUT
 {
   modelica_boolean active;
-  modelica_real** u;
+  modelica_real** u;                   /* rows of one contiguous buffer */
   modelica_real* t;
-  modelica_integer N;
-  modelica_integer n;
+  modelica_integer N;                  /* allocated rows */
+  modelica_integer n;                  /* valid rows */
   modelica_integer i;
+  modelica_integer first;              /* row of the input file stored in t[0] and u[0] */
+  void* stream;                        /* reader of the input file if only a window of rows is kept in memory, else NULL */
 }EXTERNAL_INPUT;
 
 /* Alias data with various types*/
@@ -184,6 +190,39 @@ typedef DATA_ALIAS DATA_INTEGER_ALIAS;
 typedef DATA_ALIAS DATA_BOOLEAN_ALIAS;
 typedef DATA_ALIAS DATA_STRING_ALIAS;
 
+/* kind of a variable in the name index, i.e. the array of MODEL_DATA it is stored in */
+enum VAR_NAME_KIND
+{
+  VAR_NAME_REAL_VAR = 0,
+  VAR_NAME_INTEGER_VAR,
+  VAR_NAME_BOOLEAN_VAR,
+  VAR_NAME_STRING_VAR,
+  VAR_NAME_REAL_PARAM,
+  VAR_NAME_INTEGER_PARAM,
+  VAR_NAME_BOOLEAN_PARAM,
+  VAR_NAME_STRING_PARAM,
+  VAR_NAME_REAL_ALIAS,
+  VAR_NAME_INTEGER_ALIAS,
+  VAR_NAME_BOOLEAN_ALIAS,
+  VAR_NAME_STRING_ALIAS,
+
+  VAR_NAME_MAX
+};
+
+typedef struct VAR_NAME_ENTRY
+{
+  const char* name;
+  int kind;                            /* VAR_NAME_KIND */
+  long index;                          /* position in the array of the kind */
+} VAR_NAME_ENTRY;
+
+/* names of all variables, parameters and aliases, see variable_name_index.h */
+typedef struct VAR_NAME_INDEX
+{
+  long n;
+  VAR_NAME_ENTRY* entries;             /* sorted by name, NULL if not built yet */
+} VAR_NAME_INDEX;
+
 /* collect all attributes from one variable in one struct */
 typedef struct REAL_ATTRIBUTE
 {
@@ -495,6 +534,8 @@ typedef struct MODEL_DATA
 
   STATIC_REAL_DATA* realSensitivityData;
 
+  VAR_NAME_INDEX variableNameIndex;
+
   MODEL_DATA_XML modelDataXml;         /* TODO: Rename me? */
 
   const char* modelName;
@@ -681,6 +722,8 @@ typedef struct SIMULATION_INFO
 
   CHATTERING_INFO chatteringInfo;
   CALL_STATISTICS callStatistics;      /* used to store the number of function evaluations */
+
+  void *equationTaskGraphs[2];         /* parallel evaluation of functionODE and functionAlgebraics, see equationTaskGraph.c */
 } SIMULATION_INFO;
 
 /* collects all dynamic model data like the variabel-values */
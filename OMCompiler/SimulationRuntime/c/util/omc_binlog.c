@@ -0,0 +1,831 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/* Binary log sink for -logFormat=binary, see omc_binlog.h.
+ *
+ * Every thread owns a ring buffer with a single producer (the thread) and a
+ * single consumer (the flush thread), so logging a message takes no lock
+ * once its format string is known. Format strings are looked up in an open
+ * addressing hash table that is read without locks; new entries are added
+ * under binlog.mutex and published after they are complete.
+ */
+
+#include "omc_binlog.h"
+#include "omc_error.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__MINGW32__) || defined(_MSC_VER)
+#include <windows.h>
+#endif
+
+#if defined(_MSC_VER)
+#define OMC_BINLOG_BARRIER() MemoryBarrier()
+#define OMC_BINLOG_NEXT_SEQ() ((uint64_t) InterlockedIncrement64((volatile LONGLONG*) &binlog.seq))
+#else
+#define OMC_BINLOG_BARRIER() __sync_synchronize()
+#define OMC_BINLOG_NEXT_SEQ() __sync_add_and_fetch(&binlog.seq, 1)
+#endif
+
+#define OMC_BINLOG_RING_SIZE (1 << 20)
+#define OMC_BINLOG_MAX_RECORD (1 << 16)
+#define OMC_BINLOG_MAX_FORMATS 8192
+#define OMC_BINLOG_SLOTS (2*OMC_BINLOG_MAX_FORMATS)
+#define OMC_BINLOG_MAX_ARGS 64
+#define OMC_BINLOG_MAX_SPEC 64
+/* same as SIZE_LOG_BUFFER in omc_error.c, so messages are cut at the same length */
+#define OMC_BINLOG_TEXT_SIZE 2048
+#define OMC_BINLOG_FLUSH_INTERVAL 5000 /* us */
+#define OMC_BINLOG_HEADER_SIZE 16
+#define OMC_BINLOG_NULL_STRING 0xffffffffu
+
+typedef struct omc_binlog_format {
+  char *format;
+  uint32_t hash;
+  uint32_t id;
+  int supported;                        /* 0 if the messages are formatted right away */
+  char kinds[OMC_BINLOG_MAX_ARGS+1];    /* argument kinds, see parseConversion */
+} omc_binlog_format;
+
+typedef struct omc_binlog_thread {
+  char ring[OMC_BINLOG_RING_SIZE];
+  char record[OMC_BINLOG_MAX_RECORD];   /* the record that is being encoded */
+  volatile uint64_t head;               /* written by the logging thread */
+  volatile uint64_t tail;               /* written by the flush thread */
+  volatile uint64_t dropped;            /* records that did not fit into the ring */
+  uint64_t reported;                    /* dropped records that are in the file */
+  struct omc_binlog_thread *next;
+} omc_binlog_thread;
+
+static struct {
+  FILE *file;
+  volatile int running;
+  pthread_t flusher;
+  pthread_mutex_t mutex;
+  pthread_key_t key;
+  omc_binlog_thread *threads;
+  omc_binlog_format * volatile slots[OMC_BINLOG_SLOTS];
+  omc_binlog_format *byId[OMC_BINLOG_MAX_FORMATS];
+  unsigned int numFormats;
+  unsigned int numWritten;              /* formats that are in the file */
+  volatile uint64_t seq;
+  void (*close)(int stream);
+  void (*closeWarning)(int stream);
+} binlog;
+
+static void binlogSleep(unsigned int usec)
+{
+#if defined(__MINGW32__) || defined(_MSC_VER)
+  Sleep(usec / 1000);
+#else
+  struct timespec ts;
+  ts.tv_sec = usec / 1000000;
+  ts.tv_nsec = (usec % 1000000) * 1000;
+  nanosleep(&ts, NULL);
+#endif
+}
+
+/* Parses the conversion specification behind a '%'. Returns the kind of its
+ * argument or 0 if it is not supported (positional arguments, %n, wide
+ * characters), sets *end behind the specification and *stars to the number
+ * of '*' in the width and precision.
+ *
+ *   i int, u unsigned int, l long, m unsigned long, q long long,
+ *   Q unsigned long long, z size_t, j intmax_t, t ptrdiff_t, d double,
+ *   D long double, p void*, s const char*
+ */
+static char parseConversion(const char *spec, const char **end, int *stars)
+{
+  const char *p = spec;
+  char len = 0;
+
+  *stars = 0;
+  *end = spec;
+  while (*p && strchr("-+ #0'", *p)) {
+    p++;
+  }
+  if (*p == '*') {
+    (*stars)++;
+    p++;
+  } else {
+    while (*p >= '0' && *p <= '9') {
+      p++;
+    }
+  }
+  if (*p == '$') {
+    return 0;
+  }
+  if (*p == '.') {
+    p++;
+    if (*p == '*') {
+      (*stars)++;
+      p++;
+    } else {
+      while (*p >= '0' && *p <= '9') {
+        p++;
+      }
+    }
+  }
+  switch (*p) {
+  case 'h':
+    len = *p++;
+    if (*p == 'h') {
+      p++;
+    }
+    break;
+  case 'l':
+    len = *p++;
+    if (*p == 'l') {
+      len = 'q';
+      p++;
+    }
+    break;
+  case 'q':
+  case 'L':
+  case 'z':
+  case 'j':
+  case 't':
+    len = *p++;
+    break;
+  }
+  if (!*p) {
+    return 0;
+  }
+  *end = p + 1;
+  switch (*p) {
+  case 'd':
+  case 'i':
+    switch (len) {
+    case 0: case 'h': return 'i';
+    case 'l': return 'l';
+    case 'q': case 'L': return 'q';
+    case 'z': case 'j': case 't': return len;
+    }
+    return 0;
+  case 'u':
+  case 'o':
+  case 'x':
+  case 'X':
+    switch (len) {
+    case 0: case 'h': return 'u';
+    case 'l': return 'm';
+    case 'q': case 'L': return 'Q';
+    case 'z': case 'j': case 't': return len;
+    }
+    return 0;
+  case 'c':
+    return len ? 0 : 'i';
+  case 'e': case 'E':
+  case 'f': case 'F':
+  case 'g': case 'G':
+  case 'a': case 'A':
+    return len == 'L' ? 'D' : (len == 0 || len == 'l') ? 'd' : 0;
+  case 's':
+    return len ? 0 : 's';
+  case 'p':
+    return len ? 0 : 'p';
+  }
+  return 0;
+}
+
+static int analyseFormat(const char *format, char *kinds)
+{
+  const char *p = format;
+  int n = 0, stars;
+  char kind;
+
+  while ((p = strchr(p, '%'))) {
+    if (p[1] == '%') {
+      p += 2;
+      continue;
+    }
+    kind = parseConversion(p+1, &p, &stars);
+    if (!kind || n + stars + 1 > OMC_BINLOG_MAX_ARGS) {
+      return 0;
+    }
+    while (stars--) {
+      kinds[n++] = 'i';
+    }
+    kinds[n++] = kind;
+  }
+  kinds[n] = '\0';
+  return 1;
+}
+
+static uint32_t hashFormat(const char *format)
+{
+  uint32_t hash = 2166136261u;
+  for (; *format; format++) {
+    hash = (hash ^ (unsigned char) *format) * 16777619u;
+  }
+  return hash;
+}
+
+/* Returns the entry of format or NULL if the table is full */
+static omc_binlog_format* lookupFormat(const char *format)
+{
+  uint32_t hash = hashFormat(format);
+  omc_binlog_format *entry;
+  unsigned int i, slot;
+
+  for (i = 0; i < OMC_BINLOG_SLOTS; i++) {
+    slot = (hash + i) & (OMC_BINLOG_SLOTS-1);
+    entry = binlog.slots[slot];
+    if (!entry) {
+      break;
+    }
+    OMC_BINLOG_BARRIER();
+    if (entry->hash == hash && !strcmp(entry->format, format)) {
+      return entry;
+    }
+  }
+
+  /* not found; search again under the lock, another thread may add it */
+  pthread_mutex_lock(&binlog.mutex);
+  for (i = 0; i < OMC_BINLOG_SLOTS; i++) {
+    slot = (hash + i) & (OMC_BINLOG_SLOTS-1);
+    entry = binlog.slots[slot];
+    if (!entry || (entry->hash == hash && !strcmp(entry->format, format))) {
+      break;
+    }
+  }
+  if (!entry && binlog.numFormats < OMC_BINLOG_MAX_FORMATS) {
+    entry = (omc_binlog_format*) malloc(sizeof(omc_binlog_format));
+    if (entry) {
+      entry->format = strdup(format);
+      entry->hash = hash;
+      entry->id = binlog.numFormats;
+      entry->supported = entry->format && analyseFormat(format, entry->kinds);
+      if (entry->format) {
+        binlog.byId[binlog.numFormats++] = entry;
+        OMC_BINLOG_BARRIER();
+        binlog.slots[slot] = entry;
+      } else {
+        free(entry);
+        entry = NULL;
+      }
+    }
+  }
+  pthread_mutex_unlock(&binlog.mutex);
+  return entry;
+}
+
+static omc_binlog_thread* getThread(void)
+{
+  omc_binlog_thread *thread = (omc_binlog_thread*) pthread_getspecific(binlog.key);
+  if (!thread) {
+    thread = (omc_binlog_thread*) calloc(1, sizeof(omc_binlog_thread));
+    if (!thread) {
+      return NULL;
+    }
+    pthread_mutex_lock(&binlog.mutex);
+    thread->next = binlog.threads;
+    binlog.threads = thread;
+    pthread_mutex_unlock(&binlog.mutex);
+    pthread_setspecific(binlog.key, thread);
+  }
+  return thread;
+}
+
+static void pushRecord(omc_binlog_thread *thread, uint32_t size)
+{
+  uint64_t head = thread->head;
+  size_t offset = head % OMC_BINLOG_RING_SIZE;
+  size_t n = size < OMC_BINLOG_RING_SIZE - offset ? size : OMC_BINLOG_RING_SIZE - offset;
+
+  while (head + size - thread->tail > OMC_BINLOG_RING_SIZE) {
+    if (!binlog.running) {
+      /* the flush thread is gone; drain reports the loss at close */
+      thread->dropped++;
+      return;
+    }
+    /* wait for the flush thread */
+    binlogSleep(100);
+  }
+  OMC_BINLOG_BARRIER();
+  memcpy(thread->ring + offset, thread->record, n);
+  memcpy(thread->ring, thread->record + n, size - n);
+  OMC_BINLOG_BARRIER();
+  thread->head = head + size;
+}
+
+#define OMC_BINLOG_PUT(T, v) do { \
+    T value_ = (T) (v); \
+    if (pos + sizeof(T) > end) return NULL; \
+    memcpy(pos, &value_, sizeof(T)); \
+    pos += sizeof(T); \
+  } while (0)
+
+static char* putString(char *pos, const char *end, const char *s)
+{
+  size_t len;
+  if (!s) {
+    OMC_BINLOG_PUT(uint32_t, OMC_BINLOG_NULL_STRING);
+    return pos;
+  }
+  len = strlen(s);
+  if (len >= OMC_BINLOG_MAX_RECORD) {
+    return NULL;
+  }
+  OMC_BINLOG_PUT(uint32_t, len);
+  if (pos + len + 1 > end) {
+    return NULL;
+  }
+  memcpy(pos, s, len + 1);
+  return pos + len + 1;
+}
+
+/* Returns the end of the arguments or NULL if they do not fit */
+static char* putArguments(char *pos, const char *end, const char *kinds, va_list args)
+{
+  for (; *kinds; kinds++) {
+    switch (*kinds) {
+    case 'i': OMC_BINLOG_PUT(int64_t, va_arg(args, int)); break;
+    case 'u': OMC_BINLOG_PUT(uint64_t, va_arg(args, unsigned int)); break;
+    case 'l': OMC_BINLOG_PUT(int64_t, va_arg(args, long)); break;
+    case 'm': OMC_BINLOG_PUT(uint64_t, va_arg(args, unsigned long)); break;
+    case 'q': OMC_BINLOG_PUT(int64_t, va_arg(args, long long)); break;
+    case 'Q': OMC_BINLOG_PUT(uint64_t, va_arg(args, unsigned long long)); break;
+    case 'z': OMC_BINLOG_PUT(uint64_t, va_arg(args, size_t)); break;
+    case 'j': OMC_BINLOG_PUT(int64_t, va_arg(args, intmax_t)); break;
+    case 't': OMC_BINLOG_PUT(int64_t, va_arg(args, ptrdiff_t)); break;
+    case 'd': OMC_BINLOG_PUT(double, va_arg(args, double)); break;
+    case 'D': OMC_BINLOG_PUT(long double, va_arg(args, long double)); break;
+    case 'p': OMC_BINLOG_PUT(uint64_t, (uintptr_t) va_arg(args, void*)); break;
+    case 's':
+      pos = putString(pos, end, va_arg(args, const char*));
+      if (!pos) {
+        return NULL;
+      }
+      break;
+    default:
+      return NULL;
+    }
+  }
+  return pos;
+}
+
+static uint32_t finishRecord(omc_binlog_thread *thread, char *pos, int kind, int stream, uint32_t format, int type, int flags)
+{
+  omc_binlog_record *record = (omc_binlog_record*) thread->record;
+  /* records are padded to 8 bytes so the decoder can read the headers in place */
+  while ((pos - thread->record) % 8) {
+    *pos++ = '\0';
+  }
+  record->size = (uint32_t) (pos - thread->record);
+  record->kind = (uint16_t) kind;
+  record->stream = (uint16_t) stream;
+  record->format = format;
+  record->type = (uint16_t) type;
+  record->flags = (uint16_t) flags;
+  record->seq = OMC_BINLOG_NEXT_SEQ();
+  return record->size;
+}
+
+static void binlogMessage(int type, int stream, int indentNext, const int *indexes, const char *format, va_list args)
+{
+  omc_binlog_thread *thread = getThread();
+  omc_binlog_format *entry;
+  char text[OMC_BINLOG_TEXT_SIZE];
+  char *pos, *start, *end;
+  int flags = indentNext ? OMC_BINLOG_INDENT_NEXT : 0;
+  va_list copy;
+
+  if (!thread) {
+    vsnprintf(text, OMC_BINLOG_TEXT_SIZE, format, args);
+    messageFunction(type, stream, indentNext, text, 0, indexes);
+    return;
+  }
+  pos = thread->record + sizeof(omc_binlog_record);
+  end = thread->record + OMC_BINLOG_MAX_RECORD;
+  /* keep room for a preformatted message */
+  if (indexes && (size_t) (indexes[0] + 1) * sizeof(int32_t) < OMC_BINLOG_MAX_RECORD / 2) {
+    int i;
+    for (i = 0; i <= indexes[0]; i++) {
+      int32_t index = indexes[i];
+      memcpy(pos, &index, sizeof(int32_t));
+      pos += sizeof(int32_t);
+    }
+    flags |= OMC_BINLOG_INDEXES;
+  }
+  start = pos;
+
+  va_copy(copy, args);
+  entry = lookupFormat(format);
+  if (entry && entry->supported) {
+    pos = putArguments(start, end, entry->kinds, args);
+  } else {
+    pos = NULL;
+  }
+  if (!pos) {
+    /* messages that cannot be deferred are stored as text with format "%s" */
+    vsnprintf(text, OMC_BINLOG_TEXT_SIZE, format, copy);
+    entry = binlog.byId[0];
+    pos = putString(start, end, text);
+  }
+  va_end(copy);
+  pushRecord(thread, finishRecord(thread, pos, OMC_BINLOG_MESSAGE, stream, entry->id, type, flags));
+}
+
+static void binlogMark(int kind, int stream)
+{
+  omc_binlog_thread *thread = getThread();
+  if (thread) {
+    pushRecord(thread, finishRecord(thread, thread->record + sizeof(omc_binlog_record), kind, stream, 0, 0, 0));
+  }
+}
+
+static void binlogClose(int stream)
+{
+  if (ACTIVE_STREAM(stream)) {
+    binlogMark(OMC_BINLOG_CLOSE, stream);
+  }
+}
+
+static void binlogCloseWarning(int stream)
+{
+  if (ACTIVE_WARNING_STREAM(stream)) {
+    binlogMark(OMC_BINLOG_CLOSE_WARNING, stream);
+  }
+}
+
+/* Moves new format strings and all buffered records to the file */
+static void drain(void)
+{
+  omc_binlog_record record;
+  omc_binlog_thread *thread;
+  uint64_t head, tail;
+  size_t offset, n, first;
+
+  pthread_mutex_lock(&binlog.mutex);
+  for (; binlog.numWritten < binlog.numFormats; binlog.numWritten++) {
+    static const char padding[8] = {0};
+    const char *format = binlog.byId[binlog.numWritten]->format;
+    size_t len = strlen(format) + 1;
+    memset(&record, 0, sizeof(omc_binlog_record));
+    record.size = (uint32_t) ((sizeof(omc_binlog_record) + len + 7) & ~(size_t)7);
+    record.kind = OMC_BINLOG_FORMAT;
+    record.format = binlog.numWritten;
+    fwrite(&record, sizeof(omc_binlog_record), 1, binlog.file);
+    fwrite(format, 1, len, binlog.file);
+    fwrite(padding, 1, record.size - sizeof(omc_binlog_record) - len, binlog.file);
+  }
+  for (thread = binlog.threads; thread; thread = thread->next) {
+    head = thread->head;
+    OMC_BINLOG_BARRIER();
+    tail = thread->tail;
+    if (head == tail) {
+      continue;
+    }
+    offset = tail % OMC_BINLOG_RING_SIZE;
+    n = head - tail;
+    first = n < OMC_BINLOG_RING_SIZE - offset ? n : OMC_BINLOG_RING_SIZE - offset;
+    fwrite(thread->ring + offset, 1, first, binlog.file);
+    fwrite(thread->ring, 1, n - first, binlog.file);
+    OMC_BINLOG_BARRIER();
+    thread->tail = head;
+  }
+  for (thread = binlog.threads; thread; thread = thread->next) {
+    uint64_t lost = thread->dropped - thread->reported;
+    if (!lost) {
+      continue;
+    }
+    memset(&record, 0, sizeof(omc_binlog_record));
+    record.size = sizeof(omc_binlog_record) + sizeof(uint64_t);
+    record.kind = OMC_BINLOG_LOST;
+    record.seq = OMC_BINLOG_NEXT_SEQ();
+    fwrite(&record, sizeof(omc_binlog_record), 1, binlog.file);
+    fwrite(&lost, sizeof(uint64_t), 1, binlog.file);
+    thread->reported += lost;
+  }
+  fflush(binlog.file);
+  pthread_mutex_unlock(&binlog.mutex);
+}
+
+static void* flushThread(void *arg)
+{
+  while (binlog.running) {
+    binlogSleep(OMC_BINLOG_FLUSH_INTERVAL);
+    drain();
+  }
+  return NULL;
+}
+
+int omc_binlog_open(const char *filename)
+{
+  uint32_t header[2] = {SIM_LOG_MAX, 0};
+
+  /* the log can only be recorded once */
+  if (binlog.numFormats) {
+    return 1;
+  }
+  binlog.file = fopen(filename, "wb");
+  if (!binlog.file) {
+    return 1;
+  }
+  fwrite(OMC_BINLOG_MAGIC, 1, 8, binlog.file);
+  fwrite(header, sizeof(uint32_t), 2, binlog.file);
+  pthread_mutex_init(&binlog.mutex, NULL);
+  pthread_key_create(&binlog.key, NULL);
+  binlog.running = 1;
+  /* id 0 */
+  if (!lookupFormat("%s") || pthread_create(&binlog.flusher, NULL, flushThread, NULL)) {
+    binlog.running = 0;
+    fclose(binlog.file);
+    binlog.file = NULL;
+    return 1;
+  }
+  binlog.close = messageClose;
+  binlog.closeWarning = messageCloseWarning;
+  messageClose = binlogClose;
+  messageCloseWarning = binlogCloseWarning;
+  OMC_BINLOG_BARRIER();
+  messageBinary = binlogMessage;
+  atexit(omc_binlog_close);
+  return 0;
+}
+
+void omc_binlog_close(void)
+{
+  if (!binlog.running) {
+    return;
+  }
+  messageBinary = NULL;
+  messageClose = binlog.close;
+  messageCloseWarning = binlog.closeWarning;
+  binlog.running = 0;
+  pthread_join(binlog.flusher, NULL);
+  drain();
+  fclose(binlog.file);
+  binlog.file = NULL;
+  /* the buffers are not freed; other threads may still be logging */
+}
+
+#define OMC_BINLOG_GET(T, v) do { \
+    if (args + sizeof(T) > end) return 1; \
+    memcpy(&(v), args, sizeof(T)); \
+    args += sizeof(T); \
+  } while (0)
+
+#define OMC_BINLOG_PRINT(T, v) (stars == 0 ? snprintf(out, room, spec, (T) (v)) : \
+                                stars == 1 ? snprintf(out, room, spec, star[0], (T) (v)) : \
+                                             snprintf(out, room, spec, star[0], star[1], (T) (v)))
+
+/* Formats the arguments of a message like vsnprintf into text */
+static int renderMessage(const char *format, const char *args, const char *end, char *text)
+{
+  size_t len = 0, room;
+  const char *p = format, *specEnd;
+  char spec[OMC_BINLOG_MAX_SPEC];
+  char *out;
+  int stars, star[2], i, n;
+  char kind;
+
+  while (*p) {
+    if (*p != '%' || p[1] == '%') {
+      if (len < OMC_BINLOG_TEXT_SIZE - 1) {
+        text[len++] = *p;
+      }
+      p += *p == '%' ? 2 : 1;
+      continue;
+    }
+    kind = parseConversion(p+1, &specEnd, &stars);
+    if (!kind || specEnd - p >= OMC_BINLOG_MAX_SPEC) {
+      return 1;
+    }
+    memcpy(spec, p, specEnd - p);
+    spec[specEnd - p] = '\0';
+    p = specEnd;
+    for (i = 0; i < stars; i++) {
+      int64_t value;
+      OMC_BINLOG_GET(int64_t, value);
+      star[i] = (int) value;
+    }
+    out = text + len;
+    room = OMC_BINLOG_TEXT_SIZE - len;
+    switch (kind) {
+    case 'i': case 'l': case 'q': case 'j': case 't': {
+      int64_t value;
+      OMC_BINLOG_GET(int64_t, value);
+      n = kind == 'i' ? OMC_BINLOG_PRINT(int, value) :
+          kind == 'l' ? OMC_BINLOG_PRINT(long, value) :
+          kind == 'q' ? OMC_BINLOG_PRINT(long long, value) :
+          kind == 'j' ? OMC_BINLOG_PRINT(intmax_t, value) :
+                        OMC_BINLOG_PRINT(ptrdiff_t, value);
+      break;
+    }
+    case 'u': case 'm': case 'Q': case 'z': {
+      uint64_t value;
+      OMC_BINLOG_GET(uint64_t, value);
+      n = kind == 'u' ? OMC_BINLOG_PRINT(unsigned int, value) :
+          kind == 'm' ? OMC_BINLOG_PRINT(unsigned long, value) :
+          kind == 'Q' ? OMC_BINLOG_PRINT(unsigned long long, value) :
+                        OMC_BINLOG_PRINT(size_t, value);
+      break;
+    }
+    case 'p': {
+      uint64_t value;
+      OMC_BINLOG_GET(uint64_t, value);
+      n = OMC_BINLOG_PRINT(void*, (uintptr_t) value);
+      break;
+    }
+    case 'd': {
+      double value;
+      OMC_BINLOG_GET(double, value);
+      n = OMC_BINLOG_PRINT(double, value);
+      break;
+    }
+    case 'D': {
+      long double value;
+      OMC_BINLOG_GET(long double, value);
+      n = OMC_BINLOG_PRINT(long double, value);
+      break;
+    }
+    case 's': {
+      uint32_t size;
+      const char *value = NULL;
+      OMC_BINLOG_GET(uint32_t, size);
+      if (size != OMC_BINLOG_NULL_STRING) {
+        if (args + size + 1 > end || args[size]) {
+          return 1;
+        }
+        value = args;
+        args += size + 1;
+      }
+      n = OMC_BINLOG_PRINT(const char*, value);
+      break;
+    }
+    default:
+      return 1;
+    }
+    if (n > 0) {
+      len = len + n < OMC_BINLOG_TEXT_SIZE - 1 ? len + n : OMC_BINLOG_TEXT_SIZE - 1;
+    }
+  }
+  text[len] = '\0';
+  return 0;
+}
+
+static int compareSeq(const void *a, const void *b)
+{
+  uint64_t x = (*(const omc_binlog_record**) a)->seq;
+  uint64_t y = (*(const omc_binlog_record**) b)->seq;
+  return x < y ? -1 : x > y;
+}
+
+int omc_binlog_decode(const char *filename)
+{
+  FILE *file = fopen(filename, "rb");
+  char *data = NULL;
+  const omc_binlog_record **messages = NULL;
+  const char **formats = NULL;
+  size_t size = 0, pos, numMessages = 0, numFormats = 0, i;
+  uint32_t header[2];
+  char text[OMC_BINLOG_TEXT_SIZE];
+  int fail = 0;
+
+  if (file && !fseek(file, 0, SEEK_END)) {
+    long n = ftell(file);
+    rewind(file);
+    if (n >= OMC_BINLOG_HEADER_SIZE && (data = (char*) malloc(n))) {
+      size = fread(data, 1, n, file);
+    }
+  }
+  if (file) {
+    fclose(file);
+  }
+  if (size < OMC_BINLOG_HEADER_SIZE || memcmp(data, OMC_BINLOG_MAGIC, 8)) {
+    errorStreamPrint(LOG_STDOUT, 0, "Failed to read binary log file %s.", filename);
+    free(data);
+    return 1;
+  }
+  memcpy(header, data + 8, sizeof(header));
+  if (header[0] != SIM_LOG_MAX) {
+    errorStreamPrint(LOG_STDOUT, 0, "The binary log file %s was written by a different version of the runtime.", filename);
+    free(data);
+    return 1;
+  }
+
+  /* records of one thread are in order; the threads are merged by seq */
+  messages = (const omc_binlog_record**) malloc((size / sizeof(omc_binlog_record) + 1) * sizeof(omc_binlog_record*));
+  if (!messages) {
+    free(data);
+    return 1;
+  }
+  for (pos = OMC_BINLOG_HEADER_SIZE; pos < size; pos += ((const omc_binlog_record*) (data + pos))->size) {
+    const omc_binlog_record *record = (const omc_binlog_record*) (data + pos);
+    if (pos + sizeof(omc_binlog_record) > size || record->size < sizeof(omc_binlog_record) ||
+        record->size % 8 || pos + record->size > size) {
+      /* the program was killed before the log was flushed */
+      warningStreamPrint(LOG_STDOUT, 0, "The binary log file %s is truncated.", filename);
+      break;
+    }
+    if (record->kind == OMC_BINLOG_FORMAT) {
+      const char *format = (const char*) (record + 1);
+      if (memchr(format, '\0', record->size - sizeof(omc_binlog_record))) {
+        if (record->format >= numFormats) {
+          formats = (const char**) realloc(formats, (record->format + 1) * sizeof(const char*));
+          memset(formats + numFormats, 0, (record->format + 1 - numFormats) * sizeof(const char*));
+          numFormats = record->format + 1;
+        }
+        formats[record->format] = format;
+      }
+    } else {
+      messages[numMessages++] = record;
+    }
+  }
+  qsort(messages, numMessages, sizeof(omc_binlog_record*), compareSeq);
+
+  /* only messages of active streams were recorded */
+  for (i = 0; i < SIM_LOG_MAX; i++) {
+    useStream[i] = 1;
+  }
+  showAllWarnings = 1;
+
+  for (i = 0; i < numMessages; i++) {
+    const omc_binlog_record *record = messages[i];
+    const char *args = (const char*) (record + 1);
+    const char *end = (const char*) record + record->size;
+    const int *indexes = NULL;
+
+    if (record->stream >= SIM_LOG_MAX) {
+      fail = 1;
+      continue;
+    }
+    switch (record->kind) {
+    case OMC_BINLOG_MESSAGE:
+      if (record->flags & OMC_BINLOG_INDEXES) {
+        int32_t count = -1;
+        if (args + sizeof(int32_t) <= end) {
+          memcpy(&count, args, sizeof(int32_t));
+        }
+        indexes = (const int*) args;
+        args = count < 0 ? end + 1 : args + (count + 1) * sizeof(int32_t);
+      }
+      if (record->type >= LOG_TYPE_MAX || args > end || record->format >= numFormats || !formats[record->format] ||
+          renderMessage(formats[record->format], args, end, text)) {
+        fail = 1;
+        continue;
+      }
+      messageFunction(record->type, record->stream, record->flags & OMC_BINLOG_INDENT_NEXT, text, 0, indexes);
+      break;
+    case OMC_BINLOG_CLOSE:
+      messageClose(record->stream);
+      break;
+    case OMC_BINLOG_CLOSE_WARNING:
+      messageCloseWarning(record->stream);
+      break;
+    case OMC_BINLOG_LOST: {
+      uint64_t lost;
+      if (args + sizeof(uint64_t) > end) {
+        fail = 1;
+        continue;
+      }
+      memcpy(&lost, args, sizeof(uint64_t));
+      warningStreamPrint(LOG_STDOUT, 0, "%lu log records lost, the log buffer was full.", (unsigned long) lost);
+      break;
+    }
+    default:
+      fail = 1;
+    }
+  }
+  if (fail) {
+    errorStreamPrint(LOG_STDOUT, 0, "Some messages of the binary log file %s could not be decoded.", filename);
+  }
+  free(messages);
+  free(formats);
+  free(data);
+  return fail;
+}
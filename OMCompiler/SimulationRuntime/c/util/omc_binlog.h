@@ -0,0 +1,94 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/* Binary log sink for -logFormat=binary.
+ *
+ * Instead of formatting every message with vsnprintf, the stream print
+ * functions of omc_error.c store the address of the format string and its
+ * raw arguments in a ring buffer owned by the calling thread. A background
+ * thread moves the records to the log file and writes every format string
+ * once. The messages are rendered offline with -decodeLog=file, which
+ * replays them through the text or xml log format.
+ *
+ * File layout: the header (magic, number of log streams), followed by
+ * records that start with omc_binlog_record. FORMAT records hold the
+ * format string of an id and precede the first message using it; messages
+ * of different threads are ordered by seq.
+ */
+
+#ifndef OMC_BINLOG_H
+#define OMC_BINLOG_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OMC_BINLOG_MAGIC "OMCBLOG1"
+
+enum omc_binlog_kind {
+  OMC_BINLOG_MESSAGE = 1,
+  OMC_BINLOG_CLOSE,
+  OMC_BINLOG_CLOSE_WARNING,
+  OMC_BINLOG_FORMAT,
+  OMC_BINLOG_LOST
+};
+
+#define OMC_BINLOG_INDENT_NEXT 1
+#define OMC_BINLOG_INDEXES 2
+
+typedef struct omc_binlog_record {
+  uint32_t size;     /* of the record including this header */
+  uint16_t kind;     /* enum omc_binlog_kind */
+  uint16_t stream;
+  uint32_t format;   /* id of the format string */
+  uint16_t type;     /* enum LOG_TYPE */
+  uint16_t flags;    /* OMC_BINLOG_INDENT_NEXT, OMC_BINLOG_INDEXES */
+  uint64_t seq;
+  /* MESSAGE: the indexes (int32 count and entries) if OMC_BINLOG_INDEXES is
+   *          set, then the arguments in the order of the format string
+   * FORMAT:  the zero-terminated format string
+   * LOST:    the number (uint64) of records of the thread that were dropped
+   *          since the previous LOST record */
+} omc_binlog_record;
+
+/* Starts recording all log messages into filename; returns 0 on success */
+int omc_binlog_open(const char *filename);
+/* Writes the remaining records and closes the file; called at exit */
+void omc_binlog_close(void);
+/* Renders a binary log with the current messageFunction; returns 0 on success */
+int omc_binlog_decode(const char *filename);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -275,107 +275,102 @@ void (*messageFunction)(int type, int stream, int indentNext, char *msg, int sub
 void (*messageClose)(int stream) = messageCloseText;
 void (*messageCloseWarning)(int stream) = messageCloseTextWarning;
 
+/* Set while -logFormat=binary records the messages (see util/omc_binlog.c) */
+void (*messageBinary)(int type, int stream, int indentNext, const int *indexes, const char *format, va_list args) = NULL;
+
 #define SIZE_LOG_BUFFER 2048
 
+static void va_messageStreamPrint(int type, int stream, int indentNext, const int *indexes, const char *format, va_list args)
+{
+  char logBuffer[SIZE_LOG_BUFFER];
+  if (messageBinary) {
+    /* the message is formatted later by the log decoder */
+    messageBinary(type, stream, indentNext, indexes, format, args);
+    return;
+  }
+  vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
+  messageFunction(type, stream, indentNext, logBuffer, 0, indexes);
+}
+
 #if !defined(OMC_MINIMAL_LOGGING)
 void va_infoStreamPrint(int stream, int indentNext, const char *format, va_list args)
 {
   if (useStream[stream]) {
-    char logBuffer[SIZE_LOG_BUFFER];
-    vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
-    messageFunction(LOG_TYPE_INFO, stream, indentNext, logBuffer, 0, NULL);
+    va_messageStreamPrint(LOG_TYPE_INFO, stream, indentNext, NULL, format, args);
   }
 }
 
 void infoStreamPrintWithEquationIndexes(int stream, int indentNext, const int *indexes, const char *format, ...)
 {
   if (useStream[stream]) {
-    char logBuffer[SIZE_LOG_BUFFER];
     va_list args;
     va_start(args, format);
-    vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
+    va_messageStreamPrint(LOG_TYPE_INFO, stream, indentNext, indexes, format, args);
     va_end(args);
-    messageFunction(LOG_TYPE_INFO, stream, indentNext, logBuffer, 0, indexes);
   }
 }
 
 void infoStreamPrint(int stream, int indentNext, const char *format, ...)
 {
   if (useStream[stream]) {
-    char logBuffer[SIZE_LOG_BUFFER];
     va_list args;
     va_start(args, format);
-    vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
+    va_messageStreamPrint(LOG_TYPE_INFO, stream, indentNext, NULL, format, args);
     va_end(args);
-    messageFunction(LOG_TYPE_INFO, stream, indentNext, logBuffer, 0, NULL);
   }
 }
 
 void warningStreamPrintWithEquationIndexes(int stream, int indentNext, const int *indexes, const char *format, ...)
 {
   if (ACTIVE_WARNING_STREAM(stream)) {
-    char logBuffer[SIZE_LOG_BUFFER];
     va_list args;
     va_start(args, format);
-    vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
+    va_messageStreamPrint(LOG_TYPE_WARNING, stream, indentNext, indexes, format, args);
     va_end(args);
-    messageFunction(LOG_TYPE_WARNING, stream, indentNext, logBuffer, 0, indexes);
   }
 }
 
 void warningStreamPrint(int stream, int indentNext, const char *format, ...)
 {
   if (ACTIVE_WARNING_STREAM(stream)) {
-    char logBuffer[SIZE_LOG_BUFFER];
     va_list args;
     va_start(args, format);
-    vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
+    va_messageStreamPrint(LOG_TYPE_WARNING, stream, indentNext, NULL, format, args);
     va_end(args);
-    messageFunction(LOG_TYPE_WARNING, stream, indentNext, logBuffer, 0, NULL);
   }
 }
 
 void va_warningStreamPrintWithEquationIndexes(int stream, int indentNext, const int *indexes, const char *format, va_list args)
 {
   if (ACTIVE_WARNING_STREAM(stream)) {
-    char logBuffer[SIZE_LOG_BUFFER];
-    vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
-    messageFunction(LOG_TYPE_WARNING, stream, indentNext, logBuffer, 0, indexes);
+    va_messageStreamPrint(LOG_TYPE_WARNING, stream, indentNext, indexes, format, args);
   }
 }
 
 void va_warningStreamPrint(int stream, int indentNext, const char *format, va_list args)
 {
   if (ACTIVE_WARNING_STREAM(stream)) {
-    char logBuffer[SIZE_LOG_BUFFER];
-    vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
-    messageFunction(LOG_TYPE_WARNING, stream, indentNext, logBuffer, 0, NULL);
+    va_messageStreamPrint(LOG_TYPE_WARNING, stream, indentNext, NULL, format, args);
   }
 }
 
 void errorStreamPrint(int stream, int indentNext, const char *format, ...)
 {
-  char logBuffer[SIZE_LOG_BUFFER];
   va_list args;
   va_start(args, format);
-  vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
+  va_messageStreamPrint(LOG_TYPE_ERROR, stream, indentNext, NULL, format, args);
   va_end(args);
-  messageFunction(LOG_TYPE_ERROR, stream, indentNext, logBuffer, 0, NULL);
 }
 
 void va_errorStreamPrint(int stream, int indentNext, const char *format, va_list args)
 {
-  char logBuffer[SIZE_LOG_BUFFER];
-  vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
-  messageFunction(LOG_TYPE_ERROR, stream, indentNext, logBuffer, 0, NULL);
+  va_messageStreamPrint(LOG_TYPE_ERROR, stream, indentNext, NULL, format, args);
 }
 
 void va_errorStreamPrintWithEquationIndexes(int stream, int indentNext, const int *indexes, const char *format, va_list args)
 {
 
-  char logBuffer[SIZE_LOG_BUFFER];
-  vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
-  messageFunction(LOG_TYPE_ERROR, stream, indentNext, logBuffer, 0, indexes);
+  va_messageStreamPrint(LOG_TYPE_ERROR, stream, indentNext, indexes, format, args);
 }
 #endif
 
@@ -383,24 +378,20 @@ void va_errorStreamPrintWithEquationIndexes(int stream, int indentNext, const in
 void debugStreamPrint(int stream, int indentNext, const char *format, ...)
 {
   if (useStream[stream]) {
-    char logBuffer[SIZE_LOG_BUFFER];
     va_list args;
     va_start(args, format);
-    vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
+    va_messageStreamPrint(LOG_TYPE_DEBUG, stream, indentNext, NULL, format, args);
     va_end(args);
-    messageFunction(LOG_TYPE_DEBUG, stream, indentNext, logBuffer, 0, NULL);
   }
 }
 
 void debugStreamPrintWithEquationIndexes(int stream, int indentNext, const int *indexes, const char *format, ...)
 {
   if (useStream[stream]) {
-    char logBuffer[SIZE_LOG_BUFFER];
     va_list args;
     va_start(args, format);
-    vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
+    va_messageStreamPrint(LOG_TYPE_DEBUG, stream, indentNext, indexes, format, args);
     va_end(args);
-    messageFunction(LOG_TYPE_DEBUG, stream, indentNext, logBuffer, 0, indexes);
   }
 }
 #endif
@@ -436,9 +427,7 @@ static inline jmp_buf* getBestJumpBuffer(threadData_t *threadData)
 void va_throwStreamPrint(threadData_t *threadData, const char *format, va_list args)
 {
 #if !defined(OMC_MINIMAL_LOGGING)
-  char logBuffer[SIZE_LOG_BUFFER];
-  vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
-  messageFunction(LOG_TYPE_DEBUG, LOG_ASSERT, 0, logBuffer, 0, NULL);
+  va_messageStreamPrint(LOG_TYPE_DEBUG, LOG_ASSERT, 0, NULL, format, args);
 #endif
   threadData = threadData ? threadData : (threadData_t*)pthread_getspecific(mmc_thread_data_key);
   longjmp(*getBestJumpBuffer(threadData), 1);
@@ -460,12 +449,10 @@ void throwStreamPrint(threadData_t *threadData, const char *format, ...)
 void throwStreamPrintWithEquationIndexes(threadData_t *threadData, const int *indexes, const char *format, ...)
 {
 #if !defined(OMC_MINIMAL_LOGGING)
-  char logBuffer[SIZE_LOG_BUFFER];
   va_list args;
   va_start(args, format);
-  vsnprintf(logBuffer, SIZE_LOG_BUFFER, format, args);
+  va_messageStreamPrint(LOG_TYPE_DEBUG, LOG_ASSERT, 0, indexes, format, args);
   va_end(args);
-  messageFunction(LOG_TYPE_DEBUG, LOG_ASSERT, 0, logBuffer, 0, indexes);
 #endif
   threadData = threadData ? threadData : (threadData_t*)pthread_getspecific(mmc_thread_data_key);
   longjmp(*getBestJumpBuffer(threadData), 1);
@@ -169,6 +169,7 @@ extern char logBuffer[2048];
 extern void (*messageFunction)(int type, int stream, int indentNext, char *msg, int subline, const int *indexes);
 extern void (*messageClose)(int stream);
 extern void (*messageCloseWarning)(int stream);
+extern void (*messageBinary)(int type, int stream, int indentNext, const int *indexes, const char *format, va_list args);
 
 #if !defined(OMC_MINIMAL_LOGGING)
 extern void va_infoStreamPrint(int stream, int indentNext, const char *format, va_list ap);
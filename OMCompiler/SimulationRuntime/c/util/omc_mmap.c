@@ -78,9 +78,13 @@ omc_mmap_write_unix omc_mmap_open_write_unix(const char *fileName, size_t size)
     res.size = s.st_size;
   } else {
     res.size = size;
-    lseek(fd, size, SEEK_SET);
+    /* Pages beyond the end of the file can not be written to */
+    if (ftruncate(fd, size) < 0) {
+      close(fd);
+      throwStreamPrint(NULL, "ftruncate %s failed: %s\n", fileName, strerror(errno));
+    }
   }
-  res.data = res.size == 0 ? NULL : (char*) mmap(0, res.size, PROT_WRITE, MAP_SHARED, fd, 0);
+  res.data = res.size == 0 ? NULL : (char*) mmap(0, res.size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
   close(fd);
   if (res.data == MAP_FAILED) {
     throwStreamPrint(NULL, "mmap(file=\"%s\",fd=%d,size=%ld kB) failed: %s\n", fileName, fd, (long) res.size, strerror(errno));
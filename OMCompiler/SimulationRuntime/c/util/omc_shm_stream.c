@@ -0,0 +1,150 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/* Reader side of the shared-memory result stream, see omc_shm_stream.h.
+ * It does not depend on the rest of the runtime so that clients can simply
+ * compile this file into their application. */
+
+#include "omc_shm_stream.h"
+#include <string.h>
+
+#if !defined(HAVE_MMAP)
+#if defined(unix) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+#if _POSIX_MAPPED_FILES>0
+#define HAVE_MMAP 1
+#else
+#define HAVE_MMAP 0
+#endif
+#endif
+
+#if HAVE_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <windows.h>
+#define OMC_SHM_STREAM_BARRIER() MemoryBarrier()
+#else
+#define OMC_SHM_STREAM_BARRIER() __sync_synchronize()
+#endif
+
+int omc_shm_stream_open(omc_shm_stream_reader *reader, const char *filename)
+{
+#if HAVE_MMAP
+  struct stat s;
+  const omc_shm_stream_header *header;
+  void *data;
+  int fd = open(filename, O_RDONLY);
+
+  memset(reader, 0, sizeof(omc_shm_stream_reader));
+  if (fd < 0) {
+    return 1;
+  }
+  if (fstat(fd, &s) < 0 || s.st_size < (off_t) sizeof(omc_shm_stream_header)) {
+    close(fd);
+    return 1;
+  }
+  data = mmap(0, s.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return 1;
+  }
+  header = (const omc_shm_stream_header*) data;
+  if (memcmp(header->magic, OMC_SHM_STREAM_MAGIC, sizeof(header->magic))) {
+    munmap(data, s.st_size);
+    return 1;
+  }
+  /* the rest of the header was written before the magic */
+  OMC_SHM_STREAM_BARRIER();
+  if ((size_t) header->headerSize + (size_t) header->recordSize * header->capacity > (size_t) s.st_size ||
+      header->namesOffset + header->namesSize > header->headerSize || header->capacity == 0) {
+    munmap(data, s.st_size);
+    return 1;
+  }
+  reader->header = header;
+  reader->data = (const char*) data;
+  reader->size = s.st_size;
+  return 0;
+#else
+  memset(reader, 0, sizeof(omc_shm_stream_reader));
+  return 1;
+#endif
+}
+
+void omc_shm_stream_close(omc_shm_stream_reader *reader)
+{
+#if HAVE_MMAP
+  if (reader->data) {
+    munmap((void*) reader->data, reader->size);
+  }
+#endif
+  memset(reader, 0, sizeof(omc_shm_stream_reader));
+}
+
+const char* omc_shm_stream_name(const omc_shm_stream_reader *reader, unsigned int i)
+{
+  const char *name = reader->data + reader->header->namesOffset;
+  const char *end = name + reader->header->namesSize;
+  if (i >= reader->header->nReal + reader->header->nInteger + reader->header->nBoolean) {
+    return NULL;
+  }
+  for (; i > 0 && name < end; i--) {
+    name += strlen(name) + 1;
+  }
+  return name < end ? name : NULL;
+}
+
+uint64_t omc_shm_stream_count(const omc_shm_stream_reader *reader)
+{
+  uint64_t count = reader->header->count;
+  OMC_SHM_STREAM_BARRIER();
+  return count;
+}
+
+const void* omc_shm_stream_record(const omc_shm_stream_reader *reader, uint64_t n)
+{
+  const omc_shm_stream_header *header = reader->header;
+  const char *record = reader->data + header->headerSize + (n % header->capacity) * header->recordSize;
+  uint64_t seq = *(volatile const uint64_t*) record;
+  OMC_SHM_STREAM_BARRIER();
+  return seq == 2*n+2 ? record : NULL;
+}
+
+int omc_shm_stream_valid(const omc_shm_stream_reader *reader, const void *record, uint64_t n)
+{
+  OMC_SHM_STREAM_BARRIER();
+  return *(volatile const uint64_t*) record == 2*n+2;
+}
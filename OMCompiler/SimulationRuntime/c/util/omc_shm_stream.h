@@ -0,0 +1,114 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/*
+ * Live streaming of simulation results through a shared-memory ring.
+ *
+ * The simulation (started with -shmStream=file) writes every emitted step as
+ * a fixed-size record into a ring of records in a memory-mapped file. Readers
+ * map the same file read-only and access the records in place; nothing is
+ * locked and the simulation never waits for a reader.
+ *
+ * File layout:
+ *   omc_shm_stream_header
+ *   variable names ('\0'-separated: real, integer, then boolean variables)
+ *   capacity records of recordSize bytes each, record n is stored at
+ *   index n % capacity:
+ *     uint64_t seq;                  2n+1 while record n is written, 2n+2 when done
+ *     double   time;
+ *     double   real[nReal];
+ *     int64_t  integer[nInteger];
+ *     int8_t   boolean[nBoolean];    padded to a multiple of 8 bytes
+ *
+ * A reader checks seq before and after using a record; if it changed the
+ * writer overtook the reader and the data has to be discarded.
+ */
+
+#ifndef OMC_SHM_STREAM_H_
+#define OMC_SHM_STREAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OMC_SHM_STREAM_MAGIC "OMCSHM1"
+
+typedef struct omc_shm_stream_header {
+  char magic[8];
+  uint32_t headerSize;       /* offset of the first record */
+  uint32_t recordSize;
+  uint32_t capacity;         /* number of records in the ring */
+  uint32_t nReal;
+  uint32_t nInteger;
+  uint32_t nBoolean;
+  uint32_t namesOffset;
+  uint32_t namesSize;
+  volatile uint32_t finished;  /* 1 once the simulation terminated */
+  uint32_t reserved;
+  volatile uint64_t count;     /* number of records written so far */
+} omc_shm_stream_header;
+
+#define OMC_SHM_STREAM_TIME(record) (((const double*)(record))[1])
+#define OMC_SHM_STREAM_REAL(record) (((const double*)(record)) + 2)
+#define OMC_SHM_STREAM_INTEGER(header, record) ((const int64_t*)(((const char*)(record)) + 16 + 8*(header)->nReal))
+#define OMC_SHM_STREAM_BOOLEAN(header, record) ((const int8_t*)(((const char*)(record)) + 16 + 8*((header)->nReal + (header)->nInteger)))
+
+typedef struct omc_shm_stream_reader {
+  const omc_shm_stream_header *header;
+  const char *data;
+  size_t size;
+} omc_shm_stream_reader;
+
+/* Maps the stream file; returns 0 on success */
+int omc_shm_stream_open(omc_shm_stream_reader *reader, const char *filename);
+void omc_shm_stream_close(omc_shm_stream_reader *reader);
+
+/* The name of variable i; reals come first, then integers and booleans */
+const char* omc_shm_stream_name(const omc_shm_stream_reader *reader, unsigned int i);
+
+/* Number of records written so far; the latest one is count-1 */
+uint64_t omc_shm_stream_count(const omc_shm_stream_reader *reader);
+
+/* Pointer to record n inside the mapping, or NULL if it was not written yet
+ * or was already overwritten */
+const void* omc_shm_stream_record(const omc_shm_stream_reader *reader, uint64_t n);
+
+/* Returns 1 if record still holds record n, i.e. the values read from it
+ * since omc_shm_stream_record returned it are consistent */
+int omc_shm_stream_valid(const omc_shm_stream_reader *reader, const void *record, uint64_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
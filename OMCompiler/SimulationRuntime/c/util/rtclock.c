@@ -29,6 +29,7 @@
  */
 
 #include "rtclock.h"
+#include "rtprofile.h"
 #include <assert.h>
 #include <stdlib.h>
 #include <limits.h>
@@ -166,12 +167,17 @@ long long RDTSC() {
 }
 #endif
 
+static LARGE_INTEGER performance_frequency;
+
+/* OMC_CLOCK_TSC uses the performance counter, which is based on the time
+ * stamp counter where it is invariant */
 int rt_set_clock(enum omc_rt_clock_t newClock) {
-  if (newClock != OMC_CLOCK_REALTIME && newClock != OMC_CPU_CYCLES) {
+  if (newClock != OMC_CLOCK_REALTIME && newClock != OMC_CPU_CYCLES && newClock != OMC_CLOCK_TSC) {
     return 1;
   }
 
   selectedClock = newClock;
+  QueryPerformanceFrequency(&performance_frequency);
   return 0;
 }
 
@@ -179,10 +185,19 @@ enum omc_rt_clock_t rt_get_clock() {
   return selectedClock;
 }
 
-static LARGE_INTEGER performance_frequency;
+double rt_tsc_seconds_per_cycle() {
+  return selectedClock == OMC_CLOCK_TSC ? 1.0 / (double) performance_frequency.QuadPart : 0;
+}
 
 void rt_tick(int ix) {
-  if(selectedClock == OMC_CLOCK_REALTIME) {
+  if(selectedClock == OMC_CLOCK_TSC) {
+    /* 0 marks a call that is not timed */
+    if (rt_profile_active() && !rt_profile_sample(ix)) {
+      tick_tp[ix].QuadPart = 0;
+    } else {
+      QueryPerformanceCounter(&tick_tp[ix]);
+    }
+  } else if(selectedClock == OMC_CLOCK_REALTIME) {
     static int init = 0;
     if (!init) {
 
@@ -200,7 +215,10 @@ void rt_tick(int ix) {
 
 double rt_tock(int ix) {
   double d;
-  if(selectedClock == OMC_CLOCK_REALTIME) {
+  if(selectedClock == OMC_CLOCK_TSC && tick_tp[ix].QuadPart == 0) {
+    return 0;
+  }
+  if(selectedClock != OMC_CPU_CYCLES) {
     LARGE_INTEGER tock_tp;
     double d1, d2;
     QueryPerformanceCounter(&tock_tp);
@@ -234,7 +252,15 @@ void rt_clear_total(int ix) {
 }
 
 void rt_accumulate(int ix) {
-  if(selectedClock == OMC_CLOCK_REALTIME) {
+  if(selectedClock == OMC_CLOCK_TSC) {
+    if(tick_tp[ix].QuadPart) {
+      LARGE_INTEGER tock_tp;
+      uint64_t cycles;
+      QueryPerformanceCounter(&tock_tp);
+      cycles = tock_tp.QuadPart - tick_tp[ix].QuadPart;
+      acc_tp[ix].QuadPart += rt_profile_active() ? rt_profile_record(ix, tick_tp[ix].QuadPart, cycles) : cycles;
+    }
+  } else if(selectedClock == OMC_CLOCK_REALTIME) {
     LARGE_INTEGER tock_tp;
     QueryPerformanceCounter(&tock_tp);
     acc_tp[ix].QuadPart += tock_tp.QuadPart - tick_tp[ix].QuadPart;
@@ -250,7 +276,7 @@ int rtclock_compare(rtclock_t t1, rtclock_t t2) {
 }
 
 double rtclock_value(LARGE_INTEGER tp) {
-  if(selectedClock == OMC_CLOCK_REALTIME) {
+  if(selectedClock != OMC_CPU_CYCLES) {
     double d1, d2;
     d1 = (double) (tp.QuadPart);
     d2 = (double) performance_frequency.QuadPart;
@@ -261,7 +287,7 @@ double rtclock_value(LARGE_INTEGER tp) {
 }
 
 void rt_ext_tp_tick(rtclock_t* tick_tp) {
-  if(selectedClock == OMC_CLOCK_REALTIME) {
+  if(selectedClock != OMC_CPU_CYCLES) {
     rt_ext_tp_tick_realtime(tick_tp);
   } else {
     LARGE_INTEGER time;
@@ -291,7 +317,7 @@ double rt_ext_tp_tock_realtime(rtclock_t* tick_tp) {
 
 double rt_ext_tp_tock(rtclock_t* tick_tp) {
   double d;
-  if(selectedClock == OMC_CLOCK_REALTIME) {
+  if(selectedClock != OMC_CPU_CYCLES) {
     d = rt_ext_tp_tock_realtime(tick_tp);
   } else {
     LARGE_INTEGER tock_tp;
@@ -326,16 +352,38 @@ int64_t rt_ext_tp_sync_nanosec(rtclock_t* tick_tp, uint64_t nsec)
 
 #elif defined(__APPLE_CC__)
 
+/* OMC_CLOCK_TSC counts in units of mach_absolute_time */
+static int use_tsc = 0;
+
 int rt_set_clock(enum omc_rt_clock_t newClock) {
-  return newClock != OMC_CLOCK_REALTIME;
+  use_tsc = newClock == OMC_CLOCK_TSC;
+  return newClock != OMC_CLOCK_REALTIME && newClock != OMC_CLOCK_TSC;
+}
+
+enum omc_rt_clock_t rt_get_clock() {
+  return use_tsc ? OMC_CLOCK_TSC : OMC_CLOCK_REALTIME;
+}
+
+double rt_tsc_seconds_per_cycle() {
+  static mach_timebase_info_data_t info = {0,0};
+  if (!use_tsc) {
+    return 0;
+  }
+  if(info.denom == 0)
+  mach_timebase_info(&info);
+  return 1e-9 * info.numer / info.denom;
 }
 
 void rt_tick(int ix) {
-  tick_tp[ix] = mach_absolute_time();
+  /* 0 marks a call that is not timed */
+  tick_tp[ix] = use_tsc && rt_profile_active() && !rt_profile_sample(ix) ? 0 : mach_absolute_time();
   rt_clock_ncall[ix]++;
 }
 
 double rt_tock(int ix) {
+  if (use_tsc && tick_tp[ix] == 0) {
+    return 0;
+  }
   uint64_t tock_tp = mach_absolute_time();
   uint64_t nsec;
   static mach_timebase_info_data_t info = {0,0};
@@ -368,7 +416,15 @@ void rt_clear_total(int ix)
 }
 
 void rt_accumulate(int ix) {
-  uint64_t tock_tp = mach_absolute_time();
+  uint64_t tock_tp;
+  if (use_tsc) {
+    if (tick_tp[ix]) {
+      tock_tp = mach_absolute_time() - tick_tp[ix];
+      acc_tp[ix] += rt_profile_active() ? rt_profile_record(ix, tick_tp[ix], tock_tp) : tock_tp;
+    }
+    return;
+  }
+  tock_tp = mach_absolute_time();
   acc_tp[ix] += tock_tp - tick_tp[ix];
 }
 
@@ -430,7 +486,29 @@ int64_t rt_ext_tp_sync_nanosec(rtclock_t* tick_tp, uint64_t nsec)
 #endif
 static clockid_t omc_clock = OMC_CLOCK_MONOTONIC;
 
+/* OMC_CLOCK_TSC: rt_tick and rt_accumulate only read the time stamp
+ * counter; it is converted to seconds when the timers are reported */
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+#define HAVE_TSC 1
+#else
+/* counts nanoseconds of the monotonic clock instead */
+#define HAVE_TSC 0
+#endif
+static int use_tsc = 0;
+static unsigned long long tsc_calibration_cycles;
+static struct timespec tsc_calibration_time;
+
+static inline unsigned long long rt_tsc(void);
+
 int rt_set_clock(enum omc_rt_clock_t newClock) {
+  use_tsc = 0;
+  if (newClock == OMC_CLOCK_TSC) {
+    use_tsc = 1;
+    omc_clock = OMC_CLOCK_MONOTONIC;
+    clock_gettime(omc_clock, &tsc_calibration_time);
+    tsc_calibration_cycles = rt_tsc();
+    return 0;
+  }
 #if defined(linux)
   omc_clock = newClock == OMC_CLOCK_REALTIME ? OMC_CLOCK_MONOTONIC : CLOCK_PROCESS_CPUTIME_ID;
 #else
@@ -440,6 +518,9 @@ int rt_set_clock(enum omc_rt_clock_t newClock) {
 }
 
 enum omc_rt_clock_t rt_get_clock() {
+  if (use_tsc) {
+    return OMC_CLOCK_TSC;
+  }
   return omc_clock==OMC_CLOCK_MONOTONIC ? OMC_CLOCK_REALTIME : OMC_CLOCK_CPUTIME;
 }
 
@@ -467,8 +548,56 @@ static inline unsigned long long RDTSC(void)
 }
 #endif
 
+static inline unsigned long long rt_tsc(void)
+{
+#if defined(__aarch64__)
+  unsigned long long x;
+  __asm__ __volatile__ ("mrs %0, cntvct_el0" : "=r"(x));
+  return x;
+#elif HAVE_TSC
+  return RDTSC();
+#else
+  struct timespec now;
+  clock_gettime(OMC_CLOCK_MONOTONIC, &now);
+  return (unsigned long long) now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+#endif
+}
+
+/* Calibrated against the monotonic clock over the time since rt_set_clock,
+ * so the estimate gets better the longer the simulation runs. It is only
+ * measured again once the run got 1/8 longer. */
+double rt_tsc_seconds_per_cycle() {
+  static double seconds_per_cycle = 0;
+  static unsigned long long calibrated_at = 0;
+  struct timespec now;
+  unsigned long long cycles;
+  double elapsed;
+  if (!use_tsc) {
+    return 0;
+  }
+  if (!HAVE_TSC) {
+    return 1e-9;
+  }
+  cycles = rt_tsc();
+  if (seconds_per_cycle > 0 && calibrated_at > tsc_calibration_cycles &&
+      cycles - calibrated_at < (calibrated_at - tsc_calibration_cycles)/8) {
+    return seconds_per_cycle;
+  }
+  do {
+    clock_gettime(omc_clock, &now);
+    cycles = rt_tsc();
+    elapsed = (now.tv_sec - tsc_calibration_time.tv_sec) + (now.tv_nsec - tsc_calibration_time.tv_nsec)*1e-9;
+  } while (elapsed < 1e-3);
+  seconds_per_cycle = elapsed / (double) (cycles - tsc_calibration_cycles);
+  calibrated_at = cycles;
+  return seconds_per_cycle;
+}
+
 void rt_tick(int ix) {
-  if(omc_clock == OMC_CPU_CYCLES) {
+  if(use_tsc) {
+    /* 0 marks a call that is not timed */
+    tick_tp[ix].cycles = rt_profile_active() && !rt_profile_sample(ix) ? 0 : rt_tsc();
+  } else if(omc_clock == OMC_CPU_CYCLES) {
     tick_tp[ix].cycles = RDTSC();
   } else {
     clock_gettime(omc_clock, &tick_tp[ix].time);
@@ -478,7 +607,18 @@ void rt_tick(int ix) {
 
 double rt_tock(int ix) {
   double d;
-  if(omc_clock == OMC_CPU_CYCLES) {
+  if(use_tsc) {
+    unsigned long long cycles;
+    if (tick_tp[ix].cycles == 0) {
+      /* never ticked, or a call that is not sampled */
+      return 0;
+    }
+    cycles = rt_tsc() - tick_tp[ix].cycles;
+    d = cycles * rt_tsc_seconds_per_cycle();
+    if (d < min_time) {
+      min_time = d;
+    }
+  } else if(omc_clock == OMC_CPU_CYCLES) {
     unsigned long long timer = RDTSC();
     d = (double) (timer - tick_tp[ix].cycles);
   } else {
@@ -494,7 +634,7 @@ double rt_tock(int ix) {
 
 void rt_clear(int ix)
 {
-  if(omc_clock == OMC_CPU_CYCLES) {
+  if(use_tsc || omc_clock == OMC_CPU_CYCLES) {
     total_tp[ix].cycles += acc_tp[ix].cycles;
     rt_clock_ncall_total[ix] += rt_clock_ncall[ix];
     max_tp[ix] = max_rtclock(max_tp[ix],acc_tp[ix]);
@@ -518,7 +658,7 @@ void rt_clear(int ix)
 
 void rt_clear_total(int ix)
 {
-  if(omc_clock == OMC_CPU_CYCLES) {
+  if(use_tsc || omc_clock == OMC_CPU_CYCLES) {
     total_tp[ix].cycles = 0;
     rt_clock_ncall_total[ix] = 0;
 
@@ -575,7 +715,12 @@ static inline int timeSpecCmp(struct timespec  t1, struct timespec t2)
 }
 
 void rt_accumulate(int ix) {
-  if(omc_clock == OMC_CPU_CYCLES) {
+  if(use_tsc) {
+    if(tick_tp[ix].cycles) {
+      unsigned long long cycles = rt_tsc() - tick_tp[ix].cycles;
+      acc_tp[ix].cycles += rt_profile_active() ? rt_profile_record(ix, tick_tp[ix].cycles, cycles) : cycles;
+    }
+  } else if(omc_clock == OMC_CPU_CYCLES) {
     long long cycles = RDTSC();
     acc_tp[ix].cycles += cycles -tick_tp[ix].cycles;
   } else {
@@ -592,7 +737,9 @@ void rt_accumulate(int ix) {
 
 static double rtclock_value(rtclock_t tp) {
   double d;
-  if(omc_clock == OMC_CPU_CYCLES) {
+  if(use_tsc) {
+    d = tp.cycles * rt_tsc_seconds_per_cycle();
+  } else if(omc_clock == OMC_CPU_CYCLES) {
     d = tp.cycles;
   } else {
     d = tp.time.tv_sec + tp.time.tv_nsec*1e-9;
@@ -602,7 +749,7 @@ static double rtclock_value(rtclock_t tp) {
 
 int rtclock_compare(rtclock_t t1, rtclock_t t2)
 {
-  if(omc_clock == OMC_CPU_CYCLES) {
+  if(use_tsc || omc_clock == OMC_CPU_CYCLES) {
     return t1.cycles-t2.cycles;
   } else {
     if(t1.time.tv_sec == t2.time.tv_sec) {
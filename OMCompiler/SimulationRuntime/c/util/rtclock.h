@@ -85,7 +85,8 @@ static inline double rt_tock(int ix) {return 0.0;}
 enum omc_rt_clock_t {
   OMC_CLOCK_REALTIME, /* CLOCK_MONOTONIC_RAW if available; else CLOCK_MONOTONIC */
   OMC_CLOCK_CPUTIME, /* Per-process CPU-time */
-  OMC_CPU_CYCLES /* Number of CPU-Cycles */
+  OMC_CPU_CYCLES, /* Number of CPU-Cycles */
+  OMC_CLOCK_TSC /* Time stamp counter converted to seconds (the monotonic counter of the platform where there is none); also collects histograms (see rtprofile.h) */
 };
 
 #if defined(__MINGW32__) || defined(_MSC_VER)
@@ -133,6 +134,9 @@ void rt_add_ncall(int ix, int n);
 
 void rt_measure_overhead(int ix);
 
+/* Seconds per tick of the time stamp counter; 0 if the clock is not OMC_CLOCK_TSC */
+double rt_tsc_seconds_per_cycle();
+
 /* tick() ... tock() with external rtclock_t -> returns the number of seconds since the tick */
 void rt_ext_tp_tick(rtclock_t* tick_tp);
 void rt_ext_tp_tick_realtime(rtclock_t* tick_tp);
@@ -0,0 +1,362 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+#include "rtprofile.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct rt_profile_thread {
+  rt_profile_stats *stats;
+  rt_profile_event *events;                /* ring buffer of traceEvents events */
+  uint64_t nevents;                        /* events recorded so far */
+  uint32_t id;
+  struct rt_profile_thread *next;
+} rt_profile_thread;
+
+static int numTimers = 0;
+static int firstSampled = 0;
+static int sampling = 1;
+static int traceEvents = 0;
+static int active = 0;
+
+static pthread_key_t threadKey;
+static pthread_mutex_t threadsMutex = PTHREAD_MUTEX_INITIALIZER;
+static rt_profile_thread *threads = NULL;
+static uint32_t numThreads = 0;
+static rt_profile_stats *merged = NULL;
+
+void rt_profile_init(int nTimers, int firstSampledTimer, int samplingFactor, int nTraceEvents)
+{
+  if (active) {
+    return;
+  }
+  numTimers = nTimers;
+  firstSampled = firstSampledTimer;
+  sampling = samplingFactor > 1 ? samplingFactor : 1;
+  traceEvents = nTraceEvents > 0 ? nTraceEvents : 0;
+  pthread_key_create(&threadKey, NULL);
+  active = 1;
+}
+
+int rt_profile_active(void)
+{
+  return active;
+}
+
+static rt_profile_thread* rt_profile_self(void)
+{
+  rt_profile_thread *t = (rt_profile_thread*) pthread_getspecific(threadKey);
+  if (t) {
+    return t;
+  }
+  t = (rt_profile_thread*) calloc(1, sizeof(rt_profile_thread));
+  t->stats = (rt_profile_stats*) calloc(numTimers, sizeof(rt_profile_stats));
+  t->events = traceEvents ? (rt_profile_event*) malloc(traceEvents * sizeof(rt_profile_event)) : NULL;
+  if (!t->stats || (traceEvents && !t->events)) {
+    fprintf(stderr, "rt_profile: failed to allocate the profiling buffers of a thread\n");
+    abort();
+  }
+  pthread_mutex_lock(&threadsMutex);
+  t->id = numThreads++;
+  t->next = threads;
+  threads = t;
+  pthread_mutex_unlock(&threadsMutex);
+  pthread_setspecific(threadKey, t);
+  return t;
+}
+
+int rt_profile_sample(int ix)
+{
+  rt_profile_stats *s = rt_profile_self()->stats + ix;
+  s->ncall++;
+  if (sampling == 1 || ix < firstSampled || s->nsampled < RT_PROFILE_SAMPLING_WARMUP) {
+    return 1;
+  }
+  return s->ncall % sampling == 0;
+}
+
+static inline int rt_profile_bucket(uint64_t cycles)
+{
+  int k;
+#if defined(__GNUC__)
+  k = cycles ? 63 - __builtin_clzll(cycles) : 0;
+#else
+  for (k = 0; cycles > 1; k++) {
+    cycles >>= 1;
+  }
+#endif
+  return k < RT_PROFILE_BUCKETS ? k : RT_PROFILE_BUCKETS-1;
+}
+
+uint64_t rt_profile_record(int ix, uint64_t start, uint64_t cycles)
+{
+  rt_profile_thread *t = rt_profile_self();
+  rt_profile_stats *s = t->stats + ix;
+  int sampled = sampling > 1 && ix >= firstSampled && s->nsampled >= RT_PROFILE_SAMPLING_WARMUP;
+
+  if (s->nsampled == 0 || cycles < s->min) {
+    s->min = cycles;
+  }
+  if (cycles > s->max) {
+    s->max = cycles;
+  }
+  s->nsampled++;
+  s->cycles += cycles;
+  s->hist[rt_profile_bucket(cycles)]++;
+
+  if (traceEvents) {
+    rt_profile_event *e = t->events + (t->nevents++ % traceEvents);
+    e->ix = ix;
+    e->thread = t->id;
+    e->start = start;
+    e->cycles = cycles;
+  }
+  return sampled ? cycles * sampling : cycles;
+}
+
+const rt_profile_stats* rt_profile_merge(void)
+{
+  rt_profile_thread *t;
+  int ix, k;
+
+  if (!merged) {
+    merged = (rt_profile_stats*) malloc(numTimers * sizeof(rt_profile_stats));
+  }
+  memset(merged, 0, numTimers * sizeof(rt_profile_stats));
+  pthread_mutex_lock(&threadsMutex);
+  for (t = threads; t; t = t->next) {
+    for (ix = 0; ix < numTimers; ix++) {
+      const rt_profile_stats *s = t->stats + ix;
+      rt_profile_stats *m = merged + ix;
+      if (s->nsampled && (m->nsampled == 0 || s->min < m->min)) {
+        m->min = s->min;
+      }
+      if (s->max > m->max) {
+        m->max = s->max;
+      }
+      m->ncall += s->ncall;
+      m->nsampled += s->nsampled;
+      m->cycles += s->cycles;
+      for (k = 0; k < RT_PROFILE_BUCKETS; k++) {
+        m->hist[k] += s->hist[k];
+      }
+    }
+  }
+  pthread_mutex_unlock(&threadsMutex);
+  return merged;
+}
+
+/* Calls fn for the recorded events of all threads, oldest first per thread */
+static int rt_profile_foreach_event(int (*fn)(const rt_profile_event*, void*), void *userdata)
+{
+  rt_profile_thread *t;
+  uint64_t i, first;
+  for (t = threads; t; t = t->next) {
+    first = t->nevents > (uint64_t) traceEvents ? t->nevents - traceEvents : 0;
+    for (i = first; i < t->nevents; i++) {
+      if (fn(t->events + (i % traceEvents), userdata)) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+static uint64_t rt_profile_num_events(void)
+{
+  rt_profile_thread *t;
+  uint64_t n = 0;
+  for (t = threads; t && traceEvents; t = t->next) {
+    n += t->nevents > (uint64_t) traceEvents ? traceEvents : t->nevents;
+  }
+  return n;
+}
+
+static int write_event_binary(const rt_profile_event *e, void *userdata)
+{
+  return 1 != fwrite(e, sizeof(rt_profile_event), 1, (FILE*) userdata);
+}
+
+/* Format (native byte order):
+ *   char magic[8]; uint32 numEntries; uint32 buckets; double secondsPerCycle
+ *   numEntries times: uint32 ix; uint32 nameLength; char name[nameLength]; rt_profile_stats
+ *   uint64 numEvents; rt_profile_event events[numEvents]
+ * Only timers that were called are written. */
+int rt_profile_write_binary(const char *filename, double secondsPerCycle, rt_profile_name_fn name, void *userdata)
+{
+  const rt_profile_stats *stats = rt_profile_merge();
+  FILE *fout = fopen(filename, "wb");
+  uint32_t numEntries = 0, buckets = RT_PROFILE_BUCKETS, ix, len;
+  uint64_t numEvents;
+  char buf[64];
+  int ok;
+
+  if (!fout) {
+    return 1;
+  }
+  for (ix = 0; ix < (uint32_t) numTimers; ix++) {
+    numEntries += stats[ix].ncall > 0;
+  }
+  ok = 1 == fwrite(RT_PROFILE_MAGIC, 8, 1, fout);
+  ok = ok && 1 == fwrite(&numEntries, sizeof(uint32_t), 1, fout);
+  ok = ok && 1 == fwrite(&buckets, sizeof(uint32_t), 1, fout);
+  ok = ok && 1 == fwrite(&secondsPerCycle, sizeof(double), 1, fout);
+  for (ix = 0; ok && ix < (uint32_t) numTimers; ix++) {
+    const char *str;
+    if (stats[ix].ncall == 0) {
+      continue;
+    }
+    str = name(userdata, ix, buf, sizeof(buf));
+    len = strlen(str);
+    ok = 1 == fwrite(&ix, sizeof(uint32_t), 1, fout);
+    ok = ok && 1 == fwrite(&len, sizeof(uint32_t), 1, fout);
+    ok = ok && len == fwrite(str, 1, len, fout);
+    ok = ok && 1 == fwrite(stats + ix, sizeof(rt_profile_stats), 1, fout);
+  }
+  numEvents = rt_profile_num_events();
+  ok = ok && 1 == fwrite(&numEvents, sizeof(uint64_t), 1, fout);
+  ok = ok && 0 == rt_profile_foreach_event(write_event_binary, fout);
+  ok = (0 == fclose(fout)) && ok;
+  return !ok;
+}
+
+struct trace_writer {
+  FILE *fout;
+  double usPerCycle;
+  uint64_t start;
+  int first;
+  rt_profile_name_fn name;
+  void *userdata;
+};
+
+static void write_json_string(FILE *fout, const char *str)
+{
+  fputc('"', fout);
+  for (; *str; str++) {
+    if (*str == '"' || *str == '\\') {
+      fputc('\\', fout);
+    }
+    if ((unsigned char) *str >= ' ') {
+      fputc(*str, fout);
+    }
+  }
+  fputc('"', fout);
+}
+
+static int find_trace_start(const rt_profile_event *e, void *userdata)
+{
+  uint64_t *start = (uint64_t*) userdata;
+  if (e->start < *start) {
+    *start = e->start;
+  }
+  return 0;
+}
+
+static int write_event_trace(const rt_profile_event *e, void *userdata)
+{
+  struct trace_writer *w = (struct trace_writer*) userdata;
+  char buf[64];
+  fputs(w->first ? "\n" : ",\n", w->fout);
+  w->first = 0;
+  fputs("{\"name\":", w->fout);
+  write_json_string(w->fout, w->name(w->userdata, e->ix, buf, sizeof(buf)));
+  fprintf(w->fout, ",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+    (unsigned) e->thread, (e->start - w->start) * w->usPerCycle, e->cycles * w->usPerCycle);
+  return ferror(w->fout);
+}
+
+/* Chrome trace event format with one complete ("X") event per interval.
+ * The histograms are added as metadata of the process. */
+int rt_profile_write_trace(const char *filename, double secondsPerCycle, rt_profile_name_fn name, void *userdata)
+{
+  const rt_profile_stats *stats = rt_profile_merge();
+  struct trace_writer w;
+  int ix, k, ok;
+  char buf[64];
+
+  w.fout = fopen(filename, "w");
+  if (!w.fout) {
+    return 1;
+  }
+  w.usPerCycle = secondsPerCycle * 1e6;
+  w.start = UINT64_MAX;
+  w.first = 1;
+  w.name = name;
+  w.userdata = userdata;
+  rt_profile_foreach_event(find_trace_start, &w.start);
+
+  fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", w.fout);
+  ok = 0 == rt_profile_foreach_event(write_event_trace, &w);
+  fprintf(w.fout, "%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"simulation\"}}\n],\n", w.first ? "\n" : ",\n");
+  fputs("\"otherData\":{\"histogramBuckets\":\"intervals of [2^k, 2^(k+1)) cycles\",\"timers\":[", w.fout);
+  for (ix = 0, w.first = 1; ok && ix < numTimers; ix++) {
+    if (stats[ix].ncall == 0) {
+      continue;
+    }
+    fputs(w.first ? "\n{\"name\":" : ",\n{\"name\":", w.fout);
+    w.first = 0;
+    write_json_string(w.fout, name(userdata, ix, buf, sizeof(buf)));
+    fprintf(w.fout, ",\"ncall\":%llu,\"nsampled\":%llu,\"time\":%.9g,\"min\":%.9g,\"max\":%.9g,\"hist\":[",
+      (unsigned long long) stats[ix].ncall, (unsigned long long) stats[ix].nsampled,
+      stats[ix].cycles * secondsPerCycle * (stats[ix].nsampled ? (double) stats[ix].ncall / stats[ix].nsampled : 0),
+      stats[ix].min * secondsPerCycle, stats[ix].max * secondsPerCycle);
+    for (k = 0; k < RT_PROFILE_BUCKETS; k++) {
+      fprintf(w.fout, k ? ",%u" : "%u", (unsigned) stats[ix].hist[k]);
+    }
+    fputs("]}", w.fout);
+    ok = !ferror(w.fout);
+  }
+  fputs("\n]}}\n", w.fout);
+  ok = (0 == fclose(w.fout)) && ok;
+  return !ok;
+}
+
+void rt_profile_free(void)
+{
+  rt_profile_thread *t, *next;
+  if (!active) {
+    return;
+  }
+  pthread_mutex_lock(&threadsMutex);
+  for (t = threads; t; t = next) {
+    next = t->next;
+    free(t->stats);
+    free(t->events);
+    free(t);
+  }
+  threads = NULL;
+  numThreads = 0;
+  pthread_mutex_unlock(&threadsMutex);
+  free(merged);
+  merged = NULL;
+  pthread_key_delete(threadKey);
+  active = 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+/* Per-timer statistics for -clock=TSC.
+ *
+ * Every accumulated interval of the rt_* timers is added to a histogram of
+ * its duration (one bucket per power of two cycles) in a buffer owned by the
+ * calling thread, so no locks are taken while the simulation runs. Optionally
+ * the last intervals of every thread are kept in a ring buffer and written
+ * as a Chrome trace (chrome://tracing, ui.perfetto.dev).
+ *
+ * Timers of equations and functions that were called often can be sampled:
+ * only every n-th call is timed and its duration counts n times.
+ */
+
+#ifndef __RTPROFILE__H
+#define __RTPROFILE__H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RT_PROFILE_MAGIC "OMCPROF1"
+#define RT_PROFILE_BUCKETS 40
+/* Timers are only sampled after they were timed this many times */
+#define RT_PROFILE_SAMPLING_WARMUP 10000
+
+typedef struct rt_profile_stats {
+  uint64_t ncall;                          /* timed and skipped intervals */
+  uint64_t nsampled;                       /* timed intervals */
+  uint64_t cycles;                         /* sum of the timed intervals */
+  uint64_t min, max;
+  uint32_t hist[RT_PROFILE_BUCKETS];       /* hist[k]: intervals of [2^k, 2^(k+1)) cycles */
+} rt_profile_stats;
+
+typedef struct rt_profile_event {
+  uint32_t ix;
+  uint32_t thread;
+  uint64_t start;
+  uint64_t cycles;
+} rt_profile_event;
+
+/* Returns a name for timer ix; used for the exported files */
+typedef const char* (*rt_profile_name_fn)(void *userdata, int ix, char *buf, size_t bufSize);
+
+void rt_profile_init(int numTimers, int firstSampled, int sampling, int traceEvents);
+int rt_profile_active(void);
+/* Returns non-zero if this call of timer ix should be timed */
+int rt_profile_sample(int ix);
+/* Records an interval; returns the number of cycles to accumulate for it,
+ * i.e. the interval scaled by the sampling factor */
+uint64_t rt_profile_record(int ix, uint64_t start, uint64_t cycles);
+/* Sum of the statistics of all threads; the result is owned by the profiler */
+const rt_profile_stats* rt_profile_merge(void);
+
+/* The files are written with secondsPerCycle converting cycles to seconds */
+int rt_profile_write_binary(const char *filename, double secondsPerCycle, rt_profile_name_fn name, void *userdata);
+int rt_profile_write_trace(const char *filename, double secondsPerCycle, rt_profile_name_fn name, void *userdata);
+void rt_profile_free(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -39,12 +39,14 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
   /* FLAG_CPU */                          "cpu",
   /* FLAG_CSV_OSTEP */                    "csvOstep",
   /* FLAG_DAE_MODE */                     "daeMode",
+  /* FLAG_DECODE_LOG */                   "decodeLog",
   /* FLAG_DELTA_X_LINEARIZE */            "deltaXLinearize",
   /* FLAG_DELTA_X_SOLVER */               "deltaXSolver",
   /* FLAG_EMBEDDED_SERVER */              "embeddedServer",
   /* FLAG_EMBEDDED_SERVER_PORT */         "embeddedServerPort",
   /* FLAG_MAT_SYNC */                     "mat_sync",
   /* FLAG_EMIT_PROTECTED */               "emit_protected",
+  /* FLAG_ENSEMBLE */                     "ensemble",
   /* FLAG_DATA_RECONCILE_Eps */           "eps",
   /* FLAG_F */                            "f",
   /* FLAG_HELP */                         "help",
@@ -82,6 +84,7 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
   /* FLAG_INPUT_FILE */                   "exInputFile",
   /* FLAG_INPUT_FILE_STATES */            "stateFile",
   /* FLAG_INPUT_PATH */                   "inputPath",
+  /* FLAG_INPUT_WINDOW */                 "inputWindow",
   /* FLAG_IPOPT_HESSE*/                   "ipopt_hesse",
   /* FLAG_IPOPT_INIT*/                    "ipopt_init",
   /* FLAG_IPOPT_JAC*/                     "ipopt_jac",
@@ -127,11 +130,16 @@ const char *FLAG_NAME[FLAG_MAX+1] = {
   /* FLAG_OUTPUT_PATH */                  "outputPath",
   /* FLAG_OVERRIDE */                     "override",
   /* FLAG_OVERRIDE_FILE */                "overrideFile",
+  /* FLAG_PARALLEL_EQUATIONS */           "parallelEquations",
   /* FLAG_PORT */                         "port",
+  /* FLAG_PROFILE_SAMPLING */             "profileSampling",
+  /* FLAG_PROFILE_TRACE */                "profileTrace",
   /* FLAG_R */                            "r",
   /* FLAG_DATA_RECONCILE  */              "reconcile",
   /* FLAG_RT */                           "rt",
   /* FLAG_S */                            "s",
+  /* FLAG_SHM_STREAM */                   "shmStream",
+  /* FLAG_SHM_STREAM_SIZE */              "shmStreamSize",
   /* FLAG_SINGLE_PRECISION */             "single",
   /* FLAG_SOLVER_STEPS */                 "steps",
   /* FLAG_STEADY_STATE */                 "steadyState",
@@ -148,16 +156,18 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
 
   /* FLAG_ABORT_SLOW */                   "aborts if the simulation chatters",
   /* FLAG_ALARM */                        "aborts after the given number of seconds (0 disables)",
-  /* FLAG_CLOCK */                        "selects the type of clock to use -clock=RT, -clock=CYC or -clock=CPU",
+  /* FLAG_CLOCK */                        "selects the type of clock to use -clock=RT, -clock=CYC, -clock=CPU or -clock=TSC",
   /* FLAG_CPU */                          "dumps the cpu-time into the result file",
   /* FLAG_CSV_OSTEP */                    "value specifies csv-files for debug values for optimizer step",
   /* FLAG_DAE_MODE */                     "flag to let the integrator use daeResiduals",
+  /* FLAG_DECODE_LOG */                   "value specifies a log file written with -logFormat=binary that is printed in the current log format",
   /* FLAG_DELTA_X_LINEARIZE */            "value specifies the delta x value for numerical differentiation used by linearization. The default value is 1e-5.",
   /* FLAG_DELTA_X_SOLVER */               "value specifies the delta x value for numerical differentiation used by integrator. The default values is sqrt(DBL_EPSILON).",
   /* FLAG_EMBEDDED_SERVER */              "enables an embedded server. Valid values: none, opc-da [broken], opc-ua [experimental], or the path to a shared object.",
   /* FLAG_EMBEDDED_SERVER_PORT */         "[int (default 4841)] value specifies the port number used by the embedded server",
   /* FLAG_MAT_SYNC */                     "[int (default 0)] syncs the mat file header after emitting every N time-points (default disabled)",
   /* FLAG_EMIT_PROTECTED */               "emits protected variables to the result-file",
+  /* FLAG_ENSEMBLE */                     "value specifies a csv file with parameter and start values of ensemble members simulated after the model",
   /* FLAG_DATA_RECONCILE_Eps */           "value specifies the number of convergence iteration to be performed for DataReconciliation",
   /* FLAG_F */                            "value specifies a new setup XML file to the generated simulation code",
   /* FLAG_HELP */                         "get detailed information that specifies the command-line flag",
@@ -189,12 +199,13 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_IIT */                          "[double] value specifies a time for the initialization of the model",
   /* FLAG_ILS */                          "[int] default: 4",
   /* FLAG_IMPRK_ORDER */                  "[int (default 5)] value specifies the integration order of the implicit Runge-Kutta method. Valid values: 1-6",
-  /* FLAG_IMPRK_LS */                     "selects the linear solver of the integration methods: impeuler, trapezoid and imprungekuta",
+  /* FLAG_IMPRK_LS */                     "selects the linear solver of the integration methods: impeuler, trapezoid, imprungekuta and irksco",
   /* FLAG_INITIAL_STEP_SIZE */            "value specifies an initial step size for supported solver",
   /* FLAG_INPUT_CSV */                    "value specifies an csv-file with inputs for the simulation/optimization of the model",
   /* FLAG_INPUT_FILE */                   "value specifies an external file with inputs for the simulation/optimization of the model",
   /* FLAG_INPUT_FILE_STATES */            "value specifies an file with states start values for the optimization of the model",
   /* FLAG_INPUT_PATH */                   "value specifies a path for reading the input files i.e., model_init.xml and model_info.json",
+  /* FLAG_INPUT_WINDOW */                 "value specifies the number of rows of the input file kept in memory",
   /* FLAG_IPOPT_HESSE */                  "value specifies the hessian for Ipopt",
   /* FLAG_IPOPT_INIT */                   "value specifies the initial guess for optimization",
   /* FLAG_IPOPT_JAC */                    "value specifies the Jacobian for Ipopt",
@@ -203,7 +214,7 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_JACOBIAN */                     "select the calculation method of the Jacobian used only by ida and dassl solver.",
   /* FLAG_L */                            "value specifies a time where the linearization of the model should be performed",
   /* FLAG_L_DATA_RECOVERY */              "emit data recovery matrices with model linearization",
-  /* FLAG_LOG_FORMAT */                   "value specifies the log format of the executable. -logFormat=text (default), -logFormat=xml or -logFormat=xmltcp",
+  /* FLAG_LOG_FORMAT */                   "value specifies the log format of the executable. -logFormat=text (default), -logFormat=xml, -logFormat=xmltcp, -logFormat=bintcp or -logFormat=binary",
   /* FLAG_LS */                           "value specifies the linear solver method (default: lapack, totalpivot (fallback))",
   /* FLAG_LS_IPOPT */                     "value specifies the linear solver method for ipopt",
   /* FLAG_LSS */                          "value specifies the linear sparse solver method (default: umfpack)",
@@ -240,11 +251,16 @@ const char *FLAG_DESC[FLAG_MAX+1] = {
   /* FLAG_OUTPUT_PATH */                  "value specifies a path for writing the output files i.e., model_res.mat, model_prof.intdata, model_prof.realdata etc.",
   /* FLAG_OVERRIDE */                     "override the variables or the simulation settings in the XML setup file",
   /* FLAG_OVERRIDE_FILE */                "will override the variables or the simulation settings in the XML setup file with the values from the file",
+  /* FLAG_PARALLEL_EQUATIONS */           "[int (default 1)] value specifies the number of threads used to evaluate independent equations in parallel",
   /* FLAG_PORT */                         "value specifies the port for simulation status (default disabled)",
+  /* FLAG_PROFILE_SAMPLING */             "value specifies that frequently called equations and functions are only timed every n-th call (-clock=TSC)",
+  /* FLAG_PROFILE_TRACE */                "value specifies the number of timed calls per thread written to the _prof.trace.json file (-clock=TSC)",
   /* FLAG_R */                            "value specifies a new result file than the default Model_res.mat",
   /* FLAG_DATA_RECONCILE */               "Run the DataReconciliation algorithm for constrained equation",
   /* FLAG_RT */                           "value specifies the scaling factor for real-time synchronization (0 disables)",
   /* FLAG_S */                            "value specifies the integration method",
+  /* FLAG_SHM_STREAM */                   "value specifies a file through which the emitted steps are streamed to other processes",
+  /* FLAG_SHM_STREAM_SIZE */              "value specifies the number of steps kept in the -shmStream file",
   /* FLAG_SINGLE */                       "output in single precision",
   /* FLAG_SOLVER_STEPS */                 "dumps the number of integration steps into the result file",
   /* FLAG_STEADY_STATE */                 "aborts if steady state is reached",
@@ -266,13 +282,18 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Selects the type of clock to use. Valid options include:\n\n"
   "  * RT (monotonic real-time clock)\n"
   "  * CYC (cpu cycles measured with RDTSC)\n"
-  "  * CPU (process-based CPU-time)",
+  "  * CPU (process-based CPU-time)\n"
+  "  * TSC (time stamp counter converted to seconds; cheaper than RT for profiling small equations,\n"
+  "    and additionally writes histograms of the call durations to model_prof.bin)",
   /* FLAG_CPU */
   "  Dumps the cpu-time into the result file using the variable named $cpuTime.",
   /* FLAG_CSV_OSTEP */
   "  Value specifies csv-files for debug values for optimizer step.",
   /* FLAG_DAE_MODE */
   "  Enables daeMode simulation if the model was compiled with the omc flag --daeMode and ida method is used.",
+  /* FLAG_DECODE_LOG */
+  "  Value specifies a log file that was written with -logFormat=binary.\n"
+  "  The messages are printed in the log format of this run (text or xml) and the executable exits without simulating.",
   /* FLAG_DELTA_X_LINEARIZE */
   "  Value specifies the delta x value for numerical differentiation used by linearization. The default value is sqrt(DBL_EPSILON*2e1).",
   /* FLAG_DELTA_X_SOLVER */
@@ -289,6 +310,14 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Syncs the mat file header after emitting every N time-points.",
   /* FLAG_EMIT_PROTECTED */
   "  Emits protected variables to the result-file.",
+  /* FLAG_ENSEMBLE */
+  "  Value specifies a csv file describing an ensemble of variants of the model.\n"
+  "  The first row contains names of parameters or states, each further row\n"
+  "  the values of one ensemble member. After the model itself has finished,\n"
+  "  the members are simulated one after another with the same solver; this\n"
+  "  saves the translation and process start of separate runs, not the\n"
+  "  simulation time. The states of all members are written to\n"
+  "  <model>_ensemble.csv.",
   /* FLAG_DATA_RECONCILE_Eps */
   "  Value specifies the number of convergence iteration to be performed for DataReconciliation",
   /* FLAG_F */
@@ -362,7 +391,9 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   /* FLAG_IMPRK_LS */
   "  Selects the linear solver of the integration methods impeuler, trapezoid and imprungekuta:\n\n"
   "  * iterativ - default, sparse iterativ linear solver with fallback case to dense solver\n"
-  "  * dense - dense linear solver, SUNDIALS default method",
+  "  * dense - dense linear solver, SUNDIALS default method\n"
+  "  * klu - sparse direct linear solver KLU; the Jacobian is evaluated with the coloring of its sparsity pattern\n"
+  "    and reused over the stages and steps. Also selects the sparse Newton iteration of irksco.",
   /* FLAG_INITIAL_STEP_SIZE */
   "  Value specifies an initial step size, used by the methods: dassl, ida",
   /* FLAG_INPUT_CSV */
@@ -373,6 +404,11 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Value specifies an file with states start values for the optimization of the model.",
   /* FLAG_INPUT_PATH */
   "  Value specifies a path for reading the input files i.e., model_init.xml and model_info.json",
+  /* FLAG_INPUT_WINDOW */
+  "  Value specifies the number of rows of the -csvInput file that are kept in memory.\n"
+  "  The file is then read incrementally around the current simulation time instead of being loaded\n"
+  "  completely before the simulation starts. Input files (-csvInput or -exInputFile) with the extension\n"
+  "  .mat (MATLAB v4 result files) are always read this way, with a default window of 1024 rows.",
   /* FLAG_IPOPT_HESSE */
   "  Value specifies the hessematrix for Ipopt(OMC, BFGS, const).",
   /* FLAG_IPOPT_INIT */
@@ -393,7 +429,9 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Value specifies the log format of the executable:\n\n"
   "  * text (default)\n"
   "  * xml\n"
-  "  * xmltcp (required -port flag)",
+  "  * xmltcp (required -port flag)\n"
+  "  * bintcp (required -port flag; length-prefixed binary messages and progress, sent in batches)\n"
+  "  * binary (messages are formatted later with -decodeLog; written to <model>_log.bin)",
   /* FLAG_LS */
   "  Value specifies the linear solver method",
   /* FLAG_LS_IPOPT */
@@ -497,8 +535,22 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  Note that: -overrideFile CANNOT be used with -override.\n"
   "  Use when variables for -override are too many.\n"
   "  overrideFileName contains lines of the form: var1=start1",
+  /* FLAG_PARALLEL_EQUATIONS */
+  "  Value specifies the number of threads used to evaluate independent equations\n"
+  "  of functionODE and functionAlgebraics in parallel. The dependencies are read\n"
+  "  from the model info file. The first evaluations are timed and the parallel\n"
+  "  evaluation is only used if the equations are expensive enough.\n"
+  "  Requires the model to be translated with -d=parallelEquations.",
   /* FLAG_PORT */
   "  Value specifies the port for simulation status (default disabled).",
+  /* FLAG_PROFILE_SAMPLING */
+  "  Value specifies that equations and functions are only timed every n-th call once they were timed\n"
+  "  10000 times (default 1, i.e. every call is timed). The reported times are extrapolated to all calls.\n"
+  "  Only used with -clock=TSC.",
+  /* FLAG_PROFILE_TRACE */
+  "  Value specifies the number of timed calls per thread that are kept for the file model_prof.trace.json\n"
+  "  (default 0, i.e. no trace is written). The file uses the Chrome trace event format and can be opened\n"
+  "  in chrome://tracing or https://ui.perfetto.dev. Only used with -clock=TSC.",
   /* FLAG_R */
   "  Value specifies the name of the output result file.\n"
   "  The default file-name is based on the model name and output format.\n"
@@ -510,6 +562,13 @@ const char *FLAG_DETAILED_DESC[FLAG_MAX+1] = {
   "  A value > 1 means the simulation takes a longer time to simulate.\n",
   /* FLAG_S */
   "  Value specifies the integration method. For additional information see the :ref:`User's Guide <cruntime-integration-methods>`",
+  /* FLAG_SHM_STREAM */
+  "  Value specifies a file that is memory-mapped as a ring of the most recent\n"
+  "  emitted steps (the variables selected by -variableFilter), in addition to the\n"
+  "  result file. Other processes can attach to the running simulation using the\n"
+  "  reader in util/omc_shm_stream.h. Only available on platforms with mmap.",
+  /* FLAG_SHM_STREAM_SIZE */
+  "  Value specifies the number of steps kept in the -shmStream file (default 1024).",
   /* FLAG_SINGLE */
   "  Output results in single precision (mat-format only).",
   /* FLAG_SOLVER_STEPS */
@@ -537,12 +596,14 @@ const int FLAG_TYPE[FLAG_MAX] = {
   /* FLAG_CPU */                          FLAG_TYPE_FLAG,
   /* FLAG_CSV_OSTEP */                    FLAG_TYPE_OPTION,
   /* FLAG_DAE_SOLVING */                  FLAG_TYPE_FLAG,
+  /* FLAG_DECODE_LOG */                   FLAG_TYPE_OPTION,
   /* FLAG_DELTA_X_LINEARIZE */            FLAG_TYPE_OPTION,
   /* FLAG_DELTA_X_SOLVER */               FLAG_TYPE_OPTION,
   /* FLAG_EMBEDDED_SERVER */              FLAG_TYPE_OPTION,
   /* FLAG_EMBEDDED_SERVER_PORT */         FLAG_TYPE_OPTION,
   /* FLAG_MAT_SYNC */                     FLAG_TYPE_OPTION,
   /* FLAG_EMIT_PROTECTED */               FLAG_TYPE_FLAG,
+  /* FLAG_ENSEMBLE */                     FLAG_TYPE_OPTION,
   /* FLAG_DATA_RECONCILE_Eps */           FLAG_TYPE_OPTION,
   /* FLAG_F */                            FLAG_TYPE_OPTION,
   /* FLAG_HELP */                         FLAG_TYPE_OPTION,
@@ -580,6 +641,7 @@ const int FLAG_TYPE[FLAG_MAX] = {
   /* FLAG_INPUT_FILE */                   FLAG_TYPE_OPTION,
   /* FLAG_INPUT_FILE_STATES */            FLAG_TYPE_OPTION,
   /* FLAG_INPUT_PATH */                   FLAG_TYPE_OPTION,
+  /* FLAG_INPUT_WINDOW */                 FLAG_TYPE_OPTION,
   /* FLAG_IPOPT_HESSE */                  FLAG_TYPE_OPTION,
   /* FLAG_IPOPT_INIT */                   FLAG_TYPE_OPTION,
   /* FLAG_IPOPT_JAC */                    FLAG_TYPE_OPTION,
@@ -625,11 +687,16 @@ const int FLAG_TYPE[FLAG_MAX] = {
   /* FLAG_OUTPUT_PATH */                  FLAG_TYPE_OPTION,
   /* FLAG_OVERRIDE */                     FLAG_TYPE_OPTION,
   /* FLAG_OVERRIDE_FILE */                FLAG_TYPE_OPTION,
+  /* FLAG_PARALLEL_EQUATIONS */           FLAG_TYPE_OPTION,
   /* FLAG_PORT */                         FLAG_TYPE_OPTION,
+  /* FLAG_PROFILE_SAMPLING */             FLAG_TYPE_OPTION,
+  /* FLAG_PROFILE_TRACE */                FLAG_TYPE_OPTION,
   /* FLAG_R */                            FLAG_TYPE_OPTION,
   /* FLAG_DATA_RECONCILE */               FLAG_TYPE_FLAG,
   /* FLAG_RT */                           FLAG_TYPE_OPTION,
   /* FLAG_S */                            FLAG_TYPE_OPTION,
+  /* FLAG_SHM_STREAM */                   FLAG_TYPE_OPTION,
+  /* FLAG_SHM_STREAM_SIZE */              FLAG_TYPE_OPTION,
   /* FLAG_SINGLE */                       FLAG_TYPE_FLAG,
   /* FLAG_SOLVER_STEPS */                 FLAG_TYPE_FLAG,
   /* FLAG_STEADY_STATE */                 FLAG_TYPE_FLAG,
@@ -858,14 +925,16 @@ const char *IMPRK_LS_METHOD[IMPRK_LS_MAX] = {
   "unknown",
 
   "iterative",
-  "dense"
+  "dense",
+  "klu"
 };
 
 const char *IMPRK_LS_METHOD_DESC[IMPRK_LS_MAX] = {
   "unknown",
 
   "use sparse iterative solvers",
-  "use direct dense method"
+  "use direct dense method",
+  "use sparse direct solver KLU with a colored Jacobian"
 };
 
 const char *HOM_BACK_STRAT_NAME[HOM_BACK_STRAT_MAX] = {
@@ -47,12 +47,14 @@ enum _FLAG
   FLAG_CPU,
   FLAG_CSV_OSTEP,
   FLAG_DAE_MODE,
+  FLAG_DECODE_LOG,
   FLAG_DELTA_X_LINEARIZE,
   FLAG_DELTA_X_SOLVER,
   FLAG_EMBEDDED_SERVER,
   FLAG_EMBEDDED_SERVER_PORT,
   FLAG_MAT_SYNC,
   FLAG_EMIT_PROTECTED,
+  FLAG_ENSEMBLE,
   FLAG_DATA_RECONCILE_Eps,
   FLAG_F,
   FLAG_HELP,
@@ -90,6 +92,7 @@ enum _FLAG
   FLAG_INPUT_FILE,
   FLAG_INPUT_FILE_STATES,
   FLAG_INPUT_PATH,
+  FLAG_INPUT_WINDOW,
   FLAG_IPOPT_HESSE,
   FLAG_IPOPT_INIT,
   FLAG_IPOPT_JAC,
@@ -135,11 +138,16 @@ enum _FLAG
   FLAG_OUTPUT_PATH,
   FLAG_OVERRIDE,
   FLAG_OVERRIDE_FILE,
+  FLAG_PARALLEL_EQUATIONS,
   FLAG_PORT,
+  FLAG_PROFILE_SAMPLING,
+  FLAG_PROFILE_TRACE,
   FLAG_R,
   FLAG_DATA_RECONCILE,
   FLAG_RT,
   FLAG_S,
+  FLAG_SHM_STREAM,
+  FLAG_SHM_STREAM_SIZE,
   FLAG_SINGLE_PRECISION,
   FLAG_SOLVER_STEPS,
   FLAG_STEADY_STATE,
@@ -333,6 +341,7 @@ enum IMPRK_LS
 
   IMPRK_LS_ITERATIVE,
   IMPRK_LS_DENSE,
+  IMPRK_LS_KLU,
 
   IMPRK_LS_MAX
 };
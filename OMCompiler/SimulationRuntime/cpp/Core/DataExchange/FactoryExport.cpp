@@ -9,6 +9,7 @@
 #include <Core/DataExchange/Policies/TextfileWriter.h>
 #include <Core/DataExchange/Policies/MatfileWriter.h>
 #include <Core/DataExchange/Policies/BufferReaderWriter.h>
+#include <Core/DataExchange/Policies/ChunkedBufferWriter.h>
 #include <Core/DataExchange/Policies/DefaultWriter.h>
 #include <Core/DataExchange/HistoryImpl.h>
 shared_ptr<IHistory> createMatFileWriterFactory(IGlobalSettings& globalSettings,size_t dim)
@@ -26,6 +27,11 @@ shared_ptr<IHistory> createBufferReaderWriterFactory(IGlobalSettings& globalSett
     shared_ptr<IHistory> writer= shared_ptr<IHistory>(new HistoryImpl<BufferReaderWriter >(globalSettings,dim)  );
     return writer;
 }
+shared_ptr<IHistory> createChunkedBufferWriterFactory(IGlobalSettings& globalSettings,size_t dim)
+{
+    shared_ptr<IHistory> writer= shared_ptr<IHistory>(new HistoryImpl<ChunkedBufferWriter >(globalSettings,dim)  );
+    return writer;
+}
 shared_ptr<IHistory> createDefaultWriterFactory(IGlobalSettings& globalSettings,size_t dim)
 {
     shared_ptr<IHistory> writer= shared_ptr<IHistory>(new HistoryImpl<DefaultWriter>(globalSettings,dim)  );
@@ -39,6 +45,7 @@ shared_ptr<IHistory> createDefaultWriterFactory(IGlobalSettings& globalSettings,
 #include <Core/DataExchange/Policies/TextfileWriter.h>
 #include <Core/DataExchange/Policies/MatfileWriter.h>
 #include <Core/DataExchange/Policies/BufferReaderWriter.h>
+#include <Core/DataExchange/Policies/ChunkedBufferWriter.h>
 #include <Core/DataExchange/Policies/DefaultWriter.h>
 #include <Core/DataExchange/HistoryImpl.h>
   BOOST_EXTENSION_TYPE_MAP_FUNCTION {
@@ -50,6 +57,8 @@ shared_ptr<IHistory> createDefaultWriterFactory(IGlobalSettings& globalSettings,
       ["TextFileWriter"].set<HistoryImpl<TextFileWriter > >();
   types.get<map<string, boost::extensions::factory<IHistory,IGlobalSettings&,size_t > > >()
       ["BufferReaderWriter"].set<HistoryImpl<BufferReaderWriter > >();
+  types.get<map<string, boost::extensions::factory<IHistory,IGlobalSettings&,size_t > > >()
+      ["ChunkedBufferWriter"].set<HistoryImpl<ChunkedBufferWriter > >();
   types.get<map<string, boost::extensions::factory<IHistory,IGlobalSettings&,size_t > > >()
       ["DefaultWriter"].set<HistoryImpl<DefaultWriter > >();
    /* used late for factory methode createXMLReader
@@ -64,6 +73,7 @@ shared_ptr<IHistory> createDefaultWriterFactory(IGlobalSettings& globalSettings,
 #include <Core/DataExchange/Policies/TextfileWriter.h>
 #include <Core/DataExchange/Policies/MatfileWriter.h>
 #include <Core/DataExchange/Policies/BufferReaderWriter.h>
+#include <Core/DataExchange/Policies/ChunkedBufferWriter.h>
 #include <Core/DataExchange/Policies/DefaultWriter.h>
 #include <Core/DataExchange/HistoryImpl.h>
 shared_ptr<IHistory> createMatFileWriterFactory(IGlobalSettings& globalSettings,size_t dim)
@@ -81,6 +91,11 @@ shared_ptr<IHistory> createBufferReaderWriterFactory(IGlobalSettings& globalSett
     shared_ptr<IHistory> writer= shared_ptr<IHistory>(new HistoryImpl<BufferReaderWriter >(globalSettings,dim)  );
     return writer;
 }
+shared_ptr<IHistory> createChunkedBufferWriterFactory(IGlobalSettings& globalSettings,size_t dim)
+{
+    shared_ptr<IHistory> writer= shared_ptr<IHistory>(new HistoryImpl<ChunkedBufferWriter >(globalSettings,dim)  );
+    return writer;
+}
 shared_ptr<IHistory> createDefaultWriterFactory(IGlobalSettings& globalSettings,size_t dim)
 {
     shared_ptr<IHistory> writer= shared_ptr<IHistory>(new HistoryImpl<DefaultWriter>(globalSettings,dim)  );
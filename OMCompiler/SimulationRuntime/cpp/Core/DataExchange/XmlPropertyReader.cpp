@@ -8,6 +8,7 @@
 #include <boost/lexical_cast.hpp>
 #include <fstream>
 #include <iostream>
+#include <set>
 
 XmlPropertyReader::XmlPropertyReader(IGlobalSettings *globalSettings, std::string propertyFile)
   : IPropertyReader()
@@ -34,6 +35,11 @@ void XmlPropertyReader::readInitialValues(IContinuous& system, shared_ptr<ISimVa
     double *derVars= sim_vars-> getDerStateVector();
     int refIdx = -1;
     boost::optional<int> refIdxOpt;
+    //Start values given at runtime, e.g. by a batch of simulation jobs, replace the ones of the xml file
+    const std::map<string, double>& startValues = _globalSettings->getStartValues();
+    std::map<string, double>::const_iterator startValueIter;
+    //names of the start values that were applied and names that refer to aliases
+    std::set<string> appliedStartValues, aliasStartValues;
     try
     {
       ptree tree;
@@ -61,12 +67,15 @@ void XmlPropertyReader::readInitialValues(IContinuous& system, shared_ptr<ISimVa
             descripton  = *descriptonOpt;
 
           refIdx = *refIdxOpt;
+          startValueIter = startValues.empty() ? startValues.end() : startValues.find(name);
           std::string aliasInfo = vars.second.get<std::string>("<xmlattr>.alias");
           std::string variabilityInfo = vars.second.get<std::string>("<xmlattr>.variability");
           bool isParameter = (variabilityInfo.compare("parameter") == 0);
           //If a start value is given for the alias and the referred variable, skip the alias declaration
           bool isAlias = aliasInfo.compare("alias") == 0;
           bool isNegatedAlias = aliasInfo.compare("negatedAlias") == 0;
+          if (startValueIter != startValues.end() && (isAlias || isNegatedAlias))
+            aliasStartValues.insert(name);
 
           bool emitResult = true;
           if (_globalSettings->getEmitResults() == EMIT_NONE)
@@ -88,6 +97,11 @@ void XmlPropertyReader::readInitialValues(IContinuous& system, shared_ptr<ISimVa
               if (!(isAlias || isNegatedAlias))
               {
                 boost::optional<double> v = var.second.get_optional<double>("<xmlattr>.start");
+                if (startValueIter != startValues.end())
+                {
+                  v = startValueIter->second;
+                  appliedStartValues.insert(name);
+                }
                 if (v) {
                   double value = *v;
                   LOGGER_WRITE("XMLPropertyReader: Setting real variable for " + boost::lexical_cast<std::string>(vars.second.get<std::string>("<xmlattr>.name")) + " with reference " + boost::lexical_cast<std::string>(refIdx) + " to " + boost::lexical_cast<std::string>(value), LC_INIT, LL_DEBUG);
@@ -110,6 +124,11 @@ void XmlPropertyReader::readInitialValues(IContinuous& system, shared_ptr<ISimVa
               if (!(isAlias || isNegatedAlias))
               {
                 boost::optional<int> v = var.second.get_optional<int>("<xmlattr>.start");
+                if (startValueIter != startValues.end())
+                {
+                  v = (int)startValueIter->second;
+                  appliedStartValues.insert(name);
+                }
                 if (v) {
                   int value = *v;
                   LOGGER_WRITE("XMLPropertyReader: Setting int variable for " + boost::lexical_cast<std::string>(vars.second.get<std::string>("<xmlattr>.name")) + " with reference " + boost::lexical_cast<std::string>(refIdx) + " to " + boost::lexical_cast<std::string>(value), LC_INIT, LL_DEBUG);
@@ -132,6 +151,11 @@ void XmlPropertyReader::readInitialValues(IContinuous& system, shared_ptr<ISimVa
               if (!(isAlias || isNegatedAlias))
               {
                 boost::optional<bool> v = var.second.get_optional<bool>("<xmlattr>.start");
+                if (startValueIter != startValues.end())
+                {
+                  v = (startValueIter->second != 0.0);
+                  appliedStartValues.insert(name);
+                }
                 if (v) {
                   bool value = *v;
                   LOGGER_WRITE("XMLPropertyReader: Setting bool variable for " + boost::lexical_cast<std::string>(vars.second.get<std::string>("<xmlattr>.name")) + " with reference " + boost::lexical_cast<std::string>(refIdx) + " to " + boost::lexical_cast<std::string>(value), LC_INIT, LL_DEBUG);
@@ -181,6 +205,24 @@ void XmlPropertyReader::readInitialValues(IContinuous& system, shared_ptr<ISimVa
       sstream << "Could not read start values. Current variable reference is " << refIdx;
       throw ModelicaSimulationError(UTILITY,sstream.str());
     }
+    //a start value that was not applied would silently simulate the default parameters
+    string unknownNames, aliasNames;
+    for (startValueIter = startValues.begin(); startValueIter != startValues.end(); ++startValueIter)
+    {
+      if (appliedStartValues.count(startValueIter->first))
+        continue;
+      string& names = aliasStartValues.count(startValueIter->first) ? aliasNames : unknownNames;
+      names += (names.empty() ? "" : ", ") + startValueIter->first;
+    }
+    if (!unknownNames.empty() || !aliasNames.empty())
+    {
+      string msg = "Start values could not be set";
+      if (!unknownNames.empty())
+        msg += ", unknown or String variables: " + unknownNames;
+      if (!aliasNames.empty())
+        msg += ", alias variables, set the referred variable instead: " + aliasNames;
+      throw ModelicaSimulationError(UTILITY, msg);
+    }
     _isInitialized = true;
     file.close();
 
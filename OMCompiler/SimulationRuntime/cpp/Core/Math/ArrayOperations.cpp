@@ -6,6 +6,7 @@
 #include <Core/Modelica.h>
 #include <Core/Math/ArrayOperations.h>
 #include <Core/Math/ArraySlice.h>
+#include <Core/Math/IBlas.h>
 #include <sstream>
 #include <stdio.h>
 
@@ -87,12 +88,9 @@ void cat_array(int k, const vector<const BaseArray<T>*>& x, BaseArray<T>& a)
     for (int c = 0; c < n; c++)
     {
       int n_sub_k = n_sub * x[c]->getDims()[k-1];
-      const T* x_data = x[c]->getData();
-      for (int r = 0; r < n_sub_k; r++)
-      {
-        a_data[j] = x_data[r + (i * n_sub_k)];
-        j++;
-      }
+      const T* x_data = x[c]->getData() + i * n_sub_k;
+      std::copy(x_data, x_data + n_sub_k, a_data + j);
+      j += n_sub_k;
     }
   }
 }
@@ -242,13 +240,32 @@ void transpose_array(const BaseArray<T>& x, BaseArray<T>& a)
     throw ModelicaSimulationError(MODEL_ARRAY_FUNCTION,
                                   "Wrong dimensions in transpose_array");
   vector<size_t> ex = x.getDims();
+  size_t n1 = ex[0];
+  size_t n2 = ex[1];
+  size_t nelems = x.getNumElems();
+  size_t nrest = n1 * n2 > 0 ? nelems / (n1 * n2) : 0;
+  const T* xdata = x.getData();
   std::swap(ex[0], ex[1]);
-  a.setDims(ex);
-  vector<Slice> sx(ndims);
-  vector<Slice> sa(ndims);
-  for (int i = 1; i <= x.getDim(1); i++) {
-    sa[1] = sx[0] = Slice(i);
-    ArraySlice<T>(a, sa).assign(ArraySliceConst<T>(x, sx));
+  if (a.hasWritableData())
+    a.setDims(ex);
+  // in-situ transposes and slices or reference arrays as result
+  // require an internal buffer
+  T* result = NULL;
+  T* adata = a.hasWritableData() ? a.getData() : NULL;
+  if (adata == NULL || adata == xdata) {
+    result = new T[nelems];
+    adata = result;
+  }
+  for (size_t r = 0; r < nrest; r++) {
+    const T* xr = xdata + n1 * n2 * r;
+    T* ar = adata + n1 * n2 * r;
+    for (size_t j = 0; j < n2; j++)
+      for (size_t i = 0; i < n1; i++)
+        ar[j + n2 * i] = xr[i + n1 * j];
+  }
+  if (result != NULL) {
+    a.assign(result);
+    delete [] result;
   }
 }
 
@@ -266,49 +283,87 @@ void multiply_array(const BaseArray<T>& inputArray, const T &b, BaseArray<T>& ou
   }
 };
 
+/**
+ * helper for multiply_array
+ * product c(m,n) = a(m,k) * b(k,n) of contiguous column major data,
+ * the innermost loop runs over consecutive elements of a and c
+ */
+template <typename T>
+static void multiply_data(const T* a, const T* b, T* c, size_t m, size_t k, size_t n)
+{
+  std::fill(c, c + m * n, T());
+  for (size_t j = 0; j < n; j++) {
+    T* cj = c + m * j;
+    for (size_t l = 0; l < k; l++) {
+      const T blj = b[l + k * j];
+      const T* al = a + m * l;
+      for (size_t i = 0; i < m; i++)
+        cj[i] += al[i] * blj;
+    }
+  }
+}
+
+/**
+ * helper for multiply_array
+ * large real products are passed to BLAS
+ */
+static void multiply_data(const double* a, const double* b, double* c, size_t m, size_t k, size_t n)
+{
+  if (m * k * n < 32768 || k == 0) {
+    multiply_data<double>(a, b, c, m, k, n);
+    return;
+  }
+  long int lm = m, lk = k, ln = n, inc = 1;
+  double one = 1.0, zero = 0.0;
+  char trans = 'N';
+  if (n == 1)
+    dgemv_(&trans, &lm, &lk, &one, const_cast<double*>(a), &lm,
+           const_cast<double*>(b), &inc, &zero, c, &inc);
+  else
+    dgemm_(&trans, &trans, &lm, &ln, &lk, &one, const_cast<double*>(a), &lm,
+           const_cast<double*>(b), &lk, &zero, c, &lm);
+}
+
 template <typename T>
 void multiply_array(const BaseArray<T> &leftArray, const BaseArray<T> &rightArray, BaseArray<T> &resultArray)
 {
   size_t leftNumDims = leftArray.getNumDims();
   size_t rightNumDims = rightArray.getNumDims();
   size_t matchDim = rightArray.getDim(1);
-  resultArray.setDims(leftArray.getDims());
   if (leftArray.getDim(leftNumDims) != matchDim)
     throw ModelicaSimulationError(MODEL_ARRAY_FUNCTION,
                                   "Wrong sizes in multiply_array");
-  if (leftNumDims == 1 && rightNumDims == 2) {
-    size_t rightDim = rightArray.getDim(2);
-    for (size_t j = 1; j <= rightDim; j++) {
-      T val = T();
-      for (size_t k = 1; k <= matchDim; k++)
-        val += leftArray(k) * rightArray(k, j);
-      resultArray(j) = val;
-    }
-  }
-  else if (leftNumDims == 2 && rightNumDims == 1) {
-    size_t leftDim = leftArray.getDim(1);
-    for (size_t i = 1; i <= leftDim; i++) {
-      T val = T();
-      for (size_t k = 1; k <= matchDim; k++)
-        val += leftArray(i, k) * rightArray(k);
-      resultArray(i) = val;
-    }
-  }
+  // vectors are treated as row (left) or column (right) matrices
+  size_t leftDim = leftNumDims == 2 ? leftArray.getDim(1) : 1;
+  size_t rightDim = rightNumDims == 2 ? rightArray.getDim(2) : 1;
+  vector<size_t> dims;
+  if (leftNumDims == 1 && rightNumDims == 2)
+    dims.push_back(rightDim);
+  else if (leftNumDims == 2 && rightNumDims == 1)
+    dims.push_back(leftDim);
   else if (leftNumDims == 2 && rightNumDims == 2) {
-    size_t leftDim = leftArray.getDim(1);
-    size_t rightDim = rightArray.getDim(2);
-    for (size_t i = 1; i <= leftDim; i++) {
-      for (size_t j = 1; j <= rightDim; j++) {
-        T val = T();
-        for (size_t k = 1; k <= matchDim; k++)
-          val += leftArray(i, k) * rightArray(k, j);
-        resultArray(i, j) = val;
-      }
-    }
+    dims.push_back(leftDim);
+    dims.push_back(rightDim);
   }
   else
     throw ModelicaSimulationError(MODEL_ARRAY_FUNCTION,
                                   "Unsupported dimensions in multiply_array");
+  const T* leftData = leftArray.getData();
+  const T* rightData = rightArray.getData();
+  if (&resultArray == &leftArray || &resultArray == &rightArray ||
+      !resultArray.hasWritableData()) {
+    // in-situ product, e.g. v = A * v, or a slice or reference array as result
+    T* result = new T[leftDim * rightDim];
+    multiply_data(leftData, rightData, result, leftDim, matchDim, rightDim);
+    if (resultArray.hasWritableData())
+      resultArray.setDims(dims);
+    resultArray.assign(result);
+    delete [] result;
+  }
+  else {
+    resultArray.setDims(dims);
+    multiply_data(leftData, rightData, resultArray.getData(), leftDim, matchDim, rightDim);
+  }
 }
 
 template <typename T>
@@ -198,6 +198,68 @@ label_list_type Ranking::residuenRanking(ublas::matrix<double>& R, ublas::matrix
 	else
 		throw std::runtime_error("Modelica system is not of type IReduceDAE");
 }
+/*
+Simulations of the perfect ranking: simulation i removes label i only and
+ranks it by the deviation of the outputs from the reference result Ro.
+*/
+class PerfectRankingSimulations : public IReducedSimulations
+{
+public:
+	PerfectRankingSimulations(label_list_type& labels, ublas::matrix<double>& Ro, vector<string>& output_names, Reduction& reduction)
+		: rank_vector(labels.size())
+		, messages(labels.size())
+		, _labels(labels)
+		, _Ro(Ro)
+		, _output_names(output_names)
+		, _reduction(reduction)
+	{
+	}
+
+	virtual size_t getDimSimulations()
+	{
+		return _labels.size();
+	}
+
+	virtual void setLabels(label_list_type& labels, size_t i)
+	{
+		//set label_1 to 0 and label_2 to 1
+		*(get<1>(labels[i])) = 0;
+		*(get<2>(labels[i])) = 1;
+	}
+
+	virtual void setResult(IHistory* history, size_t i)
+	{
+		//current result
+		ublas::matrix<double> Rc;
+		//query simulation result outputs
+		history->getOutputResults(Rc);
+		//rank norm_inf (x)= max |xi|
+		rank_vector[i] = ublas::norm_inf(_reduction.getError(Rc, _Ro, _output_names));
+	}
+
+	virtual void setError(std::exception& ex, size_t i)
+	{
+#undef max
+		rank_vector[i] = std::numeric_limits<double>::max();
+		ModelicaSimulationError* simulation_error = dynamic_cast<ModelicaSimulationError*>(&ex);
+		if (dynamic_cast<std::invalid_argument*>(&ex))
+			messages[i] = "division by zero for label " + to_string(get<0>(_labels[i]));
+		else if (!simulation_error || !simulation_error->isSuppressed())
+			messages[i] = "removing label " + to_string(get<0>(_labels[i])) + "causes error " + ex.what();
+	}
+
+	//rank value of each label
+	vector<double> rank_vector;
+	//errors to report for each label
+	vector<string> messages;
+
+private:
+	label_list_type& _labels;
+	ublas::matrix<double>& _Ro;
+	vector<string>& _output_names;
+	Reduction& _reduction;
+};
+
 label_list_type Ranking::perfectRanking(ublas::matrix<double>& Ro, shared_ptr<IMixedSystem> _system, IReduceDAESettings* _settings, SimSettings simsettings,
                                         string modelKey, vector<string> output_names, double timeout,ISimController* sim_controller)
 {
@@ -209,72 +271,22 @@ label_list_type Ranking::perfectRanking(ublas::matrix<double>& Ro, shared_ptr<IM
 	//cast modelica system to reduce dae object
 	shared_ptr<IReduceDAE> reduce_dae = dynamic_pointer_cast<IReduceDAE>(_system);
 
-	IHistory* history;
-	ublas::matrix<double> Rc; //current result
-
 	if (reduce_dae)
 	{
-
-
 		//get label variables
 		label_list_type labels = reduce_dae->getLabels();
-		//number of labels
-		int kDim = labels.size();
-		//vector for ranks
-		vector<double> rank_vector(kDim);
-		double rank_value;
-		//index for current ranking
-		unsigned int k = 0;
-		//loop over labels
-		FOREACH(label_type  label, labels)
-		{
-			try{
-
-				sim_controller->initialize(simsettings, modelKey, timeout);
-				//set label_1 to 0 and label_2 to 1
-				*(get<1>(label)) = 0;
-				*(get<2>(label)) = 1;
-				//vector for errors
-				ublas::vector<double> e(n);
-
-				sim_controller->runReducedSimulation();
-				history = reduce_dae->getHistory();
-				//query simulation result outputs
-				Rc.clear();
-				history->getOutputResults(Rc);
+		Reduction reduction(_system, _settings);
+		PerfectRankingSimulations simulations(labels, Ro, output_names, reduction);
 
+		//the labels are independent of each other, so they are all simulated at once
+		sim_controller->runReducedSimulations(simsettings, modelKey, timeout, &simulations, _settings->getThreads());
 
-				Reduction reduction(_system, _settings);
-				e = reduction.getError(Rc, Ro, output_names);;
-
-				//rank norm_inf (x)= max |xi|
-				rank_value = ublas::norm_inf(e);
-
-			}
-			catch (ModelicaSimulationError& ex)
-			{
-#undef max
-				rank_value = std::numeric_limits<double>::max();
-				if (!ex.isSuppressed())
-					cout << "removing label " << (get<0>(label)) << "causes error " << ex.what() << std::endl;
-				// std::cerr << "Simulation stopped with error in " << error_id_string(ex.getErrorID()) << ": "  << ex.what();
-
-			}
-			catch (std::invalid_argument& ex) // division by zero
-			{
-#undef max
-				rank_value = std::numeric_limits<double>::max();
-				cout << "division by zero for label " << (get<0>(label)) << std::endl;
-			}
-
-
-
-			rank_vector[k++] = rank_value;
-			cout << "rank value for label " << (get<0>(label)) << ": " << rank_value << std::endl;
-
-			//reset current label values
-			*(get<1>(label)) = 1;
-			*(get<2>(label)) = 0;
+		vector<double>& rank_vector = simulations.rank_vector;
+		for (size_t k = 0; k < labels.size(); k++)
+		{
+			if (!simulations.messages[k].empty())
+				cout << simulations.messages[k] << std::endl;
+			cout << "rank value for label " << (get<0>(labels[k])) << ": " << rank_vector[k] << std::endl;
 		}
 		//sort the label list in the order of the sorted ranking vector
 		sort(labels.begin(), labels.end(),
@@ -286,4 +298,4 @@ label_list_type Ranking::perfectRanking(ublas::matrix<double>& Ro, shared_ptr<IM
 	}
 	else
 		throw std::runtime_error("Modelica system is not of type IReduceDAE");
-}
\ No newline at end of file
+}
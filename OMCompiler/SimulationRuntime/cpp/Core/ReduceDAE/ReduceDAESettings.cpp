@@ -9,7 +9,8 @@
 ReduceDAESettings::ReduceDAESettings(IGlobalSettings*	globalSettings)
 	:_globalSettings(globalSettings),
 	_ranking_method(RESIDUEN),
-	_reduction_method(CANCEL_TERMS)
+	_reduction_method(CANCEL_TERMS),
+	_threads(0)
 
 {
 	//initialize max errro vector with default size
@@ -67,6 +68,22 @@ vector<string> ReduceDAESettings::getOutputNames()
 	return _output_names;
 }
 
+unsigned int ReduceDAESettings::getThreads()
+{
+#if defined(USE_THREAD)
+	if (_threads == 0)
+		return std::max(1u, (unsigned int)thread::hardware_concurrency());
+	return _threads;
+#else
+	return 1;
+#endif
+}
+
+void ReduceDAESettings::setThreads(unsigned int threads)
+{
+	_threads = threads;
+}
+
 /**
 initializes settings object by an xml file
 */
@@ -105,6 +122,11 @@ void ReduceDAESettings::load(std::string xml_file)
 
 				}
 
+				if (vars.first == "Threads")
+				{
+					_threads = vars.second.get<int>("<xmlattr>.value");
+				}
+
 				if (vars.first == "MaximumError")
 				{
 					ublas::vector<double>::size_type  i = 0;
@@ -60,6 +60,81 @@ ublas::vector<double> Reduction::getError(ublas::matrix<double>& R, ublas::matri
 	return error;
 
 }
+/*
+Simulations of one batch of the reduction: simulation i removes the labels
+canceled so far plus the label at position first+i of the ranked list.
+*/
+class CancelTermsSimulations : public IReducedSimulations
+{
+public:
+	CancelTermsSimulations(label_list_type& labels, std::vector<unsigned int>& canceled_labels, size_t first, size_t dim,
+	                       ublas::matrix<double>& Ro, vector<string>& output_names, Reduction& reduction)
+		: errors(dim)
+		, failed(dim, false)
+		, messages(dim)
+		, _labels(labels)
+		, _canceled_labels(canceled_labels)
+		, _first(first)
+		, _dim(dim)
+		, _Ro(Ro)
+		, _output_names(output_names)
+		, _reduction(reduction)
+	{
+	}
+
+	virtual size_t getDimSimulations()
+	{
+		return _dim;
+	}
+
+	virtual void setLabels(label_list_type& labels, size_t i)
+	{
+		//by initialization all labels becomes 1,
+		// so the labels which are zero untill now are applied to the model again
+		for (size_t j = 0; j < _canceled_labels.size(); j++)
+		{
+			*(get<1>(labels[_canceled_labels[j]])) = 0;
+			*(get<2>(labels[_canceled_labels[j]])) = 1;
+		}
+		//set current label_1 to 0 and label_2 to 1
+		*(get<1>(labels[get<0>(_labels[_first + i])])) = 0;
+		*(get<2>(labels[get<0>(_labels[_first + i])])) = 1;
+	}
+
+	virtual void setResult(IHistory* history, size_t i)
+	{
+		//simulation results for output variables of k.-reduction
+		ublas::matrix<double> Rok;
+		//query simulation result outputs
+		history->getOutputResults(Rok);
+		errors[i] = _reduction.getError(Rok, _Ro, _output_names);
+	}
+
+	virtual void setError(std::exception& ex, size_t i)
+	{
+		ModelicaSimulationError* simulation_error = dynamic_cast<ModelicaSimulationError*>(&ex);
+		failed[i] = true;
+		if (!simulation_error || !simulation_error->isSuppressed())
+			messages[i] = ex.what();
+	}
+
+	//output errors of each simulation
+	vector<ublas::vector<double> > errors;
+	//simulation stopped with an error
+	vector<bool> failed;
+	//errors to report for each simulation
+	vector<string> messages;
+
+private:
+	label_list_type& _labels;
+	std::vector<unsigned int>& _canceled_labels;
+	size_t _first;
+	size_t _dim;
+	ublas::matrix<double>& _Ro;
+	vector<string>& _output_names;
+	Reduction& _reduction;
+};
+
 std::vector<unsigned int> Reduction::cancelTerms(label_list_type& labels, ublas::matrix<double>& Ro, shared_ptr<IMixedSystem> _system, IReduceDAESettings* _settings
                                                  ,SimSettings simsettings, string modelKey, vector<string> output_names, double timeout,ISimController* sim_controller)
 {
@@ -71,20 +146,11 @@ std::vector<unsigned int> Reduction::cancelTerms(label_list_type& labels, ublas:
 
 	//vector of labels to be canceled
 	std::vector<unsigned int> canceled_labels;
-	std::vector<unsigned int> help_canceled_labels;
 	//cast modelica system to reduce dae object
 
 	shared_ptr<IReduceDAE> reduce_dae = dynamic_pointer_cast<IReduceDAE>(_system);
-	//get history object to query simulation results
-	IHistory*  history;
-
-	//simulation results for output variables of k.-reduction
-	ublas::matrix<double> Rok;
-	//current label
-
 
 	unsigned int nfail = 0;
-	unsigned int reductionStep = 1;
 	if (reduce_dae)
 	{
 
@@ -115,110 +181,58 @@ std::vector<unsigned int> Reduction::cancelTerms(label_list_type& labels, ublas:
         #ifdef USE_CHRONO
 		auto start = high_resolution_clock::now();
         #endif
-		//loop over labels
-		FOREACH(label_type  label, labels)
+		//the labels are tried in batches of simultaneous simulations, each assuming
+		//that the labels before it in the batch are kept. Once a label is deleted the
+		//results of the rest of the batch are outdated, so the next batch starts after it.
+		size_t numThreads = _settings->getThreads();
+		size_t next = 0;
+		bool stop = false;
+		while (next < labels.size() && !stop)
 		{
-			try
-			{
-
-				//removing initialization from here and put it ouside of BOOST_FOREACH,
-				//cause not updated output values on Rok vector!!
-				#ifdef USE_CHRONO
-                auto startSim1 = high_resolution_clock::now();
-				#endif
-                sim_controller->initialize(simsettings, modelKey, timeout);
-				//set current label_1 to 0 and label_2 to 1
-				*(get<1>(label)) = 0;
-				*(get<2>(label)) = 1;
-				//by initialization all labels becomes 1,
-				// so with this help_canceled_labels we apply all labels which are zero untill now to the model again
-				for (int i = 0; i < help_canceled_labels.size(); i++)
-				{
-
-					//cout << "indexes of deleted labels applied to the model " <<  get<0>(labels[help_canceled_labels[i]]) <<std::endl;
-					*(get<1>(labels[help_canceled_labels[i]])) = 0;
-					*(get<2>(labels[help_canceled_labels[i]])) = 1;
-				}
-
-				//number of output variables
-				ublas::matrix<double>::size_type n;
-				n = Ro.size1();
-				//vector for errors
-				ublas::vector<double> error(n);
-				//run simulation
-				sim_controller->runReducedSimulation();
-				#ifdef USE_CHRONO
-                auto endSim1 =  high_resolution_clock::now();
-				double simtime = duration_cast<duration<double>>(endSim1 - startSim1).count();
-				#endif
-                std::cout << " time of simulation for reducing label " << get<0>(label) << " is " << simtime << " seconds" << std::endl;
-				history = reduce_dae->getHistory();
-
-				//query simulation result outputs
-				Rok.clear();
-				history->getOutputResults(Rok);
-
-				//error
+			size_t dim = std::min(numThreads, labels.size() - next);
+			CancelTermsSimulations simulations(labels, canceled_labels, next, dim, Ro, output_names, *this);
+			sim_controller->runReducedSimulations(simsettings, modelKey, timeout, &simulations, numThreads);
 
-				Reduction reduction(_system, _settings);
-
-				error = reduction.getError(Rok, Ro, output_names);
+			for (i = 0; i < dim && !stop; i++)
+			{
+				label_type& label = labels[next + i];
+				unsigned int reductionStep = next + i + 1;
 
 				//check if error of selected varibles based on indexes vector is less than max error
-				if (reduction.isLess(error, sorted_max_error, indexes, output_names))
+				if (!simulations.failed[i] && isLess(simulations.errors[i], sorted_max_error, indexes, output_names))
 				{
-					cout << "delete term for label " << get<0>(label) << " with error " << error << std::endl;
+					cout << "delete term for label " << get<0>(label) << " with error " << simulations.errors[i] << std::endl;
 					//add label number to canceled_labels
 					canceled_labels.push_back(get<0>(label));
-					help_canceled_labels.push_back(reductionStep - 1);
-				}
-				else
-				{
-					cout << "do nothing for label " << get<0>(label) << " with error " << error << std::endl;
-					//reset current label values
-					*(get<1>(label)) = 1;
-					*(get<2>(label)) = 0;
-					nfail++;
-
-					//check if looking for terms to reduce has failed more than allowed
-					if ((nfail) > _settings->getNFail())
-					{
-						cout << "Redution stoped at step " << reductionStep + 1 << " because of exceeding max number of reduction fails" << std::endl;
-						//stop looking for terms to delete
-						break;
-					}
-
+					*(get<1>(label)) = 0;
+					*(get<2>(label)) = 1;
+					i++;
+					break;
 				}
 
-			}
-
-			catch (ModelicaSimulationError& ex)
-			{
-				if (!ex.isSuppressed())
-					cout << "do nothing for label " << get<0>(label) << " with error " << ex.what() << std::endl;
-				// std::cerr << "Simulation stopped with error in " << error_id_string(ex.getErrorID()) << ": "  << ex.what();
-				//reset current label values
-				*(get<1>(label)) = 1;
-				*(get<2>(label)) = 0;
+				if (!simulations.failed[i])
+					cout << "do nothing for label " << get<0>(label) << " with error " << simulations.errors[i] << std::endl;
+				else if (!simulations.messages[i].empty())
+					cout << "do nothing for label " << get<0>(label) << " with error " << simulations.messages[i] << std::endl;
 				nfail++;
 
 				//check if looking for terms to reduce has failed more than allowed
 				if ((nfail) > _settings->getNFail())
 				{
-					cout << "Redution failed for " << nfail << " times. So, it stoped at step " << reductionStep + 1 << std::endl;
+					if (!simulations.failed[i])
+						cout << "Redution stoped at step " << reductionStep + 1 << " because of exceeding max number of reduction fails" << std::endl;
+					else
+						cout << "Redution failed for " << nfail << " times. So, it stoped at step " << reductionStep + 1 << std::endl;
 					//stop looking for terms to delete
-					break;
+					stop = true;
 				}
-
 			}
-
-			reductionStep++;
-
+			next += i;
 		}
         #ifdef USE_CHRONO
 		auto end = high_resolution_clock::now();
-        #endif
 		std::cout << " time of reduction: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " milliseconds" << std::endl;
+        #endif
 		return canceled_labels;
 	}
 	else
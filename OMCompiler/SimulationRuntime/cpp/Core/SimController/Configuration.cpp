@@ -36,6 +36,33 @@ ISolverSettings* Configuration::getSolverSettings()
   return _solver_settings.get();
 }
 
+shared_ptr<Configuration> Configuration::createConfiguration()
+{
+  shared_ptr<Configuration> config(new Configuration(_library_path, _config_path, _modelicasystem_path));
+  shared_ptr<IGlobalSettings> global_settings = config->getGlobalSettings();
+  global_settings->setStartTime(_global_settings->getStartTime());
+  global_settings->setEndTime(_global_settings->getEndTime());
+  global_settings->sethOutput(_global_settings->gethOutput());
+  global_settings->setResultsFileName(_global_settings->getResultsFileName());
+  global_settings->setSelectedLinSolver(_global_settings->getSelectedLinSolver());
+  global_settings->setSelectedNonLinSolver(_global_settings->getSelectedNonLinSolver());
+  global_settings->setSelectedSolver(_global_settings->getSelectedSolver());
+  global_settings->setLogSettings(_global_settings->getLogSettings());
+  global_settings->setAlarmTime(_global_settings->getAlarmTime());
+  global_settings->setOutputPointType(_global_settings->getOutputPointType());
+  global_settings->setOutputFormat(_global_settings->getOutputFormat());
+  global_settings->setHistorySettings(_global_settings->getHistorySettings());
+  global_settings->setPararealSettings(_global_settings->getPararealSettings());
+  global_settings->setEmitResults(_global_settings->getEmitResults());
+  global_settings->setNonLinearSolverContinueOnError(_global_settings->getNonLinearSolverContinueOnError());
+  global_settings->setSolverThreads(_global_settings->getSolverThreads());
+  global_settings->setInputPath(_global_settings->getInputPath());
+  global_settings->setOutputPath(_global_settings->getOutputPath());
+  global_settings->setRuntimeLibrarypath(_global_settings->getRuntimeLibrarypath());
+  global_settings->setStartValues(_global_settings->getStartValues());
+  return config;
+}
+
 shared_ptr<ISolver> Configuration::createSelectedSolver(IMixedSystem* system)
 {
   string solver_name = _global_settings->getSelectedSolver();
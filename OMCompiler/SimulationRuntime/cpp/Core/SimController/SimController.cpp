@@ -80,6 +80,7 @@ weak_ptr<IMixedSystem> SimController::LoadSystem(string modelLib,string modelKey
      //create system
     shared_ptr<IMixedSystem> system = createSystem(modelLib, modelKey, _config->getGlobalSettings().get(), _sim_objects);
     _systems[modelKey] = system;
+    _model_libs[modelKey] = modelLib;
     return system;
 }
 
@@ -99,6 +100,7 @@ weak_ptr<IMixedSystem> SimController::LoadModelicaSystem(PATH modelica_path,stri
 
         shared_ptr<IMixedSystem> system = createModelicaSystem(modelica_path, modelKey, _config->getGlobalSettings().get(),_sim_objects);
         _systems[modelKey] = system;
+        _model_libs.erase(modelKey);
         return system;
     }
     else
@@ -131,6 +133,296 @@ shared_ptr<IMixedSystem> SimController::getSystem(string modelname)
  {
      _simMgr->runSimulation();
  }
+
+#if defined(USE_THREAD)
+/// Thread function taking the next simulation index from a shared counter
+template <class Worker>
+class SimulationThread
+{
+public:
+    SimulationThread(Worker* worker, atomic<size_t>* next, size_t dim)
+        : _worker(worker)
+        , _next(next)
+        , _dim(dim)
+    {
+    }
+
+    void operator()()
+    {
+        size_t i;
+        while ((i = _next->fetch_add(1)) < _dim)
+            _worker->run(i);
+    }
+
+private:
+    Worker* _worker;
+    atomic<size_t>* _next;
+    size_t _dim;
+};
+#endif //USE_THREAD
+
+/**
+ * Runs jobs of an ISimulationJobs object on a system of its own, created with
+ * its own configuration, so that every job can set the start values and the
+ * time span of the global settings read by the system and its history.
+ */
+class SimulationJobWorker
+{
+public:
+    SimulationJobWorker(shared_ptr<Configuration> config, SimSettings& simsettings, ISimulationJobs* jobs)
+        : _config(config)
+        , _simsettings(simsettings)
+        , _jobs(jobs)
+    {
+        shared_ptr<IGlobalSettings> global_settings = _config->getGlobalSettings();
+
+        global_settings->setStartTime(simsettings.start_time);
+        global_settings->setEndTime(simsettings.end_time);
+        global_settings->sethOutput(simsettings.step_size);
+        global_settings->setResultsFileName(simsettings.outputfile_name);
+        global_settings->setSelectedLinSolver(simsettings.linear_solver_name);
+        global_settings->setSelectedNonLinSolver(simsettings.nonlinear_solver_name);
+        global_settings->setSelectedSolver(simsettings.solver_name);
+        global_settings->setLogSettings(simsettings.logSettings);
+        global_settings->setAlarmTime(simsettings.timeOut);
+        global_settings->setOutputPointType(simsettings.outputPointType);
+        //the chunked history is kept, it also stores the results in memory
+        global_settings->setOutputFormat(simsettings.outputFormat == CHUNKED ? CHUNKED : BUFFER);
+        global_settings->setHistorySettings(simsettings.historySettings);
+        global_settings->setEmitResults(simsettings.emitResults);
+        global_settings->setNonLinearSolverContinueOnError(simsettings.nonLinearSolverContinueOnError);
+        global_settings->setSolverThreads(simsettings.solverThreads);
+        global_settings->setInputPath(simsettings.inputPath);
+        global_settings->setOutputPath(simsettings.outputPath);
+
+        //every job keeps the number of output intervals of the settings
+        _intervals = 1.0;
+        if (simsettings.step_size > 0.0)
+            _intervals = std::max(1.0, floor((simsettings.end_time - simsettings.start_time) / simsettings.step_size + 0.5));
+    }
+
+    void setSystem(shared_ptr<IMixedSystem> system)
+    {
+        _system = system;
+        _write_output = dynamic_pointer_cast<IWriteOutput>(system);
+        if (!_write_output)
+            throw ModelicaSimulationError(SIMMANAGER, "Modelica system is not of type IWriteOutput");
+    }
+
+    void run(size_t i)
+    {
+        try
+        {
+            shared_ptr<IGlobalSettings> global_settings = _config->getGlobalSettings();
+            std::map<string, double> start_values;
+            double start_time = _simsettings.start_time;
+            double end_time = _simsettings.end_time;
+            _jobs->getJob(i, start_values, start_time, end_time);
+            if (!(end_time > start_time))
+                throw ModelicaSimulationError(SIMMANAGER, "End time of simulation job " + to_string(i) + " is not after its start time");
+            global_settings->setStartValues(start_values);
+            global_settings->setStartTime(start_time);
+            global_settings->setEndTime(end_time);
+            global_settings->sethOutput((end_time - start_time) / _intervals);
+
+            SimManager simMgr(_system, _config.get());
+
+            ISolverSettings* solver_settings = _config->getSolverSettings();
+            solver_settings->setLowerLimit(_simsettings.lower_limit);
+            solver_settings->sethInit(_simsettings.lower_limit);
+            solver_settings->setUpperLimit(_simsettings.upper_limit);
+            solver_settings->setRTol(_simsettings.tolerance);
+            solver_settings->setATol(_simsettings.tolerance);
+
+            simMgr.initialize();
+            simMgr.runSimulation();
+            _jobs->setResult(_write_output->getHistory(), i);
+        }
+        catch (std::exception& ex)
+        {
+            _jobs->setError(ex, i);
+        }
+    }
+
+private:
+    shared_ptr<Configuration> _config;
+    shared_ptr<IMixedSystem> _system;
+    shared_ptr<IWriteOutput> _write_output;
+    SimSettings _simsettings;
+    ISimulationJobs* _jobs;
+    double _intervals;
+};
+
+void SimController::runSimulations(SimSettings simsettings, string modelKey, ISimulationJobs* jobs, unsigned int numThreads)
+{
+    std::map<string, string>::iterator lib_iter = _model_libs.find(modelKey);
+    if (lib_iter == _model_libs.end())
+        throw ModelicaSimulationError(SIMMANAGER, "No model library was loaded for model: " + modelKey);
+    shared_ptr<ISimVars> sim_vars = _sim_objects->getSimVars(modelKey);
+    size_t dim = jobs->getDimJobs();
+    size_t i;
+
+    #if !defined(USE_THREAD)
+    numThreads = 1;
+    #endif
+    if (numThreads > dim)
+        numThreads = dim;
+    if (numThreads < 1)
+        numThreads = 1;
+
+    // Every worker gets a system of its own, created from the loaded model
+    // library with its own configuration and simulation objects. Unlike a
+    // clone, the system then reads the start values and the time span of its
+    // worker's global settings.
+    vector<shared_ptr<SimulationJobWorker> > workers;
+    for (i = 0; i < numThreads; i++)
+    {
+        shared_ptr<Configuration> config(new Configuration(_library_path, _config_path, _modelicasystem_path));
+        shared_ptr<SimulationJobWorker> worker(new SimulationJobWorker(config, simsettings, jobs));
+        IGlobalSettings* global_settings = config->getGlobalSettings().get();
+        shared_ptr<ISimObjects> sim_objects(new SimObjects(_library_path, _modelicasystem_path, global_settings));
+        sim_objects->LoadSimData(modelKey);
+        sim_objects->LoadSimVars(modelKey, sim_vars->getDimReal(), sim_vars->getDimInt(), sim_vars->getDimBool(), sim_vars->getDimString(),
+                                 sim_vars->getDimPreVars(), sim_vars->getDimStateVars(), sim_vars->getStateVectorIndex());
+        worker->setSystem(createSystem(lib_iter->second, modelKey, global_settings, sim_objects));
+        workers.push_back(worker);
+    }
+
+    #if defined(USE_THREAD)
+    if (numThreads > 1)
+    {
+        atomic<size_t> next(0);
+        vector<shared_ptr<thread> > threads;
+        for (i = 1; i < numThreads; i++)
+            threads.push_back(shared_ptr<thread>(new thread(SimulationThread<SimulationJobWorker>(workers[i].get(), &next, dim))));
+        SimulationThread<SimulationJobWorker>(workers[0].get(), &next, dim)();
+        for (i = 0; i < threads.size(); i++)
+            threads[i]->join();
+        return;
+    }
+    #endif
+    for (i = 0; i < dim; i++)
+        workers[0]->run(i);
+}
+
+#ifdef USE_REDUCE_DAE
+/**
+ * Runs simulations of an IReducedSimulations object on a private copy of the
+ * system, using its own configuration and therefore its own solver.
+ */
+class ReducedSimulationWorker
+{
+public:
+    ReducedSimulationWorker(shared_ptr<Configuration> config, shared_ptr<IMixedSystem> system, SimSettings& simsettings, double timeout, IReducedSimulations* simulations)
+        : _config(config)
+        , _system(system)
+        , _reduce_dae(dynamic_pointer_cast<IReduceDAE>(system))
+        , _simsettings(simsettings)
+        , _simulations(simulations)
+    {
+        shared_ptr<IGlobalSettings> global_settings = _config->getGlobalSettings();
+
+        global_settings->setStartTime(simsettings.start_time);
+        global_settings->setEndTime(simsettings.end_time);
+        global_settings->sethOutput(simsettings.step_size);
+        global_settings->setResultsFileName(simsettings.outputfile_name);
+        global_settings->setSelectedLinSolver(simsettings.linear_solver_name);
+        global_settings->setSelectedNonLinSolver(simsettings.nonlinear_solver_name);
+        global_settings->setSelectedSolver(simsettings.solver_name);
+        global_settings->setLogSettings(simsettings.logSettings);
+        global_settings->setAlarmTime(timeout);
+        global_settings->setOutputPointType(simsettings.outputPointType);
+        global_settings->setOutputFormat(simsettings.outputFormat);
+        global_settings->setHistorySettings(simsettings.historySettings);
+        global_settings->setEmitResults(simsettings.emitResults);
+        global_settings->setNonLinearSolverContinueOnError(simsettings.nonLinearSolverContinueOnError);
+        global_settings->setSolverThreads(simsettings.solverThreads);
+        if (!_reduce_dae)
+            throw ModelicaSimulationError(SIMMANAGER, "Modelica system is not of type IReduceDAE");
+    }
+
+    void run(size_t i)
+    {
+        try
+        {
+            SimManager simMgr(_system, _config.get());
+
+            ISolverSettings* solver_settings = _config->getSolverSettings();
+            solver_settings->setLowerLimit(_simsettings.lower_limit);
+            solver_settings->sethInit(_simsettings.lower_limit);
+            solver_settings->setUpperLimit(_simsettings.upper_limit);
+            solver_settings->setRTol(_simsettings.tolerance);
+            solver_settings->setATol(_simsettings.tolerance);
+
+            simMgr.initialize();
+            //initialization resets all labels, so they are applied afterwards
+            label_list_type labels = _reduce_dae->getLabels();
+            _simulations->setLabels(labels, i);
+            simMgr.runSimulation();
+            _simulations->setResult(_reduce_dae->getHistory(), i);
+        }
+        catch (std::exception& ex)
+        {
+            _simulations->setError(ex, i);
+        }
+    }
+
+private:
+    shared_ptr<Configuration> _config;
+    shared_ptr<IMixedSystem> _system;
+    shared_ptr<IReduceDAE> _reduce_dae;
+    SimSettings _simsettings;
+    IReducedSimulations* _simulations;
+};
+
+#endif //USE_REDUCE_DAE
+
+void SimController::runReducedSimulations(SimSettings simsettings, string modelKey, double timeout, IReducedSimulations* simulations, unsigned int numThreads)
+{
+#ifdef USE_REDUCE_DAE
+    shared_ptr<IMixedSystem> mixedsystem = getSystem(modelKey);
+    size_t dim = simulations->getDimSimulations();
+    size_t i;
+
+    #if !defined(USE_THREAD)
+    numThreads = 1;
+    #endif
+    if (numThreads > dim)
+        numThreads = dim;
+    if (numThreads < 1)
+        numThreads = 1;
+
+    // Every worker gets a copy of the system with its own variables and
+    // history and a configuration of its own, because creating a solver
+    // replaces the solver settings of the configuration. The loaded system
+    // keeps the reference results.
+    vector<shared_ptr<ReducedSimulationWorker> > workers;
+    for (i = 0; i < numThreads; i++)
+    {
+        shared_ptr<Configuration> config(new Configuration(_library_path, _config_path, _modelicasystem_path));
+        shared_ptr<IMixedSystem> system(mixedsystem->clone());
+        workers.push_back(shared_ptr<ReducedSimulationWorker>(new ReducedSimulationWorker(config, system, simsettings, timeout, simulations)));
+    }
+
+    #if defined(USE_THREAD)
+    if (numThreads > 1)
+    {
+        atomic<size_t> next(0);
+        vector<shared_ptr<thread> > threads;
+        for (i = 1; i < numThreads; i++)
+            threads.push_back(shared_ptr<thread>(new thread(SimulationThread<ReducedSimulationWorker>(workers[i].get(), &next, dim))));
+        SimulationThread<ReducedSimulationWorker>(workers[0].get(), &next, dim)();
+        for (i = 0; i < threads.size(); i++)
+            threads[i]->join();
+        return;
+    }
+    #endif
+    for (i = 0; i < dim; i++)
+        workers[0]->run(i);
+#else
+    throw ModelicaSimulationError(SIMMANAGER,"The reduction algorithm is no supported for used compiler");
+#endif
+}
 void SimController::Start(SimSettings simsettings, string modelKey)
 {
     try
@@ -158,6 +450,8 @@ void SimController::Start(SimSettings simsettings, string modelKey)
         global_settings->setAlarmTime(simsettings.timeOut);
         global_settings->setOutputPointType(simsettings.outputPointType);
         global_settings->setOutputFormat(simsettings.outputFormat);
+        global_settings->setHistorySettings(simsettings.historySettings);
+        global_settings->setPararealSettings(simsettings.pararealSettings);
         global_settings->setEmitResults(simsettings.emitResults);
         global_settings->setNonLinearSolverContinueOnError(simsettings.nonLinearSolverContinueOnError);
         global_settings->setSolverThreads(simsettings.solverThreads);
@@ -194,7 +488,7 @@ void SimController::Start(SimSettings simsettings, string modelKey)
 
         _simMgr->runSimulation();
 
-		if(global_settings->getOutputFormat() == BUFFER)
+		if(global_settings->getOutputFormat() == BUFFER || global_settings->getOutputFormat() == CHUNKED)
 		{
 			shared_ptr<IWriteOutput> writeoutput_system = dynamic_pointer_cast<IWriteOutput>(mixedsystem);
 
@@ -259,6 +553,8 @@ void SimController::StartReduceDAE(SimSettings simsettings,string modelPath, str
         // global_settings->setAlarmTime(2);
         global_settings->setOutputPointType(simsettings.outputPointType);
         global_settings->setOutputFormat(simsettings.outputFormat);
+        global_settings->setHistorySettings(simsettings.historySettings);
+        global_settings->setPararealSettings(simsettings.pararealSettings);
         global_settings->setEmitResults(simsettings.emitResults);
         global_settings->setNonLinearSolverContinueOnError(simsettings.nonLinearSolverContinueOnError);
         global_settings->setSolverThreads(simsettings.solverThreads);
@@ -468,6 +764,8 @@ void SimController::initialize(SimSettings simsettings, string modelKey, double
         global_settings->setAlarmTime(timeout);
         global_settings->setOutputPointType(simsettings.outputPointType);
         global_settings->setOutputFormat(simsettings.outputFormat);
+        global_settings->setHistorySettings(simsettings.historySettings);
+        global_settings->setPararealSettings(simsettings.pararealSettings);
         global_settings->setEmitResults(simsettings.emitResults);
         global_settings->setNonLinearSolverContinueOnError(simsettings.nonLinearSolverContinueOnError);
         global_settings->setSolverThreads(simsettings.solverThreads);
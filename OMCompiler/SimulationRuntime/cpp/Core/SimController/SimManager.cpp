@@ -9,6 +9,178 @@
 #include <Core/SimController/SimManager.h>
 
 #include <sstream>
+#include <ctime>
+
+/**
+ * Integrates the continuous states of a clone of the simulated system for the
+ * Parareal integration of SimManager. The propagator has a configuration of
+ * its own, so that its solver writes no results. The time events of the
+ * simulated system are handled by the clone as well, which keeps its discrete
+ * variables in line.
+ */
+class PararealPropagator
+{
+public:
+    PararealPropagator(shared_ptr<Configuration> config, ISolverSettings* solver_settings)
+        : _config(config)
+        , _solver_settings(solver_settings)
+        , _startTime(0.0)
+        , _times(NULL)
+        , _dimTimes(0)
+    {
+    }
+
+    /// takes an initialized clone of the system at the start time
+    void setSystem(IMixedSystem* system, double time)
+    {
+        _system = shared_ptr<IMixedSystem>(system->clone());
+        _cont_system = dynamic_pointer_cast<IContinuous>(_system);
+        _time_system = dynamic_pointer_cast<ITime>(_system);
+        _event_system = dynamic_pointer_cast<IEvent>(_system);
+        shared_ptr<ISystemInitialization> init_system = dynamic_pointer_cast<ISystemInitialization>(_system);
+        init_system->setInitial(true);
+        init_system->initialize();
+        _event_system->saveAll();
+        init_system->setInitial(false);
+        _time_system->initTimeEventData();
+        _solver = _config->createSelectedSolver(_system.get());
+
+        ISolverSettings* solver_settings = _config->getSolverSettings();
+        solver_settings->setLowerLimit(_solver_settings->getLowerLimit());
+        solver_settings->sethInit(_solver_settings->gethInit());
+        solver_settings->setUpperLimit(_solver_settings->getUpperLimit());
+        solver_settings->setRTol(_solver_settings->getRTol());
+        solver_settings->setATol(_solver_settings->getATol());
+
+        _solver->setStartTime(time);
+        _solver->setEndTime(time);
+        _solver->solve(ISolver::SOLVERCALL(ISolver::FIRST_CALL | ISolver::RECORDCALL));
+    }
+
+    /// handles the events at time as the simulated system did with the states x
+    void handleSystemEvents(double time, const double* x, bool* events, bool time_events)
+    {
+        _time_system->setTime(time);
+        _cont_system->setContinuousStates(x);
+        if (time_events)
+        {
+            _time_system->computeNextTimeEvents(time);
+            _time_system->computeTimeEventConditions(time);
+        }
+        _system->handleSystemEvents(events);
+        if (time_events)
+            _time_system->resetTimeConditions();
+        _cont_system->evaluateAll(IContinuous::CONTINUOUS);
+        _event_system->saveAll();
+    }
+
+    /// integrates the states x0 from start_time to end_time, the result is stored in x1
+    void propagate(double start_time, double end_time, const double* x0, double* x1)
+    {
+        setStates(start_time, x0);
+        solve(start_time, end_time);
+        _cont_system->getContinuousStates(x1);
+    }
+
+    /// sets the slice integrated by run, the states are kept at all times of the slice
+    void setSlice(double start_time, const std::vector<double>& start_states, const double* times, size_t dim_times)
+    {
+        _startTime = start_time;
+        _startStates = start_states;
+        _times = times;
+        _dimTimes = dim_times;
+    }
+
+    void run()
+    {
+        try
+        {
+            size_t dimStates = _startStates.size();
+            double time = _startTime;
+            _error.clear();
+            _states.resize(_dimTimes * dimStates);
+            setStates(_startTime, &_startStates[0]);
+            for (size_t i = 0; i < _dimTimes; i++)
+            {
+                solve(time, _times[i]);
+                time = _times[i];
+                _cont_system->getContinuousStates(&_states[i * dimStates]);
+            }
+        }
+        catch (std::exception& ex)
+        {
+            _error = ex.what();
+        }
+    }
+
+    const double* getStates(size_t i) const
+    {
+        return &_states[i * _startStates.size()];
+    }
+
+    const double* getEndStates() const
+    {
+        return getStates(_dimTimes - 1);
+    }
+
+    const string& getError() const
+    {
+        return _error;
+    }
+
+private:
+    void setStates(double time, const double* x)
+    {
+        _time_system->setTime(time);
+        _cont_system->setContinuousStates(x);
+        _cont_system->evaluateAll(IContinuous::CONTINUOUS);
+    }
+
+    void solve(double start_time, double end_time)
+    {
+        // the solver reads the states of the system again on a recall
+        _solver->setStartTime(start_time);
+        _solver->setEndTime(end_time);
+        _solver->setInitStepSize(_config->getGlobalSettings()->gethOutput());
+        _solver->solve(ISolver::RECALL);
+        if (_solver->getSolverStatus() & ISolver::SOLVERERROR)
+            throw ModelicaSimulationError(SOLVER, "Parareal propagation failed at t = " + to_string(start_time));
+    }
+
+    shared_ptr<Configuration> _config;
+    ISolverSettings* _solver_settings;
+    shared_ptr<IMixedSystem> _system;
+    shared_ptr<IContinuous> _cont_system;
+    shared_ptr<ITime> _time_system;
+    shared_ptr<IEvent> _event_system;
+    shared_ptr<ISolver> _solver;
+    double _startTime;
+    std::vector<double> _startStates;
+    const double* _times;
+    size_t _dimTimes;
+    std::vector<double> _states;
+    string _error;
+};
+
+#if defined(USE_THREAD)
+/// Thread function running the fine propagation of one Parareal slice
+class PararealThread
+{
+public:
+    PararealThread(PararealPropagator* propagator)
+        : _propagator(propagator)
+    {
+    }
+
+    void operator()()
+    {
+        _propagator->run();
+    }
+
+private:
+    PararealPropagator* _propagator;
+};
+#endif //USE_THREAD
 
 SimManager::SimManager(shared_ptr<IMixedSystem> system, Configuration* config)
   : _mixed_system      (system)
@@ -30,6 +202,9 @@ SimManager::SimManager(shared_ptr<IMixedSystem> system, Configuration* config)
   , _continueSimulation(false)
   , _writeFinalState   (false)
   ,_checkTimeout(false)
+  , _pararealIterations(0)
+  , _interrupt(false)
+  , _pararealStartTime(0)
 {
     _solver = _config->createSelectedSolver(system.get());
     _initialization = shared_ptr<Initialization>(new Initialization(dynamic_pointer_cast<ISystemInitialization>(_mixed_system), _solver));
@@ -90,6 +265,7 @@ void SimManager::initialize()
     }
     #endif
 
+    _interrupt = false;
     _cont_system = dynamic_pointer_cast<IContinuous>(_mixed_system);
     _timeevent_system = dynamic_pointer_cast<ITime>(_mixed_system);
     _event_system = dynamic_pointer_cast<IEvent>(_mixed_system);
@@ -273,16 +449,22 @@ void SimManager::runSimulation()
         MEASURETIME_START(runSimStartValues, runSimHandler, "runSimulation");
     }
     #endif
+    bool parareal = usePararealProcess();
     try
     {
         LOGGER_WRITE("SimManager: Start simulation at t = " + to_string(_tStart), LC_SOLVER, LL_INFO);
-        runSingleProcess();
-        // Measure time; Output SimInfos
-        ISolver::SOLVERSTATUS status = _solver->getSolverStatus();
-        if ((status & ISolver::DONE) || (status & ISolver::USER_STOP))
+        if (parareal)
+            runPararealProcess();
+        else
         {
-            //LOGGER_WRITE("SimManager: Simulation done at t = " + to_string(_tEnd), LC_SOLVER, LL_INFO);
-            writeProperties();
+            runSingleProcess();
+            // Measure time; Output SimInfos
+            ISolver::SOLVERSTATUS status = _solver->getSolverStatus();
+            if ((status & ISolver::DONE) || (status & ISolver::USER_STOP))
+            {
+                //LOGGER_WRITE("SimManager: Simulation done at t = " + to_string(_tEnd), LC_SOLVER, LL_INFO);
+                writeProperties();
+            }
         }
     }
     catch (std::exception & ex)
@@ -290,7 +472,9 @@ void SimManager::runSimulation()
         LOGGER_WRITE("SimManager: Simulation stopped with errors before t = " +
                      to_string(_tEnd), LC_SOLVER, LL_ERROR);
         LOGGER_WRITE("SimManager: " + string(ex.what()), LC_SOLVER, LL_ERROR);
-        writeProperties();
+        // the solver of the simulation manager is not used by the Parareal integration
+        if (!parareal)
+            writeProperties();
         // rethrow with suppress depending on logger setting to not appear twice
         throw ModelicaSimulationError(SIMMANAGER, "Simulation stopped with errors before t = " + to_string(_tEnd),
                                       string(ex.what()), LOGGER_IS_SET(LC_SOLVER, LL_ERROR));
@@ -305,6 +489,8 @@ void SimManager::runSimulation()
 
 void SimManager::stopSimulation()
 {
+    // the Parareal integration does not use the solver of the simulation manager
+    _interrupt = true;
     if (_solver)
         _solver->stop();
 }
@@ -630,4 +816,278 @@ void SimManager::runSingleProcess()
     if (zeroVal_new)
         delete[] zeroVal_new;
 }  // end singleprocess
+
+bool SimManager::usePararealProcess()
+{
+    shared_ptr<IGlobalSettings> global_settings = _config->getGlobalSettings();
+    if (global_settings->getPararealSettings().slices < 2)
+        return false;
+
+    // the slices are integrated from states only, without state events and state changes
+    shared_ptr<IStateSelection> state_selection = dynamic_pointer_cast<IStateSelection>(_mixed_system);
+    string reason;
+    if (_cont_system->getDimContinuousStates() == 0)
+        reason = "the model has no continuous states";
+    else if (_dimZeroFunc > 0)
+        reason = "the model has state events";
+    else if (state_selection && state_selection->getDimStateSets() > 0)
+        reason = "the model has dynamic state selection";
+    else if (global_settings->useEndlessSim())
+        reason = "endless simulation is not supported";
+    else if (!(global_settings->gethOutput() > 0.0))
+        reason = "no output step size is set";
+    if (!reason.empty())
+    {
+        LOGGER_WRITE("SimManager: Parareal integration is not used, " + reason, LC_SOLVER, LL_WARNING);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Checks if the Parareal integration has to stop, because stopSimulation was called
+ * or the alarm time is exceeded. The alarm time is checked if the timeout check is
+ * enabled, as for the solver of runSingleProcess.
+ */
+bool SimManager::isPararealInterrupted()
+{
+    unsigned int alarmTime = _config->getGlobalSettings()->getAlarmTime();
+    if (_checkTimeout && alarmTime > 0 && difftime(time(NULL), _pararealStartTime) >= alarmTime)
+        _interrupt = true;
+    return _interrupt;
+}
+
+shared_ptr<PararealPropagator> SimManager::createPararealPropagator(string solver_name)
+{
+    shared_ptr<Configuration> config = _config->createConfiguration();
+    config->getGlobalSettings()->setSelectedSolver(solver_name);
+    config->getGlobalSettings()->setOutputPointType(OPT_NONE);
+    shared_ptr<PararealPropagator> propagator(new PararealPropagator(config, _config->getSolverSettings()));
+    propagator->setSystem(_mixed_system.get(), _tStart);
+    return propagator;
+}
+
+void SimManager::handlePararealEvents(double time, std::vector<double>& states, std::vector<shared_ptr<PararealPropagator> >& fine_propagators,
+                                      shared_ptr<PararealPropagator> coarse_propagator)
+{
+    for (size_t n = 0; n < fine_propagators.size(); n++)
+        fine_propagators[n]->handleSystemEvents(time, &states[0], _events, _dimtimeevent > 0);
+    coarse_propagator->handleSystemEvents(time, &states[0], _events, _dimtimeevent > 0);
+}
+
+void SimManager::runPararealSlices(std::vector<shared_ptr<PararealPropagator> >& propagators, size_t first, size_t last)
+{
+    size_t n;
+    #if defined(USE_THREAD)
+    vector<shared_ptr<thread> > threads;
+    for (n = first + 1; n < last; n++)
+        threads.push_back(shared_ptr<thread>(new thread(PararealThread(propagators[n].get()))));
+    propagators[first]->run();
+    for (n = 0; n < threads.size(); n++)
+        threads[n]->join();
+    #else
+    for (n = first; n < last; n++)
+        propagators[n]->run();
+    #endif
+    for (n = first; n < last; n++)
+    {
+        if (!propagators[n]->getError().empty())
+            throw ModelicaSimulationError(SIMMANAGER, "Parareal integration failed: " + propagators[n]->getError());
+    }
+}
+
+/**
+ * Parallel-in-time integration of the time span with the Parareal method.
+ * The span is split into event-free intervals at the time events, which are
+ * handled by the simulated system as in runSingleProcess. Every interval is
+ * split into slices ending at output points. A stop request or the alarm time
+ * end the integration at the start of the running interval.
+ */
+void SimManager::runPararealProcess()
+{
+    shared_ptr<IGlobalSettings> global_settings = _config->getGlobalSettings();
+    PararealSettings settings = global_settings->getPararealSettings();
+    shared_ptr<IWriteOutput> writeoutput_system = dynamic_pointer_cast<IWriteOutput>(_mixed_system);
+    OutputPointType outputPointType = global_settings->getOutputPointType();
+    double startTime, endTime, closestTimeEvent;
+
+    if (!writeoutput_system)
+        throw ModelicaSimulationError(SIMMANAGER, "Modelica system is not of type IWriteOutput");
+
+    LOGGER_WRITE("SimManager: Run Parareal process with " + to_string(settings.slices) + " time slices", LC_SOLVER, LL_DEBUG);
+    _pararealStartTime = time(NULL);
+
+    // a fine propagator of its own for every slice, the coarse one predicts the slice start states
+    std::vector<shared_ptr<PararealPropagator> > fine_propagators;
+    for (unsigned int i = 0; i < settings.slices; i++)
+        fine_propagators.push_back(createPararealPropagator(global_settings->getSelectedSolver()));
+    shared_ptr<PararealPropagator> coarse_propagator = createPararealPropagator(settings.coarseSolver);
+    std::vector<double> states(_cont_system->getDimContinuousStates());
+
+    //get information about time events
+    _timeevent_system->initTimeEventData();
+    closestTimeEvent = _timeevent_system->computeNextTimeEvents(_tStart);
+    memset(_timeEventCounter, 0, _dimtimeevent * sizeof(int));
+    _timeevent_system->setTime(_tStart);
+    _cont_system->getContinuousStates(&states[0]);
+    if (_dimtimeevent)
+        _timeevent_system->computeTimeEventConditions(_tStart);
+    _mixed_system->handleSystemEvents(_events);
+    if (_dimtimeevent)
+        _timeevent_system->resetTimeConditions();
+    handlePararealEvents(_tStart, states, fine_propagators, coarse_propagator);
+
+    if (outputPointType != OPT_NONE)
+    {
+        writeoutput_system->writeOutput(IWriteOutput::HEAD_LINE);
+        writeoutput_system->writeOutput(IWriteOutput::WRITEOUT);
+    }
+
+    _pararealIterations = 0;
+    startTime = endTime = _tStart;
+    while (_tEnd - startTime > _config->getSimControllerSettings()->dTendTol)
+    {
+        endTime = (_dimtimeevent && closestTimeEvent > startTime) ? std::min(closestTimeEvent, _tEnd) : _tEnd;
+        if (!runPararealInterval(startTime, endTime, fine_propagators, coarse_propagator, writeoutput_system))
+        {
+            LOGGER_WRITE("SimManager: Parareal integration stopped at t = " + to_string(startTime), LC_SOLVER, LL_INFO);
+            endTime = startTime;
+            break;
+        }
+        startTime = endTime;
+        if (_dimtimeevent && closestTimeEvent <= endTime)
+        {
+            // Find all time events at the current time and compute next one
+            _cont_system->getContinuousStates(&states[0]);
+            closestTimeEvent = _timeevent_system->computeNextTimeEvents(startTime);
+            _timeevent_system->computeTimeEventConditions(startTime);
+            _mixed_system->handleSystemEvents(_events);
+            _timeevent_system->resetTimeConditions();
+            _cont_system->evaluateAll(IContinuous::CONTINUOUS);
+            _event_system->saveAll();
+            handlePararealEvents(startTime, states, fine_propagators, coarse_propagator);
+            if (outputPointType == OPT_ALL)
+                writeoutput_system->writeOutput(IWriteOutput::WRITEOUT);
+        }
+    }
+
+    _step_event_system->setTerminal(true);
+    _cont_system->evaluateAll(IContinuous::CONTINUOUS);
+    LOGGER_WRITE("SimManager: Parareal integration finished after " + to_string(_pararealIterations) + " iterations", LC_SOLVER, LL_INFO);
+    LOGGER_STATUS("Finished", endTime, 0.0);
+}
+
+bool SimManager::runPararealInterval(double startTime, double endTime, std::vector<shared_ptr<PararealPropagator> >& fine_propagators,
+                                     shared_ptr<PararealPropagator> coarse_propagator, shared_ptr<IWriteOutput> writeoutput_system)
+{
+    shared_ptr<IGlobalSettings> global_settings = _config->getGlobalSettings();
+    PararealSettings settings = global_settings->getPararealSettings();
+    OutputPointType outputPointType = global_settings->getOutputPointType();
+    double h = global_settings->gethOutput();
+    double tol = _config->getSimControllerSettings()->dTendTol;
+    size_t dimStates = _cont_system->getDimContinuousStates();
+    size_t i, n, first;
+
+    if (isPararealInterrupted())
+        return false;
+
+    // output times of the interval, followed by its end time
+    std::vector<double> times;
+    double k = ceil((startTime - _tStart) / h);
+    while (_tStart + k * h <= startTime + tol)
+        k++;
+    for (; _tStart + k * h < endTime - tol; k++)
+        times.push_back(_tStart + k * h);
+    times.push_back(endTime);
+    size_t dimTimes = times.size();
+
+    // the slices end at output times, slice n at times[last[n]]
+    size_t dimSlices = std::min((size_t)settings.slices, dimTimes);
+    std::vector<size_t> last(dimSlices);
+    std::vector<double> sliceTimes(dimSlices + 1);
+    sliceTimes[0] = startTime;
+    for (n = 0; n < dimSlices; n++)
+    {
+        last[n] = (n + 1) * dimTimes / dimSlices - 1;
+        sliceTimes[n + 1] = times[last[n]];
+    }
+
+    // start states of the slices
+    std::vector<std::vector<double> > U(dimSlices + 1, std::vector<double>(dimStates));
+    _cont_system->getContinuousStates(&U[0][0]);
+
+    if (dimSlices > 1)
+    {
+        // coarse prediction G of the slice end states
+        std::vector<std::vector<double> > G(dimSlices, std::vector<double>(dimStates));
+        std::vector<double> G_new(dimStates);
+        for (n = 0; n < dimSlices; n++)
+        {
+            coarse_propagator->propagate(sliceTimes[n], sliceTimes[n + 1], &U[n][0], &G[n][0]);
+            U[n + 1] = G[n];
+        }
+
+        // after iteration j the start states of the slices up to j + 1 are exact
+        bool converged = false;
+        unsigned int j;
+        for (j = 0; j + 1 < dimSlices && j < settings.maxIterations && !converged && !isPararealInterrupted(); j++)
+        {
+            for (n = j; n < dimSlices; n++)
+                fine_propagators[n]->setSlice(sliceTimes[n], U[n], &sliceTimes[n + 1], 1);
+            runPararealSlices(fine_propagators, j, dimSlices);
+
+            // sequential correction U[n + 1] = G(U_new[n]) + F(U[n]) - G(U[n])
+            double mismatch = 0.0;
+            for (n = j; n < dimSlices; n++)
+            {
+                const double* F = fine_propagators[n]->getEndStates();
+                if (n > j)
+                    coarse_propagator->propagate(sliceTimes[n], sliceTimes[n + 1], &U[n][0], &G_new[0]);
+                for (i = 0; i < dimStates; i++)
+                {
+                    double u = (n > j) ? G_new[i] + F[i] - G[n][i] : F[i];
+                    mismatch = std::max(mismatch, fabs(u - U[n + 1][i]) / std::max(1.0, fabs(u)));
+                    U[n + 1][i] = u;
+                }
+                if (n > j)
+                    G[n] = G_new;
+            }
+            converged = mismatch <= settings.tolerance;
+        }
+        _pararealIterations += j;
+        if (isPararealInterrupted())
+            return false;
+        if (!converged && j + 1 < dimSlices)
+            LOGGER_WRITE("SimManager: Parareal iteration did not converge in " + to_string(j) + " iterations after t = " + to_string(startTime), LC_SOLVER, LL_WARNING);
+        else
+            LOGGER_WRITE("SimManager: Parareal iteration of " + to_string(dimSlices) + " slices after t = " + to_string(startTime) + " converged in " + to_string(j) + " iterations", LC_SOLVER, LL_DEBUG);
+    }
+
+    // fine integration of all slices from their start states, keeping the states of the output times
+    first = 0;
+    for (n = 0; n < dimSlices; n++)
+    {
+        fine_propagators[n]->setSlice(sliceTimes[n], U[n], &times[first], last[n] - first + 1);
+        first = last[n] + 1;
+    }
+    runPararealSlices(fine_propagators, 0, dimSlices);
+
+    // the end time of the interval is an output point if it is on the output grid or at the end of the simulation
+    bool writeEndTime = (outputPointType == OPT_ALL) || (endTime >= _tEnd - tol)
+                        || (fabs(endTime - _tStart - floor((endTime - _tStart) / h + 0.5) * h) <= tol);
+    first = 0;
+    for (n = 0; n < dimSlices; n++)
+    {
+        for (i = first; i <= last[n]; i++)
+        {
+            _timeevent_system->setTime(times[i]);
+            _cont_system->setContinuousStates(fine_propagators[n]->getStates(i - first));
+            _cont_system->evaluateAll(IContinuous::CONTINUOUS);
+            if (outputPointType != OPT_NONE && (i + 1 < dimTimes || writeEndTime))
+                writeoutput_system->writeOutput(IWriteOutput::WRITEOUT);
+        }
+        first = last[n] + 1;
+    }
+    return true;
+}
 /** @} */ // end of coreSimcontroller
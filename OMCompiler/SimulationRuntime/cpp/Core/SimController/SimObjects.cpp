@@ -134,6 +134,10 @@ shared_ptr<IAlgLoopSolverFactory> SimObjects::getAlgLoopSolverFactory()
     {
         _write_output = createBufferReaderWriter(_globalSettings,dim);
     }
+    else if( _globalSettings->getOutputFormat()  == CHUNKED)
+    {
+        _write_output = createChunkedBufferWriter(_globalSettings,dim);
+    }
     else if( _globalSettings->getOutputFormat()  == EMPTY)
     {
         _write_output = createDefaultWriter(_globalSettings,dim);
@@ -221,6 +221,16 @@ int GlobalSettings::getSolverThreads()
   return _solverThreads;
 }
 
+void GlobalSettings::setStartValues(const std::map<string, double>& start_values)
+{
+  _start_values = start_values;
+}
+
+const std::map<string, double>& GlobalSettings::getStartValues()
+{
+  return _start_values;
+}
+
  OutputFormat GlobalSettings::getOutputFormat()
  {
      return _outputFormat;
@@ -229,4 +239,24 @@ int GlobalSettings::getSolverThreads()
   {
       _outputFormat = outputFormat;
   }
+
+HistorySettings GlobalSettings::getHistorySettings()
+{
+  return _history_settings;
+}
+
+void GlobalSettings::setHistorySettings(HistorySettings set)
+{
+  _history_settings = set;
+}
+
+PararealSettings GlobalSettings::getPararealSettings()
+{
+  return _parareal_settings;
+}
+
+void GlobalSettings::setPararealSettings(PararealSettings set)
+{
+  _parareal_settings = set;
+}
 /** @} */ // end of coreSimulationSettings
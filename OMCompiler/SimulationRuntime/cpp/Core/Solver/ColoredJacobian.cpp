@@ -0,0 +1,228 @@
+/** @addtogroup coreSolver
+ *
+ *  @{
+ */
+#include <Core/ModelicaDefine.h>
+#include <Core/Modelica.h>
+#include <Core/Solver/FactoryExport.h>
+#include <Core/Solver/ColoredJacobian.h>
+#include <Core/System/FactoryExport.h>
+#include <Core/Utils/extension/logger.hpp>
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+ColoredJacobian::ColoredJacobian(IMixedSystem* system, int numThreads)
+  : _system(system)
+  , _numThreads(numThreads)
+  , _dimSys(0)
+  , _events(NULL)
+{
+#ifndef USE_OPENMP
+  //the column groups are evaluated one after another on the system
+  _numThreads = 1;
+#endif
+  if (_numThreads < 1)
+    _numThreads = 1;
+}
+
+ColoredJacobian::~ColoredJacobian()
+{
+  for (size_t i = 1; i < _mixed_systems.size(); i++)
+    delete _mixed_systems[i];
+  if (_events)
+    delete[] _events;
+}
+
+void ColoredJacobian::initialize()
+{
+  for (size_t i = 1; i < _mixed_systems.size(); i++)
+    delete _mixed_systems[i];
+  _mixed_systems.assign(1, _system);
+  _continuous_systems.assign(1, dynamic_cast<IContinuous*>(_system));
+  _time_systems.assign(1, dynamic_cast<ITime*>(_system));
+  _event_systems.assign(1, dynamic_cast<IEvent*>(_system));
+  _state_selections.assign(1, dynamic_cast<IStateSelection*>(_system));
+  _dimSys = (size_t)_continuous_systems[0]->getDimContinuousStates();
+
+  for (int i = 1; i < _numThreads; i++)
+  {
+    IMixedSystem* clonedSystem = _system->clone();
+    _mixed_systems.push_back(clonedSystem);
+    _continuous_systems.push_back(dynamic_cast<IContinuous*>(clonedSystem));
+    _time_systems.push_back(dynamic_cast<ITime*>(clonedSystem));
+    _event_systems.push_back(dynamic_cast<IEvent*>(clonedSystem));
+    _state_selections.push_back(dynamic_cast<IStateSelection*>(clonedSystem));
+    ISystemInitialization* initSystem = dynamic_cast<ISystemInitialization*>(clonedSystem);
+    initSystem->setInitial(true);
+    initSystem->initialize();
+    _event_systems[i]->saveAll();
+    initSystem->setInitial(false);
+    _time_systems[i]->initTimeEventData();
+  }
+
+  _y.assign(_numThreads, vector<double>(_dimSys));
+  _f.assign(_numThreads, vector<double>(_dimSys));
+  _zeroVal.resize(_event_systems[0]->getDimZeroFunc());
+  if (_events)
+    delete[] _events;
+  _events = new bool[_zeroVal.size() + 1];
+
+  initializeGroups();
+}
+
+void ColoredJacobian::initializeGroups()
+{
+  _groups.clear();
+  _columnPointers.clear();
+  _rowIndices.clear();
+
+  //the colors only separate the columns if the sparsity pattern is known
+  int maxColors = _system->getAMaxColors();
+  if (maxColors > 0 && maxColors < (int)_dimSys && _system->isJacobianSparse())
+  {
+    try
+    {
+      const sparsematrix_t& jacobian = _system->getSparseJacobian();
+      if ((size_t)jacobian.size1() == _dimSys && (size_t)jacobian.size2() == _dimSys)
+      {
+        _columnPointers.assign(jacobian.index1_data().begin(), jacobian.index1_data().begin() + jacobian.filled1());
+        _rowIndices.assign(jacobian.index2_data().begin(), jacobian.index2_data().begin() + jacobian.filled2());
+        _columnPointers.resize(_dimSys + 1, (int)jacobian.filled2());
+        vector<int> colorOfColumn(_dimSys);
+        _system->getAColorOfColumn(&colorOfColumn[0], (int)_dimSys);
+        _groups.resize(maxColors);
+        size_t k;
+        for (k = 0; k < _dimSys && colorOfColumn[k] >= 1 && colorOfColumn[k] <= maxColors; k++)
+          _groups[colorOfColumn[k] - 1].push_back(k);
+        if (k == _dimSys)
+          return;
+      }
+    }
+    catch (std::exception& ex)
+    {
+      LOGGER_WRITE(string("ColoredJacobian: sparsity pattern not available, ") + ex.what(), LC_SOLVER, LL_DEBUG);
+    }
+    _groups.clear();
+    _columnPointers.clear();
+    _rowIndices.clear();
+  }
+
+  //one column per group
+  _groups.resize(_dimSys);
+  for (size_t k = 0; k < _dimSys; k++)
+    _groups[k].push_back(k);
+}
+
+bool ColoredJacobian::isEfficient() const
+{
+  return _dimSys > 0 && (_groups.size() < _dimSys || _numThreads > 1);
+}
+
+void ColoredJacobian::synchronize(double time, const double* y, bool time_events)
+{
+  if (_numThreads < 2)
+    return;
+
+  //the clones replay the events of the system, like the event handling of the simulation
+  _event_systems[0]->getZeroFunc(_zeroVal.empty() ? NULL : &_zeroVal[0]);
+  for (size_t i = 0; i < _zeroVal.size(); i++)
+    _events[i] = bool(_zeroVal[i]);
+
+  DynArrayDim2<int> matrix;
+  vector<double> states;
+  for (int n = 1; n < _numThreads; n++)
+  {
+    for (int j = 0; j < _state_selections[0]->getDimStateSets(); j++)
+    {
+      states.resize(_state_selections[0]->getDimStates(j));
+      _state_selections[0]->getAMatrix(j, matrix);
+      _state_selections[0]->getStates(j, states.empty() ? NULL : &states[0]);
+      _state_selections[n]->setAMatrix(j, matrix);
+      _state_selections[n]->setStates(j, states.empty() ? NULL : &states[0]);
+    }
+    _time_systems[n]->setTime(time);
+    _continuous_systems[n]->setContinuousStates(y);
+    if (time_events)
+    {
+      _time_systems[n]->computeNextTimeEvents(time);
+      _time_systems[n]->computeTimeEventConditions(time);
+    }
+    _mixed_systems[n]->handleSystemEvents(_events);
+    if (time_events)
+      _time_systems[n]->resetTimeConditions();
+    _continuous_systems[n]->evaluateAll(IContinuous::CONTINUOUS);
+    _event_systems[n]->saveAll();
+  }
+}
+
+void ColoredJacobian::calcJacobian(double time, const double* y, const double* f, const double* delta, double* jac)
+{
+  if (_columnPointers.size())
+    std::fill(jac, jac + _dimSys * _dimSys, 0.0);
+
+  int numGroups = (int)_groups.size();
+  int failed = 0;
+#ifdef USE_OPENMP
+  #pragma omp parallel for num_threads(_numThreads) schedule(dynamic)
+#endif
+  for (int g = 0; g < numGroups; g++)
+  {
+#ifdef USE_OPENMP
+    int thread = omp_get_thread_num();
+#else
+    int thread = 0;
+#endif
+    try
+    {
+      evaluateGroup(thread, g, time, y, f, delta, jac);
+    }
+    //exceptions must not leave the parallel region
+    catch (std::exception& ex)
+    {
+#ifdef USE_OPENMP
+      #pragma omp atomic
+#endif
+      failed++;
+    }
+  }
+  if (failed)
+    throw ModelicaSimulationError(SOLVER, "ColoredJacobian::calcJacobian() evaluation of the system failed");
+}
+
+void ColoredJacobian::evaluateGroup(int thread, size_t group, double time, const double* y, const double* f, const double* delta, double* jac)
+{
+  const vector<int>& columns = _groups[group];
+  double* y_thread = &_y[thread][0];
+  double* f_thread = &_f[thread][0];
+
+  std::copy(y, y + _dimSys, y_thread);
+  for (size_t c = 0; c < columns.size(); c++)
+    y_thread[columns[c]] += delta[columns[c]];
+
+  _time_systems[thread]->setTime(time);
+  _continuous_systems[thread]->setContinuousStates(y_thread);
+  _continuous_systems[thread]->evaluateODE(IContinuous::CONTINUOUS);
+  _continuous_systems[thread]->getRHS(f_thread);
+
+  for (size_t c = 0; c < columns.size(); c++)
+  {
+    int k = columns[c];
+    double deltaInv = 1.0 / delta[k];
+    double* column = jac + k * _dimSys;
+    if (_columnPointers.size())
+    {
+      for (int j = _columnPointers[k]; j < _columnPointers[k + 1]; j++)
+      {
+        int l = _rowIndices[j];
+        column[l] = (f_thread[l] - f[l]) * deltaInv;
+      }
+    }
+    else
+    {
+      for (size_t l = 0; l < _dimSys; l++)
+        column[l] = (f_thread[l] - f[l]) * deltaInv;
+    }
+  }
+}
+ /** @} */ // end of coreSolver
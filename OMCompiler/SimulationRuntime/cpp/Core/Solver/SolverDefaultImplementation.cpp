@@ -108,6 +108,20 @@ bool SolverDefaultImplementation::stateSelection()
   return _state_selection->stateSelection(1);
 }
 
+bool SolverDefaultImplementation::initializeColoredJacobian()
+{
+  int numThreads = _settings->getGlobalSettings()->getSolverThreads();
+  _colored_jacobian = shared_ptr<ColoredJacobian>(new ColoredJacobian(_system, numThreads));
+  _colored_jacobian->initialize();
+  if (!_colored_jacobian->isEfficient())
+  {
+    _colored_jacobian.reset();
+    return false;
+  }
+  LOGGER_WRITE("SolverDefaultImplementation: Use colored jacobian of the states", LC_SOLVER, LL_DEBUG);
+  return true;
+}
+
 void SolverDefaultImplementation::initialize()
 {
   SimulationMonitor::initialize();
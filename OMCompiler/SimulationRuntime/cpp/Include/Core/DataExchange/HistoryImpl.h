@@ -24,6 +24,7 @@ public:
     , _globalSettings(globalSettings)
     , _dim(dim)
   {
+    ResultsPolicy::setHistorySettings(globalSettings.getHistorySettings());
   }
 
   virtual ~HistoryImpl()
@@ -98,6 +99,16 @@ public:
     return time;
   }
 
+  virtual bool getOutputColumn(size_t i, HistoryColumn& column)
+  {
+    return ResultsPolicy::getColumn(i, column);
+  }
+
+  virtual bool getTimeColumn(HistoryColumn& column)
+  {
+    return ResultsPolicy::getTimeColumn(column);
+  }
+
  virtual  void clear()
   {
     ResultsPolicy::eraseAll();
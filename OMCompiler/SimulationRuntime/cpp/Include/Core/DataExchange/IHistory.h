@@ -108,6 +108,32 @@ typedef  tuple<var_names_t,var_names_t,var_names_t,var_names_t,var_names_t> all_
 /**typedef for all variable description*/
 typedef  tuple<var_names_t,var_names_t,var_names_t,var_names_t,var_names_t> all_description_t;
 
+/**
+ *  Read only view of the stored results of one output variable or of the time entries.
+ *  The values are kept in chunks of chunkSize consecutive output points, the view
+ *  refers to them without copying and is valid until the history is cleared or re-initialized.
+ */
+struct HistoryColumn
+{
+  /** Pointers to the values of every chunk*/
+  vector<const double*> chunks;
+  /** Number of output points per chunk*/
+  size_t chunkSize;
+  /** Number of output points*/
+  size_t size;
+
+  HistoryColumn()
+    : chunkSize(0)
+    , size(0)
+  {
+  }
+
+  double operator[](size_t k) const
+  {
+    return chunks[k / chunkSize][k % chunkSize];
+  }
+};
+
 
 
 
@@ -138,6 +164,15 @@ public:
   */
   virtual vector<double> getTimeEntries() =0;
   /**
+  Returns a view of the results of output variable i (see getOutputNames) without copying,
+  false if the results are not stored in columns
+  */
+  virtual bool getOutputColumn(size_t i, HistoryColumn& column) = 0;
+  /**
+  Returns a view of the time entries without copying, false if the results are not stored in columns
+  */
+  virtual bool getTimeColumn(HistoryColumn& column) = 0;
+  /**
   Returns numer of all time entries
   */
   virtual unsigned long getSize()=0;
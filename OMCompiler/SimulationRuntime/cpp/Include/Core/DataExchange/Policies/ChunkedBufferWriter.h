@@ -0,0 +1,377 @@
+#pragma once
+/** @addtogroup dataexchangePolicies
+ *
+ *  @{
+ */
+
+#include <Core/DataExchange/FactoryPolicy.h>
+#include <fstream>
+#include <sstream>
+#include <set>
+#include <cstdio>
+#include <boost/algorithm/string/trim.hpp>
+
+#if !defined(__vxworks) && !defined(__TRICORE__)
+  #include <boost/interprocess/file_mapping.hpp>
+  #include <boost/interprocess/mapped_region.hpp>
+  #define USE_MAPPED_HISTORY
+#endif
+
+/**
+ Policy class to store the results of selected output variables in memory.
+ The output points are stored in chunks with one column per variable, so the
+ history hands out column views without copying. Only every n-th output
+ point is kept if a decimation is set, the last written point, e.g. at the end
+ time, is always kept. At events both the values before and after the event
+ are kept as two rows with the same time. Chunks beyond the memory budget are
+ mapped to a file next to the results file.
+*/
+class ChunkedBufferWriter : public ContainerManager
+{
+ public:
+    ChunkedBufferWriter(unsigned long size, string file_name)
+            : ContainerManager(),
+              _file_name(file_name),
+              _size(0),
+              _writes(0),
+              _pending(false),
+              _memory_size(0),
+              _mapped_size(0)
+    {
+    }
+
+    ~ChunkedBufferWriter()
+    {
+        try
+        {
+            eraseAll();
+        }
+        catch(std::exception&)
+        {
+        }
+    }
+
+    virtual void setHistorySettings(const HistorySettings& settings)
+    {
+        _settings = settings;
+        if (_settings.decimation < 1)
+            _settings.decimation = 1;
+        if (_settings.chunkSize < 1)
+            _settings.chunkSize = 1;
+    }
+
+    void init(std::string file_name, size_t dim)
+    {
+        eraseAll();
+        _file_name = file_name;
+    }
+
+    void read(ublas::matrix<double>& R, ublas::matrix<double>& dR)
+    {
+        throw ModelicaSimulationError(DATASTORAGE, "chunked history only stores output variables");
+    }
+
+    void read(ublas::matrix<double>& R, ublas::matrix<double>& dR, ublas::matrix<double>& Re)
+    {
+        throw ModelicaSimulationError(DATASTORAGE, "chunked history only stores output variables");
+    }
+
+    void read(const double& time, ublas::vector<double>& dv, ublas::vector<double>& v)
+    {
+        throw ModelicaSimulationError(DATASTORAGE, "chunked history only stores output variables");
+    }
+
+    /**
+    Copies the results of all stored output variables, Rij i variable index, j time index
+    */
+    void read(ublas::matrix<double>& R)
+    {
+        try
+        {
+            R.resize(_var_outputs.size(), storedSize());
+        }
+        catch(std::exception& ex)
+        {
+            throw ModelicaSimulationError(DATASTORAGE, string("read from chunked history failed alloc R matrix") + ex.what());
+        }
+        HistoryColumn column;
+        for (size_t i = 0; i < _var_outputs.size(); i++)
+        {
+            getColumn(i, column);
+            for (size_t j = 0; j < column.size; j++)
+                R(i, j) = column[j];
+        }
+    }
+
+    virtual bool getColumn(size_t i, HistoryColumn& column)
+    {
+        if (i >= _var_outputs.size())
+            throw ModelicaSimulationError(DATASTORAGE, "output variable index exceeds stored output variables");
+        getColumnView(i + 1, column);
+        return true;
+    }
+
+    virtual bool getTimeColumn(HistoryColumn& column)
+    {
+        getColumnView(0, column);
+        return true;
+    }
+
+    /*writes pramater values to results file
+     @v_list values of parameter
+     @start_time
+     @end_time
+     */
+    virtual void write(const all_vars_t& v_list, double start_time, double end_time)
+    {
+        //not supported for chunked history
+    }
+
+    /*
+     selects the stored output variables by their names
+     @s_list name of variables
+     @s_desc_list description of variables
+     @s_parameter_list name of parameter
+     @s_desc_parameter_list description of parameter
+     */
+    virtual void write(const all_names_t& s_list,const all_description_t& s_desc_list, const all_names_t& s_parameter_list,const all_description_t& s_desc_parameter_list)
+    {
+        eraseAll();
+        _var_outputs.clear();
+        _sources.clear();
+
+        std::set<string> selected;
+        if (!_settings.outputVariables.empty())
+        {
+            std::stringstream names(_settings.outputVariables);
+            string name;
+            while (std::getline(names, name, ','))
+            {
+                boost::algorithm::trim(name);
+                if (!name.empty())
+                    selected.insert(name);
+            }
+        }
+        addSources(get<0>(s_list), REAL_SOURCE, selected);
+        addSources(get<1>(s_list), INT_SOURCE, selected);
+        addSources(get<2>(s_list), BOOL_SOURCE, selected);
+    }
+
+    void write(const char c)
+    {
+    }
+
+    /*
+     stores the selected output variables of a time step
+     @v_list variables and state vars
+     @neg_v_list negate alias flags
+     */
+    virtual void write(const all_vars_time_t& v_list,const neg_all_vars_t& neg_v_list)
+    {
+        double time = get<3>(v_list);
+        size_t stored = storedSize();
+        size_t row;
+        if (stored > 0 && valueAt(0, stored - 1) == time)
+        {
+            //an output point written again at the same time, e.g. at an event: the first row keeps the values
+            //before the event, the second one the values after it, further writes replace the second row
+            if (_pending)
+            {
+                _size++;
+                _pending = false;
+            }
+            if (stored > 1 && valueAt(0, stored - 2) == time)
+                row = stored - 1;
+            else
+            {
+                if (_size == _chunks.size() * _settings.chunkSize)
+                    addChunk();
+                row = _size++;
+            }
+        }
+        else
+        {
+            //a point skipped by the decimation is kept in the row after the stored ones until
+            //the next point replaces it, so the last point of the simulation is never lost
+            if (_size == _chunks.size() * _settings.chunkSize)
+                addChunk();
+            row = _size;
+            _pending = (_writes++) % _settings.decimation != 0;
+            if (!_pending)
+                _size++;
+        }
+
+        WriteOutputVar<double> writeReal;
+        WriteOutputVar<int> writeInt;
+        WriteOutputVar<bool> writeBool;
+        double* chunk = _chunks[row / _settings.chunkSize]->data;
+        size_t k = row % _settings.chunkSize;
+        chunk[k] = time;
+        for (size_t i = 0; i < _sources.size(); i++)
+        {
+            const OutputSource& source = _sources[i];
+            double& value = chunk[(i + 1) * _settings.chunkSize + k];
+            if (source.type == REAL_SOURCE)
+                value = writeReal(get<0>(v_list)[source.index], get<0>(neg_v_list)[source.index]);
+            else if (source.type == INT_SOURCE)
+                value = writeInt(get<1>(v_list)[source.index], get<1>(neg_v_list)[source.index]);
+            else
+                value = writeBool(get<2>(v_list)[source.index], get<2>(neg_v_list)[source.index]);
+        }
+    }
+
+    void getTime(std::vector<double>& time)
+    {
+        size_t stored = storedSize();
+        time.reserve(time.size() + stored);
+        for (size_t j = 0; j < stored; j++)
+            time.push_back(valueAt(0, j));
+    }
+
+    unsigned long size()
+    {
+        return storedSize();
+    }
+
+    void eraseAll()
+    {
+        _chunks.clear();
+        _size = 0;
+        _writes = 0;
+        _pending = false;
+        _memory_size = 0;
+#if defined(USE_MAPPED_HISTORY)
+        if (_mapping)
+        {
+            _mapping.reset();
+            std::remove(_mapped_file_name.c_str());
+        }
+#endif
+        _mapped_size = 0;
+    }
+
+ protected:
+    enum SourceType {REAL_SOURCE, INT_SOURCE, BOOL_SOURCE};
+
+    /// position of a stored output variable in the output lists
+    struct OutputSource
+    {
+        SourceType type;
+        size_t index;
+    };
+
+    /// output points of one chunk, the time entries followed by one column per output variable
+    struct Chunk
+    {
+        vector<double> memory;
+#if defined(USE_MAPPED_HISTORY)
+        shared_ptr<boost::interprocess::mapped_region> region;
+#endif
+        double* data;
+    };
+
+    void addSources(const var_names_t& names, SourceType type, const std::set<string>& selected)
+    {
+        for (size_t i = 0; i < names.size(); i++)
+        {
+            if (!selected.empty() && selected.find(names[i]) == selected.end())
+                continue;
+            OutputSource source = {type, i};
+            _sources.push_back(source);
+            _var_outputs.push_back(names[i]);
+        }
+    }
+
+    /// number of output points including a point skipped by the decimation that is kept as last one
+    size_t storedSize() const
+    {
+        return _size + (_pending ? 1 : 0);
+    }
+
+    double valueAt(size_t column, size_t row) const
+    {
+        return _chunks[row / _settings.chunkSize]->data[column * _settings.chunkSize + row % _settings.chunkSize];
+    }
+
+    void getColumnView(size_t column, HistoryColumn& view) const
+    {
+        view.chunks.resize(_chunks.size());
+        for (size_t c = 0; c < _chunks.size(); c++)
+            view.chunks[c] = _chunks[c]->data + column * _settings.chunkSize;
+        view.chunkSize = _settings.chunkSize;
+        view.size = storedSize();
+    }
+
+    void addChunk()
+    {
+        size_t bytes = (_sources.size() + 1) * _settings.chunkSize * sizeof(double);
+        shared_ptr<Chunk> chunk(new Chunk());
+        try
+        {
+#if defined(USE_MAPPED_HISTORY)
+            if (_settings.memoryBudget > 0 && _memory_size + bytes > _settings.memoryBudget)
+            {
+                addMappedChunk(*chunk, bytes);
+                _chunks.push_back(chunk);
+                return;
+            }
+#endif
+            chunk->memory.resize(bytes / sizeof(double));
+            chunk->data = &chunk->memory[0];
+            _memory_size += bytes;
+        }
+        catch(std::exception& ex)
+        {
+            throw ModelicaSimulationError(DATASTORAGE, string("allocating chunk of history failed ") + ex.what());
+        }
+        _chunks.push_back(chunk);
+    }
+
+#if defined(USE_MAPPED_HISTORY)
+    /// appends a page aligned block to the mapped file and maps it for the chunk
+    void addMappedChunk(Chunk& chunk, size_t bytes)
+    {
+        namespace ipc = boost::interprocess;
+        size_t page_size = ipc::mapped_region::get_page_size();
+        size_t block_size = (bytes + page_size - 1) / page_size * page_size;
+        if (!_mapping)
+        {
+            //a history of its own for every writer, e.g. of parallel simulations of the same model
+            std::ostringstream name;
+            name << _file_name << "." << (size_t)this << ".history";
+            _mapped_file_name = name.str();
+            std::ofstream file(_mapped_file_name.c_str(), std::ios::binary | std::ios::trunc);
+            if (!file)
+                throw ModelicaSimulationError(DATASTORAGE, "Failed to create history file " + _mapped_file_name);
+        }
+        {
+            //grow the file to the end of the new block
+            std::fstream file(_mapped_file_name.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(_mapped_size + block_size - 1);
+            file.put('\0');
+            if (!file)
+                throw ModelicaSimulationError(DATASTORAGE, "Failed to extend history file " + _mapped_file_name);
+        }
+        if (!_mapping)
+            _mapping = shared_ptr<ipc::file_mapping>(new ipc::file_mapping(_mapped_file_name.c_str(), ipc::read_write));
+        chunk.region = shared_ptr<ipc::mapped_region>(new ipc::mapped_region(*_mapping, ipc::read_write, _mapped_size, bytes));
+        chunk.data = static_cast<double*>(chunk.region->get_address());
+        _mapped_size += block_size;
+    }
+
+    shared_ptr<boost::interprocess::file_mapping> _mapping;
+    string _mapped_file_name;
+#endif
+
+    string _file_name;
+    HistorySettings _settings;
+    vector<OutputSource> _sources;
+    vector<shared_ptr<Chunk> > _chunks;
+    size_t _size;
+    size_t _writes;
+    bool _pending;      ///< the row after the stored ones holds the last point skipped by the decimation
+    size_t _memory_size;
+    size_t _mapped_size;
+    vector<string> _var_outputs;
+};
+/** @} */ // end of dataexchangePolicies
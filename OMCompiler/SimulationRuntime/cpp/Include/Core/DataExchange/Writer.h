@@ -55,5 +55,16 @@ public:
 	virtual ~Writer() {}
 
 	virtual void write(const all_vars_time_t& v_list,const neg_all_vars_t& neg_v_list ) = 0;
+
+	/**
+	 * Sets the storage of in-memory histories, not used by the other writers
+	 */
+	virtual void setHistorySettings(const HistorySettings& settings) {}
+
+	/**
+	 * Views of stored results, only supported by writers that keep the results in columns
+	 */
+	virtual bool getColumn(size_t i, HistoryColumn& column) { return false; }
+	virtual bool getTimeColumn(HistoryColumn& column) { return false; }
 };
 /** @} */ // end of dataexchange
@@ -148,6 +148,14 @@ public:
     return _isRefArray;
   }
 
+  /**
+   * Returns false if getData() gives no write access, e.g. for slices
+   */
+  virtual bool hasWritableData() const
+  {
+    return !_isRefArray;
+  }
+
 protected:
   bool _isStatic;
   bool _isRefArray;
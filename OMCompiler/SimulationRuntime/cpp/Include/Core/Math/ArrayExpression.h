@@ -0,0 +1,268 @@
+#pragma once
+/*
+ * Expression templates for element-wise array operations.
+ *
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF THE BSD NEW LICENSE OR THE
+ * GPL VERSION 3 LICENSE OR THE OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the OSMC (Open Source Modelica Consortium)
+ * Public License (OSMC-PL) are obtained from OSMC, either from the above
+ * address, from the URLs: http://www.openmodelica.org or
+ * http://www.ida.liu.se/projects/OpenModelica, and in the OpenModelica
+ * distribution. GNU version 3 is obtained from:
+ * http://www.gnu.org/copyleft/gpl.html. The New BSD License is obtained from:
+ * http://www.opensource.org/licenses/BSD-3-Clause.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE, EXCEPT AS
+ * EXPRESSLY SET FORTH IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE
+ * CONDITIONS OF OSMC-PL.
+ *
+ */
+
+#include "Array.h"
+/** @addtogroup math
+ *   @{
+*/
+
+/**
+ * Expression templates for element-wise array operations.
+ * Nested operations like a .* b + c are collected in one expression object
+ * and evaluated by assign_array_expr in a single loop over contiguous data,
+ * without temporary arrays for the intermediate results.
+ * Note that * and / between two array expressions are element-wise.
+ */
+template <typename T, class E>
+class ArrayExpression {
+ public:
+  typedef T value_type;
+
+  const E& self() const {
+    return static_cast<const E&>(*this);
+  }
+
+  T operator[](size_t i) const {
+    return self()[i];
+  }
+
+  size_t getNumElems() const {
+    return self().getNumElems();
+  }
+
+  std::vector<size_t> getDims() const {
+    return self().getDims();
+  }
+};
+
+/**
+ * Leaf of an expression, reading the data of an array
+ */
+template <typename T>
+class ArrayExpressionRef: public ArrayExpression<T, ArrayExpressionRef<T> > {
+ public:
+  ArrayExpressionRef(const BaseArray<T>& array)
+    : _array(array)
+    , _data(array.getData())
+    , _nelems(array.getNumElems()) {
+  }
+
+  T operator[](size_t i) const {
+    return _data[i];
+  }
+
+  size_t getNumElems() const {
+    return _nelems;
+  }
+
+  std::vector<size_t> getDims() const {
+    return _array.getDims();
+  }
+
+ private:
+  const BaseArray<T>& _array;
+  const T* _data;
+  size_t _nelems;
+};
+
+/**
+ * Element-wise operations
+ */
+struct ArrayExpressionAdd {
+  template <typename T> static T apply(T a, T b) { return a + b; }
+};
+struct ArrayExpressionSub {
+  template <typename T> static T apply(T a, T b) { return a - b; }
+};
+struct ArrayExpressionSubReverse {
+  template <typename T> static T apply(T a, T b) { return b - a; }
+};
+struct ArrayExpressionMul {
+  template <typename T> static T apply(T a, T b) { return a * b; }
+};
+struct ArrayExpressionDiv {
+  template <typename T> static T apply(T a, T b) { return a / b; }
+};
+
+/**
+ * Element-wise operation of two array expressions of the same size
+ */
+template <typename T, class L, class R, class Op>
+class ArrayExpressionBinary: public ArrayExpression<T, ArrayExpressionBinary<T, L, R, Op> > {
+ public:
+  ArrayExpressionBinary(const L& left, const R& right)
+    : _left(left)
+    , _right(right) {
+    if (left.getNumElems() != right.getNumElems())
+      throw ModelicaSimulationError(MODEL_ARRAY_FUNCTION,
+        "Right and left array must have the same size for element wise operations");
+  }
+
+  T operator[](size_t i) const {
+    return Op::apply(_left[i], _right[i]);
+  }
+
+  size_t getNumElems() const {
+    return _left.getNumElems();
+  }
+
+  std::vector<size_t> getDims() const {
+    return _left.getDims();
+  }
+
+ private:
+  // nodes are small and kept by value, leaves refer to the arrays
+  const L _left;
+  const R _right;
+};
+
+/**
+ * Operation of an array expression with a scalar, applied as Op(array, scalar)
+ */
+template <typename T, class E, class Op>
+class ArrayExpressionScalar: public ArrayExpression<T, ArrayExpressionScalar<T, E, Op> > {
+ public:
+  ArrayExpressionScalar(const E& expression, T scalar)
+    : _expression(expression)
+    , _scalar(scalar) {
+  }
+
+  T operator[](size_t i) const {
+    return Op::apply(_expression[i], _scalar);
+  }
+
+  size_t getNumElems() const {
+    return _expression.getNumElems();
+  }
+
+  std::vector<size_t> getDims() const {
+    return _expression.getDims();
+  }
+
+ private:
+  const E _expression;
+  const T _scalar;
+};
+
+/**
+ * Element-wise negation of an array expression
+ */
+template <typename T, class E>
+class ArrayExpressionNegate: public ArrayExpression<T, ArrayExpressionNegate<T, E> > {
+ public:
+  ArrayExpressionNegate(const E& expression)
+    : _expression(expression) {
+  }
+
+  T operator[](size_t i) const {
+    return -_expression[i];
+  }
+
+  size_t getNumElems() const {
+    return _expression.getNumElems();
+  }
+
+  std::vector<size_t> getDims() const {
+    return _expression.getDims();
+  }
+
+ private:
+  const E _expression;
+};
+
+/**
+ * Creates the leaf of an expression for an array
+ */
+template <typename T>
+ArrayExpressionRef<T> array_expr(const BaseArray<T>& array) {
+  return ArrayExpressionRef<T>(array);
+}
+
+#define ARRAY_EXPRESSION_BINARY(op, Op) \
+template <typename T, class L, class R> \
+ArrayExpressionBinary<T, L, R, Op> \
+operator op(const ArrayExpression<T, L>& left, const ArrayExpression<T, R>& right) { \
+  return ArrayExpressionBinary<T, L, R, Op>(left.self(), right.self()); \
+} \
+template <typename T, class E> \
+ArrayExpressionScalar<T, E, Op> \
+operator op(const ArrayExpression<T, E>& left, typename ArrayExpression<T, E>::value_type right) { \
+  return ArrayExpressionScalar<T, E, Op>(left.self(), right); \
+}
+
+ARRAY_EXPRESSION_BINARY(+, ArrayExpressionAdd)
+ARRAY_EXPRESSION_BINARY(-, ArrayExpressionSub)
+ARRAY_EXPRESSION_BINARY(*, ArrayExpressionMul)
+ARRAY_EXPRESSION_BINARY(/, ArrayExpressionDiv)
+#undef ARRAY_EXPRESSION_BINARY
+
+template <typename T, class E>
+ArrayExpressionScalar<T, E, ArrayExpressionAdd>
+operator+(typename ArrayExpression<T, E>::value_type left, const ArrayExpression<T, E>& right) {
+  return ArrayExpressionScalar<T, E, ArrayExpressionAdd>(right.self(), left);
+}
+
+template <typename T, class E>
+ArrayExpressionScalar<T, E, ArrayExpressionSubReverse>
+operator-(typename ArrayExpression<T, E>::value_type left, const ArrayExpression<T, E>& right) {
+  return ArrayExpressionScalar<T, E, ArrayExpressionSubReverse>(right.self(), left);
+}
+
+template <typename T, class E>
+ArrayExpressionScalar<T, E, ArrayExpressionMul>
+operator*(typename ArrayExpression<T, E>::value_type left, const ArrayExpression<T, E>& right) {
+  return ArrayExpressionScalar<T, E, ArrayExpressionMul>(right.self(), left);
+}
+
+template <typename T, class E>
+ArrayExpressionNegate<T, E>
+operator-(const ArrayExpression<T, E>& expression) {
+  return ArrayExpressionNegate<T, E>(expression.self());
+}
+
+/**
+ * Evaluates an expression into an array with own contiguous storage
+ * (StatArray or DynArray), resizing it if needed
+ */
+template <typename T, class E>
+void assign_array_expr(BaseArray<T>& array, const ArrayExpression<T, E>& expression)
+{
+  const E& e = expression.self();
+  size_t nelems = e.getNumElems();
+  if (array.getNumElems() != nelems)
+    array.setDims(e.getDims());
+  T* data = array.getData();
+  for (size_t i = 0; i < nelems; i++)
+    data[i] = e[i];
+}
+/** @} */ // end of math
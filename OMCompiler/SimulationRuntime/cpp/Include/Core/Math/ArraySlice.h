@@ -194,6 +194,10 @@ class ArraySliceConst: public BaseArray<T> {
                                   "Can't get pointer to write to ArraySlice");
   }
 
+  virtual bool hasWritableData() const {
+    return false;
+  }
+
   virtual void getDataCopy(T data[], size_t n) const {
     if (n != getNumElems())
       throw ModelicaSimulationError(MODEL_ARRAY_FUNCTION,
@@ -16,6 +16,8 @@ extern "C" void daxpy_(long int *N, double *DA, double *DX, long int *INCX, doub
 extern "C" void dcopy_(long int *n, double *DX, long int *INCX, double *DY, long int *INCY);
 // y := alpha*A*x + beta*y
 extern "C" void dgemv_(char *trans, long int *m, long int *n, double *alpha, double *a, long int *lda, double *x, long int *incx, double *beta, double *y, long int *incy);
+// C := alpha*op(A)*op(B) + beta*C
+extern "C" void dgemm_(char *transa, char *transb, long int *m, long int *n, long int *k, double *alpha, double *a, long int *lda, double *b, long int *ldb, double *beta, double *c, long int *ldc);
 extern "C" void dscal_(long int *n, double *da, double *dx, long int *incx);
 extern "C" void dger_(long int *m, long int *n, double *alpha, double *x, long int *incx, double *y, long int *incy, 	double *a, long int *lda);
 //A := alpha*x*y' + A,
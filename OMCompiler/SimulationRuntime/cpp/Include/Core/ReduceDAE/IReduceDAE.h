@@ -33,4 +33,28 @@ public:
 	virtual ~IReduceDAE()	{};
 	//virtual void updateAll() = 0;
 
+};
+
+/*****************************************************************************/
+/**
+
+Abstract interface for a set of simulations with modified labels, run by
+ISimController::runReducedSimulations. Every simulation runs on a copy of the
+system with its own history, several of them at the same time, so
+setLabels, setResult and setError may be called from different threads but
+never twice for the same index.
+
+*/
+class IReducedSimulations
+{
+public:
+	virtual ~IReducedSimulations()	{};
+	//number of simulations
+	virtual size_t getDimSimulations()=0;
+	//sets the labels of the system copy for simulation i, after its initialization
+	virtual void setLabels(label_list_type& labels,size_t i)=0;
+	//queries the results of simulation i from the history of the system copy
+	virtual void setResult(IHistory* history,size_t i)=0;
+	//simulation i stopped with an error
+	virtual void setError(std::exception& ex,size_t i)=0;
 };
\ No newline at end of file
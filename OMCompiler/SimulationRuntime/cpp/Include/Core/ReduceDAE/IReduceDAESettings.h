@@ -32,4 +32,6 @@ public:
 	virtual void setMaxError(ublas::vector<double>& error)=0;
 	virtual IGlobalSettings* getGlobalSettings()=0;
     virtual vector<string> getOutputNames()=0;
+	virtual unsigned int getThreads()=0;
+	virtual void setThreads(unsigned int)=0;
 };
@@ -27,6 +27,10 @@ public:
 	virtual IGlobalSettings* getGlobalSettings();
 	//initializes the settings object by an xml file
     virtual vector<string> getOutputNames();
+	//Returns the number of simulations run at the same time by ranking and reduction
+	virtual unsigned int getThreads();
+	//Sets the number of simultaneous simulations, 0 uses all cores
+	virtual void setThreads(unsigned int);
 	void load(std::string xml_file);
 private:
 	IGlobalSettings*
@@ -34,7 +38,8 @@ private:
 	unsigned int
 		_ranking_method,				///< ranking mehtod
 		_reduction_method,				///< reduction mehtod
-		_nfail;							///< number of restarts after error bound was reached
+		_nfail,							///< number of restarts after error bound was reached
+		_threads;						///< number of simultaneous simulations, 0 for all cores
 	ublas::vector<double>
 		_max_error;						///< max error for all output variables, used in reduction algorithm
 
@@ -58,6 +63,8 @@ private:
 
 			ar &   make_nvp("MaximumError", _max_error);
 
+			ar & make_nvp("Threads", _threads);
+
 		}
 		catch(std::exception& ex)
 		{
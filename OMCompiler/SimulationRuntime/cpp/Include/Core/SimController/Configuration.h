@@ -16,6 +16,8 @@ public:
   shared_ptr<IGlobalSettings> getGlobalSettings();
   ISolverSettings* getSolverSettings();
   ISimControllerSettings* getSimControllerSettings();
+  /// configuration with global settings of its own, initialized with the global settings of this configuration
+  shared_ptr<Configuration> createConfiguration();
 
 private:
    shared_ptr<ISettingsFactory> _settings_factory;
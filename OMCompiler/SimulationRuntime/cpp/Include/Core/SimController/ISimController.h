@@ -25,6 +25,31 @@ struct SimSettings
   EmitResults emitResults;
   string inputPath;
   string outputPath;
+  HistorySettings historySettings;
+  PararealSettings pararealSettings;
+};
+
+class IReducedSimulations;
+class IHistory;
+
+/**
+ *  Batch of simulation jobs run by ISimController::runSimulations on copies of
+ *  a loaded system. Several jobs run at the same time, so getJob, setResult
+ *  and setError may be called from different threads but never twice for the
+ *  same index.
+ */
+class ISimulationJobs
+{
+public:
+  virtual ~ISimulationJobs() {};
+  //number of jobs
+  virtual size_t getDimJobs() = 0;
+  //start values by variable name and time span of job i
+  virtual void getJob(size_t i, std::map<string, double>& start_values, double& start_time, double& end_time) = 0;
+  //queries the results of job i from the history of the system copy
+  virtual void setResult(IHistory* history, size_t i) = 0;
+  //job i stopped with an error
+  virtual void setError(std::exception& ex, size_t i) = 0;
 };
 
 /**
@@ -44,6 +69,17 @@ public:
   virtual void initialize(SimSettings simsettings, string modelKey, double timeout)=0;
   virtual void StartReduceDAE(SimSettings simsettings,string modelPath, string modelKey, bool loadMSL, bool loadPackage)=0;
   virtual void runReducedSimulation()=0;
+  /**
+   *    Runs the simulations of a ranking or reduction step on copies of the system,
+   *    up to numThreads at the same time
+   */
+  virtual void runReducedSimulations(SimSettings simsettings, string modelKey, double timeout, IReducedSimulations* simulations, unsigned int numThreads)=0;
+  /**
+   *    Runs a batch of jobs on copies of a system loaded with LoadSystem, up to
+   *    numThreads at the same time. Results are kept in memory, the output
+   *    format of the settings is replaced by BUFFER unless it is CHUNKED.
+   */
+  virtual void runSimulations(SimSettings simsettings, string modelKey, ISimulationJobs* jobs, unsigned int numThreads)=0;
   /**
    *    Stops the simulation
    */
@@ -23,11 +23,15 @@ public:
     virtual void StartReduceDAE(SimSettings simsettings,string modelPath, string modelKey,bool loadMSL, bool loadPackage);
     virtual void initialize(SimSettings simsettings, string modelKey, double timeout);
      virtual void runReducedSimulation();
+    virtual void runReducedSimulations(SimSettings simsettings, string modelKey, double timeout, IReducedSimulations* simulations, unsigned int numThreads);
+    virtual void runSimulations(SimSettings simsettings, string modelKey, ISimulationJobs* jobs, unsigned int numThreads);
 private:
     void initialize(PATH library_path, PATH modelicasystem_path);
     bool _initialized;
     shared_ptr<Configuration> _config;
     std::map<string, shared_ptr<IMixedSystem> > _systems;
+    /// model library of every system loaded with LoadSystem
+    std::map<string, string> _model_libs;
 
 
 
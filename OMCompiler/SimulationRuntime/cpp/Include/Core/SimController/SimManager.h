@@ -12,6 +12,8 @@
 #include <Core/Utils/extension/measure_time.hpp>
 #endif
 
+class PararealPropagator;
+
 class SimManager
 {
 public:
@@ -30,6 +32,17 @@ private:
     void runSingleProcess();
     void writeProperties();
 
+    // parallel-in-time (Parareal) integration of models without state events
+    bool usePararealProcess();
+    bool isPararealInterrupted();
+    void runPararealProcess();
+    bool runPararealInterval(double startTime, double endTime, std::vector<shared_ptr<PararealPropagator> >& fine_propagators,
+                             shared_ptr<PararealPropagator> coarse_propagator, shared_ptr<IWriteOutput> writeoutput_system);
+    void runPararealSlices(std::vector<shared_ptr<PararealPropagator> >& propagators, size_t first, size_t last);
+    shared_ptr<PararealPropagator> createPararealPropagator(string solver_name);
+    void handlePararealEvents(double time, std::vector<double>& states, std::vector<shared_ptr<PararealPropagator> >& fine_propagators,
+                              shared_ptr<PararealPropagator> coarse_propagator);
+
     shared_ptr<IMixedSystem> _mixed_system;
     Configuration* _config;
 
@@ -58,6 +71,9 @@ private:
     shared_ptr<IStepEvent> _step_event_system;
 
     int* _sampleCycles;
+    unsigned int _pararealIterations;     ///< Output - number of Parareal iterations of all event-free intervals
+    bool _interrupt;                      ///< - set by stopSimulation or the alarm time, ends the Parareal integration
+    time_t _pararealStartTime;            ///< - wall clock time the Parareal integration started, for the alarm time
 
     #ifdef RUNTIME_PROFILING
     std::vector<MeasureTimeData*> *measureTimeFunctionsArray;
@@ -41,6 +41,10 @@ public:
   virtual void setLogSettings(LogSettings);
   virtual OutputFormat getOutputFormat();
   virtual void setOutputFormat(OutputFormat);
+  virtual HistorySettings getHistorySettings();
+  virtual void setHistorySettings(HistorySettings);
+  virtual PararealSettings getPararealSettings();
+  virtual void setPararealSettings(PararealSettings);
   //solver used for simulation
   virtual string getSelectedSolver();
   virtual void setSelectedSolver(string);
@@ -64,6 +68,9 @@ public:
   virtual void setSolverThreads(int);
   virtual int getSolverThreads();
 
+  virtual void setStartValues(const std::map<string, double>&);
+  virtual const std::map<string, double>& getStartValues();
+
 private:
   double
       _startTime,   ///< Start time of integration (default: 0.0)
@@ -89,5 +96,8 @@ private:
 
   int _solverThreads;
   OutputFormat _outputFormat;
+  HistorySettings _history_settings;
+  PararealSettings _parareal_settings;
+  std::map<string, double> _start_values;
 };
 /** @} */ // end of coreSimulationSettings
@@ -24,13 +24,14 @@ using std::string;
 */
 
 #include <vector>
+#include <map>
 
 enum LogCategory {LC_INIT = 0, LC_NLS = 1, LC_LS = 2, LC_SOLVER = 3, LC_OUTPUT = 4, LC_EVENTS = 5, LC_OTHER = 6, LC_MODEL = 7};
 enum LogLevel {LL_ERROR = 0, LL_WARNING = 1, LL_INFO = 2, LL_DEBUG = 3};
 enum LogFormat {LF_TXT = 0, LF_FMI = 1, LF_FMI2 = 2, LF_XML = 3, LF_XMLTCP = 4};
 enum LogOMEdit {LOG_EVENTS = 0, LOG_INIT, LOG_LS, LOG_NLS, LOG_SOLVER, LOG_STATS};
 enum OutputPointType {OPT_ALL, OPT_STEP, OPT_NONE};
-enum OutputFormat {CSV, MAT, BUFFER, EMPTY};
+enum OutputFormat {CSV, MAT, BUFFER, EMPTY, CHUNKED};
 enum EmitResults {EMIT_ALL, EMIT_PUBLIC, EMIT_NONE};
 
 struct LogSettings
@@ -51,6 +52,43 @@ struct LogSettings
   }
 };
 
+/**
+ * Storage of the CHUNKED in-memory result history
+ */
+struct HistorySettings
+{
+  std::string outputVariables; ///< comma separated names of the stored output variables, all if empty
+  unsigned int decimation;     ///< store every n-th output point
+  size_t chunkSize;            ///< number of output points per chunk
+  size_t memoryBudget;         ///< bytes of chunks kept in memory before they are mapped to a file, unlimited if 0
+
+  HistorySettings()
+    : decimation(1)
+    , chunkSize(1024)
+    , memoryBudget(256 * 1024 * 1024)
+  {
+  }
+};
+
+/**
+ * Parallel-in-time (Parareal) integration of SimManager
+ */
+struct PararealSettings
+{
+  unsigned int slices;        ///< number of time slices integrated at the same time, off if less than 2
+  unsigned int maxIterations; ///< maximal number of corrections of the slice start states
+  double tolerance;           ///< maximal relative change of the slice start states of a converged iteration
+  std::string coarseSolver;   ///< cheap solver predicting the slice start states, e.g. euler or rk12
+
+  PararealSettings()
+    : slices(0)
+    , maxIterations(10)
+    , tolerance(1e-6)
+    , coarseSolver("euler")
+  {
+  }
+};
+
 class IGlobalSettings
 {
 public:
@@ -76,6 +114,10 @@ public:
 
   virtual OutputFormat getOutputFormat() = 0;
   virtual void setOutputFormat(OutputFormat) = 0;
+  virtual HistorySettings getHistorySettings() = 0;
+  virtual void setHistorySettings(HistorySettings) = 0;
+  virtual PararealSettings getPararealSettings() = 0;
+  virtual void setPararealSettings(PararealSettings) = 0;
   virtual bool useEndlessSim() = 0;
   virtual void useEndlessSim(bool) = 0;
   ///< Write out statistical simulation infos, e.g. number of steps (at the end of simulation); [false,true]; default: true)
@@ -103,5 +145,9 @@ public:
 
   virtual void setSolverThreads(int) = 0;
   virtual int getSolverThreads() = 0;
+
+  ///< Start values that override the ones of the init xml file, indexed by variable name
+  virtual void setStartValues(const std::map<string, double>&) = 0;
+  virtual const std::map<string, double>& getStartValues() = 0;
 };
 /** @} */ // end of coreSimulationSettings
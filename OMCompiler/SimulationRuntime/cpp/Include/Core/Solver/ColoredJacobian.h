@@ -0,0 +1,59 @@
+#pragma once
+/** @addtogroup coreSolver
+ *
+ *  @{
+ */
+
+/**
+ Finite difference approximation of the state jacobian df/dy for the sundials solvers.
+ Columns of the same color of the sparsity pattern are perturbed together, the
+ column groups are evaluated in parallel on initialized clones of the system, one
+ clone per solver thread (openmp).
+*/
+class BOOST_EXTENSION_SOLVER_DECL ColoredJacobian
+{
+public:
+  ColoredJacobian(IMixedSystem* system, int numThreads);
+  ~ColoredJacobian();
+
+  /// Clones the system and builds the column groups, the system has to be initialized
+  void initialize();
+
+  /// True if less evaluations of the system than columns are needed or the columns are evaluated in parallel
+  bool isEfficient() const;
+
+  /// Takes over time, states, discrete variables and state selection of the system after an event
+  void synchronize(double time, const double* y, bool time_events);
+
+  /**
+   Computes the jacobian in column major order
+   @param time time of the jacobian
+   @param y states
+   @param f right hand side at y
+   @param delta increments of the states
+   @param jac dimSys x dimSys matrix, column major
+   */
+  void calcJacobian(double time, const double* y, const double* f, const double* delta, double* jac);
+
+private:
+  void initializeGroups();
+  void evaluateGroup(int thread, size_t group, double time, const double* y, const double* f, const double* delta, double* jac);
+
+  IMixedSystem* _system;
+  vector<IMixedSystem*> _mixed_systems;      ///< system and its clones, one per thread
+  vector<IContinuous*> _continuous_systems;
+  vector<ITime*> _time_systems;
+  vector<IEvent*> _event_systems;
+  vector<IStateSelection*> _state_selections;
+  int _numThreads;
+  size_t _dimSys;
+
+  vector<vector<int> > _groups;              ///< columns of the same color
+  vector<int> _columnPointers;               ///< sparsity pattern of the jacobian, empty if all entries are computed
+  vector<int> _rowIndices;
+  vector<vector<double> > _y;                ///< perturbed states of every thread
+  vector<vector<double> > _f;                ///< right hand side of every thread
+  vector<double> _zeroVal;
+  bool* _events;
+};
+ /** @} */ // end of coreSolver
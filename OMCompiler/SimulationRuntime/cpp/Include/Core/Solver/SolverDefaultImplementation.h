@@ -5,6 +5,7 @@
  */
 #include <Core/Solver/SystemStateSelection.h>
 #include <Core/Solver/SimulationMonitor.h>
+#include <Core/Solver/ColoredJacobian.h>
 #ifdef RUNTIME_PROFILING
 #include <Core/Utils/extension/measure_time.hpp>
 #endif
@@ -57,6 +58,9 @@ public:
   virtual bool stateSelection();
 
 protected:
+  /// Creates the colored jacobian of the states, returns false if it does not pay off compared to the internal jacobian of the solver
+  bool initializeColoredJacobian();
+
   // Member variables
   //---------------------------------------------------------------
   IMixedSystem
@@ -66,6 +70,7 @@ protected:
     *_settings;               ///< Settings for the solver
 
   shared_ptr<SystemStateSelection> _state_selection;
+  shared_ptr<ColoredJacobian> _colored_jacobian;  ///< finite difference jacobian evaluated on clones of the system, NULL if not used
   double
     _tInit,                   ///< (initiale) Startzeit (wird nicht vom Solver verändert)
     _tCurrent,                ///< current time (is changed by the solver)
@@ -91,5 +91,13 @@ class FMU2GlobalSettings : public IGlobalSettings
   virtual int getSolverThreads() { return 1; };
   virtual OutputFormat getOutputFormat() {return EMPTY;};
   virtual void setOutputFormat(OutputFormat) {};
+  virtual HistorySettings getHistorySettings() {return HistorySettings();};
+  virtual void setHistorySettings(HistorySettings) {};
+  virtual PararealSettings getPararealSettings() {return PararealSettings();};
+  virtual void setPararealSettings(PararealSettings) {};
+  virtual void setStartValues(const std::map<string, double>&) {};
+  virtual const std::map<string, double>& getStartValues() { return _start_values; };
+private:
+  std::map<string, double> _start_values;
 };
 /** @} */ // end of fmu2
@@ -106,6 +106,19 @@ public:
     shared_ptr<IHistory> writer(writer_iter->second.create(*settings,dim));
     return writer;
 
+  }
+  shared_ptr<IHistory> createChunkedBufferWriter(IGlobalSettings* settings,size_t dim)
+  {
+    std::map<std::string, factory<IHistory,IGlobalSettings&,size_t > >::iterator writer_iter;
+    std::map<std::string, factory<IHistory,IGlobalSettings&,size_t > >& writer_factory(_simobject_type_map->get());
+    writer_iter = writer_factory.find("ChunkedBufferWriter");
+    if (writer_iter == writer_factory.end())
+    {
+      throw ModelicaSimulationError(MODEL_FACTORY,"No ChunkedBufferWriter found");
+    }
+    shared_ptr<IHistory> writer(writer_iter->second.create(*settings,dim));
+    return writer;
+
   }
   shared_ptr<IHistory> createDefaultWriter(IGlobalSettings* settings,size_t dim)
   {
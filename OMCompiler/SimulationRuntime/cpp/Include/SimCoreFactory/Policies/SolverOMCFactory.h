@@ -85,7 +85,6 @@ public:
            fs::path rk12_path = ObjectFactory<CreationPolicy>::_library_path;
            fs::path rk12_name(RK12_LIB);
            rk12_path/=rk12_name;
-           std::cerr << rk12_path.string() << std::endl;
            LOADERRESULT result = ObjectFactory<CreationPolicy>::_factory->LoadLibrary(rk12_path.string(),*_solver_type_map);
            if (result != LOADER_SUCCESS)
            {
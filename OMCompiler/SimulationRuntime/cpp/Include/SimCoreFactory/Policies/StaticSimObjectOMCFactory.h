@@ -11,6 +11,7 @@ shared_ptr<IAlgLoopSolverFactory> createStaticAlgLoopSolverFactory(IGlobalSettin
 shared_ptr<IHistory> createMatFileWriterFactory(IGlobalSettings& globalSettings,size_t dim);
 shared_ptr<IHistory> createTextFileWriterFactory(IGlobalSettings& globalSettings,size_t dim);
 shared_ptr<IHistory> createBufferReaderWriterFactory(IGlobalSettings& globalSettings,size_t dim);
+shared_ptr<IHistory> createChunkedBufferWriterFactory(IGlobalSettings& globalSettings,size_t dim);
 shared_ptr<IHistory> createDefaultWriterFactory(IGlobalSettings& globalSettings,size_t dim);
 /*
 Policy class to create a OMC-,  Modelica- system or AlgLoopSolver
@@ -63,6 +64,13 @@ public:
     shared_ptr<IHistory> writer = createBufferReaderWriterFactory(*settings,dim);
     return writer;
 
+  }
+  shared_ptr<IHistory> createChunkedBufferWriter(IGlobalSettings* settings,size_t dim)
+  {
+
+    shared_ptr<IHistory> writer = createChunkedBufferWriterFactory(*settings,dim);
+    return writer;
+
   }
   shared_ptr<IHistory> createDefaultWriter(IGlobalSettings* settings,size_t dim)
   {
@@ -5,6 +5,7 @@
 #include <Core/Solver/SolverDefaultImplementation.h>
 
 #include <nvector/nvector_serial.h>   // serial N_Vector types, fcts., macros
+#include <sundials/sundials_direct.h>
 // ARKode includieren
 //#include <cvode/cvode.h>
 
@@ -96,9 +97,8 @@ private:
   static int ARK_ZerofCallback(double t, N_Vector y, double *zeroval, void *user_data);
 
   // Functions for Coloured Jacobian
-  //static int CV_JCallback(long int N, realtype t, N_Vector y, N_Vector fy, DlsMat Jac,void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
-  //int calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeight, N_Vector jthcol, double* y, N_Vector fy, DlsMat Jac);
-  //void initializeColoredJac();
+  static int ARK_JCallback(long int N, realtype t, N_Vector y, N_Vector fy, DlsMat Jac,void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
+  int calcJacobian(double t, long int N, N_Vector errorWeight, double* y, N_Vector fy, DlsMat Jac);
 
 
 
@@ -154,16 +154,6 @@ double
     _ARK_yWrite,             ///< Temp      - Vector for dense out
     _ARK_absTol;
 
-  // Variables for Coloured Jacobians
-  /*
-  int* _colorOfColumn;
-  int  _maxColors;
-  SparseMatrix _jacobianA;
-  int _jacobianANonzeros;
-  int const* _jacobianAIndex;
-  int const* _jacobianALeadindex;
-*/
-
 
 
   bool _arkode_initialized;
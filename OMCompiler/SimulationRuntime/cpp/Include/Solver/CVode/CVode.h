@@ -106,8 +106,7 @@ private:
 
   // Functions for Coloured Jacobian
   static int CV_JCallback(long int N, realtype t, N_Vector y, N_Vector fy, DlsMat Jac,void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
-  int calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeight, N_Vector jthcol, double* y, N_Vector fy, DlsMat Jac);
-  void initializeColoredJac();
+  int calcJacobian(double t, long int N, N_Vector errorWeight, double* y, N_Vector fy, DlsMat Jac);
 
 
 
@@ -165,14 +164,6 @@ double
     _CV_yWrite,        ///< Temp      - Vector for dense out
     _CV_absTol;
 
-  // Variables for Coloured Jacobians
-  int* _colorOfColumn;
-  int  _maxColors;
-  matrix_t _jacobianA;
-  int _jacobianANonzeros;
-  int const* _jacobianAIndex;
-  int const* _jacobianALeadindex;
-
 
 
 
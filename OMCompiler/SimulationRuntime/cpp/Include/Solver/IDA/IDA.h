@@ -98,8 +98,8 @@ private:
   static int zeroFunctionCB(double t, N_Vector y, N_Vector yp, double *zeroval, void *user_data);
 
   // Functions for Coloured Jacobian
-  static int jacobianFunctionCB(long int N, realtype t, N_Vector y, N_Vector fy, DlsMat Jac,void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
-  int calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeight, N_Vector jthcol, double* y, N_Vector fy, DlsMat Jac);
+  static int jacobianFunctionCB(long int N, realtype t, realtype cj, N_Vector y, N_Vector yp, N_Vector res, DlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
+  int calcJacobian(double t, long int N, double cj, N_Vector errorWeight, N_Vector f, double* y, double* yp, double* res, DlsMat Jac);
 
 
 
@@ -168,14 +168,6 @@ double
     _CV_ypWrite,
     _CV_absTol;
 
-  // Variables for Coloured Jacobians
-  int* _colorOfColumn;
-  int  _maxColors;
-  matrix_t _jacobianA;
-  int _jacobianANonzeros;
-  int const* _jacobianAIndex;
-  int const* _jacobianALeadindex;
-
 
   bool _ida_initialized;
 
@@ -5,6 +5,7 @@
  */
 #include "FactoryExport.h"
 #include <Core/Solver/SolverDefaultImplementation.h>
+#include <Core/Utils/extension/logger.hpp>
 
 class IRK12Settings;
 
@@ -66,9 +67,23 @@ private:
     void doRK12();
     void doRK12_stepControl();
 
-    void outputStepSize(bool *_activeStates, double time ,double hLatent, double hActive);
+    /// Refines the active states of a latent step with substeps of size _h_a, the latent states are interpolated
+    bool doRK12ActiveSteps(double tNext, double relTol, double absTol, double hMin);
 
-    void RK12Integration(bool *activeStates, double time, double *z0, double *z1, double h, double *error, double relTol, double absTol, int *numErrors);
+    /// Marks the states (and partitions) whose latent step error is too large, returns the number of active states
+    int markActiveStates();
+
+    /// One RK12 step for the active states, the inactive states of z1 have to be set by the caller. Returns the maximal scaled error
+    double RK12Integration(bool *activeStates, double time, double *z0, double *z1, double h, double *error, double relTol, double absTol, int *numErrors);
+
+    /// Step size for the next step of an embedded method of order 1
+    double newStepSize(double h, double errMax);
+
+    /// Partition of a state used for the multi-rate statistics (model partition or the state itself)
+    int statePartition(int state);
+
+    /// Switches on all partitions of the system (if the system is partitioned)
+    void setAllPartitionsActive();
 
     void RK12InterpolateStates(bool *activeStates, double *leftIntervalStates,double *rightIntervalStates,double leftTime,double rightTime, double *interpolStates, double interpolTime);
 
@@ -108,11 +123,16 @@ private:
     long int
         _dimSys,                                    ///< Temp             - (total) Dimension of systems (=number of ODE)
         _idid,										///< Input, Output    - Status Flag
-		_dimParts;                                  ///      				- number of partitions
+		_dimParts,                                  ///      				- number of partitions
+		_dimActivityParts;                          ///      				- number of partitions for the multi-rate statistics (model partitions or one per state)
 
     int
 		_latentSteps,
 		_activeSteps,
+		_rhsEvaluations,                            ///< Output            - Number of right hand side evaluations
+		*_partActiveSteps,                          ///< Output            - Number of latent steps refined by substeps, per partition
+		*_partAccSubSteps,                          ///< Output            - Number of accepted substeps, per partition
+		*_partRejSubSteps,                          ///< Output            - Number of rejected substeps, per partition
         _outputStp,
         _outputStps;                                ///< Output            - Number of output steps
 
@@ -132,7 +152,8 @@ private:
         *_f1,
 
 		*_zDot0,									// state derivative for state
-		*_zDotPred;									// state derivative for predictor state
+		*_zDotPred,									// state derivative for predictor state
+		*_error;									// scaled error per state of the last step
 
      double
          _hOut,                                     // Ouput step size for dense output
@@ -161,7 +182,9 @@ private:
 
     bool
 		*_activePartitions,							// boolean vector which partition has to be activated
-		*_activeStates;								// boolean vector which state has to be calculated in an active step
+		*_activeStates,								// boolean vector which state has to be calculated in an active step
+		*_allPartitionsActive,						// boolean vector to switch on all partitions
+		*_allStatesActive;							// boolean vector to calculate all states
 
     ISystemProperties* _properties;
     IContinuous* _continuous_system;
@@ -298,7 +298,8 @@ SimSettings OMCFactory::readSimulationParameter(int argc, const char* argv[])
        "none", OPT_NONE MAP_LIST_END;
      map<string, OutputFormat> outputFormatMap = MAP_LIST_OF
        "csv", CSV MAP_LIST_SEP "mat", MAT MAP_LIST_SEP
-       "buffer", BUFFER MAP_LIST_SEP "empty", EMPTY MAP_LIST_END;
+       "buffer", BUFFER MAP_LIST_SEP "empty", EMPTY MAP_LIST_SEP
+       "chunked", CHUNKED MAP_LIST_END;
      map<string, EmitResults> emitResultsMap = MAP_LIST_OF
        "all", EMIT_ALL MAP_LIST_SEP "public", EMIT_PUBLIC MAP_LIST_SEP
        "none", EMIT_NONE MAP_LIST_END;
@@ -330,8 +331,15 @@ SimSettings OMCFactory::readSimulationParameter(int argc, const char* argv[])
           ("log-port", po::value< int >()->default_value(0), "tcp port for log messages (default 0 meaning stdout/stderr)")
           ("alarm,A", po::value<unsigned int >()->default_value(360), "sets timeout in seconds for simulation")
           ("output-type,O", po::value< string >()->default_value("all"), "the points in time written to result file: all (output steps + events), step (just output points), none")
-          ("output-format,P", po::value< string >()->default_value("mat"), "simulation results output format: csv, mat, buffer, empty")
+          ("output-format,P", po::value< string >()->default_value("mat"), "simulation results output format: csv, mat, buffer, chunked, empty")
           ("emit-results,U", po::value< string >()->default_value("public"), "emit results: all, public, none")
+          ("output-variables", po::value< string >()->default_value(""), "comma separated output variables stored by the chunked output format (default all)")
+          ("output-decimation", po::value< unsigned int >()->default_value(1), "chunked output format stores every n-th output point")
+          ("output-memory-budget", po::value< unsigned int >()->default_value(256), "megabytes of chunked results kept in memory before they are mapped to a file (0 meaning unlimited)")
+          ("parareal-slices", po::value< unsigned int >()->default_value(0), "number of time slices integrated in parallel by the Parareal method (default 0 meaning sequential integration)")
+          ("parareal-iterations", po::value< unsigned int >()->default_value(10), "maximal number of Parareal iterations")
+          ("parareal-tolerance", po::value< double >()->default_value(1e-6), "relative tolerance of the slice start states of a converged Parareal iteration")
+          ("parareal-coarse-solver", po::value< string >()->default_value("euler"), "coarse solver of the Parareal method: euler, rk12")
           ;
 
      // a group for all options that should not be visible if '--help' is set
@@ -471,13 +479,24 @@ SimSettings OMCFactory::readSimulationParameter(int argc, const char* argv[])
            "Unknown emit-results " + emitResults_str);
      }
 
+     HistorySettings historySettings;
+     historySettings.outputVariables = vm["output-variables"].as<string>();
+     historySettings.decimation = std::max(vm["output-decimation"].as<unsigned int>(), 1u);
+     historySettings.memoryBudget = (size_t)vm["output-memory-budget"].as<unsigned int>() * 1024 * 1024;
+
+     PararealSettings pararealSettings;
+     pararealSettings.slices = vm["parareal-slices"].as<unsigned int>();
+     pararealSettings.maxIterations = std::max(vm["parareal-iterations"].as<unsigned int>(), 1u);
+     pararealSettings.tolerance = vm["parareal-tolerance"].as<double>();
+     pararealSettings.coarseSolver = vm["parareal-coarse-solver"].as<string>();
+
      fs::path libraries_path = fs::path( runtime_lib_path) ;
      fs::path modelica_path = fs::path( modelica_lib_path) ;
 
      libraries_path.make_preferred();
      modelica_path.make_preferred();
 
-     SimSettings settings = {solver, linSolver, nonLinSolver, starttime, stoptime, stepsize, 1e-24, 0.01, tolerance, resultsfilename, timeOut, outputPointType, logSettings, nlsContinueOnError, solverThreads, outputFormat, emitResults, inputPath, outputPath};
+     SimSettings settings = {solver, linSolver, nonLinSolver, starttime, stoptime, stepsize, 1e-24, 0.01, tolerance, resultsfilename, timeOut, outputPointType, logSettings, nlsContinueOnError, solverThreads, outputFormat, emitResults, inputPath, outputPath, historySettings, pararealSettings};
 
      _library_path = libraries_path.string();
      _modelicasystem_path = modelica_path.string();
@@ -248,7 +248,9 @@ void Arkode::initialize()
       throw ModelicaSimulationError(SOLVER,"Cvode::initialize()");
 
   // Use own jacobian matrix
-  // Check if Colored Jacobians are worth to use
+  // Check if Colored Jacobians are worth to use, the columns are evaluated in parallel with more than one solver thread
+  if (_continuous_system->getDimContinuousStates() > 0 && initializeColoredJacobian())
+    _idid = ARKDlsSetDenseJacFn(_arkodeMem, &ARK_JCallback);
 
   if (_idid < 0)
       throw ModelicaSimulationError(SOLVER,"ARKode::initialize()");
@@ -310,6 +312,8 @@ void Arkode::solve(const SOLVERCALL action)
       if (writeOutput)
         writeArkodeOutput(_tCurrent, _h, _locStps);
     _continuous_system->getContinuousStates(_z);
+      if (_colored_jacobian)
+        _colored_jacobian->synchronize(_tCurrent, _z, true);
     }
 
     // Solver soll fortfahren
@@ -488,6 +492,9 @@ void Arkode::ArkodeCore()
         writeToFile(0, _tCurrent, _h);
       }
 
+      if (_colored_jacobian)
+        _colored_jacobian->synchronize(_tCurrent, NV_DATA_S(_ARK_y), false);
+
       _idid = ARKodeReInit(_arkodeMem, NULL, ARK_fCallback, _tCurrent, _ARK_y);
       if (_idid < 0)
         throw ModelicaSimulationError(SOLVER,"CVode::ReInit()");
@@ -627,6 +634,44 @@ int Arkode::ARK_ZerofCallback(double t, N_Vector y, double *zeroval, void *user_
   return (0);
 }
 
+int Arkode::ARK_JCallback(long int N, double t, N_Vector y, N_Vector fy, DlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
+{
+  return ((Arkode*) user_data)->calcJacobian(t, N, tmp1, NV_DATA_S(y), fy, Jac);
+}
+
+int Arkode::calcJacobian(double t, long int N, N_Vector errorWeight, double* y, N_Vector fy, DlsMat Jac)
+{
+  try
+  {
+    double fnorm, minInc, *errorWeight_data, h, srur;
+
+    errorWeight_data = NV_DATA_S(errorWeight);
+
+    //Get relevant info
+    _idid = ARKodeGetErrWeights(_arkodeMem, errorWeight);
+    if (_idid < 0)
+      throw ModelicaSimulationError(SOLVER,"ARKode::calcJacobian()");
+    _idid = ARKodeGetCurrentStep(_arkodeMem, &h);
+    if (_idid < 0)
+      throw ModelicaSimulationError(SOLVER,"ARKode::calcJacobian()");
+
+    srur = sqrt(UROUND);
+
+    fnorm = N_VWrmsNorm(fy, errorWeight);
+    minInc = (fnorm != 0.0) ? (1000.0 * abs(h) * UROUND * N * fnorm) : 1.0;
+
+    for (int j = 0; j < N; j++)
+      _delta[j] = max(srur*abs(y[j]), minInc / errorWeight_data[j]);
+
+    _colored_jacobian->calcJacobian(t, y, NV_DATA_S(fy), _delta, Jac->data);
+  }      //workaround until exception can be catch from c- libraries
+  catch (std::exception/* & ex */)
+  {
+    return 1;
+  }
+  return 0;
+}
+
 int Arkode::reportErrorMessage(ostream& messageStream)
 {
   if (_solverStatus == ISolver::SOLVERERROR)
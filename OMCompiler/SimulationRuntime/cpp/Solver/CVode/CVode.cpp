@@ -38,18 +38,13 @@ Cvode::Cvode(IMixedSystem* system, ISolverSettings* settings)
 	_delta(NULL),
 	_deltaInv(NULL),
 	_ysave(NULL),
-	_colorOfColumn(NULL),
-	_jacobianAIndex(NULL),
-	_jacobianALeadindex(NULL),
 	_CV_absTol(),
 	_tLastWrite(-1.0),
 	_bWritten(false),
 	_zeroFound(false),
 	_CV_y0(),
 	_CV_y(),
-	_CV_yWrite(),
-	_maxColors(0),
-	_jacobianANonzeros(0)
+	_CV_yWrite()
 {
 	_data = ((void*) this);
 
@@ -108,8 +103,6 @@ Cvode::~Cvode()
 		CVodeFree(&_cvodeMem);
 	}
 
-	if (_colorOfColumn)
-		delete[] _colorOfColumn;
 	if (_delta)
 		delete[] _delta;
 	if (_deltaInv)
@@ -293,14 +286,10 @@ void Cvode::initialize()
 			throw ModelicaSimulationError(SOLVER, "Cvode::initialize()");
 
 		// Use own jacobian matrix
-		// Check if Colored Jacobians are worth to use
+		// Check if Colored Jacobians are worth to use, the columns are evaluated in parallel with more than one solver thread
 #if SUNDIALS_MAJOR_VERSION >= 2 || (SUNDIALS_MAJOR_VERSION == 2 && SUNDIALS_MINOR_VERSION >= 4)
-		_maxColors = _system->getAMaxColors();
-		if (_maxColors < _dimSys && _continuous_system->getDimContinuousStates() > 0)
-		{
-			// _idid = CVDlsSetDenseJacFn(_cvodeMem, &CV_JCallback);
-			// initializeColoredJac();
-		}
+		if (_continuous_system->getDimContinuousStates() > 0 && initializeColoredJacobian())
+			_idid = CVDlsSetDenseJacFn(_cvodeMem, &CV_JCallback);
 #endif
 
 		if (_idid < 0)
@@ -383,6 +372,8 @@ void Cvode::solve(const SOLVERCALL action)
 			if (writeOutput)
 				writeCVodeOutput(_tCurrent, _h, _locStps);
 			_continuous_system->getContinuousStates(_z);
+			if (_colored_jacobian)
+				_colored_jacobian->synchronize(_tCurrent, _z, true);
 		}
 
 		// Solver soll fortfahren
@@ -626,6 +617,9 @@ void Cvode::CVodeCore()
 				writeToFile(0, _tCurrent, _h);
 			}
 
+			if (_colored_jacobian)
+				_colored_jacobian->synchronize(_tCurrent, NV_DATA_S(_CV_y), false);
+
 			_idid = CVodeReInit(_cvodeMem, _tCurrent, _CV_y);
 			if (_idid < 0)
 				throw ModelicaSimulationError(SOLVER, "CVode::ReInit()");
@@ -814,21 +808,17 @@ int Cvode::CV_ZerofCallback(double t, N_Vector y, double *zeroval, void *user_da
 
 int Cvode::CV_JCallback(long int N, double t, N_Vector y, N_Vector fy, DlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
 {
-	return ((Cvode*)user_data)->calcJacobian(t, N, tmp1, tmp2, tmp3, NV_DATA_S(y), fy, Jac);
+	return ((Cvode*)user_data)->calcJacobian(t, N, tmp1, NV_DATA_S(y), fy, Jac);
 
 }
 
-int Cvode::calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeight, N_Vector jthCol, double* y, N_Vector fy, DlsMat Jac)
+int Cvode::calcJacobian(double t, long int N, N_Vector errorWeight, double* y, N_Vector fy, DlsMat Jac)
 {
 	try
 	{
-		int l, g;
-		double fnorm, minInc, *f_data, *fHelp_data, *errorWeight_data, h, srur, delta_inv;
+		double fnorm, minInc, *errorWeight_data, h, srur;
 
-		f_data = NV_DATA_S(fy);
 		errorWeight_data = NV_DATA_S(errorWeight);
-		fHelp_data = NV_DATA_S(fHelp);
-
 
 		//Get relevant info
 		_idid = CVodeGetErrWeights(_cvodeMem, errorWeight);
@@ -855,83 +845,9 @@ int Cvode::calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeig
 			_delta[j] = max(srur*abs(y[j]), minInc / errorWeight_data[j]);
 		}
 
-		for (int j = 0; j < N; j++)
-		{
-			_deltaInv[j] = 1 / _delta[j];
-		}
-
-		if (_jacobianANonzeros != 0)
-		{
-			for (int color = 1; color <= _maxColors; color++)
-			{
-				for (int k = 0; k < _dimSys; k++)
-				{
-					if ((_colorOfColumn[k]) == color)
-					{
-						_ysave[k] = y[k];
-						y[k] += _delta[k];
-					}
-				}
-
-				calcFunction(t, y, fHelp_data);
-
-				for (int k = 0; k < _dimSys; k++)
-				{
-					if ((_colorOfColumn[k]) == color)
-					{
-						y[k] = _ysave[k];
-
-						int startOfColumn = k * _dimSys;
-						for (int j = _jacobianALeadindex[k]; j < _jacobianALeadindex[k + 1]; j++)
-						{
-							l = _jacobianAIndex[j];
-							g = l + startOfColumn;
-							Jac->data[g] = (fHelp_data[l] - f_data[l]) * _deltaInv[k];
-						}
-					}
-				}
-			}
-		}
-
-
-
-
-
+		// Columns of the same color are computed with one evaluation of the system, the colors on clones of the system in parallel
+		_colored_jacobian->calcJacobian(t, y, NV_DATA_S(fy), _delta, Jac->data);
 	}
-
-
-
-
-
-
-	/*
-	//Calculation of J without colouring
-	for (j = 0; j < N; j++)
-	{
-
-
-	//N_VSetArrayPointer(DENSE_COL(Jac,j), jthCol);
-
-	_ysave[j] = y[j];
-
-	y[j] += _delta[j];
-
-	calcFunction(t, y, fHelp_data);
-
-	y[j] = _ysave[j];
-
-	delta_inv = 1.0/_delta[j];
-	N_VLinearSum(delta_inv, fHelp, -delta_inv, fy, jthCol);
-
-	for(int i=0; i<_dimSys; ++i)
-	{
-	Jac->data[i+j*_dimSys] = NV_Ith_S(jthCol,i);
-	}
-
-	//DENSE_COL(Jac,j) = N_VGetArrayPointer(jthCol);
-	}
-	*/
-
 	//workaround until exception can be catch from c- libraries
 	catch (std::exception & ex)
 	{
@@ -944,21 +860,6 @@ int Cvode::calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeig
 	return 0;
 }
 
-void Cvode::initializeColoredJac()
-{
-
-	if (_colorOfColumn)
-		delete[] _colorOfColumn;
-	_colorOfColumn = new int[_dimSys];
-	_system->getAColorOfColumn(_colorOfColumn, _dimSys);
-
-	// _system->getJacobian(_jacobianA);
-	//_jacobianANonzeros  = boost::numeric::bindings::traits::spmatrix_num_nonzeros (_jacobianA);
-	// _jacobianAIndex     = bindings::begin_index_minor(_jacobianA);
-	//_jacobianALeadindex = bindings::begin_index_major(_jacobianA);
-
-}
-
 int Cvode::reportErrorMessage(ostream& messageStream)
 {
 	if (_solverStatus == ISolver::SOLVERERROR)
@@ -43,9 +43,6 @@ Ida::Ida(IMixedSystem* system, ISolverSettings* settings)
       _delta(NULL),
       _deltaInv(NULL),
       _ysave(NULL),
-      _colorOfColumn (NULL),
-      _jacobianAIndex(NULL),
-      _jacobianALeadindex(NULL),
       _CV_y0(),
       _CV_y(),
       _CV_yp(),
@@ -54,9 +51,7 @@ Ida::Ida(IMixedSystem* system, ISolverSettings* settings)
       _CV_absTol(),
       _bWritten(false),
       _zeroFound(false),
-      _maxColors(0),
-      _tLastWrite(-1.0),
-      _jacobianANonzeros(0)
+      _tLastWrite(-1.0)
 {
   _data = ((void*) this);
   #ifdef RUNTIME_PROFILING
@@ -129,8 +124,6 @@ Ida::~Ida()
     IDAFree(&_idaMem);
   }
 
-  if (_colorOfColumn)
-    delete [] _colorOfColumn;
   if(_delta)
     delete [] _delta;
   if(_deltaInv)
@@ -344,10 +337,13 @@ void Ida::initialize()
          throw std::invalid_argument("IDA::initialize()");
 	}
 
-  // Use own jacobian matrix
-  //_idid = CVDlsSetDenseJacFn(_idaMem, &jacobianFunctionCB);
-  //if (_idid < 0)
-  //    throw std::invalid_argument("IDA::initialize()");
+  // Use own jacobian matrix of the ode system if coloring or parallel evaluation of the columns is worth to use
+  if (_dimAE == 0 && _dimStates > 0 && initializeColoredJacobian())
+  {
+    _idid = IDADlsSetDenseJacFn(_idaMem, &jacobianFunctionCB);
+    if (_idid < 0)
+      throw std::invalid_argument("IDA::initialize()");
+  }
 
     if (_dimZeroFunc)
     {
@@ -429,6 +425,8 @@ void Ida::solve(const SOLVERCALL action)
       if (writeOutput)
         writeIDAOutput(_tCurrent, _h, _locStps);
        _continuous_system->getContinuousStates(_y);
+      if (_colored_jacobian)
+        _colored_jacobian->synchronize(_tCurrent, _y, true);
     }
 
     // Solver soll fortfahren
@@ -658,6 +656,9 @@ void Ida::IDACore()
         writeToFile(0, _tCurrent, _h);
       }
 
+      if (_colored_jacobian)
+        _colored_jacobian->synchronize(_tCurrent, NV_DATA_S(_CV_y), false);
+
       _idid = IDAReInit(_idaMem, _tCurrent, _CV_y,_CV_yp);
       if (_idid < 0)
         throw std::runtime_error("IDA::ReInit()");
@@ -910,23 +911,21 @@ int Ida::zeroFunctionCB(double t, N_Vector y, N_Vector yp, double *zeroval, void
   return (0);
 }
 
-int Ida::jacobianFunctionCB(long int N, double t, N_Vector y, N_Vector fy, DlsMat Jac,void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
+int Ida::jacobianFunctionCB(long int N, double t, double cj, N_Vector y, N_Vector yp, N_Vector res, DlsMat Jac, void *user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
 {
-  return ((Ida*) user_data)->calcJacobian(t,N, tmp1, tmp2, tmp3,  NV_DATA_S(y), fy, Jac);
+  return ((Ida*) user_data)->calcJacobian(t, N, cj, tmp1, tmp2, NV_DATA_S(y), NV_DATA_S(yp), NV_DATA_S(res), Jac);
 
 }
 
 
-int Ida::calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeight, N_Vector jthCol, double* y, N_Vector fy, DlsMat Jac)
+int Ida::calcJacobian(double t, long int N, double cj, N_Vector errorWeight, N_Vector f, double* y, double* yp, double* res, DlsMat Jac)
 {
   try
   {
-  int l,g;
-  double fnorm, minInc, *f_data, *fHelp_data, *errorWeight_data, h, srur, delta_inv;
+  double *f_data, *errorWeight_data, h, srur;
 
-  f_data = NV_DATA_S(fy);
+  f_data = NV_DATA_S(f);
   errorWeight_data = NV_DATA_S(errorWeight);
-  fHelp_data = NV_DATA_S(fHelp);
 
 
   //Get relevant info
@@ -945,81 +944,26 @@ int Ida::calcJacobian(double t, long int N, N_Vector fHelp, N_Vector errorWeight
 
   srur = sqrt(UROUND);
 
-  fnorm = N_VWrmsNorm(fy, errorWeight);
-  minInc = (fnorm != 0.0) ?
-           (1000.0 * abs(h) * UROUND * N * fnorm) : 1.0;
-
+  // Increments as in the internal difference quotient jacobian of IDA
   for(int j=0;j<N;j++)
   {
-    _delta[j] = max(srur*abs(y[j]), minInc/errorWeight_data[j]);
-  }
-    for(int j=0;j<N;j++)
-  {
-    _deltaInv[j] = 1/_delta[j];
+    _delta[j] = max(srur*max(abs(y[j]), abs(h*yp[j])), 1.0/errorWeight_data[j]);
+    if (h*yp[j] < 0.0)
+      _delta[j] = -_delta[j];
   }
 
-  // Calculation of the jacobian
-
- if (_jacobianANonzeros != 0)
- {
-  for(int color=1; color <= _maxColors; color++)
+  // The residual of the ode system is res = f(y) - yp
+  for(int j=0;j<N;j++)
   {
-      for(int k=0; k < _dimSys; k++)
-    {
-      if((_colorOfColumn[k] ) == color)
-      {
-        _ysave[k] = y[k];
-        y[k]+= _delta[k];
-      }
-    }
-
-    calcFunction(t, y, fHelp_data,fHelp_data);
-
-  for (int k = 0; k < _dimSys; k++)
-   {
-       if((_colorOfColumn[k]) == color)
-     {
-        y[k] = _ysave[k];
-
-    int startOfColumn = k * _dimSys;
-    for (int j = _jacobianALeadindex[k]; j < _jacobianALeadindex[k+1];j++)
-      {
-        l = _jacobianAIndex[j];
-        g = l + startOfColumn;
-        Jac->data[g] = (fHelp_data[l] - f_data[l]) * _deltaInv[k];
-      }
-    }
-  }
+    f_data[j] = res[j] + yp[j];
   }
- }
-
-  /*
-  //Calculation of J without colouring
-   for (j = 0; j < N; j++)
-   {
-
-
-    //N_VSetArrayPointer(DENSE_COL(Jac,j), jthCol);
-
-     _ysave[j] = y[j];
 
-    y[j] += _delta[j];
-
-    calcFunction(t, y, fHelp_data);
-
-    y[j] = _ysave[j];
-
-    delta_inv = 1.0/_delta[j];
-    N_VLinearSum(delta_inv, fHelp, -delta_inv, fy, jthCol);
-
-    for(int i=0; i<_dimSys; ++i)
-        {
-            Jac->data[i+j*_dimSys] = NV_Ith_S(jthCol,i);
-        }
-
-    //DENSE_COL(Jac,j) = N_VGetArrayPointer(jthCol);
+  // Calculation of the jacobian dres/dy + cj*dres/dyp = df/dy - cj*I
+  _colored_jacobian->calcJacobian(t, y, f_data, _delta, Jac->data);
+  for(int j=0;j<N;j++)
+  {
+    Jac->data[j + j*N] -= cj;
   }
-  */
 
  }      //workaround until exception can be catch from c- libraries
   catch (std::exception& ex)
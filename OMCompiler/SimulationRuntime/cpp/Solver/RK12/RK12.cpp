@@ -26,6 +26,7 @@ RK12::RK12(IMixedSystem* system, ISolverSettings* settings)
     , _zWrite           (NULL)
 	, _zDot0			(NULL)
 	, _zDotPred			(NULL)
+	, _error			(NULL)
 
     , _dimSys           (0)
     , _outputStps       (0)
@@ -46,9 +47,17 @@ RK12::RK12(IMixedSystem* system, ISolverSettings* settings)
     ,_zeroTol            (1e-8)
     ,_outputStp(1)
     ,_tZero(-1)
+    ,_zeroSignIter      (NULL)
 	,_dimParts 	(0)
+	,_dimActivityParts	(0)
+	,_rhsEvaluations	(0)
+	,_partActiveSteps	(NULL)
+	,_partAccSubSteps	(NULL)
+	,_partRejSubSteps	(NULL)
 	,_activePartitions	(NULL)
 	,_activeStates		(NULL)
+	,_allPartitionsActive	(NULL)
+	,_allStatesActive	(NULL)
 {
 }
 
@@ -60,6 +69,20 @@ RK12::~RK12()
         delete [] _z0;
     if(_z1)
         delete [] _z1;
+    if(_z_a)
+        delete [] _z_a;
+    if(_z_a_0)
+        delete [] _z_a_0;
+    if(_z_a_1)
+        delete [] _z_a_1;
+    if(_zPred)
+        delete [] _zPred;
+    if(_zDot0)
+        delete [] _zDot0;
+    if(_zDotPred)
+        delete [] _zDotPred;
+    if(_error)
+        delete [] _error;
     if(_zInit)
         delete [] _zInit;
     if(_zWrite)
@@ -68,9 +91,22 @@ RK12::~RK12()
         delete [] _f0;
     if(_f1)
         delete [] _f1;
+    if(_zeroSignIter)
+        delete [] _zeroSignIter;
     if(_activePartitions)
         delete [] _activePartitions;
-
+    if(_allPartitionsActive)
+        delete [] _allPartitionsActive;
+    if(_activeStates)
+        delete [] _activeStates;
+    if(_allStatesActive)
+        delete [] _allStatesActive;
+    if(_partActiveSteps)
+        delete [] _partActiveSteps;
+    if(_partAccSubSteps)
+        delete [] _partAccSubSteps;
+    if(_partRejSubSteps)
+        delete [] _partRejSubSteps;
 }
 
 bool RK12::stateSelection()
@@ -106,7 +142,6 @@ void RK12::initialize()
         // Allocate state vectors, stages and temporary arrays
         if(_z)            	delete [] _z;
         if(_z0)        		delete [] _z0;
-        if(_zPred)        	delete [] _zPred;
         if(_z1)        		delete [] _z1;
         if(_z_a)          delete [] _z_a;
         if(_z_a_0)        	delete [] _z_a_0;
@@ -115,6 +150,7 @@ void RK12::initialize()
         if(_zPred)        	delete [] _zPred;
         if(_zDotPred)      delete [] _zDotPred;
         if(_zDot0)          delete [] _zDot0;
+        if(_error)          delete [] _error;
 
         if(_zInit)          delete [] _zInit;
         if(_zWrite)         delete [] _zWrite;
@@ -124,10 +160,10 @@ void RK12::initialize()
         if(_zeroSignIter)   delete [] _zeroSignIter;
 
         if(_activeStates)	delete [] _activeStates;
+        if(_allStatesActive)	delete [] _allStatesActive;
 
         _z  		= new double[_dimSys];
         _z0 		= new double[_dimSys];
-        _zPred 		= new double[_dimSys];
         _z1 		= new double[_dimSys];
         _z_a  	= new double[_dimSys];
         _z_a_0 	= new double[_dimSys];
@@ -136,6 +172,7 @@ void RK12::initialize()
         _zPred	 	= new double[_dimSys];
         _zDotPred 	= new double[_dimSys];
         _zDot0 		= new double[_dimSys];
+        _error 		= new double[_dimSys];
 
         _zInit      = new double[_dimSys];
         _zWrite     = new double[_dimSys];
@@ -145,10 +182,10 @@ void RK12::initialize()
         _zeroSignIter	= new int[_dimZeroFunc];
 
         _activeStates = new bool[_dimSys];
+        _allStatesActive = new bool[_dimSys];
 
         memset(_z,			0,_dimSys*sizeof(double));
         memset(_z0,			0,_dimSys*sizeof(double));
-        memset(_zPred,		0,_dimSys*sizeof(double));
         memset(_z1,			0,_dimSys*sizeof(double));
         memset(_z_a,		0,_dimSys*sizeof(double));
         memset(_z_a_0,		0,_dimSys*sizeof(double));
@@ -157,18 +194,21 @@ void RK12::initialize()
         memset(_zPred		,0,_dimSys*sizeof(double));
         memset(_zDotPred	,0,_dimSys*sizeof(double));
         memset(_zDot0		,0,_dimSys*sizeof(double));
+        memset(_error		,0,_dimSys*sizeof(double));
 
         memset(_zInit,		0,_dimSys*sizeof(double));
         memset(_zWrite,		0,_dimSys*sizeof(double));
 
         memset(_f0,0,_dimSys*sizeof(double));
         memset(_f1,0,_dimSys*sizeof(double));
-        memset(_zeroSignIter,0,_dimSys*sizeof(int));
+        memset(_zeroSignIter,0,_dimZeroFunc*sizeof(int));
 
         memset(_activeStates,0,_dimSys*sizeof(bool));
+        memset(_allStatesActive,true,_dimSys*sizeof(bool));
 
         // Counter initialisieren
         _outputStps    = 0;
+        _rhsEvaluations = 0;
 
         if( _RK12Settings->getDenseOutput())
         {
@@ -183,15 +223,32 @@ void RK12::initialize()
     _tZero=-1;
 
     }
-	// partition activation
-	if(_dimParts != -1)
+	// partition activation, the partitions of the system (-d=multirate) are the activity partitions,
+	// an unpartitioned system is partitioned automatically with one partition per state
+	if(_activePartitions)   	delete [] _activePartitions;
+	if(_allPartitionsActive)	delete [] _allPartitionsActive;
+	_activePartitions = NULL;
+	_allPartitionsActive = NULL;
+	if(_dimParts > 0)
 	{
-		if(_activePartitions)   delete [] _activePartitions;
 		_activePartitions = new bool[_dimParts];
+		_allPartitionsActive = new bool[_dimParts];
 		memset(_activePartitions,true,_dimParts*sizeof(bool));
-		_h_a = 0.5*_h;
+		memset(_allPartitionsActive,true,_dimParts*sizeof(bool));
 	}
-
+	_dimActivityParts = _dimParts > 0 ? _dimParts : _dimSys;
+
+	if(_partActiveSteps)	delete [] _partActiveSteps;
+	if(_partAccSubSteps)	delete [] _partAccSubSteps;
+	if(_partRejSubSteps)	delete [] _partRejSubSteps;
+	_partActiveSteps = new int[_dimActivityParts];
+	_partAccSubSteps = new int[_dimActivityParts];
+	_partRejSubSteps = new int[_dimActivityParts];
+	memset(_partActiveSteps,0,_dimActivityParts*sizeof(int));
+	memset(_partAccSubSteps,0,_dimActivityParts*sizeof(int));
+	memset(_partRejSubSteps,0,_dimActivityParts*sizeof(int));
+
+	_h_a = 0.5*_h;
 }
 void RK12::setTimeOut(unsigned int time_out)
   {
@@ -264,21 +321,18 @@ void RK12::solve(const SOLVERCALL command)
                 solverOutput(_accStps,_tCurrent,_z,_h);
 
                 // Choose integration method
-                if (_RK12Settings->getRK12Method()  == RK12Settings::STEPSIZECONTROL){
-                	//doRK12 with global step size and step size control
-            		std::cout<<"do RK12 step size controlled! "<<std::endl;
-            		doRK12_stepControl();
-                	}
-
-                else if (_RK12Settings->getRK12Method()  == RK12Settings::MULTIRATE){
-
-                	//doRK12 with multi-rate();
-            		std::cout<<"do RK12 multirate!"<<std::endl;
-                	doRK12();
-                	}
-
-                else{
-            		std::cout<<"do RK12 else!"<<std::endl;}
+                if (_RK12Settings->getRK12Method()  == RK12Settings::STEPSIZECONTROL)
+                {
+                    //doRK12 with global step size and step size control
+                    doRK12_stepControl();
+                }
+                else if (_RK12Settings->getRK12Method()  == RK12Settings::MULTIRATE)
+                {
+                    //doRK12 with latent steps for the slow partitions and substeps for the active ones
+                    doRK12();
+                }
+                else
+                    _idid = -2;
             }
 
             // Integration was not sucessfull (=0) or was terminated by the user (=1)
@@ -304,18 +358,21 @@ void RK12::solve(const SOLVERCALL command)
     }
 }
 
-void RK12::RK12Integration(bool *activeStates, double time, double *z0, double *z1, double h, double *error, double relTol, double absTol, int *numErrors)
+double RK12::RK12Integration(bool *activeStates, double time, double *z0, double *z1, double h, double *error, double relTol, double absTol, int *numErrors)
 {
+	double errMax = 0.0;
 	*numErrors = 0;
+
 	//calculate system
 	calcFunction(time, z0, _zDot0);
 
 	for(int i = 0; i < _dimSys; ++i){
-		//calculate the activated states only
-		if (activeStates[i] == true){
+		//calculate the activated states only, the inactive ones are given by the caller
+		if (activeStates[i] == true)
 			//do a forward euler step as predictor
-			_zPred[i] = _z0[i] + h * _zDot0[i];
-		}
+			_zPred[i] = z0[i] + h * _zDot0[i];
+		else
+			_zPred[i] = z1[i];
 	}
 
 	//calculate system for predictor
@@ -325,23 +382,21 @@ void RK12::RK12Integration(bool *activeStates, double time, double *z0, double *
 	for(int i = 0; i < _dimSys; ++i){
 		if (activeStates[i] == true){
 			z1[i] = z0[i] + 0.5*h *(_zDot0[i] + _zDotPred[i]);
-			//calculate error
-			if (!toleranceOK(z0[i], z1[i], relTol, absTol)) {
+			//the difference between euler and heun estimates the local error of the euler step
+			error[i] = fabs(z1[i] - _zPred[i]) / (absTol + relTol*max(fabs(z0[i]),fabs(z1[i])));
+			errMax = max(errMax, error[i]);
+			if (error[i] > 1.0)
 				*numErrors = *numErrors+1;
-			}
 		}
+		else
+			error[i] = 0.0;
 	}
-	//printing
-	for (int i=0;i < _dimSys; i++) {
-		if (activeStates[i] == true){
-		 //std::cout<<"state"<<i<<" at "<<time<<"   z0  "<<z0[i]<<"  _zDot0	"<<_zDot0[i]<<"  _zPred  "<<_zPred[i]<<"  _zDotPred  "<<_zDotPred[i]<<"	 z1	"<<z1[i]<<" relError "<<relError(z0[i],z1[i])<<"  correct?  "<<toleranceOK(z0[i], z1[i], relTol, absTol)<<std::endl;
-	 	 }
-	}
+	return errMax;
 }
 
 
 void RK12::RK12InterpolateStates(bool *activeStates, double *leftIntervalStates, double *rightIntervalStates,double leftTime,double rightTime, double *interpolStates, double interpolTime){
-	for (int i; i<_dimSys;i++)
+	for (int i = 0; i<_dimSys;i++)
 	{
 		if (activeStates[i] == false)
 			interpolStates[i] = ( (rightIntervalStates[i]-leftIntervalStates[i]) * (interpolTime-leftTime) / (rightTime-leftTime) ) +  leftIntervalStates[i];
@@ -349,224 +404,257 @@ void RK12::RK12InterpolateStates(bool *activeStates, double *leftIntervalStates,
 }
 
 
-void RK12::doRK12()
+double RK12::newStepSize(double h, double errMax)
+{
+	// order 1 error estimate, keep the step size change within [0.2, 2]
+	if (errMax <= 0.0)
+		return 2.0*h;
+	return h * min(2.0, max(0.2, 0.9*sqrt(1.0/errMax)));
+}
+
+
+int RK12::statePartition(int state)
+{
+	return _dimParts > 0 ? _continuous_system->getActivator(state) : state;
+}
+
+
+void RK12::setAllPartitionsActive()
+{
+	if (_dimParts > 0)
+		_continuous_system->setPartitionActivation(_allPartitionsActive);
+}
+
+
+int RK12::markActiveStates()
+{
+	int numActive = 0;
+
+	if (_dimParts > 0)
+	{
+		//a state with a too large error activates its whole partition
+		memset(_activePartitions,false,_dimParts*sizeof(bool));
+		for (int i = 0; i < _dimSys; i++)
+			if (_error[i] > 1.0)
+				_activePartitions[_continuous_system->getActivator(i)] = true;
+		for (int i = 0; i < _dimSys; i++)
+			_activeStates[i] = _activePartitions[_continuous_system->getActivator(i)];
+	}
+	else
+	{
+		for (int i = 0; i < _dimSys; i++)
+			_activeStates[i] = _error[i] > 1.0;
+	}
+
+	for (int i = 0; i < _dimSys; i++)
+		if (_activeStates[i])
+			++numActive;
+	return numActive;
+}
+
+
+bool RK12::doRK12ActiveSteps(double tNext, double relTol, double absTol, double hMin)
 {
 	int
-		numAccSteps = 0,
-		numAccActiveSteps = 0,
 		numErrors = 0;
 
-    double
-		tNext,
-		tActNext,
-		tActCurrent;						// point of time after another step with step size _h
+	double
+		hActive,
+		errMax,
+		tActCurrent = _tCurrent;
 
-    double
-		hNew = _h;
+	bool
+		lastStep,
+		*partitionCounted = new bool[_dimActivityParts];
 
-    double
-	    absTol = 1e-6,					// the max absolute error per step per state
-		relTol = 1e-4;					// the max relative error per step per state
+	// which partitions are refined in this latent step
+	memset(partitionCounted,false,_dimActivityParts*sizeof(bool));
+	for (int i = 0; i < _dimSys; i++)
+		if (_activeStates[i])
+			partitionCounted[statePartition(i)] = true;
+	for (int j = 0; j < _dimActivityParts; j++)
+		if (partitionCounted[j])
+			++_partActiveSteps[j];
 
-    double
-		*delta_z = new double[_dimSys];			// the error
+	if (_dimParts > 0)
+		_continuous_system->setPartitionActivation(_activePartitions);
 
-    bool
-		*allPartitionsActive = new bool[_dimParts],						// to switch on all partitions
-    	*allStatesActive = new bool[_dimSys];							// to calculate all states
-    	memset(allPartitionsActive,true,_dimParts*sizeof(bool));
-    	memset(allStatesActive,true,_dimSys*sizeof(bool));
+	// set the start values for the active interval
+	memcpy(_z_a_0,_z0,(int)_dimSys*sizeof(double));
 
+	while (tActCurrent < tNext)
+	{
+		// the active step size is smaller than the latent one, the last substep ends at the latent border
+		_h_a = min(_h_a, 0.5*_h);
+		hActive = _h_a;
+		lastStep = (tActCurrent + 1.01*hActive >= tNext);
+		if (lastStep)
+			hActive = tNext - tActCurrent;
 
-    while( _idid == 0 && _solverStatus != USER_STOP )
-    {
-    	//update step size
-        _h = hNew;
+		//interpolate the latent states at both borders of the substep
+		RK12InterpolateStates(_activeStates, _z0, _z1, _tCurrent, tNext, _z_a_0, tActCurrent);
+		RK12InterpolateStates(_activeStates, _z0, _z1, _tCurrent, tNext, _z_a, tActCurrent + hActive);
 
-    	// adapt step size of the last step before endTime
-        if((_tCurrent + _h) > _tEnd) {
-            _h = (_tEnd - _tCurrent);
-            std::cout<<"last step size "<<_h<<std::endl;
-        }
+		//integrate with active step size
+		errMax = RK12Integration(_activeStates, tActCurrent, _z_a_0, _z_a, hActive, _error, relTol, absTol, &numErrors);
 
-        // time for the next latent step
-        tNext = _tCurrent + _h;
+		if (numErrors == 0)
+		{
+			//active step is ok
+			for (int j = 0; j < _dimActivityParts; j++)
+				if (partitionCounted[j])
+					++_partAccSubSteps[j];
+
+			tActCurrent = lastStep ? tNext : tActCurrent + hActive;
+			memcpy(_z_a_0, _z_a, (int)_dimSys*sizeof(double));
+			if (!lastStep)
+				_h_a = newStepSize(hActive, errMax);
+		}
+		else
+		{
+			//active step is wrong, reduce the step size and repeat
+			for (int j = 0; j < _dimActivityParts; j++)
+				if (partitionCounted[j])
+					++_partRejSubSteps[j];
+
+			_h_a = newStepSize(hActive, errMax);
+			if (_h_a < hMin)
+				break;
+		}
+	}
+	delete [] partitionCounted;
 
-        //MAKE A LATENT STEP
-        //------------------
-        //std::cout<<"START LATENT STEP ("<<_h<<") at "<<_tCurrent<<std::endl;
+	setAllPartitionsActive();
 
-        // save old state vector for latent step
-        memcpy(_z0,_z,(int)_dimSys*sizeof(double));
+	if (tActCurrent < tNext)
+		return false;
 
-        //set partitions to active
-		_continuous_system->setPartitionActivation(allPartitionsActive);
+	//write the refined states to the right interval border
+	for (int i = 0; i < _dimSys; i++)
+		if (_activeStates[i])
+			_z1[i] = _z_a_0[i];
 
-        //integrate with latent step size
-        RK12Integration(allStatesActive, _tCurrent, _z0, _z, _h, delta_z, relTol, absTol, &numErrors);
+	return true;
+}
 
-    	//latent step is completely or partially ok
-        if (numErrors == 0) {
-			++ numAccSteps;
-			if (numAccSteps==4) {
-				// increase step size for the next step
-		        //std::cout<<"INCREASE LATENT STEP SIZE "<<_h<<std::endl;
-		        hNew = _h*2.0;
-				numAccSteps = 0;
-			}
 
-			// some printing
-			RK12::outputStepSize(_activeStates, _tCurrent, _h, -2.0);
+void RK12::doRK12()
+{
+	int
+		numErrors = 0,
+		numActive = 0;
 
-        }
-    	//latent step is completely wrong
-        else if(numErrors == _dimSys) {
-            //std::cout<<"ALL IS WRONG -> REDUCE LATENT STEP SIZE "<<_h<<std::endl;
-            hNew = _h/ 2.0;
-            memcpy(_z,_z0,(int)_dimSys*sizeof(double));
-          	tNext = _tCurrent;
-        }
+	double
+		tNext,
+		errMax,
+		hNew = _h;
 
-				//refine wrong states in an active step
-				else {
-					//which partitions belong to this errors?
-					for (int i=0;  i<  _dimSys; i++ ){
-						int j = _continuous_system->getActivator(i);
-						if (toleranceOK(_z0[i], _z[i], relTol, absTol)) {
-							//this error is small enough, no need to calculate this partition
-							_activePartitions[j] = false;
-							_activeStates[i] = false;
-							}
-						else {
-							_activePartitions[j] = true;
-							_activeStates[i] = true;
-						}
-					}
-					_continuous_system->setPartitionActivation(_activePartitions);
-
-					//std::cout<<"active partitions ";
-					//for (int i=0;i < _dimParts; i++) std::cout<<"  "<<_activePartitions[i];
-					//std::cout<<std::endl;
-
-
-					// integrate with active step size
-					tActCurrent = _tCurrent;
-
-					// set the start values for the active interval
-					memcpy(_z_a_0,_z0,(int)_dimSys*sizeof(double));
-
-					while (tActCurrent < tNext) {
-						numErrors = 0;
-
-						// In case the active step size is too big for the latent one, reduce it, adapt last step as well
-						if (_h <= _h_a) _h_a = _h/2;
-						if (tActCurrent + _h_a - tNext > 1e-8) std::cout<<"ADAPT LAST ACTIVE STEP "<<std::endl;
-
-						//some printing
-						//std::cout<<"START ACTIVE STEP ("<<_h_a<<") at "<<tActCurrent<<std::endl;
-						//std::cout<<"active partitions in active step";
-						//for (int i=0;i < _dimParts; i++) std::cout<<"  "<<_activePartitions[i];
-						//std::cout<<std::endl;
-
-						//interpolate states
-						RK12InterpolateStates(_activeStates, _z0,_z,_tCurrent,tNext, _z_a_0,tActCurrent);
-
-						//integrate with active step size
-						RK12Integration(_activeStates, tActCurrent, _z_a_0, _z_a, _h_a, delta_z, relTol, absTol, &numErrors);
-
-						//active step is ok
-						if(numErrors == 0)
-						{
-							if (numAccActiveSteps == 4) {
-								_h_a = _h_a * 2.0;
-								numAccActiveSteps = 0;
-								//std::cout<<"INCREASE ACTIVE STEP SIZE "<<_h_a<<std::endl;
-
-							}
-							else {
-								numAccActiveSteps = numAccActiveSteps+1;
-							}
-							//std::cout<<"ACTIVE STEP WAS OK "<<std::endl;
-							tActCurrent = tActCurrent+_h_a;
-							//set state for the next step
-							memcpy(_z_a_0, _z_a, (int)_dimSys*sizeof(double));
-
-							// some printing
-							RK12::outputStepSize(_activeStates, tActCurrent, _h, _h_a);
-
-						}
-						//active step is wrong
-						else {
-							//std::cout<<"REDUCE ACTIVE STEP SIZE AND REPEAT"<<std::endl;
-							_h_a = _h_a / 2.0;
-						}
-					  }
-					}
-
-        ++ _totStps;
-
-        //write result to right interval boarder vector
-        memcpy(_z1,_z,_dimSys*sizeof(double));
-
-
-    	//printing
-        solverOutput(_accStps,tNext,_z,_h);
-
-        //event handling
-        doMyZeroSearch();
-
-        if (((_tEnd - _tCurrent) < dynamic_cast<ISolverSettings*>(_RK12Settings)->getEndTimeTol()))
-            break;
-
-        if (_zeroStatus ==EQUAL_ZERO && _tZero > -1)   {
-
-        	// found zero crossing -> complete step
-            _firstStep            = true;
-            _hUpLim = dynamic_cast<ISolverSettings*>(_RK12Settings)->getUpperLimit();
-
-            //handle all events that occured at this t
-            //update_events_type update_event = boost::bind(&SolverDefaultImplementation::updateEventState, this);
-            _mixed_system->handleSystemEvents(_events/*,boost::ref(update_event)*/);
-            _event_system->getZeroFunc(_zeroVal);
-            _zeroStatus = EQUAL_ZERO;
-            memcpy(_zeroValLastSuccess,_zeroVal,_dimZeroFunc*sizeof(double));
-        }
+	const double
+		absTol = dynamic_cast<ISolverSettings*>(_RK12Settings)->getATol(),		// the max absolute error per step per state
+		relTol = dynamic_cast<ISolverSettings*>(_RK12Settings)->getRTol(),		// the max relative error per step per state
+		hMin = dynamic_cast<ISolverSettings*>(_RK12Settings)->getLowerLimit(),
+		hMax = dynamic_cast<ISolverSettings*>(_RK12Settings)->getUpperLimit();
 
-        if (_tZero > -1)        {
-            solverOutput(_accStps,_tZero,_z,_h);
-            _tCurrent = _tZero;
-            _tZero=-1;
-        }
-        else        {
-            //_tCurrent += _h;
-            _tCurrent = tNext;
-        }
-    }
-}
+	while( _idid == 0 && _solverStatus != USER_STOP )
+	{
+		//update step size
+		_h = hNew;
+
+		// adapt step size of the last step before endTime
+		if((_tCurrent + _h) > _tEnd)
+			_h = (_tEnd - _tCurrent);
+
+		// time for the next latent step
+		tNext = _tCurrent + _h;
 
+		//MAKE A LATENT STEP
+		//------------------
+		// save old state vector for latent step
+		memcpy(_z0,_z,(int)_dimSys*sizeof(double));
 
-void RK12::outputStepSize(bool *_activeStates, double time ,double hLatent, double hActive){
-	double stepsize = 0.0;
-	std::cout<<"time "<<time;
-	for (int i=0; i<_dimSys; i++) {
-		if (_activeStates[i]==true)
+		//integrate all states with latent step size
+		setAllPartitionsActive();
+		errMax = RK12Integration(_allStatesActive, _tCurrent, _z0, _z1, _h, _error, relTol, absTol, &numErrors);
+		memcpy(_f0,_zDot0,_dimSys*sizeof(double));
+
+		if (numErrors > 0)
 		{
-			stepsize = hActive;
+			numActive = markActiveStates();
+
+			//latent step is completely wrong
+			if (numActive == _dimSys)
+			{
+				++ _rejStps;
+				hNew = newStepSize(_h, errMax);
+				if (hNew < hMin)
+					_idid = -11;
+				continue;
+			}
+
+			//the latent states determine the next latent step size
+			errMax = 0.0;
+			for (int i = 0; i < _dimSys; i++)
+				if (!_activeStates[i])
+					errMax = max(errMax, _error[i]);
+			hNew = newStepSize(_h, errMax);
+
+			//refine wrong states in an active step
+			if (!doRK12ActiveSteps(tNext, relTol, absTol, hMin))
+			{
+				_idid = -11;
+				break;
+			}
 		}
 		else
-		{
-			stepsize = hLatent;
+			hNew = newStepSize(_h, errMax);
+
+		hNew = min(hNew, hMax);
+
+		++ _totStps;
+		++ _accStps;
+
+		//write result to right interval boarder vector
+		memcpy(_z,_z1,_dimSys*sizeof(double));
+		calcFunction(tNext, _z1, _f1);
+
+		//printing
+		solverOutput(_accStps,tNext,_z,_h);
+
+		//event handling
+		doMyZeroSearch();
+
+		if (((_tEnd - _tCurrent) < dynamic_cast<ISolverSettings*>(_RK12Settings)->getEndTimeTol()))
+			break;
+
+		if (_zeroStatus ==EQUAL_ZERO && _tZero > -1)   {
+
+			// found zero crossing -> complete step
+			_firstStep            = true;
+			_hUpLim = dynamic_cast<ISolverSettings*>(_RK12Settings)->getUpperLimit();
+
+			//handle all events that occured at this t
+			//update_events_type update_event = boost::bind(&SolverDefaultImplementation::updateEventState, this);
+			_mixed_system->handleSystemEvents(_events/*,boost::ref(update_event)*/);
+			_event_system->getZeroFunc(_zeroVal);
+			_zeroStatus = EQUAL_ZERO;
+			memcpy(_zeroValLastSuccess,_zeroVal,_dimZeroFunc*sizeof(double));
+		}
+
+		if (_tZero > -1)        {
+			solverOutput(_accStps,_tZero,_z,_h);
+			_tCurrent = _tZero;
+			_tZero=-1;
+		}
+		else        {
+			_tCurrent = tNext;
 		}
-		std::cout<<"  ;  "<<stepsize;
 	}
-	std::cout<<""<<std::endl;
 }
 
+
 double RK12::toleranceOK(double z1, double z2, double relTol, double absTol)
 {
 	double absError = fabs(z1-z2);
-	//std::cout<<"absError "<<absError<<std::endl;
-	//std::cout<<"relError "<<relError(z1,z2)<<std::endl;
 
 	if (absError <= absTol)
 	{
@@ -592,83 +680,57 @@ double RK12::relError(double z1, double z2)
 void RK12::doRK12_stepControl()
 {
 	int
-		numAccSteps = 0,
 		numErrors = 0;
 
-    double
-		tNext;
-
-    double
+	double
+		tNext,
+		errMax,
 		hNew = _h;
 
-    double
-	    absTol = 1e-6,					// the max absolute error per step per state
-		relTol = 1e-4;					// the max relative error per step per state
-
-    double
-		*delta_z = new double[_dimSys];			// the error
-
-    bool
-		*allPartitionsActive = new bool[_dimParts],						// to switch on all partitions
-    	*allStatesActive = new bool[_dimSys];							// to calculate all states
-    	memset(allPartitionsActive,true,_dimParts*sizeof(bool));
-    	memset(allStatesActive,true,_dimSys*sizeof(bool));
-
+	const double
+		absTol = dynamic_cast<ISolverSettings*>(_RK12Settings)->getATol(),		// the max absolute error per step per state
+		relTol = dynamic_cast<ISolverSettings*>(_RK12Settings)->getRTol(),		// the max relative error per step per state
+		hMin = dynamic_cast<ISolverSettings*>(_RK12Settings)->getLowerLimit(),
+		hMax = dynamic_cast<ISolverSettings*>(_RK12Settings)->getUpperLimit();
 
 	//set partitions to active
-	_continuous_system->setPartitionActivation(allPartitionsActive);
-
-    while( _idid == 0 && _solverStatus != USER_STOP )
-    {
-    	//update step size
-        _h = hNew;
+	setAllPartitionsActive();
 
-    	// adapt step size of the last step before endTime
-        if((_tCurrent + _h) > _tEnd) {
-            _h = (_tEnd - _tCurrent);
-            std::cout<<"last step size "<<_h<<std::endl;
-        }
-
-        // time for the next latent step
-        tNext = _tCurrent + _h;
-
-        //MAKE A LATENT STEP
-        //------------------
-        //std::cout<<"START LATENT STEP ("<<_h<<") at "<<_tCurrent<<std::endl;
+	while( _idid == 0 && _solverStatus != USER_STOP )
+	{
+		//update step size
+		_h = hNew;
 
-        // save old state vector for latent step
-        memcpy(_z0,_z,(int)_dimSys*sizeof(double));
+		// adapt step size of the last step before endTime
+		if((_tCurrent + _h) > _tEnd)
+			_h = (_tEnd - _tCurrent);
 
-        //integrate with latent step size
-        RK12Integration(allStatesActive, _tCurrent, _z0, _z, _h, delta_z, relTol, absTol, &numErrors);
+		// time for the next step
+		tNext = _tCurrent + _h;
 
-    	//latent step is completely or partially ok
-        if (numErrors == 0) {
-			++ numAccSteps;
-			if (numAccSteps==4) {
-				// increase step size for the next step
-		        //std::cout<<"INCREASE LATENT STEP SIZE "<<_h<<std::endl;
-		        hNew = _h*2.0;
-				numAccSteps = 0;
-			}
-        }
+		// save old state vector
+		memcpy(_z0,_z,(int)_dimSys*sizeof(double));
 
-    	//latent step is completely wrong
-        else {
-            //std::cout<<"ALL IS WRONG -> REDUCE LATENT STEP SIZE "<<_h<<std::endl;
-            hNew = _h/ 2.0;
-            memcpy(_z,_z0,(int)_dimSys*sizeof(double));
-          	tNext = _tCurrent;
-        }
+		//integrate with global step size
+		errMax = RK12Integration(_allStatesActive, _tCurrent, _z0, _z1, _h, _error, relTol, absTol, &numErrors);
+		hNew = min(newStepSize(_h, errMax), hMax);
 
-		// some printing
-		RK12::outputStepSize(_activeStates, _tCurrent, _h, -2.0);
+		//step is wrong, repeat with smaller step size
+		if (numErrors > 0)
+		{
+			++ _rejStps;
+			if (hNew < hMin)
+				_idid = -11;
+			continue;
+		}
 
+		++ _totStps;
 		++ _accStps;
 
 		//write result to right interval boarder vector
-		memcpy(_z1,_z,_dimSys*sizeof(double));
-
+		memcpy(_f0,_zDot0,_dimSys*sizeof(double));
+		memcpy(_z,_z1,_dimSys*sizeof(double));
+		calcFunction(tNext, _z1, _f1);
 
 		solverOutput(_accStps,tNext,_z,_h);
 
@@ -699,7 +761,6 @@ void RK12::doRK12_stepControl()
 			_tZero=-1;
 		}
 		else {
-			//_tCurrent += _h;
 			_tCurrent = tNext;
 		}
    }
@@ -1057,6 +1118,7 @@ void RK12::calcFunction(const double& t, const double* z, double* f)
     _continuous_system->setContinuousStates(z);
     _continuous_system->evaluateODE(IContinuous::ALL);    // vxworksupdate
     _continuous_system->getRHS(f);
+    ++_rhsEvaluations;
 }
 
 void RK12::solverOutput(const int& stp, const double& t, double* z, const double& h)
@@ -1202,6 +1264,24 @@ void RK12::interp1(double time, double *value)
 
 void RK12::writeSimulationInfo()
 {
+    LOGGER_WRITE("RK12: number of accepted steps = " + to_string(_accStps), LC_SOLVER, LL_INFO);
+    LOGGER_WRITE("RK12: number of rejected steps = " + to_string(_rejStps), LC_SOLVER, LL_INFO);
+    LOGGER_WRITE("RK12: function evaluations = " + to_string(_rhsEvaluations), LC_SOLVER, LL_INFO);
+
+    if (_RK12Settings->getRK12Method() == IRK12Settings::MULTIRATE && _partActiveSteps)
+    {
+        // partitions that were never refined are integrated with the latent steps only
+        for (int j = 0; j < _dimActivityParts; j++)
+        {
+            if (_partActiveSteps[j] == 0)
+                continue;
+            LOGGER_WRITE("RK12: " + string(_dimParts > 0 ? "partition " : "state ") + to_string(j)
+                + ": active in " + to_string(_partActiveSteps[j]) + " of " + to_string(_accStps) + " steps"
+                + ", accepted substeps = " + to_string(_partAccSubSteps[j])
+                + ", rejected substeps = " + to_string(_partRejSubSteps[j]), LC_SOLVER, LL_INFO);
+        }
+    }
+
     //// Solver
     //outputStream
     //    << "Solver:                       RK12\n"
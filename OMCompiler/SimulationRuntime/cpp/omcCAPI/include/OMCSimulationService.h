@@ -0,0 +1,76 @@
+#pragma once
+/**
+ *  \file OMCSimulationService.h
+ *  \brief Interface to run batches of simulations of a compiled C++ runtime model, with results in memory
+ */
+
+#include "OMCAPI.h"
+#include <stddef.h>
+
+extern "C"
+{
+    OMC_DLL typedef struct OMCSimulationService simulationService;
+
+   /**
+    *  \brief One simulation of a batch: parameter set, time span and outputs, filled with the results by RunSimulationJobs
+    */
+   typedef struct SimulationJob
+   {
+       int numParameters;              ///< number of start values replacing the ones of the init xml file, not supported by models compiled with -d=hardcodedStartValues
+       const char** parameterNames;    ///< names of the parameters or variables with start value
+       const double* parameterValues;  ///< start values
+       double startTime;               ///< simulation start time
+       double stopTime;                ///< simulation stop time
+       int numOutputs;                 ///< number of output variables to return
+       const char** outputNames;       ///< names of the output variables
+
+       int status;                     ///< result: 1 if the simulation succeeded, -1 on error
+       int numTimePoints;              ///< result: number of output points
+       double* time;                   ///< result: numTimePoints time entries
+       double* values;                 ///< result: numOutputs x numTimePoints values, output by output
+       char* error;                    ///< result: error text if the simulation failed else NULL
+   } simulationJob;
+
+   /**
+    *  \brief Loads a compiled model library with the C++ runtime and keeps it resident for following batches
+    *  \param [out] servicePtr pointer to allocated service instance
+    *  \param [in] argc number of runtime arguments
+    *  \param [in] argv runtime arguments as for the model executable, e.g. -R runtime library path, -M model path, -I solver, -G number of intervals
+    *  \param [in] modelLib name of model library, e.g OMCppMyModel.so
+    *  \param [in] modelName model name
+    *  \return a status flag
+    *  \details The dimensions of the model variables are read from the init xml file of the model library, e.g. MyModel_init.xml in the input path
+    */
+   int OMC_DLL InitSimulationService(simulationService** servicePtr, int argc, const char* argv[], const char* modelLib, const char* modelName);
+
+   /**
+    *  \brief Runs a batch of simulation jobs on copies of the loaded model
+    *  \param [in] service Pointer to service instance
+    *  \param [in,out] jobs jobs to simulate, results are stored in every job
+    *  \param [in] numJobs number of jobs
+    *  \param [in] numThreads maximal number of simulations at the same time
+    *  \return a status flag, -1 if any job failed
+    */
+   int OMC_DLL RunSimulationJobs(simulationService* service, simulationJob* jobs, int numJobs, int numThreads);
+
+   /**
+    *  \brief Free memory of the results of simulation jobs
+    *  \param [in] jobs jobs of RunSimulationJobs
+    *  \param [in] numJobs number of jobs
+    */
+   void OMC_DLL FreeSimulationJobResults(simulationJob* jobs, int numJobs);
+
+   /**
+    *  \brief Return an error text for the last service function call
+    *  \param [in] service Pointer to service instance
+    *  \param [out] result includes an error text if an error occured else it is empty
+    *  \return a status flag
+    */
+   int OMC_DLL GetSimulationServiceError(simulationService* service, const char** result);
+
+   /**
+    *  \brief Unloads the model and frees memory of the service instance
+    *  \param [in] service Pointer to service instance
+    */
+   void OMC_DLL FreeSimulationService(simulationService* service);
+}
@@ -0,0 +1,264 @@
+#include <Core/ModelicaDefine.h>
+#include <Core/Modelica.h>
+#include <Core/SimController/ISimController.h>
+#include <Core/System/FactoryExport.h>
+#include <Core/Utils/extension/logger.hpp>
+#include <SimCoreFactory/OMCFactory/OMCFactory.h>
+
+#include "OMCSimulationService.h"
+#include <boost/property_tree/xml_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+Complete definition for OMCSimulationService
+*/
+OMC_DLL typedef struct OMCSimulationService
+{
+   OMCSimulationService();
+   ~OMCSimulationService();
+   shared_ptr<OMCFactory> factory;
+   shared_ptr<ISimController> simController;
+   SimSettings simSettings;
+   string modelName;
+   string error;
+} simulationService;
+
+OMC_DLL OMCSimulationService::OMCSimulationService()
+{
+}
+
+OMC_DLL OMCSimulationService::~OMCSimulationService()
+{
+  //the system has to be released before the libraries of the factory
+  simController.reset();
+}
+
+static char* copyString(const char* str)
+{
+  char* copy = (char*)malloc(strlen(str) + 1);
+  strcpy(copy, str);
+  return copy;
+}
+
+/**
+Reads the dimensions of the simulation variables of LoadSimVars from the init xml file of the model library,
+the file of OMCpp<prefix>.so is <prefix>_init.xml in the input path
+*/
+static void readVariableDimensions(const string& inputPath, const string& modelLib, size_t dims[7])
+{
+  using boost::property_tree::ptree;
+  static const char* attributes[7] = {"numberOfRealVariables", "numberOfIntegerVariables", "numberOfBooleanVariables",
+    "numberOfStringVariables", "numberOfPreVariables", "numberOfContinuousStates", "stateIndex"};
+
+  string prefix = modelLib.substr(modelLib.find_last_of("/\\") + 1);
+  prefix = prefix.substr(0, prefix.rfind('.'));
+  if (prefix.compare(0, 5, "OMCpp") == 0)
+    prefix = prefix.substr(5);
+  string initFile = inputPath + prefix + "_init.xml";
+
+  ptree tree;
+  try
+  {
+    read_xml(initFile, tree);
+  }
+  catch (std::exception& ex)
+  {
+    throw ModelicaSimulationError(MODEL_FACTORY, "Could not read the init xml file " + initFile, ex.what());
+  }
+  for (int i = 0; i < 7; i++)
+  {
+    boost::optional<size_t> dim = tree.get_optional<size_t>(string("ModelDescription.<xmlattr>.") + attributes[i]);
+    if (!dim)
+      throw ModelicaSimulationError(MODEL_FACTORY, "The init xml file " + initFile + " has no attribute " + attributes[i]
+                                    + ", the model has to be translated again");
+    dims[i] = *dim;
+  }
+}
+
+/**
+Batch of simulation jobs of the C interface
+*/
+class SimulationJobBatch : public ISimulationJobs
+{
+public:
+  SimulationJobBatch(simulationJob* jobs, size_t numJobs)
+    : _jobs(jobs)
+    , _numJobs(numJobs)
+  {
+  }
+
+  virtual size_t getDimJobs()
+  {
+    return _numJobs;
+  }
+
+  virtual void getJob(size_t i, std::map<string, double>& start_values, double& start_time, double& end_time)
+  {
+    simulationJob& job = _jobs[i];
+    for (int j = 0; j < job.numParameters; j++)
+      start_values[job.parameterNames[j]] = job.parameterValues[j];
+    start_time = job.startTime;
+    end_time = job.stopTime;
+  }
+
+  virtual void setResult(IHistory* history, size_t i)
+  {
+    simulationJob& job = _jobs[i];
+    vector<string> output_names;
+    history->getOutputNames(output_names);
+
+    //rows of the requested outputs
+    vector<size_t> rows(job.numOutputs);
+    for (int j = 0; j < job.numOutputs; j++)
+    {
+      vector<string>::iterator iter = std::find(output_names.begin(), output_names.end(), string(job.outputNames[j]));
+      if (iter == output_names.end())
+        throw ModelicaSimulationError(DATASTORAGE, string("Output variable was not found in results: ") + job.outputNames[j]);
+      rows[j] = iter - output_names.begin();
+    }
+
+    //a chunked history (output format chunked) is read through column views
+    //without copying, the other histories through the output results matrix
+    HistoryColumn time_column;
+    if (history->getTimeColumn(time_column))
+    {
+      size_t numTimePoints = time_column.size;
+      allocateResults(job, numTimePoints);
+      for (size_t k = 0; k < numTimePoints; k++)
+        job.time[k] = time_column[k];
+      HistoryColumn column;
+      for (int j = 0; j < job.numOutputs; j++)
+      {
+        history->getOutputColumn(rows[j], column);
+        for (size_t k = 0; k < numTimePoints; k++)
+          job.values[j * numTimePoints + k] = column[k];
+      }
+    }
+    else
+    {
+      ublas::matrix<double> Ro;
+      history->getOutputResults(Ro);
+      vector<double> time_values = history->getTimeEntries();
+      size_t numTimePoints = std::min(time_values.size(), (size_t)Ro.size2());
+      allocateResults(job, numTimePoints);
+      std::copy(time_values.begin(), time_values.begin() + numTimePoints, job.time);
+      for (int j = 0; j < job.numOutputs; j++)
+        for (size_t k = 0; k < numTimePoints; k++)
+          job.values[j * numTimePoints + k] = Ro(rows[j], k);
+    }
+    job.status = 1;
+  }
+
+  virtual void setError(std::exception& ex, size_t i)
+  {
+    simulationJob& job = _jobs[i];
+    free(job.time);
+    free(job.values);
+    job.time = NULL;
+    job.values = NULL;
+    job.numTimePoints = 0;
+    job.error = copyString(ex.what());
+    job.status = -1;
+  }
+
+private:
+  void allocateResults(simulationJob& job, size_t numTimePoints)
+  {
+    job.numTimePoints = (int)numTimePoints;
+    job.time = (double*)malloc(std::max(numTimePoints, (size_t)1) * sizeof(double));
+    job.values = (double*)malloc(std::max(numTimePoints * job.numOutputs, (size_t)1) * sizeof(double));
+  }
+
+  simulationJob* _jobs;
+  size_t _numJobs;
+};
+
+extern "C" {
+
+  int InitSimulationService(simulationService** servicePtr, int argc, const char* argv[], const char* modelLib, const char* modelName)
+  {
+    simulationService* service = new simulationService();
+    *servicePtr = service;
+    try
+    {
+      std::map<std::string, std::string> opts;
+      service->factory = shared_ptr<OMCFactory>(new OMCFactory());
+      std::pair<shared_ptr<ISimController>, SimSettings> simulation = service->factory->createSimulation(argc, argv, opts);
+      service->simController = simulation.first;
+      service->simSettings = simulation.second;
+      service->modelName = modelName;
+
+      size_t dims[7];
+      readVariableDimensions(service->simSettings.inputPath, modelLib, dims);
+      shared_ptr<ISimObjects> simObjects = service->simController->getSimObjects();
+      simObjects->LoadSimData(modelName);
+      simObjects->LoadSimVars(modelName, dims[0], dims[1], dims[2], dims[3], dims[4], dims[5], dims[6]);
+      service->simController->LoadSystem(modelLib, modelName);
+    }
+    catch (std::exception& ex)
+    {
+      service->error = ex.what();
+      return -1;
+    }
+    return 1;
+  }
+
+  int RunSimulationJobs(simulationService* service, simulationJob* jobs, int numJobs, int numThreads)
+  {
+    service->error.clear();
+    for (int i = 0; i < numJobs; i++)
+    {
+      jobs[i].status = 0;
+      jobs[i].numTimePoints = 0;
+      jobs[i].time = NULL;
+      jobs[i].values = NULL;
+      jobs[i].error = NULL;
+    }
+    try
+    {
+      SimulationJobBatch batch(jobs, numJobs);
+      service->simController->runSimulations(service->simSettings, service->modelName, &batch, numThreads > 0 ? numThreads : 1);
+    }
+    catch (std::exception& ex)
+    {
+      service->error = ex.what();
+      return -1;
+    }
+    for (int i = 0; i < numJobs; i++)
+    {
+      if (jobs[i].status != 1)
+      {
+        service->error = string("Simulation job ") + to_string(i) + " failed" + (jobs[i].error ? string(": ") + jobs[i].error : string(""));
+        return -1;
+      }
+    }
+    return 1;
+  }
+
+  void FreeSimulationJobResults(simulationJob* jobs, int numJobs)
+  {
+    for (int i = 0; i < numJobs; i++)
+    {
+      free(jobs[i].time);
+      free(jobs[i].values);
+      free(jobs[i].error);
+      jobs[i].time = NULL;
+      jobs[i].values = NULL;
+      jobs[i].error = NULL;
+      jobs[i].numTimePoints = 0;
+    }
+  }
+
+  int GetSimulationServiceError(simulationService* service, const char** result)
+  {
+    *result = service->error.c_str();
+    return 1;
+  }
+
+  void FreeSimulationService(simulationService* service)
+  {
+    delete service;
+  }
+}
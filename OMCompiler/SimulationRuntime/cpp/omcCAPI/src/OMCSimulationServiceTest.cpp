@@ -0,0 +1,209 @@
+
+#include "OMC.h"
+#include "OMCSimulationService.h"
+#include <string>
+#include <iostream>
+#include <cmath>
+
+#if defined(_WIN32)
+  #define MODEL_LIB_EXT ".dll"
+#else
+  #define MODEL_LIB_EXT ".so"
+#endif
+
+/*
+Test for the simulation service: builds a model with the C++ runtime and simulates two jobs with different parameters.
+Usage: OMCSimulationServiceTest <OpenModelica home> <absolute test folder>
+*/
+
+static bool sendCommand(OMCData* omcData, const std::string& command)
+{
+  char *result = 0, *errorMsg = 0;
+  int status = SendCommand(omcData, command.c_str(), &result);
+  std::cout << command << std::endl;
+  if (status > 0)
+    std::cout << "..ok " << result << std::endl;
+  else
+    std::cout << "..failed" << std::endl;
+  if (GetError(omcData, &errorMsg) > 0 && errorMsg && *errorMsg)
+    std::cout << "..Errors/warnings: " << errorMsg << std::endl;
+  return status > 0 && std::string(result).find("false") != 0;
+}
+
+/*
+Builds the model der(x) = -k*x with the given flags, the service reads the variable dimensions from its init xml file
+*/
+static bool buildModel(OMCData* omcData, const std::string& modelName, const std::string& flags)
+{
+  return sendCommand(omcData, "loadString(\"model " + modelName + " parameter Real k = 1; Real x(start = 1, fixed = true); Real y = -x; equation der(x) = -k*x; end " + modelName + ";\")")
+         && sendCommand(omcData, "setCommandLineOptions(\"+simCodeTarget=Cpp " + flags + "\")")
+         && sendCommand(omcData, "buildModel(" + modelName + ")");
+}
+
+/*
+Simulates the model with k = 1 and k = 2, the results have to follow the parameters of the jobs.
+If expectRejected is set, the start values have to be rejected with an error text containing it.
+*/
+static bool runJobs(const std::string& omhome, const std::string& modelName, const std::string& testfolder,
+                    const char* parameterName, const std::string& expectRejected)
+{
+  std::string runtimeLibrary = omhome + "/lib/omc/cpp";
+  const char* argv[] = {"OMCSimulationServiceTest", "-R", runtimeLibrary.c_str(), "-M", testfolder.c_str(), "-G", "100"};
+  std::string modelLib = "OMCpp" + modelName + MODEL_LIB_EXT;
+  simulationService* service = 0;
+  const char* errorMsg = 0;
+  bool ok;
+
+  if (InitSimulationService(&service, 7, argv, modelLib.c_str(), modelName.c_str()) < 0)
+  {
+    GetSimulationServiceError(service, &errorMsg);
+    std::cout << "..failed to load the model: " << errorMsg << std::endl;
+    FreeSimulationService(service);
+    return false;
+  }
+
+  const char* parameterNames[] = {parameterName};
+  const char* outputNames[] = {"x"};
+  double k[2] = {1.0, 2.0};
+  simulationJob jobs[2];
+  for (int i = 0; i < 2; i++)
+  {
+    jobs[i].numParameters = 1;
+    jobs[i].parameterNames = parameterNames;
+    jobs[i].parameterValues = &k[i];
+    jobs[i].startTime = 0.0;
+    jobs[i].stopTime = 1.0;
+    jobs[i].numOutputs = 1;
+    jobs[i].outputNames = outputNames;
+  }
+
+  int status = RunSimulationJobs(service, jobs, 2, 2);
+  if (!expectRejected.empty())
+  {
+    GetSimulationServiceError(service, &errorMsg);
+    ok = status < 0 && std::string(errorMsg).find(expectRejected) != std::string::npos;
+    std::cout << (ok ? "..ok rejected: " : "..failed, start values were not rejected: ") << errorMsg << std::endl;
+  }
+  else if (status < 0)
+  {
+    GetSimulationServiceError(service, &errorMsg);
+    std::cout << "..failed " << errorMsg << std::endl;
+    ok = false;
+  }
+  else
+  {
+    ok = true;
+    for (int i = 0; i < 2; i++)
+    {
+      double x = jobs[i].values[jobs[i].numTimePoints - 1];
+      std::cout << "..job " << i << ": x(1) = " << x << ", expected " << std::exp(-k[i]) << std::endl;
+      ok = ok && std::fabs(x - std::exp(-k[i])) < 1e-3;
+    }
+    std::cout << (ok ? "..ok" : "..failed") << std::endl;
+  }
+
+  FreeSimulationJobResults(jobs, 2);
+  FreeSimulationService(service);
+  return ok;
+}
+
+/*
+Simulates the model with the chunked output format keeping every 10th of the 101 output points.
+The last point is kept as well, all stored points have to follow x = exp(-k*t).
+*/
+static bool runChunked(const std::string& omhome, const std::string& modelName, const std::string& testfolder)
+{
+  std::string runtimeLibrary = omhome + "/lib/omc/cpp";
+  const char* argv[] = {"OMCSimulationServiceTest", "-R", runtimeLibrary.c_str(), "-M", testfolder.c_str(), "-G", "100",
+                        "-P", "chunked", "--output-decimation", "10"};
+  std::string modelLib = "OMCpp" + modelName + MODEL_LIB_EXT;
+  simulationService* service = 0;
+  const char* errorMsg = 0;
+  bool ok;
+
+  if (InitSimulationService(&service, 11, argv, modelLib.c_str(), modelName.c_str()) < 0)
+  {
+    GetSimulationServiceError(service, &errorMsg);
+    std::cout << "..failed to load the model: " << errorMsg << std::endl;
+    FreeSimulationService(service);
+    return false;
+  }
+
+  const char* parameterNames[] = {"k"};
+  const char* outputNames[] = {"x"};
+  double k = 2.0;
+  simulationJob job;
+  job.numParameters = 1;
+  job.parameterNames = parameterNames;
+  job.parameterValues = &k;
+  job.startTime = 0.0;
+  job.stopTime = 1.0;
+  job.numOutputs = 1;
+  job.outputNames = outputNames;
+
+  if (RunSimulationJobs(service, &job, 1, 1) < 0)
+  {
+    GetSimulationServiceError(service, &errorMsg);
+    std::cout << "..failed " << errorMsg << std::endl;
+    ok = false;
+  }
+  else
+  {
+    int n = job.numTimePoints;
+    std::cout << "..stored " << n << " time points from " << job.time[0] << " to " << job.time[n - 1] << std::endl;
+    ok = n >= 11 && n <= 13 && job.time[0] == 0.0 && std::fabs(job.time[n - 1] - 1.0) < 1e-10;
+    for (int i = 0; i < n; i++)
+    {
+      ok = ok && (i == 0 || job.time[i] >= job.time[i - 1])
+              && std::fabs(job.values[i] - std::exp(-k * job.time[i])) < 1e-3;
+    }
+    std::cout << (ok ? "..ok" : "..failed") << std::endl;
+  }
+
+  FreeSimulationJobResults(&job, 1);
+  FreeSimulationService(service);
+  return ok;
+}
+
+int main(int argc, const char* argv[])
+{
+  if (argc < 3)
+  {
+    std::cout << "Usage: OMCSimulationServiceTest <OpenModelica home> <absolute test folder>" << std::endl;
+    return 1;
+  }
+  std::string omhome = argv[1];
+  std::string testfolder = argv[2];
+  char *change_dir_results = 0;
+  bool ok = true;
+
+  std::cout << "Test OMC simulation service ..." << std::endl;
+  InitMetaOMC();
+
+  OMCData *omcData;
+  InitOMC(&omcData, "gcc", omhome.c_str());
+  sendCommand(omcData, "mkdir(\"" + testfolder + "\")");
+  if (SetWorkingDirectory(omcData, testfolder.c_str(), &change_dir_results) < 0)
+  {
+    std::cout << "..failed to change to the test folder" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Simulate two jobs with different parameters" << std::endl;
+  ok = buildModel(omcData, "ServiceTest", "") && runJobs(omhome, "ServiceTest", testfolder, "k", "");
+
+  std::cout << "Store every 10th output point with the chunked output format" << std::endl;
+  ok = runChunked(omhome, "ServiceTest", testfolder) && ok;
+
+  std::cout << "Reject start values of unknown and alias variables" << std::endl;
+  ok = runJobs(omhome, "ServiceTest", testfolder, "unknownParameter", "unknown or String variables: unknownParameter") && ok;
+  ok = runJobs(omhome, "ServiceTest", testfolder, "y", "alias variables, set the referred variable instead: y") && ok;
+
+  std::cout << "Reject start values of a model with hardcoded start values" << std::endl;
+  //a model of its own, the library of the first one may still be loaded
+  ok = buildModel(omcData, "ServiceTestHardcoded", "-d=hardcodedStartValues")
+       && runJobs(omhome, "ServiceTestHardcoded", testfolder, "k", "hardcodedStartValues") && ok;
+
+  std::cout << (ok ? "Test succeeded" : "Test failed") << std::endl;
+  return ok ? 0 : 1;
+}
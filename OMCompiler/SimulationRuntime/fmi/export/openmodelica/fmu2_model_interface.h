@@ -91,6 +91,11 @@ typedef struct {
   int _need_update;
   int _has_jacobian;
   ANALYTIC_JACOBIAN* fmiDerJac;
+
+  omc_memory_pool *memoryPool;      /* temporaries of the instance */
+  omc_memory_pool *previousPool;    /* active pool before the current call */
+  omc_pool_state poolState;
+  int poolDepth;                    /* nesting of calls, e.g. in fmi2DoStep */
 } ModelInstance;
 
 /* reset alignment policy to the one set before reading this file */
@@ -231,7 +231,7 @@ void AbstractAnimationWindow::updateControlPanelValues()
   if (getVisualizer()) {
     VisualizerFMU* FMUvis = dynamic_cast<VisualizerFMU*>(mpVisualizer);
     for (int stateIdx = 0; stateIdx < mSpinBoxVector.size(); stateIdx++) {
-      mStateLabels.at(stateIdx)->setText(QString::number(FMUvis->getFMU()->getFMUData()->_states[stateIdx]));
+      mStateLabels.at(stateIdx)->setText(QString::number(FMUvis->getStateValue(stateIdx)));
     }
   }
 }
@@ -256,13 +256,13 @@ void AbstractAnimationWindow::initInteractiveControlPanel()
     for (unsigned int stateIdx = 0; stateIdx < FMUvis->getFMU()->getFMUData()->_nStates; stateIdx++)
     {
       DoubleSpinBoxIndexed* spinBox = new DoubleSpinBoxIndexed(this, stateIdx);
-      spinBox->setValue(FMUvis->getFMU()->getFMUData()->_states[stateIdx]);
+      spinBox->setValue(FMUvis->getStateValue(stateIdx));
       spinBox->setMaximum(DBL_MAX);
       spinBox->setMinimum(-DBL_MAX);
       spinBox->setSingleStep(0.1);
       mSpinBoxVector.push_back(spinBox);
 
-      QLabel* stateLabel = new QLabel(QString::number(FMUvis->getFMU()->getFMUData()->_states[stateIdx]), this);
+      QLabel* stateLabel = new QLabel(QString::number(FMUvis->getStateValue(stateIdx)), this);
       stateLabel->setMargin(0);
       mStateLabels.push_back(stateLabel);
 
@@ -327,9 +327,8 @@ void AbstractAnimationWindow::setStateSolveSystem(double val, int idx)
   if (idx>=0) {
     VisualizerFMU* FMUvis = dynamic_cast<VisualizerFMU*>(mpVisualizer);
     if (FMUvis) {
-      FMUvis->getFMU()->getFMUData()->_states[idx] = val;
+      FMUvis->setStateValue(idx, val);
     }
-    FMUvis->updateSystem();
     mpViewerWidget->update();
   }
 }
@@ -0,0 +1,171 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "FMUSimulationThread.h"
+#include "VisualizerFMU.h"
+
+#include <algorithm>
+
+/*!
+ * \class FMUFrameRing
+ * \brief Single producer, single consumer ring of frames.
+ * The frame at the tail is kept until the renderer has moved past the next frame, so it can always interpolate.
+ */
+FMUFrameRing::FMUFrameRing()
+  : mCapacity(1), mFrameSize(1), mData(1, 0.0), mHead(0), mTail(0)
+{
+}
+
+/*!
+ * \brief FMUFrameRing::resize
+ * Resizes and clears the ring. Must not be called while the simulation thread is running.
+ * \param capacity
+ * \param frameSize
+ */
+void FMUFrameRing::resize(const size_t capacity, const size_t frameSize)
+{
+  mCapacity = std::max<size_t>(capacity, 2);
+  mFrameSize = std::max<size_t>(frameSize, 1);
+  mData.assign(mCapacity * mFrameSize, 0.0);
+  clear();
+}
+
+/*!
+ * \brief FMUFrameRing::clear
+ * Drops all frames. Must not be called while the simulation thread is running.
+ */
+void FMUFrameRing::clear()
+{
+  mHead.store(0);
+  mTail.store(0);
+}
+
+bool FMUFrameRing::isEmpty() const
+{
+  return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire);
+}
+
+bool FMUFrameRing::isFull() const
+{
+  return mHead.load(std::memory_order_relaxed) - mTail.load(std::memory_order_acquire) >= mCapacity;
+}
+
+/*!
+ * \brief FMUFrameRing::beginWrite
+ * Returns the next free frame or NULL if the ring is full. Called by the producer only.
+ * \return
+ */
+double* FMUFrameRing::beginWrite()
+{
+  if (isFull()) {
+    return NULL;
+  }
+  return &mData[(mHead.load(std::memory_order_relaxed) % mCapacity) * mFrameSize];
+}
+
+/*!
+ * \brief FMUFrameRing::commitWrite
+ * Publishes the frame returned by beginWrite. Called by the producer only.
+ */
+void FMUFrameRing::commitWrite()
+{
+  mHead.store(mHead.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+/*!
+ * \brief FMUFrameRing::interpolate
+ * Linearly interpolates the frame values at the given time. Frames before the time are released to the producer.
+ * If the producer has not reached the time yet the latest frame is returned, i.e. values[0] is less than time.
+ * Called by the consumer only.
+ * \param time
+ * \param values
+ * \return false if there is no frame yet.
+ */
+bool FMUFrameRing::interpolate(const double time, std::vector<double> &values)
+{
+  size_t tail = mTail.load(std::memory_order_relaxed);
+  const size_t head = mHead.load(std::memory_order_acquire);
+  if (head == tail) {
+    return false;
+  }
+  while (tail + 1 < head && frame(tail + 1)[0] <= time) {
+    ++tail;
+  }
+  mTail.store(tail, std::memory_order_release);
+  values.resize(mFrameSize);
+  const double *pFrame0 = frame(tail);
+  if (tail + 1 < head && time > pFrame0[0]) {
+    const double *pFrame1 = frame(tail + 1);
+    const double w = (time - pFrame0[0]) / (pFrame1[0] - pFrame0[0]);
+    for (size_t i = 0; i < mFrameSize; ++i) {
+      values[i] = pFrame0[i] + w * (pFrame1[i] - pFrame0[i]);
+    }
+    values[0] = time;
+  } else {
+    std::copy(pFrame0, pFrame0 + mFrameSize, values.begin());
+  }
+  return true;
+}
+
+/*!
+ * \class FMUSimulationThread
+ * \brief Runs the FMU integration of the animation independent of the scene updates.
+ */
+/*!
+ * \brief FMUSimulationThread::FMUSimulationThread
+ * \param pVisualizerFMU
+ */
+FMUSimulationThread::FMUSimulationThread(VisualizerFMU *pVisualizerFMU)
+  : QThread(), mpVisualizerFMU(pVisualizerFMU), mStop(false)
+{
+}
+
+/*!
+ * \brief FMUSimulationThread::stop
+ * Stops the simulation after the current frame and waits for the thread.
+ */
+void FMUSimulationThread::stop()
+{
+  mStop.store(true);
+  wait();
+  mStop.store(false);
+}
+
+void FMUSimulationThread::run()
+{
+  while (!mStop.load()) {
+    if (mpVisualizerFMU->getFrames()->isFull()) {
+      msleep(5);
+    } else if (!mpVisualizerFMU->simulateFrame()) {
+      break;
+    }
+  }
+}
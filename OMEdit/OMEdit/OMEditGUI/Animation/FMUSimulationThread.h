@@ -0,0 +1,84 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of  MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef FMUSIMULATIONTHREAD_H
+#define FMUSIMULATIONTHREAD_H
+
+#include <QThread>
+
+#include <atomic>
+#include <vector>
+
+/*!
+ * \class FMUFrameRing
+ * \brief Lock-free ring of simulation frames between the FMU simulation thread (producer) and the renderer (consumer).
+ * A frame is the simulation time followed by the frame values.
+ */
+class FMUFrameRing
+{
+public:
+  FMUFrameRing();
+  void resize(const size_t capacity, const size_t frameSize);
+  void clear();
+  bool isEmpty() const;
+  bool isFull() const;
+  double* beginWrite();
+  void commitWrite();
+  bool interpolate(const double time, std::vector<double> &values);
+private:
+  size_t mCapacity;
+  size_t mFrameSize;
+  std::vector<double> mData;
+  std::atomic<size_t> mHead;
+  std::atomic<size_t> mTail;
+
+  const double* frame(const size_t index) const {return &mData[(index % mCapacity) * mFrameSize];}
+};
+
+class VisualizerFMU;
+/*!
+ * \class FMUSimulationThread
+ * \brief Advances the FMU of a VisualizerFMU and fills its frame ring until the ring is full or the simulation ends.
+ */
+class FMUSimulationThread : public QThread
+{
+public:
+  FMUSimulationThread(VisualizerFMU *pVisualizerFMU);
+  void stop();
+  bool isStopRequested() const {return mStop.load();}
+protected:
+  virtual void run();
+private:
+  VisualizerFMU *mpVisualizerFMU;
+  std::atomic<bool> mStop;
+};
+
+#endif // FMUSIMULATIONTHREAD_H
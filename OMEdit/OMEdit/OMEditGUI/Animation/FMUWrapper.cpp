@@ -37,6 +37,9 @@
 #include "Modeling/MessagesWidget.h"
 #include "Util/Helper.h"
 
+#include <algorithm>
+#include <cmath>
+
 SimSettingsFMU::SimSettingsFMU()
                 : _callEventUpdate(fmi1_false),
                   _toleranceControlled(fmi1_true),
@@ -100,6 +103,11 @@ void SimSettingsFMU::setSolver(const Solver& solver)
   _solver = solver;
 }
 
+Solver SimSettingsFMU::getSolver() const
+{
+  return _solver;
+}
+
 int* SimSettingsFMU::getCallEventUpdate()
 {
   return &_callEventUpdate;
@@ -124,7 +132,93 @@ bool SimSettingsFMU::getIterateEvents()
 //-------------------------------
 
 
-FMUWrapperAbstract::FMUWrapperAbstract(){
+FMUWrapperAbstract::FMUWrapperAbstract()
+    : mFMUdata(),
+      mRKStates(),
+      mRKStages()
+{
+}
+
+/*!
+ * \brief FMUWrapperAbstract::setCurrentTime
+ * Sets the time the integration continues from, e.g. after the states were reset to an earlier frame.
+ * \param time
+ */
+void FMUWrapperAbstract::setCurrentTime(const double time)
+{
+  mFMUdata._tcur = time;
+}
+
+/*!
+ * \brief FMUWrapperAbstract::doDormandPrinceStep
+ * Integrates the step [_tcur - _hcur, _tcur] with the embedded Runge-Kutta 5(4) pair of Dormand and Prince.
+ * The derivatives at the start of the step have to be in _statesDer, i.e. solveSystem() was called before.
+ * If the local error is too large the step is shortened until it is accepted, so _tcur and _hcur may change.
+ * \param relTol The relative (and absolute) error tolerance.
+ * \return The step size proposed for the next step.
+ */
+double FMUWrapperAbstract::doDormandPrinceStep(const double relTol)
+{
+  static const double c[7] = {0.0, 1.0/5.0, 3.0/10.0, 4.0/5.0, 8.0/9.0, 1.0, 1.0};
+  static const double a[7][6] = {
+    {0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+    {1.0/5.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+    {3.0/40.0, 9.0/40.0, 0.0, 0.0, 0.0, 0.0},
+    {44.0/45.0, -56.0/15.0, 32.0/9.0, 0.0, 0.0, 0.0},
+    {19372.0/6561.0, -25360.0/2187.0, 64448.0/6561.0, -212.0/729.0, 0.0, 0.0},
+    {9017.0/3168.0, -355.0/33.0, 46732.0/5247.0, 49.0/176.0, -5103.0/18656.0, 0.0},
+    {35.0/384.0, 0.0, 500.0/1113.0, 125.0/192.0, -2187.0/6784.0, 11.0/84.0}
+  };
+  // difference between the 5th and the 4th order weights
+  static const double e[7] = {71.0/57600.0, 0.0, -71.0/16695.0, 71.0/1920.0, -17253.0/339200.0, 22.0/525.0, -1.0/40.0};
+  const size_t n = mFMUdata._nStates;
+  const double t0 = mFMUdata._tcur - mFMUdata._hcur;
+  const double hMin = 1e-12 * std::max(1.0, std::fabs(t0));
+  double h = mFMUdata._hcur;
+  double err = 0.0;
+
+  if (n == 0) {
+    return h;
+  }
+  mRKStates.assign(mFMUdata._states, mFMUdata._states + n);
+  mRKStages.resize(8 * n);
+  double *k = &mRKStages[0];
+  double *x = &mRKStages[7 * n];
+  std::copy(mFMUdata._statesDer, mFMUdata._statesDer + n, k);
+
+  for (;;) {
+    for (int s = 1; s < 7; ++s) {
+      for (size_t i = 0; i < n; ++i) {
+        double sum = 0.0;
+        for (int j = 0; j < s; ++j) {
+          sum += a[s][j] * k[j * n + i];
+        }
+        x[i] = mRKStates[i] + h * sum;
+      }
+      // the last stage is evaluated at the new solution and leaves the FMU at the end of the step
+      computeDerivatives(t0 + c[s] * h, x, &k[s * n]);
+    }
+    err = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+      double sum = 0.0;
+      for (int j = 0; j < 7; ++j) {
+        sum += e[j] * k[j * n + i];
+      }
+      const double scale = relTol * (1.0 + std::max(std::fabs(mRKStates[i]), std::fabs(x[i])));
+      err += (h * sum / scale) * (h * sum / scale);
+    }
+    err = std::sqrt(err / n);
+    if (err <= 1.0 || h <= hMin) {
+      break;
+    }
+    h = std::max(hMin, h * std::max(0.2, 0.9 * std::pow(err, -0.25)));
+  }
+
+  std::copy(x, x + n, mFMUdata._states);
+  std::copy(&k[6 * n], &k[7 * n], mFMUdata._statesDer);
+  mFMUdata._hcur = h;
+  mFMUdata._tcur = t0 + h;
+  return h * (err > 0.0 ? std::min(5.0, std::max(0.2, 0.9 * std::pow(err, -0.2))) : 5.0);
 }
 
 //-------------------------------
@@ -134,8 +228,7 @@ FMUWrapperAbstract::FMUWrapperAbstract(){
 FMUWrapper_ME_1::FMUWrapper_ME_1()
     : FMUWrapperAbstract(),
       mpFMU(nullptr),
-      mCallBackFunctions(),
-      mFMUdata()
+      mCallBackFunctions()
 {
 }
 
@@ -341,6 +434,13 @@ void FMUWrapper_ME_1::completedIntegratorStep(int* callEventUpdate)
   mFMUdata._fmiStatus = fmi1_import_completed_integrator_step(mpFMU, (char*)callEventUpdate);
 }
 
+void FMUWrapper_ME_1::computeDerivatives(const double time, const double* states, double* derivatives)
+{
+  mFMUdata._fmiStatus = fmi1_import_set_time(mpFMU, time);
+  mFMUdata._fmiStatus = fmi1_import_set_continuous_states(mpFMU, states, mFMUdata._nStates);
+  mFMUdata._fmiStatus = fmi1_import_get_derivatives(mpFMU, derivatives, mFMUdata._nStates);
+}
+
 //-------------------------------
 // FMU Model Exchange Version 2.0
 //-------------------------------
@@ -348,8 +448,7 @@ void FMUWrapper_ME_1::completedIntegratorStep(int* callEventUpdate)
 FMUWrapper_ME_2::FMUWrapper_ME_2()
     : FMUWrapperAbstract(),
       mpFMU(nullptr),
-      mCallBackFunctions(),
-      mFMUdata()
+      mCallBackFunctions()
 {
   mFMUdata.terminateSimulation = fmi2_false;
 }
@@ -582,6 +681,13 @@ void FMUWrapper_ME_2::completedIntegratorStep(int* callEventUpdate)
   mFMUdata.fmiStatus2 = fmi2_import_completed_integrator_step(mpFMU, fmi2_true, (fmi2_boolean_t*)callEventUpdate, &mFMUdata.terminateSimulation);
 }
 
+void FMUWrapper_ME_2::computeDerivatives(const double time, const double* states, double* derivatives)
+{
+  mFMUdata.fmiStatus2 = fmi2_import_set_time(mpFMU, time);
+  mFMUdata.fmiStatus2 = fmi2_import_set_continuous_states(mpFMU, states, mFMUdata._nStates);
+  mFMUdata.fmiStatus2 = fmi2_import_get_derivatives(mpFMU, derivatives, mFMUdata._nStates);
+}
+
 unsigned int FMUWrapper_ME_2::fmi_get_variable_by_name(const char* name)
 {
     fmi2_import_variable_t* var = fmi2_import_get_variable_by_name(mpFMU, name);
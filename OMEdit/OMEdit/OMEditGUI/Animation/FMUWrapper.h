@@ -42,6 +42,7 @@
 #include <iostream>
 #include <memory>
 #include <map>
+#include <vector>
 
 
 typedef struct
@@ -69,7 +70,8 @@ typedef struct
 enum class Solver
 {
   NONE = 0,
-  EULER_FORWARD = 1
+  EULER_FORWARD = 1,
+  DORMAND_PRINCE = 2
 };
 
 class SimSettingsFMU
@@ -89,6 +91,7 @@ class SimSettingsFMU
   double getRelativeTolerance();
   int getToleranceControlled() const;
   void setSolver(const Solver& solver);
+  Solver getSolver() const;
   int* getCallEventUpdate();
   int getIntermediateResults();
   void setIterateEvents(bool iE);
@@ -124,12 +127,22 @@ class FMUWrapperAbstract
   virtual void setLastStepSize(const double simTimeEnd) = 0;
   virtual void solveSystem() = 0;
   virtual void doEulerStep() = 0;
+  double doDormandPrinceStep(const double relTol);
+  void setCurrentTime(const double time);
   virtual void setContinuousStates() = 0;
   virtual void completedIntegratorStep(int* callEventUpdate) = 0;
+  virtual void computeDerivatives(const double time, const double* states, double* derivatives) = 0;
 
   virtual const FMUData* getFMUData()  = 0;
   virtual void fmi_get_real(unsigned int* valueRef, double* res) = 0;
   virtual unsigned int fmi_get_variable_by_name(const char* name) = 0;
+
+ protected:
+  FMUData mFMUdata;
+
+ private:
+  std::vector<double> mRKStates;
+  std::vector<double> mRKStages;
 };
 
 class FMUWrapper_ME_1 : public FMUWrapperAbstract
@@ -152,6 +165,7 @@ class FMUWrapper_ME_1 : public FMUWrapperAbstract
   void doEulerStep();
   void setContinuousStates();
   void completedIntegratorStep(int* callEventUpdate);
+  void computeDerivatives(const double time, const double* states, double* derivatives);
 
   const FMUData* getFMUData();
   fmi1_import_t* getFMU();
@@ -161,7 +175,6 @@ class FMUWrapper_ME_1 : public FMUWrapperAbstract
  private:
   fmi1_import_t* mpFMU;
   fmi1_callback_functions_t mCallBackFunctions;
-  FMUData mFMUdata;
 };
 
 
@@ -184,6 +197,7 @@ class FMUWrapper_ME_2 : public FMUWrapperAbstract
   void solveSystem();
   void doEulerStep();
   void completedIntegratorStep(int* callEventUpdate);
+  void computeDerivatives(const double time, const double* states, double* derivatives);
   void do_event_iteration(fmi2_import_t *fmu, fmi2_event_info_t *eventInfo);
 
   const FMUData* getFMUData();
@@ -194,7 +208,6 @@ class FMUWrapper_ME_2 : public FMUWrapperAbstract
  private:
   fmi2_import_t* mpFMU;
   fmi2_callback_functions_t mCallBackFunctions;
-  FMUData mFMUdata;
 };
 
 #endif // end FMUWRAPPER_H
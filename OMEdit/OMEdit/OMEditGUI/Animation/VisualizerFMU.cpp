@@ -35,15 +35,28 @@
 
 #include "VisualizerFMU.h"
 
+#include <algorithm>
+
 
 VisualizerFMU::VisualizerFMU(const std::string& modelFile, const std::string& path)
     : VisualizerAbstract(modelFile, path, VisType::FMU),
       mpFMU(nullptr),
-      mpSimSettings(new SimSettingsFMU())
+      mpSimSettings(new SimSettingsFMU()),
+      mpSimulationThread(new FMUSimulationThread(this)),
+      mFrames(),
+      mFrameValues(),
+      mVisAttributes(),
+      mVisValueRefs(),
+      mFrameInterval(0.01),
+      mLastFrameTime(0.0),
+      mHNext(0.001),
+      mLastRealTime(0.0)
 {
 }
  VisualizerFMU::~VisualizerFMU()
  {
+   stopSimulationThread();
+   delete mpSimulationThread;
    if (mpFMU){
      free(mpFMU);
    }
@@ -172,6 +185,35 @@ int VisualizerFMU::setVarReferencesInVisAttributes()
   return isOk;
 }
 
+/*!
+ * \brief VisualizerFMU::collectVisAttributes
+ * Collects the attributes that are read from the FMU. Their values are stored in the frames in this order.
+ */
+void VisualizerFMU::collectVisAttributes()
+{
+  mVisAttributes.clear();
+  mVisValueRefs.clear();
+  for (auto& shape : mpOMVisualBase->_shapes)
+  {
+    ShapeObjectAttribute* attributes[] = {&shape._length, &shape._width, &shape._height,
+                                          &shape._lDir[0], &shape._lDir[1], &shape._lDir[2],
+                                          &shape._wDir[0], &shape._wDir[1], &shape._wDir[2],
+                                          &shape._r[0], &shape._r[1], &shape._r[2],
+                                          &shape._rShape[0], &shape._rShape[1], &shape._rShape[2],
+                                          &shape._T[0], &shape._T[1], &shape._T[2],
+                                          &shape._T[3], &shape._T[4], &shape._T[5],
+                                          &shape._T[6], &shape._T[7], &shape._T[8]};
+    for (auto attr : attributes)
+    {
+      if (!attr->isConst)
+      {
+        mVisAttributes.push_back(attr);
+        mVisValueRefs.push_back(attr->fmuValueRef);
+      }
+    }
+  }
+}
+
 void VisualizerFMU::simulate(TimeManager& omvm)
 {
   while (omvm.getSimTime() < omvm.getRealTime() + omvm.getHVisual() && omvm.getSimTime() < omvm.getEndTime())
@@ -211,8 +253,9 @@ double VisualizerFMU::simulateStep(const double time)
     mpFMU->handleEvents(mpSimSettings->getIntermediateResults());
   }
 
-  // Updated next time step
-  mpFMU->updateNextTimeStep(mpSimSettings->getHdef());
+  // Updated next time step, the adaptive solver takes at most one step per frame
+  const bool adaptive = mpSimSettings->getSolver() == Solver::DORMAND_PRINCE;
+  mpFMU->updateNextTimeStep(adaptive ? std::min(mHNext, mFrameInterval) : mpSimSettings->getHdef());
 
   // last step
   mpFMU->setLastStepSize(mpSimSettings->getTend());
@@ -228,8 +271,12 @@ double VisualizerFMU::simulateStep(const double time)
   //fmi1_import_get_real(mpFMUl.mpFMU, &vr, 1, &value);
   //std::cout<<"value "<<value<<std::endl;
 
-  // integrate a step with euler
-  mpFMU->doEulerStep();
+  // integrate a step
+  if (adaptive) {
+    mHNext = mpFMU->doDormandPrinceStep(mpSimSettings->getRelativeTolerance());
+  } else {
+    mpFMU->doEulerStep();
+  }
 
   // Set states
   mpFMU->setContinuousStates();
@@ -240,18 +287,107 @@ double VisualizerFMU::simulateStep(const double time)
   return mpFMU->getFMUData()->_tcur;
 }
 
+/*!
+ * \brief VisualizerFMU::simulateFrame
+ * Simulates until the next frame is due or the thread is asked to stop and stores the frame.
+ * Called by the simulation thread.
+ * \return false if the end of the simulation is reached.
+ */
+bool VisualizerFMU::simulateFrame()
+{
+  const FMUData* pData = mpFMU->getFMUData();
+  const double tEnd = mpSimSettings->getTend();
+  if (pData->_tcur >= tEnd || pData->terminateSimulation) {
+    return false;
+  }
+  do {
+    simulateStep(pData->_tcur);
+  } while (pData->_tcur < mLastFrameTime + mFrameInterval && pData->_tcur < tEnd && !pData->terminateSimulation
+           && !mpSimulationThread->isStopRequested());
+  storeFrame();
+  return true;
+}
+
+/*!
+ * \brief VisualizerFMU::storeFrame
+ * Stores time, states and visualization values of the FMU in the frame ring.
+ */
+void VisualizerFMU::storeFrame()
+{
+  const FMUData* pData = mpFMU->getFMUData();
+  double* pFrame = mFrames.beginWrite();
+  if (!pFrame) {
+    return;
+  }
+  pFrame[0] = pData->_tcur;
+  std::copy(pData->_states, pData->_states + pData->_nStates, pFrame + 1);
+  double* pValues = pFrame + 1 + pData->_nStates;
+  for (size_t i = 0; i < mVisValueRefs.size(); ++i) {
+    mpFMU->fmi_get_real(&mVisValueRefs[i], &pValues[i]);
+  }
+  mFrames.commitWrite();
+  mLastFrameTime = pData->_tcur;
+}
+
+/*!
+ * \brief VisualizerFMU::startSimulationThread
+ * Restarts the frame ring at the current FMU time and starts the simulation thread.
+ */
+void VisualizerFMU::startSimulationThread()
+{
+  mFrameInterval = mpTimeManager->getHVisual() / 10.0;
+  mFrames.resize(512, 1 + mpFMU->getFMUData()->_nStates + mVisAttributes.size());
+  storeFrame();
+  mFrames.interpolate(mpFMU->getFMUData()->_tcur, mFrameValues);
+  mpSimulationThread->start();
+}
+
+void VisualizerFMU::stopSimulationThread()
+{
+  mpSimulationThread->stop();
+}
+
+/*!
+ * \brief VisualizerFMU::rewindToShownFrame
+ * Sets the time and the states of the FMU back to the frame that is shown. The frames the simulation thread has
+ * computed ahead are dropped when it is restarted. Must only be called while the simulation thread is stopped.
+ * Only the continuous states are reset; the discrete state of the FMU stays at the time the thread has reached.
+ */
+void VisualizerFMU::rewindToShownFrame()
+{
+  const FMUData* pData = mpFMU->getFMUData();
+  if (mFrameValues.size() == 1 + pData->_nStates + mVisAttributes.size()) {
+    mpFMU->setCurrentTime(mFrameValues[0]);
+    std::copy(mFrameValues.begin() + 1, mFrameValues.begin() + 1 + pData->_nStates, pData->_states);
+  }
+  mpTimeManager->setVisTime(pData->_tcur);
+}
+
 void VisualizerFMU::initializeVisAttributes(const double time)
 {
+  stopSimulationThread();
   mpFMU->initialize(mpSimSettings);
+  mHNext = mpSimSettings->getHdef();
   //std::cout<<"VisualizerFMU::loadFMU: FMU was successfully initialized."<<std::endl;
 
   mpTimeManager->setVisTime(mpTimeManager->getStartTime());
   mpTimeManager->setSimTime(mpTimeManager->getStartTime());
   setVarReferencesInVisAttributes();
+  collectVisAttributes();
   updateVisAttributes(mpTimeManager->getVisTime());
+  startSimulationThread();
 }
 
 void VisualizerFMU::updateVisAttributes(const double time)
+{
+  // Get the values for the scene graph objects
+  for (auto attr : mVisAttributes) {
+    updateObjectAttributeFMU(attr, mpFMU);
+  }
+  updateShapes(time);
+}
+
+void VisualizerFMU::updateShapes(const double time)
 {
   // Update all shapes.
   rAndT rT;
@@ -261,36 +397,6 @@ void VisualizerFMU::updateVisAttributes(const double time)
     size_t i = 0;
     for (auto& shape : mpOMVisualBase->_shapes)
     {
-      // Get the values for the scene graph objects
-      updateObjectAttributeFMU(&shape._length, mpFMU);
-      updateObjectAttributeFMU(&shape._width, mpFMU);
-      updateObjectAttributeFMU(&shape._height, mpFMU);
-
-      updateObjectAttributeFMU(&shape._lDir[0], mpFMU);
-      updateObjectAttributeFMU(&shape._lDir[1], mpFMU);
-      updateObjectAttributeFMU(&shape._lDir[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._wDir[0], mpFMU);
-      updateObjectAttributeFMU(&shape._wDir[1], mpFMU);
-      updateObjectAttributeFMU(&shape._wDir[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._r[0], mpFMU);
-      updateObjectAttributeFMU(&shape._r[1], mpFMU);
-      updateObjectAttributeFMU(&shape._r[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._rShape[0], mpFMU);
-      updateObjectAttributeFMU(&shape._rShape[1], mpFMU);
-      updateObjectAttributeFMU(&shape._rShape[2], mpFMU);
-
-      updateObjectAttributeFMU(&shape._T[0], mpFMU);
-      updateObjectAttributeFMU(&shape._T[1], mpFMU);
-      updateObjectAttributeFMU(&shape._T[2], mpFMU);
-      updateObjectAttributeFMU(&shape._T[3], mpFMU);
-      updateObjectAttributeFMU(&shape._T[4], mpFMU);
-      updateObjectAttributeFMU(&shape._T[5], mpFMU);
-      updateObjectAttributeFMU(&shape._T[6], mpFMU);
-      updateObjectAttributeFMU(&shape._T[7], mpFMU);
-      updateObjectAttributeFMU(&shape._T[8], mpFMU);
       rT = rotateModelica2OSG(osg::Vec3f(shape._r[0].exp, shape._r[1].exp, shape._r[2].exp),
                 osg::Vec3f(shape._rShape[0].exp, shape._rShape[1].exp, shape._rShape[2].exp),
                 osg::Matrix3(shape._T[0].exp, shape._T[1].exp, shape._T[2].exp,
@@ -321,22 +427,31 @@ void VisualizerFMU::updateVisAttributes(const double time)
   }
 }
 
+/*!
+ * \brief VisualizerFMU::updateScene
+ * Shows the frame of the simulation thread at the given time. If the simulation thread is behind, the visualization
+ * time is set back to the latest frame, so the animation slows down instead of blocking the GUI.
+ * \param time
+ */
 void VisualizerFMU::updateScene(const double time)
 {
   mpTimeManager->updateTick(); //for real-time measurement
-
-  mpTimeManager->setSimTime(mpTimeManager->getVisTime());
-  double nextStep = mpTimeManager->getVisTime() + mpTimeManager->getHVisual();
-
-  double vis1 = mpTimeManager->getRealTime();
-  while (mpTimeManager->getSimTime() < nextStep)
-  {
-    //std::cout<<"simulate "<<omvManager->_simTime<<" to "<<nextStep<<std::endl;
-    mpTimeManager->setSimTime(simulateStep(mpTimeManager->getSimTime()));
+  if (!mFrames.interpolate(time, mFrameValues)) {
+    return;
   }
-  mpTimeManager->updateTick();                     //for real-time measurement
-  mpTimeManager->setRealTimeFactor(mpTimeManager->getHVisual() / (mpTimeManager->getRealTime() - vis1));
-  updateVisAttributes(mpTimeManager->getVisTime());
+  if (mFrameValues[0] < time) {
+    mpTimeManager->setVisTime(mFrameValues[0]);
+  }
+  mpTimeManager->setSimTime(mFrameValues[0]);
+  const size_t offset = 1 + mpFMU->getFMUData()->_nStates;
+  for (size_t i = 0; i < mVisAttributes.size(); ++i) {
+    mVisAttributes[i]->exp = (float) mFrameValues[offset + i];
+  }
+  if (mpTimeManager->getRealTime() > mLastRealTime) {
+    mpTimeManager->setRealTimeFactor(mpTimeManager->getHVisual() / (mpTimeManager->getRealTime() - mLastRealTime));
+  }
+  mLastRealTime = mpTimeManager->getRealTime();
+  updateShapes(mFrameValues[0]);
 }
 
 // Todo pass by const ref
@@ -352,9 +467,43 @@ void VisualizerFMU::updateObjectAttributeFMU(ShapeObjectAttribute* attr, FMUWrap
 
 void VisualizerFMU::setSimulationSettings(double stepsize, Solver solver, bool iterateEvents)
 {
+  stopSimulationThread();
   mpSimSettings->setHdef(stepsize);
   mpSimSettings->setSolver(solver);
   mpSimSettings->setIterateEvents(iterateEvents);
+  mHNext = stepsize;
+  if (mpFMU && !mVisAttributes.empty()) {
+    // continue from the frame that is shown
+    rewindToShownFrame();
+    updateSystem();
+    startSimulationThread();
+  }
+}
+
+/*!
+ * \brief VisualizerFMU::setStateValue
+ * Sets a state of the FMU at the time that is shown and restarts the simulation from there.
+ * \param idx
+ * \param value
+ */
+void VisualizerFMU::setStateValue(const unsigned int idx, const double value)
+{
+  stopSimulationThread();
+  rewindToShownFrame();
+  mpFMU->getFMUData()->_states[idx] = value;
+  updateSystem();
+  startSimulationThread();
+}
+
+/*!
+ * \brief VisualizerFMU::getStateValue
+ * Returns the state value of the frame that is currently shown.
+ * \param idx
+ * \return
+ */
+double VisualizerFMU::getStateValue(const unsigned int idx) const
+{
+  return (idx + 1 < mFrameValues.size()) ? mFrameValues[idx + 1] : 0.0;
 }
 
 FMUWrapperAbstract* VisualizerFMU::getFMU()
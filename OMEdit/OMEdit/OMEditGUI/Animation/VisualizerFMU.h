@@ -38,6 +38,7 @@
 
 #include "Visualizer.h"
 #include "FMUWrapper.h"
+#include "FMUSimulationThread.h"
 #include "Shapes.h"
 #include "TimeManager.h"
 
@@ -58,12 +59,17 @@ class VisualizerFMU : public VisualizerAbstract
   int setVarReferencesInVisAttributes();
   void simulate(TimeManager& omvm) override;
   double simulateStep(const double time);
+  bool simulateFrame();
   void updateSystem();
   void updateVisAttributes(const double time) override;
+  void updateShapes(const double time);
   void updateScene(const double time = 0.0) override;
   void updateObjectAttributeFMU(ShapeObjectAttribute* attr, FMUWrapperAbstract* fmuWrapper);
   void setSimulationSettings(double stepsize, Solver solver, bool iterateEvents);
+  void setStateValue(const unsigned int idx, const double value);
+  double getStateValue(const unsigned int idx) const;
   FMUWrapperAbstract* getFMU();
+  FMUFrameRing* getFrames() {return &mFrames;}
 
  private:
   std::shared_ptr<fmi_import_context_t> mpContext;
@@ -71,6 +77,22 @@ class VisualizerFMU : public VisualizerAbstract
   fmi_version_enu_t mVersion;
   FMUWrapperAbstract* mpFMU;
   std::shared_ptr<SimSettingsFMU> mpSimSettings;
+  FMUSimulationThread* mpSimulationThread;
+  //! Frames computed by the simulation thread: time, states and the values of mVisAttributes.
+  FMUFrameRing mFrames;
+  std::vector<double> mFrameValues;
+  std::vector<ShapeObjectAttribute*> mVisAttributes;
+  std::vector<unsigned int> mVisValueRefs;
+  double mFrameInterval;
+  double mLastFrameTime;
+  double mHNext;
+  double mLastRealTime;
+
+  void collectVisAttributes();
+  void storeFrame();
+  void rewindToShownFrame();
+  void startSimulationThread();
+  void stopSimulationThread();
 };
 
 
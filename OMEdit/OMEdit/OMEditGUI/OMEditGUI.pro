@@ -321,6 +321,7 @@ SOURCES += Animation/AbstractAnimationWindow.cpp \
   Animation/VisualizerFMU.cpp \
   Animation/FMUSettingsDialog.cpp \
   Animation/FMUWrapper.cpp \
+  Animation/FMUSimulationThread.cpp \
   Animation/Shapes.cpp
 
 greaterThan(QT_MAJOR_VERSION, 4):greaterThan(QT_MINOR_VERSION, 3) { # if Qt 5.4 or greater
@@ -340,6 +341,7 @@ HEADERS += Animation/AbstractAnimationWindow.h \
   Animation/VisualizerFMU.h \
   Animation/FMUSettingsDialog.h \
   Animation/FMUWrapper.h \
+  Animation/FMUSimulationThread.h \
   Animation/Shapes.h \
   Animation/rapidxml.hpp
 }
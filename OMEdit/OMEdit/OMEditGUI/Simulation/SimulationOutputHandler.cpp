@@ -34,6 +34,8 @@
 #include "SimulationOutputHandler.h"
 #include "Options/OptionsDialog.h"
 
+#include <QtEndian>
+
 /*!
   \class SimulationMessageModel
   \brief Data model for Simulation output messages.
@@ -291,6 +293,53 @@ void SimulationOutputHandler::parseSimulationOutput(QString output)
   mXmlSimpleReader.parseContinue();
 }
 
+/*!
+ * \brief SimulationOutputHandler::parseSimulationOutputRecords
+ * Handles the records decoded from the binary simulation output like the corresponding xml elements.
+ * \param records
+ */
+void SimulationOutputHandler::parseSimulationOutputRecords(const QList<SimulationOutputRecord> &records)
+{
+  foreach (SimulationOutputRecord record, records) {
+    QXmlAttributes attributes;
+    switch (record.mKind) {
+      case SimulationOutputRecord::Message:
+        // the messages after the display limit are only written to the log file
+        if (isMaximumDisplayLimitReached()) {
+          writeSimulationLog(record.mText + "\n");
+          break;
+        }
+        attributes.append("stream", "", "stream", record.mStream);
+        attributes.append("type", "", "type", record.mType);
+        attributes.append("text", "", "text", record.mText);
+        startElement("", "", "message", attributes);
+        if (isMaximumDisplayLimitReached()) {
+          break;
+        }
+        if (!record.mIndex.isEmpty()) {
+          QXmlAttributes usedAttributes;
+          usedAttributes.append("index", "", "index", record.mIndex);
+          startElement("", "", "used", usedAttributes);
+        }
+        if (!record.mIndentNext) {
+          endElement("", "", "message");
+        }
+        break;
+      case SimulationOutputRecord::MessageEnd:
+        if (mLevel > 0 && !isMaximumDisplayLimitReached()) {
+          endElement("", "", "message");
+        }
+        break;
+      case SimulationOutputRecord::Status:
+        attributes.append("progress", "", "progress", QString::number(record.mProgress));
+        startElement("", "", "status", attributes);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
 /*!
  * \brief SimulationOutputHandler::writeSimulationLog
  * Writes the simulation log file.
@@ -477,3 +526,153 @@ bool SimulationOutputHandler::fatalError(const QXmlParseException &exception)
   }
   return false;
 }
+
+/*!
+ * \class SimulationBinaryOutputReader
+ * \brief Reads and decodes the binary output (-logFormat=bintcp) of the simulation executable in its own thread.
+ */
+/*
+  The simulation executable sends frames of a uint32 payload length followed by the records,
+  all numbers are little endian.
+  message:     uint8 1, stream (uint8 length, chars), type (uint8 length, chars), uint8 indentNext,
+               text (uint32 length, chars), uint32 number of indexes, int32 indexes
+  message end: uint8 2
+  status:      uint8 3, int32 progress, double time, double step size, phase (uint8 length, chars)
+  */
+/*!
+ * \brief SimulationBinaryOutputReader::SimulationBinaryOutputReader
+ */
+SimulationBinaryOutputReader::SimulationBinaryOutputReader()
+  : QObject(0), mpTcpSocket(0)
+{
+}
+
+/*!
+ * \brief SimulationBinaryOutputReader::openSocket
+ * Slot activated when SimulationTcpServer newSocketDescriptor SIGNAL is raised.\n
+ * Creates the socket of the connection to the simulation executable in the thread of the reader.
+ * \param socketDescriptor
+ */
+void SimulationBinaryOutputReader::openSocket(SocketDescriptor socketDescriptor)
+{
+  mpTcpSocket = new QTcpSocket(this);
+  if (!mpTcpSocket->setSocketDescriptor(socketDescriptor)) {
+    emit socketDisconnected();
+    return;
+  }
+  connect(mpTcpSocket, SIGNAL(readyRead()), SLOT(readSimulationOutput()));
+  connect(mpTcpSocket, SIGNAL(disconnected()), SLOT(readSimulationOutput()));
+  connect(mpTcpSocket, SIGNAL(disconnected()), SIGNAL(socketDisconnected()));
+}
+
+/*!
+ * \brief SimulationBinaryOutputReader::readRecord
+ * Decodes the record at position of a frame.
+ * \param pData - the frame payload.
+ * \param size - size of the frame payload.
+ * \param position - position of the record, moved behind the record.
+ * \param record - the decoded record.
+ * \return false if the record is incomplete or unknown.
+ */
+bool SimulationBinaryOutputReader::readRecord(const char *pData, int size, int &position, SimulationOutputRecord &record)
+{
+  const uchar *pBytes = reinterpret_cast<const uchar*>(pData);
+  quint32 length;
+  switch (pBytes[position++]) {
+    case SimulationOutputRecord::Message:
+      record.mKind = SimulationOutputRecord::Message;
+      if (position >= size || position + 1 + pBytes[position] > size) {
+        return false;
+      }
+      record.mStream = QString::fromUtf8(pData + position + 1, pBytes[position]);
+      position += 1 + pBytes[position];
+      if (position >= size || position + 1 + pBytes[position] > size) {
+        return false;
+      }
+      record.mType = QString::fromUtf8(pData + position + 1, pBytes[position]);
+      position += 1 + pBytes[position];
+      if (position + 5 > size) {
+        return false;
+      }
+      record.mIndentNext = pBytes[position] != 0;
+      length = qFromLittleEndian<quint32>(pBytes + position + 1);
+      position += 5;
+      if (length > (quint32)(size - position)) {
+        return false;
+      }
+      record.mText = QString::fromUtf8(pData + position, length);
+      position += length;
+      if (position + 4 > size) {
+        return false;
+      }
+      length = qFromLittleEndian<quint32>(pBytes + position);
+      position += 4;
+      if (length > (quint32)(size - position) / 4) {
+        return false;
+      }
+      // the view links the last used index like the xml output
+      if (length > 0) {
+        record.mIndex = QString::number(qFromLittleEndian<qint32>(pBytes + position + 4 * (length - 1)));
+      }
+      position += 4 * length;
+      return true;
+    case SimulationOutputRecord::MessageEnd:
+      record.mKind = SimulationOutputRecord::MessageEnd;
+      return true;
+    case SimulationOutputRecord::Status:
+      record.mKind = SimulationOutputRecord::Status;
+      // progress, time and step size
+      if (position + 21 > size) {
+        return false;
+      }
+      record.mProgress = qFromLittleEndian<qint32>(pBytes + position);
+      position += 20;
+      if (position + 1 + pBytes[position] > size) {
+        return false;
+      }
+      position += 1 + pBytes[position];
+      return true;
+    default:
+      return false;
+  }
+}
+
+/*!
+ * \brief SimulationBinaryOutputReader::readSimulationOutput
+ * Slot activated when QTcpSocket readyRead or disconnected SIGNAL is raised.\n
+ * Decodes the complete frames and sends their records in one batch, only the last progress status is kept.
+ */
+void SimulationBinaryOutputReader::readSimulationOutput()
+{
+  mBuffer.append(mpTcpSocket->readAll());
+  QList<SimulationOutputRecord> records;
+  int statusIndex = -1;
+  int offset = 0;
+  while (mBuffer.size() - offset >= 4) {
+    quint32 frameSize = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(mBuffer.constData() + offset));
+    if (frameSize > (quint32)(mBuffer.size() - offset - 4)) {
+      break;
+    }
+    const char *pFrame = mBuffer.constData() + offset + 4;
+    int position = 0;
+    while (position < (int)frameSize) {
+      SimulationOutputRecord record;
+      // skip the rest of an invalid frame
+      if (!readRecord(pFrame, frameSize, position, record)) {
+        break;
+      }
+      if (record.mKind == SimulationOutputRecord::Status) {
+        if (statusIndex >= 0) {
+          records.removeAt(statusIndex);
+        }
+        statusIndex = records.size();
+      }
+      records.append(record);
+    }
+    offset += 4 + frameSize;
+  }
+  mBuffer.remove(0, offset);
+  if (!records.isEmpty()) {
+    emit sendSimulationOutputRecords(records);
+  }
+}
@@ -37,6 +37,7 @@
 #include "Simulation/SimulationOutputWidget.h"
 
 #include <QXmlDefaultHandler>
+#include <QTcpSocket>
 
 class SimulationMessage
 {
@@ -113,8 +114,27 @@ public:
   ~SimulationOutputHandler();
   SimulationMessageModel* getSimulationMessageModel() {return mpSimulationMessageModel;}
   void parseSimulationOutput(QString output);
+  void parseSimulationOutputRecords(const QList<SimulationOutputRecord> &records);
   void writeSimulationLog(const QString &text);
   void simulationProcessFinished();
 };
 
+class SimulationBinaryOutputReader : public QObject
+{
+  Q_OBJECT
+public:
+  SimulationBinaryOutputReader();
+private:
+  QTcpSocket *mpTcpSocket;
+  QByteArray mBuffer;
+
+  bool readRecord(const char *pData, int size, int &position, SimulationOutputRecord &record);
+public slots:
+  void openSocket(SocketDescriptor socketDescriptor);
+  void readSimulationOutput();
+signals:
+  void sendSimulationOutputRecords(QList<SimulationOutputRecord> records);
+  void socketDisconnected();
+};
+
 #endif // SIMULATIONOUTPUTHANDLER_H
@@ -396,10 +396,29 @@ SimulationOutputWidget::SimulationOutputWidget(SimulationOptions simulationOptio
   mpArchivedSimulationItem = new ArchivedSimulationItem(mSimulationOptions, this);
   MainWindow::instance()->getSimulationDialog()->getArchivedSimulationsTreeWidget()->addTopLevelItem(mpArchivedSimulationItem);
   // start the tcp server
-  mpTcpServer = new QTcpServer;
+  mpTcpServer = new SimulationTcpServer(isOutputBinary());
   mSocketDisconnected = true;
+  mpBinaryOutputThread = 0;
+  mpBinaryOutputReader = 0;
+  qRegisterMetaType<QList<SimulationOutputRecord> >("QList<SimulationOutputRecord>");
+  if (isOutputBinary()) {
+    // decode the binary output in a separate thread and only handle the decoded records here.
+    // The reader creates the socket in its thread from the descriptor of the accepted connection.
+    qRegisterMetaType<SocketDescriptor>("SocketDescriptor");
+    mpBinaryOutputThread = new QThread;
+    mpBinaryOutputReader = new SimulationBinaryOutputReader;
+    mpBinaryOutputReader->moveToThread(mpBinaryOutputThread);
+    connect(mpBinaryOutputThread, SIGNAL(finished()), mpBinaryOutputReader, SLOT(deleteLater()));
+    connect(mpTcpServer, SIGNAL(newSocketDescriptor(SocketDescriptor)), SLOT(binarySocketConnected()));
+    connect(mpTcpServer, SIGNAL(newSocketDescriptor(SocketDescriptor)), mpBinaryOutputReader, SLOT(openSocket(SocketDescriptor)));
+    connect(mpBinaryOutputReader, SIGNAL(sendSimulationOutputRecords(QList<SimulationOutputRecord>)),
+            SLOT(writeSimulationOutputRecords(QList<SimulationOutputRecord>)));
+    connect(mpBinaryOutputReader, SIGNAL(socketDisconnected()), SLOT(socketDisconnected()));
+    mpBinaryOutputThread->start();
+  } else {
+    connect(mpTcpServer, SIGNAL(newConnection()), SLOT(createSimulationProgressSocket()));
+  }
   mpTcpServer->listen(QHostAddress(QHostAddress::LocalHost));
-  connect(mpTcpServer, SIGNAL(newConnection()), SLOT(createSimulationProgressSocket()));
   // create the thread
   mpSimulationProcessThread = new SimulationProcessThread(this);
   connect(mpSimulationProcessThread, SIGNAL(sendCompilationStarted()), SLOT(compilationProcessStarted()));
@@ -420,6 +439,11 @@ SimulationOutputWidget::~SimulationOutputWidget()
   if (OptionsDialog::instance()->getSimulationPage()->getDeleteEntireSimulationDirectoryCheckBox()->isChecked()) {
     Utilities::removeDirectoryRecursivly(mSimulationOptions.getWorkingDirectory());
   }
+  if (mpBinaryOutputThread) {
+    mpBinaryOutputThread->quit();
+    mpBinaryOutputThread->wait();
+    delete mpBinaryOutputThread;
+  }
   if (mpSimulationOutputHandler) {
     delete mpSimulationOutputHandler;
   }
@@ -428,6 +452,17 @@ SimulationOutputWidget::~SimulationOutputWidget()
   }
 }
 
+/*!
+ * \brief SimulationOutputWidget::isOutputBinary
+ * Returns true if the simulation executable sends its messages and progress in the binary format (-logFormat=bintcp).\n
+ * Only the C runtime supports it, the other targets use the xml format.
+ * \return
+ */
+bool SimulationOutputWidget::isOutputBinary()
+{
+  return mSimulationOptions.getTargetLanguage().compare("C") == 0;
+}
+
 void SimulationOutputWidget::addGeneratedFileTab(QString fileName)
 {
   QFile file(fileName);
@@ -535,6 +570,34 @@ void SimulationOutputWidget::deleteIntermediateCompilationFiles()
   }
 }
 
+/*!
+ * \class SimulationTcpServer
+ * \brief Accepts the connection of the simulation executable.
+ */
+/*!
+ * \brief SimulationTcpServer::SimulationTcpServer
+ * \param handOutDescriptor - if true the first connection is handed out with newSocketDescriptor instead of a pending socket.
+ */
+SimulationTcpServer::SimulationTcpServer(bool handOutDescriptor)
+  : QTcpServer(), mHandOutDescriptor(handOutDescriptor)
+{
+}
+
+/*!
+ * \brief SimulationTcpServer::incomingConnection
+ * Hands out the descriptor of the first connection for the binary output, a socket must not be moved to another thread.
+ * \param socketDescriptor
+ */
+void SimulationTcpServer::incomingConnection(SocketDescriptor socketDescriptor)
+{
+  if (mHandOutDescriptor) {
+    mHandOutDescriptor = false;
+    emit newSocketDescriptor(socketDescriptor);
+  } else {
+    QTcpServer::incomingConnection(socketDescriptor);
+  }
+}
+
 /*!
  * \brief SimulationOutputWidget::createSimulationProgressSocket
  * Slot activated when QTcpServer newConnection SIGNAL is raised.\n
@@ -547,13 +610,23 @@ void SimulationOutputWidget::createSimulationProgressSocket()
     if (pTcpServer && pTcpServer->hasPendingConnections()) {
       QTcpSocket *pTcpSocket = pTcpServer->nextPendingConnection();
       mSocketDisconnected = false;
-      connect(pTcpSocket, SIGNAL(readyRead()), SLOT(readSimulationProgress()));
       connect(pTcpSocket, SIGNAL(disconnected()), SLOT(socketDisconnected()));
+      connect(pTcpSocket, SIGNAL(readyRead()), SLOT(readSimulationProgress()));
       disconnect(pTcpServer, SIGNAL(newConnection()), this, SLOT(createSimulationProgressSocket()));
     }
   }
 }
 
+/*!
+ * \brief SimulationOutputWidget::binarySocketConnected
+ * Slot activated when SimulationTcpServer newSocketDescriptor SIGNAL is raised.\n
+ * The socket is read by the SimulationBinaryOutputReader in its thread.
+ */
+void SimulationOutputWidget::binarySocketConnected()
+{
+  mSocketDisconnected = false;
+}
+
 /*!
  * \brief SimulationProcessThread::readSimulationProgress
  * Slot activated when QTcpSocket readyRead or disconnected SIGNAL is raised.\n
@@ -698,6 +771,26 @@ void SimulationOutputWidget::writeSimulationOutput(QString output, StringHandler
   mpGeneratedFilesTabWidget->setCurrentIndex(0);
 }
 
+/*!
+ * \brief SimulationOutputWidget::writeSimulationOutputRecords
+ * Slot activated when SimulationBinaryOutputReader sendSimulationOutputRecords signal is raised.\n
+ * Writes the decoded simulation messages and progress.
+ * \param records
+ */
+void SimulationOutputWidget::writeSimulationOutputRecords(QList<SimulationOutputRecord> records)
+{
+  mpGeneratedFilesTabWidget->setTabEnabled(0, true);
+  if (!mpSimulationOutputHandler) {
+    mpSimulationOutputHandler = new SimulationOutputHandler(this, "");
+    if (isOutputStructured()) {
+      mpSimulationOutputTree->setModel(mpSimulationOutputHandler->getSimulationMessageModel());
+    }
+  }
+  mpSimulationOutputHandler->parseSimulationOutputRecords(records);
+  /* make the compilation tab the current one */
+  mpGeneratedFilesTabWidget->setCurrentIndex(0);
+}
+
 /*!
  * \brief SimulationOutputWidget::simulationProcessFinished
  * Slot activated when SimulationProcessThread sendSimulationFinished signal is raised.\n
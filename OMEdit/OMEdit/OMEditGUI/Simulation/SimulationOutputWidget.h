@@ -45,14 +45,66 @@
 #include <QProcess>
 #include <QDateTime>
 #include <QTcpServer>
+#include <QThread>
 
 class Label;
 class SimulationProcessThread;
 class SimulationOutputHandler;
 class SimulationOutputWidget;
 class SimulationMessage;
+class SimulationBinaryOutputReader;
 class ArchivedSimulationItem;
 
+/*!
+ * \class SimulationOutputRecord
+ * \brief A decoded record of the binary simulation output (-logFormat=bintcp).
+ */
+class SimulationOutputRecord
+{
+public:
+  enum RecordKind {
+    Message = 1,
+    MessageEnd = 2,
+    Status = 3
+  };
+  RecordKind mKind;
+  QString mStream;
+  QString mType;
+  QString mText;
+  bool mIndentNext;
+  QString mIndex;
+  int mProgress;
+  SimulationOutputRecord()
+    : mKind(Message), mIndentNext(false), mProgress(0)
+  {}
+};
+Q_DECLARE_METATYPE(QList<SimulationOutputRecord>)
+
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
+typedef qintptr SocketDescriptor;
+#else
+typedef int SocketDescriptor;
+#endif
+
+/*!
+ * \class SimulationTcpServer
+ * \brief Accepts the connection of the simulation executable.
+ * For the binary output the first connection is handed out as a socket descriptor,
+ * so the socket can be created in the thread reading it.
+ */
+class SimulationTcpServer : public QTcpServer
+{
+  Q_OBJECT
+public:
+  SimulationTcpServer(bool handOutDescriptor);
+protected:
+  void incomingConnection(SocketDescriptor socketDescriptor);
+private:
+  bool mHandOutDescriptor;
+signals:
+  void newSocketDescriptor(SocketDescriptor socketDescriptor);
+};
+
 class SimulationOutputTree : public QTreeView
 {
   Q_OBJECT
@@ -85,6 +137,7 @@ public:
   QProgressBar* getProgressBar() {return mpProgressBar;}
   QTabWidget* getGeneratedFilesTabWidget() {return mpGeneratedFilesTabWidget;}
   bool isOutputStructured() {return mIsOutputStructured;}
+  bool isOutputBinary();
   SimulationOutputTree* getSimulationOutputTree() {return mpSimulationOutputTree;}
   QPlainTextEdit* getCompilationOutputTextBox() {return mpCompilationOutputTextBox;}
   QTcpServer* getTcpServer() {return mpTcpServer;}
@@ -109,14 +162,17 @@ private:
   SimulationOutputTree *mpSimulationOutputTree;
   QPlainTextEdit *mpCompilationOutputTextBox;
   ArchivedSimulationItem *mpArchivedSimulationItem;
-  QTcpServer *mpTcpServer;
+  SimulationTcpServer *mpTcpServer;
   bool mSocketDisconnected;
+  QThread *mpBinaryOutputThread;
+  SimulationBinaryOutputReader *mpBinaryOutputReader;
   SimulationProcessThread *mpSimulationProcessThread;
   QDateTime mResultFileLastModifiedDateTime;
 
   void deleteIntermediateCompilationFiles();
 public slots:
   void createSimulationProgressSocket();
+  void binarySocketConnected();
   void readSimulationProgress();
   void socketDisconnected();
   void compilationProcessStarted();
@@ -124,6 +180,7 @@ public slots:
   void compilationProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
   void simulationProcessStarted();
   void writeSimulationOutput(QString output, StringHandler::SimulationMessageType type, bool textFormat);
+  void writeSimulationOutputRecords(QList<SimulationOutputRecord> records);
   void simulationProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
   void cancelCompilationOrSimulation();
   void openTransformationalDebugger();
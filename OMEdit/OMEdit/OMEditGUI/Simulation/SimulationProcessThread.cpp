@@ -136,7 +136,7 @@ void SimulationProcessThread::runSimulationExecutable()
 #endif
   connect(mpSimulationProcess, SIGNAL(finished(int,QProcess::ExitStatus)), SLOT(simulationProcessFinished(int,QProcess::ExitStatus)), Qt::DirectConnection);
   QStringList args(QString("-port=").append(QString::number(mpSimulationOutputWidget->getTcpServer()->serverPort())));
-  args << "-logFormat=xmltcp" << simulationOptions.getSimulationFlags();
+  args << (mpSimulationOutputWidget->isOutputBinary() ? "-logFormat=bintcp" : "-logFormat=xmltcp") << simulationOptions.getSimulationFlags();
   // start the executable
   QString fileName = QString(simulationOptions.getWorkingDirectory()).append("/").append(simulationOptions.getOutputFileName());
   fileName = fileName.replace("//", "/");
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+# Runs a simulation executable with -logFormat=bintcp, receives its records
+# and prints the messages in the layout of the text log (-logFormat=text).
+# Usage: bintcpLog.py <executable> <simulation flags...>
+# The exit code is 1 if the message ends do not match the messages, or if the
+# last status record is not "Finished".
+
+import socket
+import struct
+import subprocess
+import sys
+
+BINTCP_MESSAGE = 1
+BINTCP_MESSAGE_END = 2
+BINTCP_STATUS = 3
+
+
+def recvAll(conn):
+  data = b""
+  while True:
+    chunk = conn.recv(65536)
+    if not chunk:
+      return data
+    data += chunk
+
+
+class Decoder:
+  def __init__(self, payload):
+    self.data = payload
+    self.pos = 0
+
+  def uint(self, fmt):
+    value, = struct.unpack_from("<" + fmt, self.data, self.pos)
+    self.pos += struct.calcsize(fmt)
+    return value
+
+  def string(self, lengthFormat):
+    length = self.uint(lengthFormat)
+    value = self.data[self.pos:self.pos + length].decode("utf-8", "replace")
+    self.pos += length
+    return value
+
+
+class TextLog:
+  """Renders the messages like messageText in util/omc_error.c"""
+  def __init__(self):
+    self.lines = []
+    self.level = {}
+    self.lastStream = None
+    self.lastType = {}
+    self.open = []
+
+  def message(self, msgType, stream, indentNext, msg, subline=False):
+    level = self.level.get(stream, 0)
+    line = "%-17s | " % ("|" if subline or (self.lastStream == stream and level > 0) else stream)
+    line += "%-7s | " % ("|" if subline or (self.lastStream == stream and self.lastType.get(stream) == msgType and level > 0) else msgType)
+    self.lastType[stream] = msgType
+    self.lastStream = stream
+    line += "| " * level
+    if "\n" in msg[:-1]:
+      first, rest = msg.split("\n", 1)
+      self.lines.append(line + first)
+      self.message(msgType, stream, 0, rest, True)
+      return
+    self.lines.append(line + msg.rstrip("\n"))
+    if indentNext:
+      self.level[stream] = level + 1
+      self.open.append(stream)
+
+  def close(self):
+    if not self.open:
+      return False
+    stream = self.open.pop()
+    self.level[stream] -= 1
+    return True
+
+
+def main():
+  server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+  server.bind(("127.0.0.1", 0))
+  server.listen(1)
+  port = server.getsockname()[1]
+  process = subprocess.Popen(sys.argv[1:] + ["-port=%d" % port, "-logFormat=bintcp"],
+                             stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+  conn, _ = server.accept()
+  data = recvAll(conn)
+  conn.close()
+  output = process.communicate()[0]
+
+  log = TextLog()
+  balanced = True
+  phase = None
+  offset = 0
+  while offset + 4 <= len(data):
+    size, = struct.unpack_from("<I", data, offset)
+    frame = Decoder(data[offset + 4:offset + 4 + size])
+    offset += 4 + size
+    while frame.pos < len(frame.data):
+      record = frame.uint("B")
+      if record == BINTCP_MESSAGE:
+        stream = frame.string("B")
+        msgType = frame.string("B")
+        indentNext = frame.uint("B")
+        msg = frame.string("I")
+        for _ in range(frame.uint("I")):
+          frame.uint("i")
+        log.message(msgType, stream, indentNext, msg)
+      elif record == BINTCP_MESSAGE_END:
+        balanced = log.close() and balanced
+      elif record == BINTCP_STATUS:
+        frame.uint("i")
+        frame.uint("d")
+        frame.uint("d")
+        phase = frame.string("B")
+      else:
+        print("unknown record %d" % record)
+        return 1
+
+  for line in log.lines:
+    print(line)
+  sys.stdout.write(output.decode("utf-8", "replace"))
+  if not balanced or log.open:
+    print("unbalanced message ends")
+    return 1
+  if phase != "Finished":
+    print("last status: %s" % phase)
+    return 1
+  return 0
+
+
+if __name__ == "__main__":
+  sys.exit(main())
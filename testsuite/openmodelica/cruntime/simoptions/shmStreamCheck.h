@@ -0,0 +1,78 @@
+/* Reads the ring written by -shmStream through omc_shm_stream.h, used by
+ * shmStreamCheck.mo. Returns 0 if the ring holds the last capacity records
+ * of the finished simulation of ShmStreamM with consistent values, else the
+ * number of the failed check. */
+
+#include "util/omc_shm_stream.h"
+#include <math.h>
+#include <string.h>
+
+static int shmStreamFind(const omc_shm_stream_reader *reader, const char *name, unsigned int first, unsigned int n)
+{
+  unsigned int i;
+  for (i = first; i < first + n; i++) {
+    if (0 == strcmp(omc_shm_stream_name(reader, i), name)) {
+      return i - first;
+    }
+  }
+  return -1;
+}
+
+static int shmStreamCheckRing(const omc_shm_stream_reader *reader, int capacity, double *lastTime, double *lastX, int *lastK, int *count)
+{
+  const omc_shm_stream_header *header = reader->header;
+  int x = shmStreamFind(reader, "x", 0, header->nReal);
+  int k = shmStreamFind(reader, "k", header->nReal, header->nInteger);
+  int b = shmStreamFind(reader, "b", header->nReal + header->nInteger, header->nBoolean);
+  uint64_t n, total = omc_shm_stream_count(reader);
+  const void *record;
+  double time = -1;
+  int64_t prevK = 0;
+
+  *count = (int) total;
+  if (header->capacity != (uint32_t) capacity || !header->finished) {
+    return 1;
+  }
+  if (x < 0 || k < 0 || b < 0) {
+    return 2;
+  }
+  /* the ring wrapped around: the older records are overwritten */
+  if (total <= (uint64_t) capacity || omc_shm_stream_record(reader, total - capacity - 1) || omc_shm_stream_record(reader, total)) {
+    return 3;
+  }
+  for (n = total - capacity; n < total; n++) {
+    if (!(record = omc_shm_stream_record(reader, n))) {
+      return 4;
+    }
+    /* der(x) = 1, x(0) = 0 */
+    if (OMC_SHM_STREAM_TIME(record) < time || fabs(OMC_SHM_STREAM_REAL(record)[x] - OMC_SHM_STREAM_TIME(record)) > 1e-6) {
+      return 5;
+    }
+    if (OMC_SHM_STREAM_INTEGER(header, record)[k] < prevK || OMC_SHM_STREAM_BOOLEAN(header, record)[b] != (OMC_SHM_STREAM_INTEGER(header, record)[k] > 5)) {
+      return 6;
+    }
+    time = OMC_SHM_STREAM_TIME(record);
+    prevK = OMC_SHM_STREAM_INTEGER(header, record)[k];
+    *lastTime = time;
+    *lastX = OMC_SHM_STREAM_REAL(record)[x];
+    *lastK = (int) prevK;
+    if (!omc_shm_stream_valid(reader, record, n)) {
+      return 7;
+    }
+  }
+  return 0;
+}
+
+static int shmStreamCheck(const char *filename, int capacity, double *lastTime, double *lastX, int *lastK, int *count)
+{
+  omc_shm_stream_reader reader;
+  int status;
+  *lastTime = *lastX = 0;
+  *lastK = *count = 0;
+  if (omc_shm_stream_open(&reader, filename)) {
+    return 8;
+  }
+  status = shmStreamCheckRing(&reader, capacity, lastTime, lastX, lastK, count);
+  omc_shm_stream_close(&reader);
+  return status;
+}
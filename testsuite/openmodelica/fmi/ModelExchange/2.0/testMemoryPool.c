@@ -0,0 +1,249 @@
+/* Driver of testMemoryPool.mos: loads the binary of an FMI 2.0 model exchange
+ * FMU and checks the mark/release scopes of the memory pool and the pools of
+ * the FMU instances.
+ * Usage: testMemoryPool <FMU binary> <modelDescription.xml>
+ */
+
+#include <dlfcn.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The parts of fmi2FunctionTypes.h and memory_pool.h that are used */
+typedef void* fmi2Component;
+typedef int fmi2Boolean;
+typedef enum { fmi2OK, fmi2Warning, fmi2Discard, fmi2Error, fmi2Fatal, fmi2Pending } fmi2Status;
+typedef enum { fmi2ModelExchange, fmi2CoSimulation } fmi2Type;
+
+typedef struct {
+  void (*logger)(void*, const char*, fmi2Status, const char*, const char*, ...);
+  void* (*allocateMemory)(size_t, size_t);
+  void (*freeMemory)(void*);
+  void (*stepFinished)(void*, fmi2Status);
+  void* componentEnvironment;
+} fmi2CallbackFunctions;
+
+typedef struct {
+  fmi2Boolean newDiscreteStatesNeeded;
+  fmi2Boolean terminateSimulation;
+  fmi2Boolean nominalsOfContinuousStatesChanged;
+  fmi2Boolean valuesOfContinuousStatesChanged;
+  fmi2Boolean nextEventTimeDefined;
+  double nextEventTime;
+} fmi2EventInfo;
+
+typedef struct {
+  void *pool;
+  void *chunk;
+  size_t used;
+} omc_pool_state;
+
+typedef struct {
+  size_t used;
+  size_t reserved;
+  size_t peakUsed;
+  size_t peakReserved;
+} omc_pool_statistics;
+
+typedef struct {
+  void (*init)(void);
+  void* (*malloc)(size_t);
+  void* (*malloc_atomic)(size_t);
+} omc_alloc_interface_t;
+
+static void *lib;
+
+static void* load(const char *name)
+{
+  void *sym = dlsym(lib, name);
+  if (!sym) {
+    printf("missing symbol %s\n", name);
+    exit(1);
+  }
+  return sym;
+}
+
+#define CHECK(cond, msg) if (!(cond)) { printf("failed: %s\n", msg); return 0; }
+
+/* Nested mark/release scopes of a pool, the second one spans a new chunk */
+static int testScopes(void)
+{
+  void* (*pool_new)(void) = (void* (*)(void)) load("memory_pool_new");
+  void (*pool_free)(void*) = (void (*)(void*)) load("memory_pool_free");
+  void* (*activate)(void*) = (void* (*)(void*)) load("memory_pool_activate");
+  omc_pool_state (*get_state)(void) = (omc_pool_state (*)(void)) load("get_memory_state");
+  void (*restore_state)(omc_pool_state) = (void (*)(omc_pool_state)) load("restore_memory_state");
+  void (*statistics)(void*, omc_pool_statistics*) = (void (*)(void*, omc_pool_statistics*)) load("memory_pool_statistics");
+  omc_alloc_interface_t *pooled = (omc_alloc_interface_t*) load("omc_alloc_interface_pooled");
+  omc_pool_state outer, inner;
+  omc_pool_statistics stats;
+  size_t reserved;
+  int i;
+
+  void *pool = pool_new();
+  void *previous = activate(pool);
+  outer = get_state();
+  pooled->malloc(1000);
+  statistics(NULL, &stats);
+  CHECK(stats.used == 1000, "allocation in the outer scope");
+
+  inner = get_state();
+  pooled->malloc_atomic(4*1024*1024);
+  statistics(NULL, &stats);
+  CHECK(stats.used == 1000 + 4*1024*1024, "allocation in a new chunk of the inner scope");
+  restore_state(inner);
+  statistics(NULL, &stats);
+  CHECK(stats.used == 1000, "release of the inner scope");
+  reserved = stats.reserved;
+
+  /* the released chunk is reused and not allocated again */
+  for (i = 0; i < 10; i++) {
+    inner = get_state();
+    pooled->malloc_atomic(4*1024*1024);
+    restore_state(inner);
+  }
+  statistics(NULL, &stats);
+  CHECK(stats.reserved == reserved && stats.peakReserved == reserved, "reuse of the released chunk");
+
+  restore_state(outer);
+  statistics(NULL, &stats);
+  CHECK(stats.used == 0 && stats.peakUsed == 1000 + 4*1024*1024, "release of the outer scope");
+
+  CHECK(activate(previous) == pool, "activation of the previous pool");
+  pool_free(pool);
+  statistics(NULL, &stats);
+  CHECK(stats.peakUsed == 0, "no allocations in the default pool");
+  return 1;
+}
+
+/* Peak usage of the instance pools, logged by fmi2FreeInstance */
+static unsigned long peakUsage[2];
+
+static void logger(void *env, const char *instanceName, fmi2Status status, const char *category, const char *message, ...)
+{
+  char buf[1024];
+  unsigned long used, reserved;
+  va_list args;
+  va_start(args, message);
+  vsnprintf(buf, sizeof(buf), message, args);
+  va_end(args);
+  if (sscanf(buf, "fmi2FreeInstance: memory pool peak usage %lu of %lu", &used, &reserved) == 2) {
+    peakUsage[instanceName[0] == 'B'] = used;
+  } else if (status != fmi2OK) {
+    printf("%s: %s\n", instanceName, buf);
+  }
+}
+
+/* Two instances are integrated alternately with explicit Euler steps, A for 10
+ * and B for 2000 steps. Every call releases its temporaries, so the peak
+ * usage of both pools is the same. fmi2ExitInitializationMode of a model with
+ * a sample calls fmi2EventUpdate, the nested call must keep the instance pool
+ * active until the outer call returns. */
+static int testInstances(const char *guid)
+{
+  fmi2Component (*instantiate)(const char*, fmi2Type, const char*, const char*, const fmi2CallbackFunctions*, fmi2Boolean, fmi2Boolean) =
+    (fmi2Component (*)(const char*, fmi2Type, const char*, const char*, const fmi2CallbackFunctions*, fmi2Boolean, fmi2Boolean)) load("fmi2Instantiate");
+  fmi2Status (*setDebugLogging)(fmi2Component, fmi2Boolean, size_t, const char*[]) = (fmi2Status (*)(fmi2Component, fmi2Boolean, size_t, const char*[])) load("fmi2SetDebugLogging");
+  fmi2Status (*setupExperiment)(fmi2Component, fmi2Boolean, double, double, fmi2Boolean, double) = (fmi2Status (*)(fmi2Component, fmi2Boolean, double, double, fmi2Boolean, double)) load("fmi2SetupExperiment");
+  fmi2Status (*enterInitializationMode)(fmi2Component) = (fmi2Status (*)(fmi2Component)) load("fmi2EnterInitializationMode");
+  fmi2Status (*exitInitializationMode)(fmi2Component) = (fmi2Status (*)(fmi2Component)) load("fmi2ExitInitializationMode");
+  fmi2Status (*newDiscreteStates)(fmi2Component, fmi2EventInfo*) = (fmi2Status (*)(fmi2Component, fmi2EventInfo*)) load("fmi2NewDiscreteStates");
+  fmi2Status (*enterContinuousTimeMode)(fmi2Component) = (fmi2Status (*)(fmi2Component)) load("fmi2EnterContinuousTimeMode");
+  fmi2Status (*setTime)(fmi2Component, double) = (fmi2Status (*)(fmi2Component, double)) load("fmi2SetTime");
+  fmi2Status (*getContinuousStates)(fmi2Component, double*, size_t) = (fmi2Status (*)(fmi2Component, double*, size_t)) load("fmi2GetContinuousStates");
+  fmi2Status (*setContinuousStates)(fmi2Component, const double*, size_t) = (fmi2Status (*)(fmi2Component, const double*, size_t)) load("fmi2SetContinuousStates");
+  fmi2Status (*getDerivatives)(fmi2Component, double*, size_t) = (fmi2Status (*)(fmi2Component, double*, size_t)) load("fmi2GetDerivatives");
+  fmi2Status (*completedIntegratorStep)(fmi2Component, fmi2Boolean, fmi2Boolean*, fmi2Boolean*) = (fmi2Status (*)(fmi2Component, fmi2Boolean, fmi2Boolean*, fmi2Boolean*)) load("fmi2CompletedIntegratorStep");
+  void (*freeInstance)(fmi2Component) = (void (*)(fmi2Component)) load("fmi2FreeInstance");
+  void (*statistics)(void*, omc_pool_statistics*) = (void (*)(void*, omc_pool_statistics*)) load("memory_pool_statistics");
+  fmi2CallbackFunctions functions = {logger, calloc, free, NULL, NULL};
+  const char *categories[] = {"logFmi2Call"};
+  const char *names[2] = {"A", "B"};
+  int numSteps[2] = {10, 2000};
+  fmi2Component comp[2];
+  fmi2EventInfo eventInfo;
+  fmi2Boolean enterEventMode, terminateSimulation;
+  omc_pool_statistics stats;
+  double x, der_x, h = 1e-4;
+  int i, k;
+
+  for (k = 0; k < 2; k++) {
+    comp[k] = instantiate(names[k], fmi2ModelExchange, guid, "", &functions, 0, 1);
+    CHECK(comp[k], "fmi2Instantiate");
+    setDebugLogging(comp[k], 1, 1, categories);
+    setupExperiment(comp[k], 0, 0.0, 0.0, 0, 0.0);
+    CHECK(enterInitializationMode(comp[k]) == fmi2OK && exitInitializationMode(comp[k]) == fmi2OK, "initialization");
+    memset(&eventInfo, 0, sizeof(eventInfo));
+    eventInfo.newDiscreteStatesNeeded = 1;
+    while (eventInfo.newDiscreteStatesNeeded) {
+      newDiscreteStates(comp[k], &eventInfo);
+    }
+    enterContinuousTimeMode(comp[k]);
+  }
+  statistics(NULL, &stats);
+  CHECK(stats.peakUsed == 0, "no allocations of the initialization in the default pool");
+
+  for (i = 1; i <= numSteps[1]; i++) {
+    for (k = 0; k < 2; k++) {
+      if (i > numSteps[k]) {
+        continue;
+      }
+      getContinuousStates(comp[k], &x, 1);
+      CHECK(getDerivatives(comp[k], &der_x, 1) == fmi2OK, "fmi2GetDerivatives");
+      x += h*der_x;
+      setTime(comp[k], i*h);
+      setContinuousStates(comp[k], &x, 1);
+      completedIntegratorStep(comp[k], 1, &enterEventMode, &terminateSimulation);
+    }
+  }
+  statistics(NULL, &stats);
+  CHECK(stats.peakUsed == 0, "no allocations of the steps in the default pool");
+
+  for (k = 0; k < 2; k++) {
+    freeInstance(comp[k]);
+  }
+  printf("peak usage of the instance pools: %s\n", peakUsage[0] > 0 && peakUsage[0] == peakUsage[1] ? "equal" : "different");
+  return peakUsage[0] > 0 && peakUsage[0] == peakUsage[1];
+}
+
+int main(int argc, char **argv)
+{
+  char buf[65536], *guid, *end;
+  size_t len;
+  FILE *file;
+  int ok;
+
+  if (argc < 3) {
+    printf("Usage: testMemoryPool <FMU binary> <modelDescription.xml>\n");
+    return 1;
+  }
+  file = fopen(argv[2], "r");
+  len = file ? fread(buf, 1, sizeof(buf) - 1, file) : 0;
+  buf[len] = '\0';
+  if (file) {
+    fclose(file);
+  }
+  guid = strstr(buf, "guid=\"");
+  if (!guid || !(end = strchr(guid + 6, '"'))) {
+    printf("no guid in %s\n", argv[2]);
+    return 1;
+  }
+  guid += 6;
+  *end = '\0';
+
+  lib = dlopen(argv[1], RTLD_NOW | RTLD_LOCAL);
+  if (!lib) {
+    printf("%s\n", dlerror());
+    return 1;
+  }
+  ok = testScopes();
+  printf("mark/release scopes: %s\n", ok ? "ok" : "failed");
+  if (testInstances(guid)) {
+    printf("instance pools: ok\n");
+  } else {
+    printf("instance pools: failed\n");
+    ok = 0;
+  }
+  return ok ? 0 : 1;
+}